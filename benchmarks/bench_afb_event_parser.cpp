@@ -0,0 +1,89 @@
+#include <QtTest/QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "afb_event_parser.h"
+
+/**
+ * @brief Per-frame cost of decoding a Vehicle.Speed event
+ *
+ * Compares the previous QJsonDocument path in VehicleDataManager against
+ * AfbEventParser on the same QString input. Run with e.g. "-tickcounter"
+ * or "-callgrind" for stable numbers on target hardware.
+ */
+class BenchAfbEventParser : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchQJsonDocument_data();
+    void benchQJsonDocument();
+    void benchAfbEventParser_data();
+    void benchAfbEventParser();
+
+private:
+    void addFrames();
+};
+
+void BenchAfbEventParser::initTestCase() {
+    qInfo() << "Benchmarking AFB event decoding";
+}
+
+void BenchAfbEventParser::addFrames() {
+    QTest::addColumn<QString>("frame");
+
+    QTest::newRow("minimal") << QString(R"({"event":"vss/Vehicle.Speed","data":{"value":65.5}})");
+    QTest::newRow("binding") << QString(
+        R"({"jtype":"afb-event","event":"vss/Vehicle.Speed",)"
+        R"("data":{"path":"Vehicle.Speed","value":65.5,"unit":"km/h","timestamp":1699964123456}})");
+    QTest::newRow("other signal") << QString(
+        R"({"jtype":"afb-event","event":"vss/Vehicle.Powertrain.CombustionEngine.Speed",)"
+        R"("data":{"path":"Vehicle.Powertrain.CombustionEngine.Speed","value":2450,)"
+        R"("unit":"rpm","timestamp":1699964123456}})");
+}
+
+void BenchAfbEventParser::benchQJsonDocument_data() {
+    addFrames();
+}
+
+void BenchAfbEventParser::benchQJsonDocument() {
+    QFETCH(QString, frame);
+
+    double sink = 0.0;
+    QBENCHMARK {
+        // Mirrors the original VehicleDataManager::onTextMessageReceived
+        QJsonDocument doc = QJsonDocument::fromJson(frame.toUtf8());
+        QJsonObject obj = doc.object();
+        if (obj.contains("event") && obj["event"].toString() == "vss/Vehicle.Speed") {
+            QJsonObject data = obj["data"].toObject();
+            if (data["unit"].toString("km/h") == "km/h") {
+                sink += data["value"].toDouble();
+            }
+        }
+    }
+    Q_UNUSED(sink);
+}
+
+void BenchAfbEventParser::benchAfbEventParser_data() {
+    addFrames();
+}
+
+void BenchAfbEventParser::benchAfbEventParser() {
+    QFETCH(QString, frame);
+
+    double sink = 0.0;
+    QBENCHMARK {
+        AfbEvent event;
+        const auto result = AfbEventParser::parse(
+            reinterpret_cast<const char16_t*>(frame.utf16()),
+            static_cast<std::size_t>(frame.size()), event);
+        if (result == AfbEventParser::Result::Event && event.nameEquals("vss/Vehicle.Speed") &&
+            (!event.has_unit || event.unitEquals("km/h"))) {
+            sink += event.value;
+        }
+    }
+    Q_UNUSED(sink);
+}
+
+QTEST_MAIN(BenchAfbEventParser)
+#include "bench_afb_event_parser.moc"
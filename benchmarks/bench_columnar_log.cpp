@@ -0,0 +1,111 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <cmath>
+#include "columnar_log.h"
+
+/**
+ * @brief Scanning a day of speed log: CSV text vs. columnar blocks
+ *
+ * Both files hold the same records. The CSV scan reads and parses every
+ * row the way analysis scripts do; the columnar scan maps the file and
+ * decodes the blocks.
+ */
+class BenchColumnarLog : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchCsvScan();
+    void benchColumnarScan();
+    void benchColumnarWrite();
+
+private:
+    static constexpr int RECORDS = 24 * 3600 * 10;   // one day at 10 Hz
+
+    QTemporaryDir temp_dir_;
+    QVector<SpeedLogRecord> records_;
+    QString csv_path_;
+    QString columnar_path_;
+};
+
+void BenchColumnarLog::initTestCase() {
+    QVERIFY(temp_dir_.isValid());
+    csv_path_ = temp_dir_.filePath("day.csv");
+    columnar_path_ = temp_dir_.filePath("day.cslog");
+
+    const qint64 start_ms = QDateTime::currentMSecsSinceEpoch();
+    records_.reserve(RECORDS);
+    for (int i = 0; i < RECORDS; ++i) {
+        SpeedLogRecord record;
+        record.wall_ms = start_ms + i * 100;
+        record.smoothed_speed = 60.0 + 40.0 * std::sin(i * 0.001);
+        record.raw_speed = record.smoothed_speed + (i % 5) * 0.3;
+        record.state = static_cast<quint8>(record.smoothed_speed / 25.0);
+        records_.append(record);
+    }
+
+    SpeedLogCsvFormatter formatter;
+    QByteArray csv(SpeedLogCsvFormatter::HEADER);
+    for (const auto& record : records_) {
+        formatter.appendRow(csv, record);
+    }
+    QFile file(csv_path_);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(csv);
+    file.close();
+
+    ColumnarLogWriter writer;
+    QVERIFY(writer.open(columnar_path_));
+    for (const auto& record : records_) {
+        writer.append(record);
+    }
+    writer.close();
+
+    qInfo() << "Records:" << RECORDS << "CSV:" << QFileInfo(csv_path_).size() << "bytes,"
+            << "columnar:" << QFileInfo(columnar_path_).size() << "bytes";
+}
+
+void BenchColumnarLog::benchCsvScan() {
+    double sum = 0.0;
+    qint64 last_ms = 0;
+    QBENCHMARK {
+        QFile file(csv_path_);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        file.readLine();   // header
+        while (!file.atEnd()) {
+            const QList<QByteArray> fields = file.readLine().split(',');
+            if (fields.size() == 4) {
+                last_ms = QDateTime::fromString(QString::fromLatin1(fields[0]), Qt::ISODate)
+                              .toMSecsSinceEpoch();
+                sum += fields[1].toDouble();
+            }
+        }
+    }
+    QVERIFY(sum > 0.0 && last_ms > 0);
+}
+
+void BenchColumnarLog::benchColumnarScan() {
+    double sum = 0.0;
+    QBENCHMARK {
+        ColumnarLogReader reader;
+        QVERIFY(reader.open(columnar_path_));
+        reader.forEach([&sum](const SpeedLogRecord& record) { sum += record.raw_speed; });
+    }
+    QVERIFY(sum > 0.0);
+}
+
+void BenchColumnarLog::benchColumnarWrite() {
+    const QString path = temp_dir_.filePath("write.cslog");
+    QBENCHMARK {
+        QFile::remove(path);
+        ColumnarLogWriter writer;
+        QVERIFY(writer.open(path));
+        for (const auto& record : records_) {
+            writer.append(record);
+        }
+    }
+}
+
+QTEST_MAIN(BenchColumnarLog)
+#include "bench_columnar_log.moc"
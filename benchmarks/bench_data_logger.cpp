@@ -0,0 +1,55 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "data_logger.h"
+
+/**
+ * @brief Caller-side cost of DataLogger::logSpeedData
+ *
+ * Compares the synchronous path (format, write and flush per record)
+ * against the background writer, where the caller only enqueues a
+ * fixed-size record.
+ */
+class BenchDataLogger : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchSynchronous();
+    void benchWriterThread();
+
+private:
+    static constexpr int RECORDS_PER_ITERATION = 100;
+
+    QTemporaryDir temp_dir_;
+};
+
+void BenchDataLogger::initTestCase() {
+    QVERIFY(temp_dir_.isValid());
+    qInfo() << "Benchmarking DataLogger," << RECORDS_PER_ITERATION << "records per iteration";
+}
+
+void BenchDataLogger::benchSynchronous() {
+    DataLogger logger(temp_dir_.path() + "/sync");
+    QBENCHMARK {
+        for (int i = 0; i < RECORDS_PER_ITERATION; ++i) {
+            logger.logSpeedData(60.0 + (i & 7), 60.0, ExpressionState::NORMAL);
+        }
+    }
+}
+
+void BenchDataLogger::benchWriterThread() {
+    DataLogger logger(temp_dir_.path() + "/async");
+    QVERIFY(logger.startWriter(50));
+    QBENCHMARK {
+        for (int i = 0; i < RECORDS_PER_ITERATION; ++i) {
+            logger.logSpeedData(60.0 + (i & 7), 60.0, ExpressionState::NORMAL);
+        }
+    }
+    logger.stopWriter();
+    qInfo() << "Written:" << logger.writtenRecords() << "dropped:" << logger.droppedRecords()
+            << "max queue depth:" << logger.maxQueueDepth();
+}
+
+QTEST_MAIN(BenchDataLogger)
+#include "bench_data_logger.moc"
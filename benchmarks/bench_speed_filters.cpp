@@ -0,0 +1,132 @@
+#include <QtTest/QtTest>
+#include <QVector>
+#include <random>
+#include "business_logic/speed_filters.h"
+#include "speed_trace.h"
+
+/**
+ * @brief Lag, noise rejection and per-sample cost of the SpeedMonitor policies
+ *
+ * The reference trace is the synthetic drive cycle, or a DataLogger CSV
+ * given in CARSPEEDBOY_TRACE. Gaussian noise (sigma 1.5 km/h) is added and
+ * each filter's output is compared with the clean trace: lag is the time
+ * shift that minimises the squared error, noise is the remaining RMS error
+ * at that shift relative to the input noise.
+ */
+class BenchSpeedFilters : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void reportLagAndNoise();
+    void benchUpdate_data();
+    void benchUpdate();
+
+private:
+    struct Quality {
+        double lag_ms;
+        double noise_ratio;
+    };
+
+    template <typename Filter>
+    Quality measure(Filter filter) const;
+
+    QVector<double> clean_;
+    QVector<double> noisy_;
+    double period_s_ = 0.1;
+
+    static constexpr double NOISE_SIGMA = 1.5;
+    static constexpr int MAX_LAG_SAMPLES = 30;
+};
+
+void BenchSpeedFilters::initTestCase() {
+    SpeedTrace trace;
+    const QString path = qEnvironmentVariable("CARSPEEDBOY_TRACE");
+    if (path.isEmpty() || !trace.loadCsv(path)) {
+        trace = SpeedTrace::synthetic(120000, 10);
+    }
+    period_s_ = static_cast<double>(trace.durationMs()) / trace.size() / 1000.0;
+
+    std::mt19937 random(42);
+    std::normal_distribution<double> noise(0.0, NOISE_SIGMA);
+    for (const TracePoint& point : trace.points()) {
+        clean_.append(point.speed);
+        noisy_.append(point.speed + noise(random));
+    }
+    qInfo() << "Trace:" << clean_.size() << "samples at" << period_s_ * 1000.0 << "ms";
+}
+
+template <typename Filter>
+BenchSpeedFilters::Quality BenchSpeedFilters::measure(Filter filter) const {
+    QVector<double> output;
+    output.reserve(noisy_.size());
+    for (double value : noisy_) {
+        output.append(filter.update(value, period_s_));
+    }
+
+    // Best alignment between output[i] and clean[i - lag]
+    int best_lag = 0;
+    double best_error = std::numeric_limits<double>::max();
+    for (int lag = 0; lag <= MAX_LAG_SAMPLES; ++lag) {
+        double error = 0.0;
+        for (int i = MAX_LAG_SAMPLES; i < output.size(); ++i) {
+            const double diff = output[i] - clean_[i - lag];
+            error += diff * diff;
+        }
+        if (error < best_error) {
+            best_error = error;
+            best_lag = lag;
+        }
+    }
+
+    const double rms = std::sqrt(best_error / (output.size() - MAX_LAG_SAMPLES));
+    return {best_lag * period_s_ * 1000.0, rms / NOISE_SIGMA};
+}
+
+void BenchSpeedFilters::reportLagAndNoise() {
+    const auto report = [](const char* name, Quality quality) {
+        qInfo().nospace() << name << ": lag " << quality.lag_ms
+                          << " ms, residual noise x" << quality.noise_ratio;
+    };
+    report(MovingAverageFilter::NAME, measure(MovingAverageFilter(5)));
+    report(EmaFilter::NAME, measure(EmaFilter(0.3)));
+    report(MedianFilter::NAME, measure(MedianFilter(5)));
+    report(OneEuroFilter::NAME, measure(OneEuroFilter()));
+    report(KalmanFilter::NAME, measure(KalmanFilter()));
+}
+
+void BenchSpeedFilters::benchUpdate_data() {
+    QTest::addColumn<int>("policy");
+    QTest::newRow(MovingAverageFilter::NAME) << 0;
+    QTest::newRow(EmaFilter::NAME) << 1;
+    QTest::newRow(MedianFilter::NAME) << 2;
+    QTest::newRow(OneEuroFilter::NAME) << 3;
+    QTest::newRow(KalmanFilter::NAME) << 4;
+}
+
+void BenchSpeedFilters::benchUpdate() {
+    QFETCH(int, policy);
+
+    SpeedFilter filter;
+    switch (policy) {
+        case 0: filter = MovingAverageFilter(); break;
+        case 1: filter = EmaFilter(); break;
+        case 2: filter = MedianFilter(); break;
+        case 3: filter = OneEuroFilter(); break;
+        default: filter = KalmanFilter(); break;
+    }
+
+    // Same dispatch as SpeedMonitor::onRawSpeedUpdate
+    double sink = 0.0;
+    QBENCHMARK {
+        for (double value : noisy_) {
+            sink += std::visit([value, this](auto& f) { return f.update(value, period_s_); },
+                               filter);
+        }
+    }
+    QVERIFY(sink > 0.0);
+}
+
+QTEST_MAIN(BenchSpeedFilters)
+#include "bench_speed_filters.moc"
@@ -0,0 +1,94 @@
+#include <QtTest/QtTest>
+#include <cmath>
+#include "speed_log_csv_scanner.h"
+
+/**
+ * @brief Parsing a day of CSV speed log held in memory
+ *
+ * Row by row through SpeedLogCsvParser (what the offline readers did)
+ * against SpeedLogCsvScanner with its scalar and AVX2 delimiter search.
+ * Divide the logged size by the time per iteration for throughput.
+ */
+class BenchSpeedLogCsv : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchParserRows();
+    void benchScannerScalar();
+    void benchScannerAvx2();
+
+private:
+    void scan(bool use_simd);
+
+    static constexpr int RECORDS = 24 * 3600 * 10;   // one day at 10 Hz
+
+    QByteArray log_;
+};
+
+void BenchSpeedLogCsv::initTestCase() {
+    const qint64 start_ms = QDateTime(QDate(2024, 3, 5), QTime(0, 0)).toMSecsSinceEpoch();
+    SpeedLogCsvFormatter formatter(true);
+    log_ = SpeedLogCsvFormatter::HEADER;
+    log_.reserve(RECORDS * 48);
+    for (int i = 0; i < RECORDS; ++i) {
+        SpeedLogRecord record;
+        record.wall_ms = start_ms + i * 100;
+        record.smoothed_speed = 60.0 + 40.0 * std::sin(i * 0.001);
+        record.raw_speed = record.smoothed_speed + (i % 5) * 0.3;
+        record.state = static_cast<quint8>(record.smoothed_speed / 25.0);
+        formatter.appendRow(log_, record);
+    }
+    qInfo() << "Records:" << RECORDS << "CSV:" << log_.size() << "bytes, AVX2:"
+            << SpeedLogCsvScanner::hasAvx2();
+}
+
+void BenchSpeedLogCsv::benchParserRows() {
+    quint64 rows = 0;
+    QBENCHMARK {
+        rows = 0;
+        const char* bytes = log_.constData();
+        SpeedLogRecord record;
+        int pos = 0;
+        while (pos < log_.size()) {
+            const int end = log_.indexOf('\n', pos);
+            if (end < 0) {
+                break;
+            }
+            if (SpeedLogCsvParser::parseRow(bytes + pos, end - pos, &record)) {
+                ++rows;
+            }
+            pos = end + 1;
+        }
+    }
+    QCOMPARE(rows, quint64(RECORDS));
+}
+
+void BenchSpeedLogCsv::scan(bool use_simd) {
+    quint64 rows = 0;
+    double sum = 0.0;
+    QBENCHMARK {
+        SpeedLogCsvScanner scanner(use_simd);
+        scanner.scan(log_.constData(), log_.size(), [&sum](const SpeedLogRecord& record, qint64, qint64) {
+            sum += record.raw_speed;
+        });
+        rows = scanner.stats().records;
+    }
+    QCOMPARE(rows, quint64(RECORDS));
+    Q_UNUSED(sum);
+}
+
+void BenchSpeedLogCsv::benchScannerScalar() {
+    scan(false);
+}
+
+void BenchSpeedLogCsv::benchScannerAvx2() {
+    if (!SpeedLogCsvScanner::hasAvx2()) {
+        QSKIP("No AVX2 on this CPU");
+    }
+    scan(true);
+}
+
+QTEST_MAIN(BenchSpeedLogCsv)
+#include "bench_speed_log_csv.moc"
@@ -0,0 +1,81 @@
+#include <QtTest/QtTest>
+#include <QQueue>
+#include <numeric>
+#include "common/running_window.h"
+
+/**
+ * @brief Per-sample cost of the SpeedMonitor moving average
+ *
+ * Compares the previous QQueue + std::accumulate implementation against
+ * RunningWindow for every supported window size (1-20).
+ */
+class BenchSpeedMonitor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void benchQueueAccumulate_data();
+    void benchQueueAccumulate();
+    void benchRunningWindow_data();
+    void benchRunningWindow();
+
+private:
+    void addWindowSizes();
+
+    static constexpr int SAMPLES_PER_ITERATION = 1000;
+};
+
+void BenchSpeedMonitor::initTestCase() {
+    qInfo() << "Benchmarking moving average," << SAMPLES_PER_ITERATION << "samples per iteration";
+}
+
+void BenchSpeedMonitor::addWindowSizes() {
+    QTest::addColumn<int>("window_size");
+    for (int size = 1; size <= 20; ++size) {
+        QTest::newRow(QByteArray::number(size).constData()) << size;
+    }
+}
+
+void BenchSpeedMonitor::benchQueueAccumulate_data() {
+    addWindowSizes();
+}
+
+void BenchSpeedMonitor::benchQueueAccumulate() {
+    QFETCH(int, window_size);
+
+    QQueue<double> samples;
+    double sink = 0.0;
+    QBENCHMARK {
+        // Mirrors the original SpeedMonitor::onRawSpeedUpdate
+        for (int i = 0; i < SAMPLES_PER_ITERATION; ++i) {
+            samples.enqueue(60.0 + (i & 7));
+            if (samples.size() > window_size) {
+                samples.dequeue();
+            }
+            sink += std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+        }
+    }
+    QVERIFY(sink > 0.0);
+}
+
+void BenchSpeedMonitor::benchRunningWindow_data() {
+    addWindowSizes();
+}
+
+void BenchSpeedMonitor::benchRunningWindow() {
+    QFETCH(int, window_size);
+
+    RunningWindow<20> samples(static_cast<std::size_t>(window_size));
+    double sink = 0.0;
+    QBENCHMARK {
+        for (int i = 0; i < SAMPLES_PER_ITERATION; ++i) {
+            samples.push(60.0 + (i & 7));
+            sink += samples.mean();
+        }
+    }
+    QVERIFY(sink > 0.0);
+}
+
+QTEST_MAIN(BenchSpeedMonitor)
+#include "bench_speed_monitor.moc"
@@ -1,14 +1,27 @@
 #pragma once
 
+#include <QDateTime>
 #include <QObject>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 class VehicleDataManager;
 class SpeedMonitor;
+class SpeedExtrapolator;
 class ExpressionStateMachine;
 class DataLogger;
+class SpeedRollup;
 class AlertManager;
 class ConfigurationManager;
+class SampleChannel;
+class SampleCoalescer;
+class LatencyTracker;
+class QThread;
+struct VehicleSample;
 
 /**
  * @brief Main application controller
@@ -17,6 +30,7 @@ class ConfigurationManager;
  */
 class ApplicationController : public QObject {
     Q_OBJECT
+    Q_PROPERTY(double displaySpeed READ displaySpeed NOTIFY displaySpeedChanged)
 
 public:
     explicit ApplicationController(QObject* parent = nullptr);
@@ -39,20 +53,146 @@ public:
      */
     void shutdown();
 
+    /**
+     * @brief Sample channel used in I/O-thread acquisition mode
+     * @return Channel, or nullptr when acquisition runs on this thread
+     */
+    const SampleChannel* sampleChannel() const { return sample_channel_.get(); }
+
+    /**
+     * @brief Rate-limiting stage between acquisition and business logic
+     * @return Coalescer (exposes submitted/delivered/coalesced counters)
+     */
+    const SampleCoalescer* sampleCoalescer() const { return sample_coalescer_.get(); }
+
+    /**
+     * @brief Per-stage latency histograms (receive -> frame swapped)
+     */
+    const LatencyTracker* latencyTracker() const { return latency_tracker_.get(); }
+
+    /**
+     * @brief Snapshot of the latency histograms for diagnostics/QML
+     * @return Map of stage name -> {count, min_us, mean_us, p50_us, p99_us, max_us}
+     */
+    Q_INVOKABLE QVariantMap latencyStatistics() const;
+
+    /**
+     * @brief Inter-sample gap statistics of the speed stream
+     * @return See SpeedMonitor::gapSummary()
+     */
+    Q_INVOKABLE QVariantMap sampleGapStatistics() const;
+
+    /**
+     * @brief Newest speed rollup buckets for trend displays
+     * @param tier "1s", "1m" or "1h"
+     * @param count Maximum number of buckets
+     * @return Oldest first, the last one still open; each {start_ms, count,
+     *         min_kmh, max_kmh, mean_kmh, state_ms: {state name -> ms}}
+     */
+    Q_INVOKABLE QVariantList speedRollup(const QString& tier, int count) const;
+
+    /**
+     * @brief Alerts raised by expression state changes
+     */
+    const AlertManager* alertManager() const { return alert_manager_.get(); }
+
+    /**
+     * @brief Most recent alerts, newest first
+     * @return See AlertManager::recentAlerts()
+     */
+    Q_INVOKABLE QVariantList recentAlerts(int count) const;
+
+    /**
+     * @brief Alerts raised in [from, to), oldest first
+     * @return See AlertManager::alertsBetween()
+     */
+    Q_INVOKABLE QVariantList alertsBetween(const QDateTime& from, const QDateTime& to) const;
+
+    /**
+     * @brief Speed to show in the current frame
+     *
+     * Extrapolated to the frame time when display.extrapolate_speed is set,
+     * otherwise the smoothed speed.
+     * @return Speed in km/h
+     */
+    double displaySpeed() const { return display_speed_; }
+
+public slots:
+    /**
+     * @brief Record end-to-end latency of the last displayed speed sample
+     *
+     * Connect to QQuickWindow::frameSwapped with Qt::DirectConnection; it is
+     * safe to call from the scene graph render thread.
+     */
+    void onFrameSwapped();
+
+    /**
+     * @brief Refresh displaySpeed for the frame about to be rendered
+     *
+     * Connect to QQuickWindow::afterAnimating (GUI thread, once per frame).
+     * Changing the property schedules the next frame, so frames keep
+     * coming only while the extrapolated value moves.
+     */
+    void onBeforeFrame();
+
 signals:
     void speedChanged(double speed);
+    void displaySpeedChanged(double speed);
     void expressionStateChanged(const QString& state);
     void errorOccurred(const QString& message);
 
 private slots:
     void onSpeedUpdate(double speed);
     void onVehicleDataError(const QString& error);
+    void onSamplesAvailable();
+    void onSampleReady(const VehicleSample& sample);
+    void onSmoothedSpeedUpdate(double speed);
+    
+    // Apply a config section; called at startup and when a reload changes it
+    void applyExpressionConfig();
+    void applySmoothingConfig();
+    void applyDisplaySettings();
+    void onLoggingConfigChanged();
+    void onVssConfigChanged();
+    void onDataSourceConfigChanged();
+    
+    /**
+     * @brief Reconnect with the current afb, vss and source settings
+     *
+     * Deferred so that several acquisition sections changed by one reload
+     * cause a single reconnect. afb.io_thread needs a restart.
+     */
+    void scheduleReconnect();
+    void reconnectAcquisition();
 
 private:
+    /**
+     * @brief Configure DataLogger and the rollups from the logging section
+     * @param startup Also recover torn log files (before the writer starts)
+     */
+    void configureLogging(bool startup);
+    void startAcquisitionThread();
+    void stopAcquisitionThread();
+    void setDisplaySpeed(double speed);
+
     std::unique_ptr<ConfigurationManager> config_manager_;
     std::unique_ptr<VehicleDataManager> vehicle_data_manager_;
     std::unique_ptr<SpeedMonitor> speed_monitor_;
+    std::unique_ptr<SpeedExtrapolator> speed_extrapolator_;
     std::unique_ptr<ExpressionStateMachine> state_machine_;
     std::unique_ptr<DataLogger> data_logger_;
+    std::unique_ptr<SpeedRollup> speed_rollup_;
     std::unique_ptr<AlertManager> alert_manager_;
+    std::unique_ptr<SampleCoalescer> sample_coalescer_;
+    std::unique_ptr<SampleChannel> sample_channel_;   ///< Set in I/O-thread mode
+    std::unique_ptr<QThread> io_thread_;              ///< Runs VehicleDataManager
+    std::unique_ptr<LatencyTracker> latency_tracker_;
+    int speed_signal_id_ = -1;
+    QStringList signal_paths_;                        ///< vss.signals in use
+    bool reconnect_scheduled_ = false;
+    bool source_changed_ = false;                     ///< Recreate the data source on reconnect
+    std::int64_t current_received_ns_ = 0;            ///< Receive time of the sample in flight
+    std::atomic<std::int64_t> frame_pending_ns_{0};   ///< Receive time awaiting frameSwapped
+    double display_speed_ = 0.0;
+    bool extrapolate_speed_ = true;
 };
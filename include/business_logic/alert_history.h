@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief One alert history entry (16 bytes, trivially copyable)
+ *
+ * Text is not stored; AlertManager formats it from the ids on read.
+ */
+struct AlertRecord {
+    std::int64_t timestamp_ns = 0;   ///< Monotonic time the alert was raised
+    std::uint8_t level = 0;          ///< AlertManager::AlertLevel
+    std::uint8_t state = 0;          ///< ExpressionState that raised it
+    std::uint16_t message_id = 0;    ///< Index into AlertManager's message table
+    std::uint32_t sequence = 0;      ///< Running alert number (wraps)
+};
+
+/**
+ * @brief Fixed-capacity ring of alert records
+ *
+ * Appending overwrites the oldest record once full and never allocates.
+ * Records are kept in append order; timestamps are expected to be
+ * non-decreasing, which lets range queries use binary search.
+ *
+ * @tparam Capacity Number of records kept
+ */
+template <std::size_t Capacity>
+class AlertHistory {
+    static_assert(Capacity >= 1, "Capacity must be at least 1");
+
+public:
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    void append(const AlertRecord& record) {
+        records_[(head_ + count_) % Capacity] = record;
+        if (count_ < Capacity) {
+            ++count_;
+        } else {
+            head_ = (head_ + 1) % Capacity;
+        }
+    }
+
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /**
+     * @brief Record by age
+     * @param index 0 = oldest, size() - 1 = newest
+     */
+    const AlertRecord& at(std::size_t index) const { return records_[(head_ + index) % Capacity]; }
+
+    /**
+     * @brief Visit the newest records, newest first
+     * @param count Maximum number of records
+     * @param visit Called as visit(const AlertRecord&)
+     */
+    template <typename Visitor>
+    void forEachRecent(std::size_t count, Visitor&& visit) const {
+        const std::size_t n = count < count_ ? count : count_;
+        for (std::size_t i = 0; i < n; ++i) {
+            visit(at(count_ - 1 - i));
+        }
+    }
+
+    /**
+     * @brief Visit records with from_ns <= timestamp_ns < to_ns, oldest first
+     */
+    template <typename Visitor>
+    void forEachInRange(std::int64_t from_ns, std::int64_t to_ns, Visitor&& visit) const {
+        for (std::size_t i = lowerBound(from_ns); i < count_; ++i) {
+            const AlertRecord& record = at(i);
+            if (record.timestamp_ns >= to_ns) {
+                break;
+            }
+            visit(record);
+        }
+    }
+
+    /**
+     * @brief Number of records with from_ns <= timestamp_ns < to_ns
+     */
+    std::size_t countInRange(std::int64_t from_ns, std::int64_t to_ns) const {
+        const std::size_t first = lowerBound(from_ns);
+        const std::size_t last = lowerBound(to_ns);
+        return last > first ? last - first : 0;
+    }
+
+private:
+    // Index of the first record at or after timestamp_ns
+    std::size_t lowerBound(std::int64_t timestamp_ns) const {
+        std::size_t low = 0;
+        std::size_t high = count_;
+        while (low < high) {
+            const std::size_t mid = low + (high - low) / 2;
+            if (at(mid).timestamp_ns < timestamp_ns) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    std::array<AlertRecord, Capacity> records_{};
+    std::size_t head_ = 0;    ///< Oldest record
+    std::size_t count_ = 0;
+};
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <QObject>
-#include <QQueue>
+#include <QDateTime>
+#include <QVariantList>
+#include "alert_history.h"
 #include "expression_state_machine.h"
 
 /**
  * @brief Manages visual alerts based on expression state
  * 
- * Provides priority-based alert management and history tracking.
+ * Provides priority-based alert management and history tracking. History
+ * is a fixed ring of compact AlertRecord entries; text and wall-clock
+ * times are produced only when a reader asks for them.
  */
 class AlertManager : public QObject {
     Q_OBJECT
@@ -21,6 +25,9 @@ public:
     };
     Q_ENUM(AlertLevel)
 
+    static constexpr int MAX_HISTORY_SIZE = 100;  ///< Maximum history entries
+    using History = AlertHistory<MAX_HISTORY_SIZE>;
+
     explicit AlertManager(QObject* parent = nullptr);
     ~AlertManager();
 
@@ -34,7 +41,45 @@ public:
      * @brief Get alert history size
      * @return Number of alerts in history
      */
-    int alertHistorySize() const { return alert_history_.size(); }
+    int alertHistorySize() const { return static_cast<int>(alert_history_.size()); }
+
+    /**
+     * @brief Raw alert history for diagnostics (no formatting, no copy)
+     */
+    const History& history() const { return alert_history_; }
+
+    /**
+     * @brief Most recent alerts, newest first
+     * @param count Maximum number of alerts
+     * @return List of maps {time, level, state, message, text}
+     */
+    Q_INVOKABLE QVariantList recentAlerts(int count) const;
+
+    /**
+     * @brief Alerts raised in [from, to), oldest first
+     * @return List of maps {time, level, state, message, text}
+     */
+    Q_INVOKABLE QVariantList alertsBetween(const QDateTime& from, const QDateTime& to) const;
+
+    /**
+     * @brief Wall-clock time of a record
+     */
+    QDateTime alertTime(const AlertRecord& record) const;
+
+    /**
+     * @brief Format a record as "[ISO time] Level N: message"
+     */
+    QString formatAlert(const AlertRecord& record) const;
+
+    /**
+     * @brief Message text for a message id
+     */
+    static QString alertMessage(int message_id);
+
+    /**
+     * @brief Drop all history entries
+     */
+    void clearHistory() { alert_history_.clear(); }
 
 public slots:
     /**
@@ -75,11 +120,23 @@ private:
     /**
      * @brief Add alert to history
      * @param level Alert level
-     * @param message Alert message
+     * @param state Expression state that raised it
      */
-    void addToHistory(AlertLevel level, const QString& message);
+    void addToHistory(AlertLevel level, ExpressionState state);
+
+    /**
+     * @brief Convert a record to the map returned to QML
+     */
+    QVariantMap toVariant(const AlertRecord& record) const;
+
+    /**
+     * @brief Monotonic clock in nanoseconds
+     */
+    static qint64 nowNs();
 
     AlertLevel current_alert_level_;           ///< Current alert level
-    QQueue<QString> alert_history_;            ///< Alert history
-    static constexpr int MAX_HISTORY_SIZE = 100;  ///< Maximum history entries
+    History alert_history_;                    ///< Alert history
+    quint32 next_sequence_;                    ///< Sequence number of the next alert
+    qint64 wall_base_ms_;                      ///< Wall clock at mono_base_ns_
+    qint64 mono_base_ns_;                      ///< Monotonic clock at construction
 };
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <vector>
+#include "speed_log_record.h"
+
+/**
+ * @brief On-disk layout of the columnar speed log (.cslog)
+ *
+ * All integers are little-endian.
+ *
+ *   file header (16 bytes)
+ *     magic "CSBL", u16 version, u16 header size, u32 block capacity, u32 reserved
+ *   block, repeated
+ *     header (40 bytes)
+ *       u32 magic "BLK1", u32 record count n,
+ *       i64 first wall ms, i64 last wall ms,
+ *       i32 first raw speed, i32 first smoothed speed (centi-km/h),
+ *       u8 time width, u8 raw width, u8 smoothed width (bytes, 1 or 2),
+ *       u8 state bits (4 or 8),
+ *       u32 CRC-32 of the header's first 36 bytes and the payload (version 2;
+ *       zero in version 1 files)
+ *     columns, each fixed-width within the block
+ *       u8/u16[n]  timestamp delta (ms)
+ *       i8/i16[n]  raw speed delta (centi-km/h)
+ *       i8/i16[n]  smoothed speed delta (centi-km/h)
+ *       state[n]   expression state, two per byte at 4 bits (low nibble first)
+ *     zero padding to a multiple of 8 bytes
+ *
+ * Deltas are taken from the previous record; the first delta of a block is
+ * zero. Each column uses the narrowest width that holds all of the block's
+ * deltas. A record whose deltas do not fit in 16 bits starts a new block,
+ * so blocks need no escape codes. A steady 10 Hz drive takes 4-5 bytes per
+ * record against ~45-60 bytes of CSV text.
+ *
+ * Blocks are only appended, so a power loss can at worst leave a torn
+ * last block; its checksum or length gives it away.
+ */
+namespace ColumnarLog {
+    constexpr char FILE_MAGIC[4] = {'C', 'S', 'B', 'L'};
+    constexpr quint16 VERSION = 2;                 ///< 2 adds block checksums
+    constexpr int FILE_HEADER_SIZE = 16;
+    constexpr quint32 BLOCK_MAGIC = 0x314b4c42;    ///< "BLK1"
+    constexpr int BLOCK_HEADER_SIZE = 40;
+    constexpr double SPEED_SCALE = 100.0;          ///< Stored units per km/h
+    constexpr const char* FILE_SUFFIX = "cslog";
+
+    /**
+     * @brief Speed in stored units, rounded and clamped to +-200,000 km/h
+     */
+    qint32 toCentiKmh(double speed);
+
+    /**
+     * @brief Column widths of one block
+     */
+    struct BlockLayout {
+        quint8 time_width = 2;       ///< Bytes per timestamp delta
+        quint8 raw_width = 2;        ///< Bytes per raw speed delta
+        quint8 smoothed_width = 2;   ///< Bytes per smoothed speed delta
+        quint8 state_bits = 8;       ///< Bits per state
+
+        bool isValid() const {
+            return (time_width == 1 || time_width == 2) && (raw_width == 1 || raw_width == 2)
+                && (smoothed_width == 1 || smoothed_width == 2)
+                && (state_bits == 4 || state_bits == 8);
+        }
+
+        /**
+         * @brief Column bytes for count records, padding included
+         */
+        qint64 payloadSize(quint32 count) const {
+            const qint64 n = count;
+            const qint64 bytes = n * (time_width + raw_width + smoothed_width)
+                + (n * state_bits + 7) / 8;
+            return (bytes + 7) & ~qint64(7);
+        }
+    };
+}
+
+/**
+ * @brief Appends SpeedLogRecords to a columnar log file
+ *
+ * Records are buffered column-wise and written one block at a time, when
+ * the block is full, when a delta does not fit, or on flush(). Speeds are
+ * rounded to 0.01 km/h.
+ */
+class ColumnarLogWriter {
+public:
+    static constexpr int DEFAULT_BLOCK_CAPACITY = 1024;   ///< ~100 s at 10 Hz
+    static constexpr int MAX_BLOCK_CAPACITY = 65535;
+
+    explicit ColumnarLogWriter(int block_capacity = DEFAULT_BLOCK_CAPACITY);
+    ~ColumnarLogWriter();
+
+    ColumnarLogWriter(const ColumnarLogWriter&) = delete;
+    ColumnarLogWriter& operator=(const ColumnarLogWriter&) = delete;
+
+    /**
+     * @brief Open a log file, appending to it if it already has a valid header
+     * @param path File path
+     * @param error Set to the reason on failure (optional)
+     * @return true if successful
+     */
+    bool open(const QString& path, QString* error = nullptr);
+
+    /**
+     * @brief Write the pending block and close the file
+     */
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+    QString path() const { return file_.fileName(); }
+    int blockCapacity() const { return block_capacity_; }
+
+    /**
+     * @brief Buffer one record, writing a block when needed
+     * @return false if a block write failed
+     */
+    bool append(const SpeedLogRecord& record);
+
+    /**
+     * @brief Write the pending records as a (possibly short) block
+     * @return false if the write failed
+     */
+    bool flush();
+
+    /**
+     * @brief flush(), then fdatasync() so the written blocks survive a power loss
+     * @return false if the write or sync failed
+     */
+    bool sync();
+
+    /**
+     * @brief Bytes in the file, pending records excluded
+     */
+    qint64 fileSize() const { return file_size_; }
+
+    int pendingRecords() const { return static_cast<int>(states_.size()); }
+    quint64 blocksWritten() const { return blocks_written_; }
+
+private:
+    bool fits(qint64 wall_ms, qint32 raw, qint32 smoothed) const;
+    bool writeBlock();
+
+    QFile file_;
+    int block_capacity_;
+    qint64 file_size_ = 0;
+    quint64 blocks_written_ = 0;
+
+    // Pending block
+    qint64 first_ms_ = 0;
+    qint64 last_ms_ = 0;
+    qint32 first_raw_ = 0;
+    qint32 first_smoothed_ = 0;
+    qint32 last_raw_ = 0;
+    qint32 last_smoothed_ = 0;
+    std::vector<qint32> time_deltas_;      ///< Widths are chosen when the block is written
+    std::vector<qint32> raw_deltas_;
+    std::vector<qint32> smoothed_deltas_;
+    std::vector<quint8> states_;
+};
+
+/**
+ * @brief Reads a columnar log through a read-only memory mapping
+ *
+ * open() maps the file and walks the block headers to build the block
+ * index; payloads are decoded on demand. A trailing partial or corrupt
+ * block (bad length or checksum) ends the index and is reported by
+ * truncated(), so a file that is still being written or was cut by a
+ * power loss can be read up to its last complete block.
+ */
+class ColumnarLogReader {
+public:
+    /**
+     * @brief Index entry for one block
+     */
+    struct BlockInfo {
+        qint64 offset = 0;       ///< Block header position in the file
+        quint32 count = 0;       ///< Records in the block
+        qint64 first_ms = 0;
+        qint64 last_ms = 0;
+        ColumnarLog::BlockLayout layout;
+    };
+
+    ColumnarLogReader() = default;
+    ~ColumnarLogReader();
+
+    ColumnarLogReader(const ColumnarLogReader&) = delete;
+    ColumnarLogReader& operator=(const ColumnarLogReader&) = delete;
+
+    /**
+     * @brief Map a file and index its blocks
+     * @param path File path
+     * @param error Set to the reason on failure (optional)
+     * @return false if the file cannot be mapped or has no valid file header
+     */
+    bool open(const QString& path, QString* error = nullptr);
+
+    void close();
+    bool isOpen() const { return data_ != nullptr; }
+
+    const QVector<BlockInfo>& blocks() const { return blocks_; }
+    quint64 recordCount() const { return record_count_; }
+    qint64 fileSize() const { return size_; }
+
+    /**
+     * @brief Bytes after the last complete block
+     */
+    bool truncated() const { return truncated_; }
+
+    /**
+     * @brief File header plus all complete blocks; the size to truncate a torn file to
+     */
+    qint64 validBytes() const { return valid_bytes_; }
+
+    /**
+     * @brief Decode one block
+     * @param block Block index
+     * @param out Room for blocks()[block].count records
+     * @return Records decoded
+     */
+    int decodeBlock(int block, SpeedLogRecord* out) const;
+
+    QVector<SpeedLogRecord> readBlock(int block) const;
+    QVector<SpeedLogRecord> readAll() const;
+
+    /**
+     * @brief Visit every record in file order
+     * @param visit Called as visit(const SpeedLogRecord&)
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        std::vector<SpeedLogRecord> buffer;
+        for (int i = 0; i < blocks_.size(); ++i) {
+            buffer.resize(blocks_[i].count);
+            const int count = decodeBlock(i, buffer.data());
+            for (int j = 0; j < count; ++j) {
+                visit(buffer[j]);
+            }
+        }
+    }
+
+    /**
+     * @brief Visit records with from_ms <= wall_ms < to_ms in file order
+     *
+     * Blocks outside the range are skipped using the index.
+     */
+    template <typename Visitor>
+    void forEachInRange(qint64 from_ms, qint64 to_ms, Visitor&& visit) const {
+        std::vector<SpeedLogRecord> buffer;
+        for (int i = firstBlockEndingAtOrAfter(from_ms); i < blocks_.size(); ++i) {
+            const BlockInfo& info = blocks_[i];
+            if (info.last_ms < from_ms || info.first_ms >= to_ms) {
+                if (ordered_ && info.first_ms >= to_ms) {
+                    break;
+                }
+                continue;
+            }
+            buffer.resize(info.count);
+            const int count = decodeBlock(i, buffer.data());
+            for (int j = 0; j < count; ++j) {
+                if (buffer[j].wall_ms >= from_ms && buffer[j].wall_ms < to_ms) {
+                    visit(buffer[j]);
+                }
+            }
+        }
+    }
+
+private:
+    // First block that may hold from_ms (binary search when blocks are ordered)
+    int firstBlockEndingAtOrAfter(qint64 from_ms) const;
+
+    QFile file_;
+    const uchar* data_ = nullptr;
+    qint64 size_ = 0;
+    QVector<BlockInfo> blocks_;
+    quint64 record_count_ = 0;
+    qint64 valid_bytes_ = 0;
+    bool truncated_ = false;
+    bool ordered_ = true;        ///< Block time ranges do not overlap or go back
+};
@@ -4,18 +4,82 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDateTime>
+#include <QVector>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "common/spsc_ring_buffer.h"
+#include "columnar_log.h"
 #include "expression_state_machine.h"
+#include "log_retention.h"
+#include "log_time_index.h"
+#include "speed_log_record.h"
 
 /**
- * @brief Logs speed and state data to CSV files
+ * @brief Logs speed and state data to CSV or columnar files
  * 
  * Provides structured logging with automatic file rotation
- * based on file size.
+ * based on file size. The columnar format (see ColumnarLogWriter) stores
+ * the same columns in about an eighth of the space; records are written
+ * a block at a time, so up to one block is still in memory until the
+ * block fills, the file rotates or the logger is destroyed.
+ *
+ * With durable commits each writer batch is a group commit: one write and
+ * one fdatasync, with a checksummed block (columnar) or a '#commit' marker
+ * line (CSV; see LogRecovery for this change to the CSV format).
+ * A batch closes after the flush interval or once CommitPolicy::max_records
+ * are queued, which bounds what a power cut can lose. recoverLogFiles()
+ * truncates torn tails at the next start.
+ *
+ * With a time index each log gets a sidecar (LogTimeIndex) mapping time
+ * buckets to byte ranges and per-bucket speed and state aggregates, which
+ * SpeedLogQuery uses to answer range queries without scanning the logs.
+ *
+ * Files rotate by size and optionally on the hour or day. With a
+ * retention policy, each rotation prunes old files by count, total size
+ * and age on a background thread, using an index built by one directory
+ * scan rather than listing the directory again.
+ *
+ * By default each record is formatted, written and flushed on the caller's
+ * thread. After startWriter() the caller only pushes a SpeedLogRecord into
+ * a lock-free queue. A background thread drains it every flush interval,
+ * formats the batch, and writes, flushes and rotates the file. Records
+ * that do not fit in the queue are dropped and counted.
  */
 class DataLogger : public QObject {
     Q_OBJECT
 
 public:
+    /**
+     * @brief On-disk log format
+     */
+    enum class Format {
+        Csv,        ///< speed_log_*.csv text
+        Columnar    ///< speed_log_*.cslog blocks (ColumnarLogWriter)
+    };
+
+    /**
+     * @brief Time-based rotation, in addition to rotation by size
+     */
+    enum class RotationInterval {
+        None,
+        Hourly,     ///< Start a new file at every full hour (local time)
+        Daily       ///< Start a new file at midnight (local time)
+    };
+
+    /**
+     * @brief Group commit settings for the background writer
+     */
+    struct CommitPolicy {
+        bool durable = false;     ///< fdatasync each commit and checksum it
+        int max_records = 0;      ///< Commit early once this many records are queued, 0 = interval only
+    };
+
+    static constexpr int QUEUE_CAPACITY = 4096;              ///< Writer queue slots (~7 min at 10 Hz)
+    static constexpr int DEFAULT_FLUSH_INTERVAL_MS = 1000;   ///< Writer batch interval
+
     explicit DataLogger(const QString& log_dir = "/var/log/carspeedboy", 
                        QObject* parent = nullptr);
     ~DataLogger();
@@ -38,12 +102,144 @@ public:
      */
     void setMaxFileSize(qint64 size_bytes);
 
+    /**
+     * @brief Rotate on a time boundary as well as by size
+     *
+     * Call before startWriter().
+     */
+    void setRotationInterval(RotationInterval interval);
+
+    /**
+     * @brief Get the time-based rotation interval
+     */
+    RotationInterval rotationInterval() const { return rotation_interval_; }
+
+    /**
+     * @brief Enable retention: scan the log directory and prune it now and on every rotation
+     *
+     * Call before startWriter().
+     * @param policy Limits; the active file counts towards max_files and max_total_bytes
+     */
+    void setRetention(const LogRetention::Policy& policy);
+
+    /**
+     * @brief Closed log files currently indexed for retention
+     */
+    int retainedFiles() const { return retention_ ? retention_->fileCount() : 0; }
+
+    /**
+     * @brief Wait for a pending background prune to finish
+     */
+    void waitForRetention();
+
+    /**
+     * @brief Keep a sidecar time index for each log file
+     *
+     * Call before logging starts; the current file is indexed from its next record.
+     * @param bucket_ms Bucket length, 0 to disable
+     */
+    void setTimeIndex(int bucket_ms);
+
+    /**
+     * @brief Time index bucket length, 0 when disabled
+     */
+    int timeIndexBucketMs() const { return time_index_bucket_ms_; }
+
+    /**
+     * @brief Switch the log format
+     *
+     * Starts a new file in the new format. The previous file is removed if
+     * nothing was logged to it.
+     * @return false while the background writer is running
+     */
+    bool setFormat(Format format);
+
+    /**
+     * @brief Get the log format
+     */
+    Format format() const { return format_; }
+
+    /**
+     * @brief Move logging to another directory
+     *
+     * Starts a new file in the directory, creating it if needed. The previous
+     * file is removed if nothing was logged to it. Call setRetention() again
+     * afterwards to prune the new directory.
+     * @return false while the background writer is running
+     */
+    bool setLogDirectory(const QString& log_dir);
+
+    /**
+     * @brief Get the log directory
+     */
+    QString logDirectory() const { return log_dir_; }
+
     /**
      * @brief Get current log file path
      * @return Log file path
      */
     QString currentLogFile() const { return current_log_file_; }
 
+    /**
+     * @brief Move formatting and file I/O to a background writer thread
+     * @param flush_interval_ms Time between batched writes (> 0)
+     * @return false if already running or the interval is invalid
+     */
+    bool startWriter(int flush_interval_ms = DEFAULT_FLUSH_INTERVAL_MS);
+
+    /**
+     * @brief Write everything still queued and stop the writer thread
+     */
+    void stopWriter();
+
+    /**
+     * @brief Set the group commit policy
+     *
+     * Applies to the background writer; call before startWriter().
+     */
+    void setCommitPolicy(const CommitPolicy& policy);
+
+    /**
+     * @brief Get the group commit policy
+     */
+    CommitPolicy commitPolicy() const { return commit_policy_; }
+
+    /**
+     * @brief Check earlier log files and truncate tails torn by a power loss
+     * @return Number of files truncated
+     */
+    int recoverLogFiles();
+
+    /**
+     * @brief Batches committed by the writer thread
+     */
+    quint64 commits() const { return commits_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Check if the background writer is running
+     */
+    bool isWriterRunning() const { return writer_.joinable(); }
+
+    /**
+     * @brief Records dropped because the writer queue was full
+     */
+    quint64 droppedRecords() const { return dropped_records_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records written to disk by the writer thread
+     */
+    quint64 writtenRecords() const { return written_records_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Records waiting for the writer thread
+     */
+    int queueDepth() const { return static_cast<int>(queue_.size()); }
+
+    /**
+     * @brief Deepest queue the writer has drained since start
+     */
+    int maxQueueDepth() const { return max_queue_depth_.load(std::memory_order_relaxed); }
+
 public slots:
     /**
      * @brief Log speed data
@@ -53,6 +249,13 @@ public slots:
      */
     void logSpeedData(double raw_speed, double smoothed_speed, ExpressionState state);
 
+    /**
+     * @brief Log speed data with an explicit timestamp (replays)
+     * @param wall_ms Row time, ms since epoch
+     */
+    void logSpeedDataAt(double raw_speed, double smoothed_speed, ExpressionState state,
+                        qint64 wall_ms);
+
 signals:
     /**
      * @brief Emitted when log file is rotated
@@ -66,6 +269,12 @@ signals:
      */
     void loggingError(const QString& error_message);
 
+    /**
+     * @brief Emitted from the retention thread after old log files were deleted
+     * @param paths Removed files
+     */
+    void logFilesRemoved(const QStringList& paths);
+
 private:
     /**
      * @brief Open new log file
@@ -73,6 +282,25 @@ private:
      */
     bool openLogFile();
 
+    /**
+     * @brief Start the current file's time index if enabled
+     */
+    void openTimeIndex();
+
+    /**
+     * @brief Index the columnar records that have reached the file
+     *
+     * Columnar records are indexed once their block is written, so the
+     * sidecar never aggregates rows that are still in memory.
+     * @param block_offset File size before the block(s) were written
+     */
+    void indexWrittenRecords(qint64 block_offset);
+
+    /**
+     * @brief Remove a log file and its time index
+     */
+    static void removeLogFile(const QString& path);
+
     /**
      * @brief Close current log file
      */
@@ -83,6 +311,28 @@ private:
      */
     void checkAndRotate();
 
+    /**
+     * @brief Close the current file, open a new one and schedule a prune
+     */
+    void rotateLogFile();
+
+    /**
+     * @brief Prune old files on the retention thread
+     */
+    void schedulePrune();
+
+    /**
+     * @brief First rotation boundary after a time
+     * @return ms since epoch, or 0 without time-based rotation
+     */
+    qint64 nextRotationMs(qint64 now_ms) const;
+
+    /**
+     * @brief Commit the records appended since the last call (writer thread)
+     * @param batch CSV text; cleared afterwards
+     */
+    void writeBatch(QByteArray& batch, quint64 count);
+
     /**
      * @brief Write CSV header to file
      */
@@ -95,12 +345,46 @@ private:
      */
     QString stateToString(ExpressionState state) const;
 
+    /**
+     * @brief Writer thread main loop
+     */
+    void writerLoop();
+
+    /**
+     * @brief Format and write everything queued (writer thread)
+     */
+    void drainQueue();
+
     QString log_dir_;                ///< Directory for log files
     QString current_log_file_;       ///< Current log file path
     QFile* log_file_;                ///< Current log file
     QTextStream* log_stream_;        ///< Text stream for writing
     bool enabled_;                   ///< Logging enabled flag
     qint64 max_file_size_;          ///< Maximum file size before rotation
+    qint64 file_size_;               ///< Bytes in the current file (writer thread)
+    quint64 records_in_file_;        ///< Records logged to the current file
+    Format format_;
+    std::unique_ptr<ColumnarLogWriter> columnar_writer_;   ///< Open in Columnar format
+    RotationInterval rotation_interval_;
+    qint64 next_rotation_ms_;        ///< Time-based rotation boundary, 0 = none
+    int time_index_bucket_ms_;       ///< 0 = no time index
+    std::unique_ptr<LogTimeIndexWriter> time_index_;       ///< Sidecar of the current file
+    QVector<SpeedLogRecord> unindexed_records_;            ///< Columnar records not written yet
+    std::unique_ptr<LogRetention> retention_;
+    std::thread retention_thread_;   ///< Latest background prune
+    
+    SpscRingBuffer<SpeedLogRecord, QUEUE_CAPACITY> queue_;
+    std::thread writer_;
+    std::mutex writer_mutex_;                    ///< Guards writer_stop_ for the wakeup
+    std::condition_variable writer_wakeup_;
+    bool writer_stop_;
+    int flush_interval_ms_;
+    std::atomic<quint64> dropped_records_{0};
+    std::atomic<quint64> written_records_{0};
+    std::atomic<int> max_queue_depth_{0};
+    std::atomic<quint64> commits_{0};
+    CommitPolicy commit_policy_;
+    SpeedLogCsvFormatter csv_formatter_;         ///< Writer thread row formatting
     
     static constexpr qint64 DEFAULT_MAX_SIZE = 10 * 1024 * 1024;  ///< 10MB
 };
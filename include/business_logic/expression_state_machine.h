@@ -2,20 +2,36 @@
 
 #include <QObject>
 #include <QString>
+#include <QVector>
+#include "business_logic/speed_band_table.h"
 
 /**
  * @brief Expression states based on vehicle speed
+ *
+ * The speed ranges come from the band table: each band maps to one of
+ * these, in ascending speed order (see ExpressionStateMachine).
  */
 enum class ExpressionState {
-    RELAXED,    // 0-20 km/h
-    NORMAL,     // 21-60 km/h
-    ALERT,      // 61-100 km/h
-    WARNING,    // 101-120 km/h
-    SCARED      // 121+ km/h
+    RELAXED,    // Slowest band(s)
+    NORMAL,
+    ALERT,
+    WARNING,
+    SCARED      // Fastest band(s)
 };
 
 /**
  * @brief Manages expression state transitions based on speed
+ *
+ * States are bands of a SpeedBandTable (five by default, any number from
+ * config). Each band also maps to one of the five ExpressionState values
+ * used by the character and alert components: by name when it matches
+ * one ("relaxed" ... "scared"), otherwise by its position in the table.
+ *
+ * Band changes go through a BandTracker: directional hysteresis and no
+ * dwell time by default (legacy behaviour). Symmetric hysteresis and a
+ * minimum dwell time can be enabled to stop state-change storms near an
+ * edge, since every change reloads the character animation and adds an
+ * alert history entry.
  */
 class ExpressionStateMachine : public QObject {
     Q_OBJECT
@@ -23,29 +39,96 @@ class ExpressionStateMachine : public QObject {
 public:
     explicit ExpressionStateMachine(QObject* parent = nullptr);
 
+    /**
+     * @brief Use the default five bands with these upper edges
+     */
     void setThresholds(double relaxed, double normal, double alert, double warning);
+
+    /**
+     * @brief Replace the band table
+     * @param bands Bands in ascending speed order (see SpeedBandTable::setBands)
+     * @return true if accepted; the previous bands stay active otherwise
+     */
+    bool setBands(const QVector<SpeedBand>& bands);
+
+    /**
+     * @brief Active band table
+     */
+    const SpeedBandTable& bandTable() const { return band_table_; }
+
+    /**
+     * @brief Select how edge hysteresis is applied (default Directional)
+     */
+    void setHysteresisMode(HysteresisMode mode);
+
+    /**
+     * @brief Time a new band must persist before the state changes
+     * @param dwell_ms Minimum dwell in milliseconds, 0 = change immediately
+     */
+    void setMinDwellMs(int dwell_ms);
+
+    /**
+     * @brief Process a speed sample stamped with the monotonic clock now
+     */
     void updateSpeed(double speed);
+
+    /**
+     * @brief Process a speed sample
+     * @param speed Speed in km/h
+     * @param timestamp_ns Monotonic sample time (for the dwell time)
+     */
+    void updateSpeed(double speed, qint64 timestamp_ns);
+
+    /**
+     * @brief Classify historical samples with the live table and settings
+     *
+     * Runs a fresh tracker; does not change the current state.
+     * @param speeds Samples in time order; the first is compared with 0 km/h
+     * @param timestamps_ns Sample times, or empty for 100 ms spacing
+     * @return Band index per sample
+     */
+    QVector<int> classify(const QVector<double>& speeds,
+                          const QVector<qint64>& timestamps_ns = {}) const;
     
     ExpressionState getCurrentState() const { return current_state_; }
+    int currentBand() const { return current_band_; }
+
+    /**
+     * @brief Name of the current ExpressionState ("relaxed" ... "scared")
+     */
     QString getStateString() const;
 
+    /**
+     * @brief Name of the current band in the band table
+     */
+    QString currentBandName() const { return band_table_.bandName(current_band_); }
+
+    /**
+     * @brief ExpressionState a band maps to
+     */
+    ExpressionState expressionForBand(int band) const;
+
+    /**
+     * @brief Committed and suppressed transition counters
+     */
+    const BandTracker::Statistics& transitionStatistics() const { return tracker_.statistics(); }
+
 signals:
     void stateChanged(ExpressionState oldState, ExpressionState newState);
-    void stateStringChanged(const QString& state);
+    void stateStringChanged(const QString& state);   ///< getStateString() after stateChanged
+    void bandChanged(int oldBand, int newBand);
 
 private:
-    ExpressionState determineState(double speed) const;
-    void setState(ExpressionState new_state);
+    void setBand(int new_band);
 
+    SpeedBandTable band_table_;
+    BandTracker tracker_;
+    QVector<ExpressionState> band_expressions_;   ///< ExpressionState per band
+    int current_band_;
     ExpressionState current_state_;
-    double relaxed_max_;
-    double normal_max_;
-    double alert_max_;
-    double warning_max_;
     
     // Hysteresis to prevent rapid state changes
     double hysteresis_margin_ = 2.0;
-    double last_speed_;
 };
 
 // Declare metatype for use in signals/slots
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief Repairs DataLogger files cut short by a power loss
+ *
+ * With durable commits every CSV commit ends in a marker line
+ *
+ *   #commit,<records>,<crc32 of the rows since the previous marker, hex>
+ *
+ * and every columnar block carries its own checksum. A marker covers the
+ * last <records> rows before it, so a file may mix committed rows with
+ * rows logged without durable commits. Recovery keeps a CSV file up to its
+ * last complete row and drops a commit whose checksum does not match;
+ * columnar files are kept up to their last verified block. Readers never
+ * see a torn line.
+ *
+ * The marker lines change the documented four-column CSV format: parsers
+ * that read durable CSV logs directly must skip lines starting with '#'.
+ */
+class LogRecovery {
+public:
+    static constexpr const char* COMMIT_PREFIX = "#commit,";
+    static constexpr int TAIL_CHECK_BYTES = 4096;   ///< Read to decide whether a file needs a full scan
+
+    struct Result {
+        bool ok = true;                ///< File could be checked (and truncated if needed)
+        qint64 original_bytes = 0;
+        qint64 recovered_bytes = 0;
+
+        bool truncated() const { return recovered_bytes < original_bytes; }
+    };
+
+    /**
+     * @brief Marker line that closes a CSV commit
+     * @param records Rows in the commit
+     * @param rows The commit's rows, newlines included
+     */
+    static QByteArray commitMarker(quint64 records, const QByteArray& rows);
+
+    /**
+     * @brief Length of the intact prefix of a DataLogger CSV file
+     */
+    static qint64 validCsvBytes(const QByteArray& data);
+
+    /**
+     * @brief Check one log file and truncate a torn tail
+     *
+     * .cslog files are checked block by block; anything else as CSV. A CSV
+     * file whose last line is complete is left alone without a full read.
+     */
+    static Result recoverFile(const QString& path);
+};
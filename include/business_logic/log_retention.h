@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+#include <deque>
+#include <mutex>
+
+/**
+ * @brief Retention index for rotated DataLogger files
+ *
+ * Holds the closed log files of one directory, oldest first, with their
+ * sizes and modification times. The directory is scanned once; afterwards
+ * rotations add files to the index, so pruning never lists the directory.
+ * All methods are thread-safe so pruning can run on a background thread.
+ */
+class LogRetention {
+public:
+    /**
+     * @brief Limits; 0 disables a limit
+     */
+    struct Policy {
+        int max_files = 0;             ///< Files kept, the active file included
+        qint64 max_total_bytes = 0;    ///< Bytes kept, the active file included
+        qint64 max_age_ms = 0;         ///< Closed files older than this are removed
+    };
+
+    struct Entry {
+        QString path;
+        qint64 size = 0;
+        qint64 modified_ms = 0;        ///< Last write, ms since epoch
+    };
+
+    /**
+     * @param dir Log directory
+     * @param name_filters File patterns that belong to the logger
+     */
+    LogRetention(const QString& dir, const QStringList& name_filters);
+
+    void setPolicy(const Policy& policy);
+    Policy policy() const;
+
+    /**
+     * @brief Rebuild the index from the directory
+     * @param exclude File to leave out (the active log file)
+     * @return Number of files indexed
+     */
+    int scan(const QString& exclude = QString());
+
+    /**
+     * @brief Add a closed file as the newest entry
+     */
+    void addFile(const QString& path, qint64 size, qint64 modified_ms);
+
+    /**
+     * @brief Files the policy would remove, oldest first
+     * @param now_ms Current time, ms since epoch
+     * @param active_bytes Size of the active file
+     */
+    QStringList selectExpired(qint64 now_ms, qint64 active_bytes) const;
+
+    /**
+     * @brief Delete the files selectExpired() returns and drop them from the index
+     * @return Paths removed
+     */
+    QStringList prune(qint64 now_ms, qint64 active_bytes);
+
+    int fileCount() const;
+    qint64 totalBytes() const;
+    QVector<Entry> entries() const;
+
+private:
+    int expiredCount(qint64 now_ms, qint64 active_bytes) const;   // Caller holds mutex_
+
+    mutable std::mutex mutex_;
+    QString dir_;
+    QStringList name_filters_;
+    Policy policy_;
+    std::deque<Entry> entries_;        ///< Oldest first
+    qint64 total_bytes_ = 0;           ///< Sum of entries_ sizes
+};
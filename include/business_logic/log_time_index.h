@@ -0,0 +1,175 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+#include "columnar_log.h"
+#include "speed_log_record.h"
+
+/**
+ * @brief Aggregate of a run of SpeedLogRecords
+ *
+ * Speeds are kept in centi-km/h like the columnar format, so aggregates
+ * read from an index and aggregates of raw rows compare exactly.
+ */
+struct SpeedAggregate {
+    static constexpr int STATE_SLOTS = 6;   ///< Five ExpressionStates plus one for unknown values
+
+    quint64 count = 0;
+    qint64 first_ms = 0;              ///< Earliest wall time
+    qint64 last_ms = 0;               ///< Latest wall time
+    qint32 min_raw = 0;
+    qint32 max_raw = 0;
+    qint32 min_smoothed = 0;
+    qint32 max_smoothed = 0;
+    qint64 sum_raw = 0;
+    qint64 sum_smoothed = 0;
+    std::array<quint64, STATE_SLOTS> state_counts{};   ///< Records per state
+
+    void add(const SpeedLogRecord& record);
+    void merge(const SpeedAggregate& other);
+
+    bool isEmpty() const { return count == 0; }
+    double minRawKmh() const { return min_raw / ColumnarLog::SPEED_SCALE; }
+    double maxRawKmh() const { return max_raw / ColumnarLog::SPEED_SCALE; }
+    double minSmoothedKmh() const { return min_smoothed / ColumnarLog::SPEED_SCALE; }
+    double maxSmoothedKmh() const { return max_smoothed / ColumnarLog::SPEED_SCALE; }
+    double meanRawKmh() const { return count ? sum_raw / ColumnarLog::SPEED_SCALE / count : 0.0; }
+    double meanSmoothedKmh() const { return count ? sum_smoothed / ColumnarLog::SPEED_SCALE / count : 0.0; }
+};
+
+/**
+ * @brief Sparse time index kept next to a speed log file
+ *
+ * The sidecar (log path + ".idx") holds one entry per time bucket with the
+ * bucket's byte range in the log and a SpeedAggregate, so range queries
+ * seek straight to the rows they need and aggregates over whole buckets
+ * never read the log. All integers are little-endian.
+ *
+ *   header (16 bytes)
+ *     magic "CSTI", u16 version, u16 header size, u32 bucket ms, u32 reserved
+ *   entry (96 bytes), repeated
+ *     i64 first wall ms, i64 last wall ms, i64 offset, i64 end offset,
+ *     u32 count, i32 min raw, i32 max raw, i32 min smoothed, i32 max smoothed
+ *     (centi-km/h), u32 reserved, i64 raw sum, i64 smoothed sum,
+ *     u32 state counts[6]
+ *
+ * For CSV logs offset and end offset delimit the bucket's rows exactly.
+ * For columnar logs they only bound the blocks holding the bucket; readers
+ * use the log's own block index to seek. A bucket is written once it is
+ * complete, so the newest rows of an active log are not indexed yet.
+ */
+class LogTimeIndex {
+public:
+    static constexpr char FILE_MAGIC[4] = {'C', 'S', 'T', 'I'};
+    static constexpr quint16 VERSION = 1;
+    static constexpr int HEADER_SIZE = 16;
+    static constexpr int ENTRY_SIZE = 96;
+    static constexpr int DEFAULT_BUCKET_MS = 10000;   ///< ~100 rows at 10 Hz
+
+    /**
+     * @brief One index entry
+     */
+    struct Bucket {
+        qint64 offset = 0;        ///< First byte of the bucket's rows
+        qint64 end_offset = 0;    ///< Byte after the bucket's last row
+        SpeedAggregate stats;
+    };
+
+    /**
+     * @brief Sidecar path of a log file
+     */
+    static QString indexPath(const QString& log_path) { return log_path + ".idx"; }
+
+    /**
+     * @brief Load a sidecar
+     *
+     * A torn last entry is ignored.
+     * @return false if the file is missing or has no valid header
+     */
+    bool load(const QString& index_path);
+
+    /**
+     * @brief Index an existing log file by reading it once and write its sidecar
+     * @param log_path CSV or columnar log
+     * @param bucket_ms Bucket length
+     * @return false if the log cannot be read or the sidecar cannot be written
+     */
+    bool build(const QString& log_path, int bucket_ms = DEFAULT_BUCKET_MS);
+
+    const QVector<Bucket>& buckets() const { return buckets_; }
+    int bucketMs() const { return bucket_ms_; }
+
+    /**
+     * @brief End of the indexed part of the log (0 without buckets)
+     */
+    qint64 indexedBytes() const;
+
+    /**
+     * @brief Drop buckets that reach past a log file's end (after recovery truncated it)
+     */
+    void clampTo(qint64 log_size);
+
+private:
+    QVector<Bucket> buckets_;
+    int bucket_ms_ = DEFAULT_BUCKET_MS;
+};
+
+/**
+ * @brief Builds a log's time index while the log is written
+ *
+ * Records are added with the byte range they occupy in the log. A bucket
+ * closes when a record falls into another bucket; closed buckets are
+ * written by flush(), which the logger calls after the rows themselves
+ * are written so the index never points past committed data.
+ */
+class LogTimeIndexWriter {
+public:
+    explicit LogTimeIndexWriter(int bucket_ms = LogTimeIndex::DEFAULT_BUCKET_MS);
+    ~LogTimeIndexWriter();
+
+    LogTimeIndexWriter(const LogTimeIndexWriter&) = delete;
+    LogTimeIndexWriter& operator=(const LogTimeIndexWriter&) = delete;
+
+    /**
+     * @brief Create (or replace) a sidecar
+     * @return true if successful
+     */
+    bool open(const QString& index_path);
+
+    /**
+     * @brief Close the open bucket, write it and close the file
+     */
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+    int bucketMs() const { return bucket_ms_; }
+
+    /**
+     * @brief Add one record
+     * @param offset First byte of the record in the log
+     * @param end_offset Byte after the record
+     */
+    void add(const SpeedLogRecord& record, qint64 offset, qint64 end_offset);
+
+    /**
+     * @brief Write the buckets closed since the last flush
+     * @return false if the write failed
+     */
+    bool flush();
+
+    quint64 bucketsWritten() const { return buckets_written_; }
+
+private:
+    bool write(const QVector<LogTimeIndex::Bucket>& buckets);
+
+    QFile file_;
+    int bucket_ms_;
+    qint64 bucket_key_ = 0;                   ///< wall_ms / bucket_ms_ of open_
+    bool has_open_ = false;
+    LogTimeIndex::Bucket open_;               ///< Bucket still receiving records
+    QVector<LogTimeIndex::Bucket> closed_;    ///< Closed, not yet written
+    quint64 buckets_written_ = 0;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "business_logic/speed_filters.h"
+#include "data_acquisition/configuration_manager.h"
+
+class ExpressionStateMachine;
+class SpeedMonitor;
+
+/**
+ * @brief Applies config.json to the speed -> expression pipeline
+ *
+ * ApplicationController and the replay tool both configure their
+ * SpeedMonitor and ExpressionStateMachine through these functions, so a
+ * replay runs with exactly the settings the app would use.
+ */
+class PipelineConfig {
+public:
+    /**
+     * @brief Smoothing filter named by smoothing.filter
+     *
+     * Unknown names fall back to the moving average with a warning.
+     */
+    static SpeedFilter makeSpeedFilter(const ConfigurationManager::SmoothingConfig& config);
+
+    /**
+     * @brief Apply the smoothing section: window, filter, horizon and stall threshold
+     */
+    static void applySmoothing(const ConfigurationManager& config, SpeedMonitor& monitor);
+
+    /**
+     * @brief Apply speed_thresholds, expression_bands and expression_transitions
+     *
+     * Custom expression bands replace the thresholds when they are valid;
+     * either way the band table is replaced once.
+     */
+    static void applyExpression(const ConfigurationManager& config, ExpressionStateMachine& state_machine);
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief One speed band of the expression state machine
+ */
+struct SpeedBand {
+    QString name;                   ///< State name reported to QML, e.g. "relaxed"
+    double max_kmh = 0.0;           ///< Upper edge (inclusive); ignored for the last band
+    double hysteresis_kmh = 0.0;    ///< Upper edge is raised by this while speed falls
+};
+
+/**
+ * @brief How band edge hysteresis is applied
+ */
+enum class HysteresisMode {
+    Directional,   ///< Edges raised while speed is not rising (legacy)
+    Symmetric      ///< Leave the current band only hysteresis beyond either of its edges
+};
+
+/**
+ * @brief Sorted speed bands with branchless classification
+ *
+ * A speed belongs to the first band whose upper edge it does not exceed;
+ * the last band is open-ended. When the speed is not rising (speed <=
+ * previous) each edge is raised by its band's hysteresis, so a falling
+ * speed has to drop clearly below an edge before it changes band.
+ *
+ * Classification counts the edges below the speed: a branchless linear
+ * scan for small tables, binary search for larger ones. The single-sample
+ * and array forms share the same code, so live and offline results agree.
+ */
+class SpeedBandTable {
+public:
+    static constexpr int LINEAR_SCAN_MAX_EDGES = 16;   ///< Switch to binary search above this
+
+    /**
+     * @brief Default table: relaxed/normal/alert/warning/scared at 20/60/100/120 km/h
+     */
+    SpeedBandTable();
+
+    /**
+     * @brief Replace the bands
+     *
+     * Bands must be non-empty, have unique non-empty names, strictly
+     * increasing edges, non-negative hysteresis, and edges that stay
+     * increasing when the hysteresis is applied.
+     * @param bands Bands in ascending speed order
+     * @param error Set to the reason on failure (optional)
+     * @return true if accepted; the table is unchanged otherwise
+     */
+    bool setBands(const QVector<SpeedBand>& bands, QString* error = nullptr);
+
+    /**
+     * @brief Default five-band layout with the given edges and hysteresis
+     */
+    static QVector<SpeedBand> defaultBands(double relaxed_max = 20.0, double normal_max = 60.0,
+                                           double alert_max = 100.0, double warning_max = 120.0,
+                                           double hysteresis_kmh = 2.0);
+
+    const QVector<SpeedBand>& bands() const { return bands_; }
+    int bandCount() const { return bands_.size(); }
+    QString bandName(int band) const;
+
+    /**
+     * @brief Find a band by name
+     * @return Band index, or -1
+     */
+    int indexOf(const QString& name) const;
+
+    /**
+     * @brief Classify one sample
+     * @param speed Speed in km/h
+     * @param previous_speed Preceding sample; selects the hysteresis edges
+     * @return Band index
+     */
+    int classify(double speed, double previous_speed) const {
+        const std::vector<double>& edges = speed > previous_speed ? rising_edges_ : falling_edges_;
+        return countEdgesBelow(edges.data(), edges.size(), speed);
+    }
+
+    /**
+     * @brief Classify one sample with symmetric hysteresis
+     *
+     * Stays in current_band until the speed is more than the edge's
+     * hysteresis above its upper edge or below its lower edge.
+     * @param speed Speed in km/h
+     * @param current_band Band held so far
+     * @return Band index
+     */
+    int classifySymmetric(double speed, int current_band) const;
+
+    /**
+     * @brief Classify a series of samples in order
+     * @param speeds Samples in time order
+     * @param count Number of samples
+     * @param previous_speed Sample preceding speeds[0]
+     * @param bands Output, count band indices
+     */
+    void classify(const double* speeds, std::size_t count, double previous_speed,
+                  int* bands) const;
+
+    /**
+     * @brief Classify a series of samples in order
+     * @param speeds Samples in time order; the first is compared with 0 km/h
+     * @return Band index per sample
+     */
+    QVector<int> classify(const QVector<double>& speeds) const;
+
+private:
+    static int countEdgesBelow(const double* edges, std::size_t count, double speed);
+
+    QVector<SpeedBand> bands_;
+    std::vector<double> rising_edges_;    ///< Upper edges of all but the last band
+    std::vector<double> falling_edges_;   ///< Same, plus hysteresis
+};
+
+/**
+ * @brief Stateful band selection with hysteresis and dwell-time debouncing
+ *
+ * A band change is committed only after the new band has been selected
+ * continuously for the minimum dwell time. Moving further in the same
+ * direction keeps the dwell timer running. Changes that are held back are
+ * counted, so the effect of the settings can be measured. The defaults
+ * (directional hysteresis, no dwell) reproduce SpeedBandTable::classify().
+ */
+class BandTracker {
+public:
+    static constexpr qint64 DEFAULT_SAMPLE_PERIOD_NS = 100000000;   ///< Batch spacing without timestamps
+
+    struct Statistics {
+        quint64 samples = 0;
+        quint64 transitions = 0;              ///< Committed band changes
+        quint64 held_by_hysteresis = 0;       ///< Samples past an edge that hysteresis kept in band
+        quint64 suppressed_by_dwell = 0;      ///< Pending changes dropped before the dwell time
+    };
+
+    explicit BandTracker(HysteresisMode mode = HysteresisMode::Directional,
+                         qint64 min_dwell_ns = 0);
+
+    void setMode(HysteresisMode mode) { mode_ = mode; }
+    HysteresisMode mode() const { return mode_; }
+    void setMinDwellNs(qint64 min_dwell_ns) { min_dwell_ns_ = qMax<qint64>(min_dwell_ns, 0); }
+    qint64 minDwellNs() const { return min_dwell_ns_; }
+
+    /**
+     * @brief Feed one sample
+     * @param table Band table
+     * @param speed Speed in km/h
+     * @param timestamp_ns Monotonic sample time
+     * @return Committed band after this sample
+     */
+    int update(const SpeedBandTable& table, double speed, qint64 timestamp_ns);
+
+    /**
+     * @brief Classify a series of samples with a fresh tracker state
+     * @param table Band table
+     * @param speeds Samples in time order; the first is compared with 0 km/h
+     * @param timestamps_ns Sample times, or empty for DEFAULT_SAMPLE_PERIOD_NS spacing
+     * @return Committed band per sample
+     */
+    QVector<int> classify(const SpeedBandTable& table, const QVector<double>& speeds,
+                          const QVector<qint64>& timestamps_ns = {}) const;
+
+    int band() const { return band_; }
+    const Statistics& statistics() const { return statistics_; }
+
+    /**
+     * @brief Restart in a band, dropping any pending change
+     *
+     * The statistics keep counting across restarts (e.g. a new band table).
+     */
+    void reset(int band = 0);
+
+private:
+    HysteresisMode mode_;
+    qint64 min_dwell_ns_;
+    int band_ = 0;
+    double last_speed_ = 0.0;
+    int pending_band_ = -1;           ///< Band waiting for the dwell time, -1 = none
+    qint64 pending_since_ns_ = 0;
+    Statistics statistics_;
+};
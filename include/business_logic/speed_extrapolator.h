@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include "business_logic/speed_filters.h"
+
+/**
+ * @brief Estimates speed between samples for per-frame rendering
+ *
+ * Speed samples arrive at ~10 Hz while the display renders at 60 Hz. The
+ * extrapolator tracks speed and acceleration with a constant-acceleration
+ * Kalman filter and projects them forward to any render timestamp, so the
+ * display moves every frame and leads the smoothing lag instead of
+ * animating toward an old value.
+ *
+ * Extrapolation error is bounded: the projected change never exceeds
+ * max_acceleration_kmh_s * max_lead_s. Beyond max_lead_s the projection
+ * fades back to the last estimate, and once the data is older than
+ * stale_after_s the last estimate is held unchanged.
+ *
+ * Not thread-safe; feed and sample it from the GUI thread.
+ */
+class SpeedExtrapolator {
+public:
+    struct Settings {
+        double max_lead_s = 0.2;                 ///< Longest projection past the last sample
+        double stale_after_s = 0.5;              ///< Hold the last estimate after this
+        double max_acceleration_kmh_s = 40.0;    ///< Acceleration clamp (~11 m/s^2)
+        double process_noise = 50.0;             ///< See KalmanFilter
+        double measurement_noise = 1.0;          ///< See KalmanFilter
+    };
+
+    static constexpr double MIN_SPEED = 0.0;     ///< km/h
+    static constexpr double MAX_SPEED = 300.0;   ///< km/h
+
+    SpeedExtrapolator();
+    explicit SpeedExtrapolator(const Settings& settings);
+
+    /**
+     * @brief Feed a measured speed
+     * @param speed_kmh Speed in km/h
+     * @param timestamp_ns Monotonic sample time; older than the last sample is ignored
+     */
+    void addSample(double speed_kmh, std::int64_t timestamp_ns);
+
+    /**
+     * @brief Estimated speed at a point in time
+     * @param timestamp_ns Monotonic time, typically the next frame
+     * @return Speed in km/h, 0 before the first sample
+     */
+    double speedAt(std::int64_t timestamp_ns) const;
+
+    /**
+     * @brief Whether the last sample is older than stale_after_s
+     * @param now_ns Monotonic time
+     * @return true if stale or no sample has been received
+     */
+    bool isStale(std::int64_t now_ns) const;
+
+    bool hasData() const { return last_sample_ns_ != 0; }
+    std::int64_t lastSampleNs() const { return last_sample_ns_; }
+
+    /**
+     * @brief Filtered speed at the last sample (km/h)
+     */
+    double estimatedSpeed() const { return filter_.speed(); }
+
+    /**
+     * @brief Clamped acceleration at the last sample (km/h per s)
+     */
+    double estimatedAcceleration() const;
+
+    /**
+     * @brief Largest possible distance between speedAt() and estimatedSpeed()
+     */
+    double maxError() const { return settings_.max_acceleration_kmh_s * settings_.max_lead_s; }
+
+    const Settings& settings() const { return settings_; }
+
+    /**
+     * @brief Replace the settings and start over
+     */
+    void setSettings(const Settings& settings);
+
+    /**
+     * @brief Forget all samples
+     */
+    void reset();
+
+private:
+    Settings settings_;
+    KalmanFilter filter_;
+    std::int64_t last_sample_ns_;
+};
@@ -0,0 +1,358 @@
+#pragma once
+
+#include "common/running_window.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <variant>
+
+/**
+ * @brief Smoothing policies for SpeedMonitor
+ *
+ * Every policy has the same shape so it can be used as a template
+ * parameter or held in SpeedFilter:
+ *   double update(double value, double dt_s);  // returns the filtered value
+ *   void reset();
+ *   static constexpr const char* NAME;
+ *   static constexpr bool USES_WINDOW;         // honours setWindowSize()
+ * dt_s is the time since the previous sample in seconds. None of them
+ * allocate after construction. Window-based policies also implement
+ * setWindowSize() and setHorizon().
+ */
+
+/**
+ * @brief Sample times for window-based policies
+ *
+ * Integrates dt into a local clock so samples older than the horizon can
+ * be expired without absolute timestamps.
+ */
+template <std::size_t Capacity>
+class SampleClock {
+public:
+    /**
+     * @brief Advance by dt and record the new sample's time
+     */
+    void push(double dt_s) {
+        now_s_ += std::max(dt_s, 0.0);
+        times_.push(now_s_);
+    }
+
+    /**
+     * @brief Whether the oldest sample is beyond the horizon (never the newest)
+     */
+    bool oldestExpired(double horizon_s) const {
+        return horizon_s > 0.0 && times_.size() > 1 && now_s_ - times_.oldest() > horizon_s;
+    }
+
+    void popOldest() { times_.popOldest(); }
+    void setWindowSize(std::size_t window_size) { times_.setWindowSize(window_size); }
+
+    void clear() {
+        times_.clear();
+        now_s_ = 0.0;
+    }
+
+private:
+    RunningWindow<Capacity> times_;
+    double now_s_ = 0.0;
+};
+
+/**
+ * @brief Time-weighted moving average over the last N samples
+ *
+ * Each sample is weighted by the time since the previous one, capped at
+ * max_sample_weight_s, so a burst of frames delivered within a few
+ * milliseconds after a stall counts for a few milliseconds of driving
+ * rather than N full sample periods. With regular spacing this is the
+ * plain moving average (lag ~ N/2 samples). Samples older than the horizon
+ * are dropped.
+ */
+class MovingAverageFilter {
+public:
+    static constexpr const char* NAME = "moving_average";
+    static constexpr bool USES_WINDOW = true;
+    static constexpr std::size_t MAX_WINDOW_SIZE = 20;
+    static constexpr double MIN_SAMPLE_WEIGHT_S = 1e-6;
+
+    explicit MovingAverageFilter(std::size_t window_size = 5, double max_sample_weight_s = 0.1)
+        : max_sample_weight_s_(max_sample_weight_s) {
+        setWindowSize(window_size);
+    }
+
+    double update(double value, double dt_s) {
+        const double weight = std::clamp(dt_s, MIN_SAMPLE_WEIGHT_S,
+                                         std::max(max_sample_weight_s_, MIN_SAMPLE_WEIGHT_S));
+        weighted_.push(value * weight);
+        weights_.push(weight);
+        clock_.push(dt_s);
+
+        while (clock_.oldestExpired(horizon_s_)) {
+            weighted_.popOldest();
+            weights_.popOldest();
+            clock_.popOldest();
+        }
+        return weighted_.sum() / weights_.sum();
+    }
+
+    void reset() {
+        weighted_.clear();
+        weights_.clear();
+        clock_.clear();
+    }
+
+    void setWindowSize(std::size_t window_size) {
+        weighted_.setWindowSize(window_size);
+        weights_.setWindowSize(window_size);
+        clock_.setWindowSize(window_size);
+    }
+
+    /**
+     * @brief Drop samples older than this (0 = keep the whole window)
+     */
+    void setHorizon(double horizon_s) { horizon_s_ = horizon_s; }
+
+    std::size_t size() const { return weights_.size(); }
+
+private:
+    RunningWindow<MAX_WINDOW_SIZE> weighted_;   ///< value * weight, running sum
+    RunningWindow<MAX_WINDOW_SIZE> weights_;    ///< weight, running sum
+    SampleClock<MAX_WINDOW_SIZE> clock_;
+    double max_sample_weight_s_;
+    double horizon_s_ = 0.0;
+};
+
+/**
+ * @brief Exponential moving average with a time constant
+ *
+ * The blend factor is derived from dt, so irregular sample spacing is
+ * weighted correctly.
+ */
+class EmaFilter {
+public:
+    static constexpr const char* NAME = "ema";
+    static constexpr bool USES_WINDOW = false;
+
+    explicit EmaFilter(double time_constant_s = 0.3) : time_constant_s_(time_constant_s) {}
+
+    double update(double value, double dt_s) {
+        if (!initialized_) {
+            estimate_ = value;
+            initialized_ = true;
+            return estimate_;
+        }
+        const double alpha = time_constant_s_ > 0.0
+            ? 1.0 - std::exp(-std::max(dt_s, 0.0) / time_constant_s_)
+            : 1.0;
+        estimate_ += alpha * (value - estimate_);
+        return estimate_;
+    }
+
+    void reset() { initialized_ = false; }
+
+private:
+    double time_constant_s_;
+    double estimate_ = 0.0;
+    bool initialized_ = false;
+};
+
+/**
+ * @brief Running median over the last N samples (rejects isolated spikes)
+ *
+ * Count-based; samples older than the horizon are dropped.
+ */
+class MedianFilter {
+public:
+    static constexpr const char* NAME = "median";
+    static constexpr bool USES_WINDOW = true;
+    static constexpr std::size_t MAX_WINDOW_SIZE = 20;
+
+    explicit MedianFilter(std::size_t window_size = 5) { setWindowSize(window_size); }
+
+    double update(double value, double dt_s) {
+        if (window_.full()) {
+            removeOldest();
+        }
+        window_.push(value);
+        clock_.push(dt_s);
+
+        // Insert into the sorted copy (N <= 20, a shift beats a heap here)
+        const std::size_t count = window_.size();
+        auto* end = sorted_.data() + count - 1;
+        auto* it = std::upper_bound(sorted_.data(), end, value);
+        std::copy_backward(it, end, end + 1);
+        *it = value;
+
+        while (clock_.oldestExpired(horizon_s_)) {
+            removeOldest();
+        }
+
+        const std::size_t kept = window_.size();
+        return kept % 2 == 1 ? sorted_[kept / 2]
+                             : 0.5 * (sorted_[kept / 2 - 1] + sorted_[kept / 2]);
+    }
+
+    void reset() {
+        window_.clear();
+        clock_.clear();
+    }
+
+    void setHorizon(double horizon_s) { horizon_s_ = horizon_s; }
+
+    void setWindowSize(std::size_t window_size) {
+        window_.setWindowSize(window_size);
+        clock_.setWindowSize(window_size);
+        // Rebuild the sorted copy from the samples that were kept
+        for (std::size_t i = 0; i < window_.size(); ++i) {
+            sorted_[i] = window_.at(i);
+        }
+        std::sort(sorted_.data(), sorted_.data() + window_.size());
+    }
+
+private:
+    // Drop the oldest sample from both the window and the sorted copy
+    void removeOldest() {
+        const double evicted = window_.oldest();
+        auto* end = sorted_.data() + window_.size();
+        auto* it = std::lower_bound(sorted_.data(), end, evicted);
+        std::copy(it + 1, end, it);
+        window_.popOldest();
+        clock_.popOldest();
+    }
+
+    RunningWindow<MAX_WINDOW_SIZE> window_;          ///< Samples in arrival order
+    std::array<double, MAX_WINDOW_SIZE> sorted_{};   ///< Same samples, sorted
+    SampleClock<MAX_WINDOW_SIZE> clock_;
+    double horizon_s_ = 0.0;
+};
+
+/**
+ * @brief One-euro filter (Casiez et al., CHI 2012)
+ *
+ * Low-pass whose cutoff rises with the rate of change: heavy smoothing
+ * while cruising, little lag while accelerating or braking.
+ */
+class OneEuroFilter {
+public:
+    static constexpr const char* NAME = "one_euro";
+    static constexpr bool USES_WINDOW = false;
+
+    explicit OneEuroFilter(double min_cutoff_hz = 1.0, double beta = 0.05,
+                           double derivative_cutoff_hz = 1.0)
+        : min_cutoff_hz_(min_cutoff_hz)
+        , beta_(beta)
+        , derivative_cutoff_hz_(derivative_cutoff_hz) {}
+
+    double update(double value, double dt_s) {
+        if (!initialized_) {
+            estimate_ = value;
+            derivative_ = 0.0;
+            initialized_ = true;
+            return estimate_;
+        }
+        dt_s = std::max(dt_s, MIN_DT_S);
+
+        const double raw_derivative = (value - estimate_) / dt_s;
+        derivative_ += smoothing(derivative_cutoff_hz_, dt_s) * (raw_derivative - derivative_);
+
+        const double cutoff_hz = min_cutoff_hz_ + beta_ * std::fabs(derivative_);
+        estimate_ += smoothing(cutoff_hz, dt_s) * (value - estimate_);
+        return estimate_;
+    }
+
+    void reset() { initialized_ = false; }
+
+private:
+    static constexpr double MIN_DT_S = 1e-4;
+
+    static double smoothing(double cutoff_hz, double dt_s) {
+        const double tau = 1.0 / (2.0 * M_PI * cutoff_hz);
+        return 1.0 / (1.0 + tau / dt_s);
+    }
+
+    double min_cutoff_hz_;
+    double beta_;
+    double derivative_cutoff_hz_;
+    double estimate_ = 0.0;
+    double derivative_ = 0.0;     ///< Smoothed rate of change (km/h per s)
+    bool initialized_ = false;
+};
+
+/**
+ * @brief 1-D constant-acceleration Kalman filter
+ *
+ * State is [speed, acceleration], driven by white jerk noise. Tracks ramps
+ * without the steady-state lag of averaging filters.
+ */
+class KalmanFilter {
+public:
+    static constexpr const char* NAME = "kalman";
+    static constexpr bool USES_WINDOW = false;
+
+    /**
+     * @param process_noise Jerk spectral density ((km/h)^2 / s^5)
+     * @param measurement_noise Measurement variance ((km/h)^2)
+     */
+    explicit KalmanFilter(double process_noise = 50.0, double measurement_noise = 1.0)
+        : q_(process_noise)
+        , r_(measurement_noise) {}
+
+    double update(double value, double dt_s) {
+        if (!initialized_) {
+            speed_ = value;
+            acceleration_ = 0.0;
+            p00_ = r_;
+            p01_ = 0.0;
+            p11_ = INITIAL_ACCELERATION_VARIANCE;
+            initialized_ = true;
+            return speed_;
+        }
+        const double dt = std::max(dt_s, 0.0);
+
+        // Predict: x = F x, P = F P F' + Q
+        speed_ += acceleration_ * dt;
+        const double dt2 = dt * dt;
+        const double p00 = p00_ + 2.0 * dt * p01_ + dt2 * p11_ + q_ * dt2 * dt / 3.0;
+        const double p01 = p01_ + dt * p11_ + q_ * dt2 / 2.0;
+        const double p11 = p11_ + q_ * dt;
+
+        // Update with the speed measurement (H = [1 0])
+        const double innovation = value - speed_;
+        const double s = p00 + r_;
+        const double k0 = p00 / s;
+        const double k1 = p01 / s;
+        speed_ += k0 * innovation;
+        acceleration_ += k1 * innovation;
+
+        p00_ = (1.0 - k0) * p00;
+        p01_ = (1.0 - k0) * p01;
+        p11_ = p11 - k1 * p01;
+        return speed_;
+    }
+
+    void reset() { initialized_ = false; }
+
+    double speed() const { return speed_; }
+    double acceleration() const { return acceleration_; }   ///< km/h per s
+
+private:
+    static constexpr double INITIAL_ACCELERATION_VARIANCE = 100.0;
+
+    double q_;
+    double r_;
+    double speed_ = 0.0;
+    double acceleration_ = 0.0;
+    double p00_ = 0.0;   ///< Covariance (symmetric 2x2)
+    double p01_ = 0.0;
+    double p11_ = 0.0;
+    bool initialized_ = false;
+};
+
+/**
+ * @brief Any of the policies above, chosen at run time (e.g. from config)
+ *
+ * Dispatch goes through std::visit; storage is inline, so switching
+ * policies does not allocate.
+ */
+using SpeedFilter = std::variant<MovingAverageFilter, EmaFilter, MedianFilter,
+                                 OneEuroFilter, KalmanFilter>;
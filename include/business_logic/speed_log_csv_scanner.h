@@ -0,0 +1,116 @@
+#pragma once
+
+#include "speed_log_record.h"
+#include <QDateTime>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief Block parser for whole DataLogger CSV logs
+ *
+ * Finds every ',' and '\n' of a 64 KiB window 64 bytes at a time (AVX2
+ * when the CPU has it, eight bytes at a time otherwise) and walks the
+ * resulting position list row by row. Fields are parsed in place:
+ * timestamps as fixed-layout ISO text with the local-time offset cached
+ * per minute, decimals through the exact power-of-ten path and state
+ * names through SpeedLogCsvParser's perfect hash. Rows the fast paths do
+ * not take (exponents, zone suffixes, stray whitespace) go to
+ * SpeedLogCsvParser, so every row parses exactly as it would there.
+ */
+class SpeedLogCsvScanner {
+public:
+    static constexpr int WINDOW_BYTES = 64 * 1024;
+
+    struct Stats {
+        quint64 records = 0;
+        quint64 ignored = 0;       ///< Header, '#' commit markers and blank rows
+        quint64 malformed = 0;
+        quint64 slow_rows = 0;     ///< Records that needed SpeedLogCsvParser
+    };
+
+    /**
+     * @brief Whether this build and CPU can use the AVX2 delimiter search
+     */
+    static bool hasAvx2();
+
+    /**
+     * @param use_simd Use AVX2 where available (false forces the scalar path)
+     */
+    explicit SpeedLogCsvScanner(bool use_simd = true);
+
+    bool usesAvx2() const { return use_avx2_; }
+
+    /**
+     * @brief Parse every complete row of data
+     *
+     * A last row without newline is left alone, so a growing file or a
+     * chunked read can continue from the returned offset.
+     *
+     * @param visit Called as visit(record, row_offset, next_row_offset)
+     * @return Bytes consumed (up to and including the last newline)
+     */
+    template <typename Visitor>
+    qint64 scan(const char* data, qint64 length, Visitor&& visit) {
+        SpeedLogRecord record;
+        qint64 base = 0;
+        while (base < length) {
+            const int window = static_cast<int>(qMin<qint64>(WINDOW_BYTES, length - base));
+            const char* text = data + base;
+            const int found = findDelimiters(text, window);
+
+            int row = 0;
+            int commas[3];
+            int comma_count = 0;
+            for (int i = 0; i < found; ++i) {
+                const int pos = static_cast<int>(positions_[i]);
+                if (text[pos] == ',') {
+                    if (comma_count < 3) {
+                        commas[comma_count] = pos - row;
+                    }
+                    ++comma_count;
+                    continue;
+                }
+                if (parseRow(text + row, pos - row, commas, comma_count, &record)) {
+                    visit(record, base + row, base + pos + 1);
+                }
+                row = pos + 1;
+                comma_count = 0;
+            }
+
+            if (row == 0) {
+                if (window < WINDOW_BYTES) {
+                    break;   // Incomplete last row
+                }
+                // A row longer than a window is garbage; resume after it
+                const void* newline = std::memchr(text + window, '\n',
+                                                  static_cast<std::size_t>(length - base - window));
+                if (!newline) {
+                    break;
+                }
+                ++stats_.malformed;
+                base = static_cast<const char*>(newline) - data + 1;
+                continue;
+            }
+            base += row;
+        }
+        return base;
+    }
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    // Positions of ',' and '\n' in text[0, length) into positions_; returns the count
+    int findDelimiters(const char* text, int length);
+
+    // One row without its newline; commas are row-relative
+    bool parseRow(const char* line, int length, const int* commas, int comma_count,
+                  SpeedLogRecord* record);
+    bool parseTimestamp(const char* text, int length, qint64* wall_ms);
+
+    bool use_avx2_;
+    std::vector<quint32> positions_;
+    Stats stats_;
+    char cached_minute_[16] = {};    ///< "YYYY-MM-DDTHH:MM" of cached_minute_ms_
+    qint64 cached_minute_ms_ = 0;
+    bool minute_cached_ = false;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QtGlobal>
+#include "log_time_index.h"
+#include "speed_log_csv_scanner.h"
+#include "speed_log_record.h"
+
+/**
+ * @brief Time range queries over the speed logs of one directory
+ *
+ * Uses each log's sidecar time index (LogTimeIndex). Buckets entirely
+ * inside the range are answered from the index; only buckets cut by the
+ * range ends and rows not indexed yet (the active file's open bucket) are
+ * read from the log, by seeking to their byte range. Logs without a
+ * sidecar are indexed once on first use.
+ *
+ * CSV timestamps have one-second resolution unless the logger writes
+ * milliseconds, so rows read from CSV logs are matched by that time.
+ */
+class SpeedLogQuery {
+public:
+    /**
+     * @brief Work done by the last query
+     */
+    struct Stats {
+        int files = 0;                 ///< Logs overlapping the range
+        int index_buckets = 0;         ///< Buckets answered from the index
+        quint64 rows_read = 0;         ///< Records read from the logs
+        int indexes_built = 0;         ///< Missing sidecars created
+    };
+
+    /**
+     * @param log_dir DataLogger log directory
+     */
+    explicit SpeedLogQuery(const QString& log_dir);
+
+    /**
+     * @brief Build missing sidecars (default) or read unindexed logs in full
+     */
+    void setBuildMissingIndexes(bool build) { build_missing_ = build; }
+
+    /**
+     * @brief Log files in the directory, oldest first
+     */
+    QStringList logFiles() const;
+
+    /**
+     * @brief Aggregate of the records with from_ms <= wall_ms < to_ms
+     *
+     * Max/min/mean speeds and time in each state (as record counts);
+     * a range on bucket boundaries reads no log rows.
+     */
+    SpeedAggregate aggregate(qint64 from_ms, qint64 to_ms);
+
+    /**
+     * @brief Records with from_ms <= wall_ms < to_ms, in file order
+     */
+    QVector<SpeedLogRecord> records(qint64 from_ms, qint64 to_ms);
+
+    const Stats& lastStats() const { return stats_; }
+
+private:
+    /**
+     * @brief Load or build a log's index; false leaves the log unindexed
+     */
+    bool loadIndex(const QString& log_path, qint64 log_size, LogTimeIndex* index);
+
+    /**
+     * @brief Query one log
+     *
+     * Whole buckets are merged into aggregate when it is set; rows are read
+     * for everything else. Rows in the range go to aggregate or records.
+     */
+    void queryFile(const QString& log_path, qint64 from_ms, qint64 to_ms,
+                   SpeedAggregate* aggregate, QVector<SpeedLogRecord>* records);
+
+    /**
+     * @brief Read a columnar log's rows for the buckets cut by the range and its unindexed tail
+     */
+    void queryColumnar(const QString& log_path, const LogTimeIndex& index, bool has_tail,
+                       qint64 from_ms, qint64 to_ms, SpeedAggregate* aggregate,
+                       QVector<SpeedLogRecord>* records);
+
+    /**
+     * @brief Read the CSV rows in [offset, end_offset) that fall in the range
+     */
+    void readCsvRange(QFile& file, qint64 offset, qint64 end_offset, qint64 from_ms, qint64 to_ms,
+                      SpeedAggregate* aggregate, QVector<SpeedLogRecord>* records);
+
+    QString log_dir_;
+    bool build_missing_ = true;
+    Stats stats_;
+    SpeedLogCsvScanner csv_scanner_;    ///< Reused so its position buffer is allocated once
+};
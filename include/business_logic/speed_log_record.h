@@ -0,0 +1,162 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+#include <QtGlobal>
+#include <cstring>
+
+/**
+ * @brief One speed log entry (fixed size)
+ *
+ * Queued by DataLogger's writer, stored by the columnar log format and
+ * formatted as one CSV row.
+ */
+struct SpeedLogRecord {
+    qint64 wall_ms = 0;            ///< Wall-clock time, ms since epoch
+    double raw_speed = 0.0;
+    double smoothed_speed = 0.0;
+    quint8 state = 0;              ///< ExpressionState
+};
+
+/**
+ * @brief Formats SpeedLogRecords as DataLogger CSV rows
+ *
+ * Schema: timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state.
+ * The ISO timestamp is cached per second (per millisecond with
+ * millisecond timestamps), so 10 Hz data formats the date once per second.
+ */
+class SpeedLogCsvFormatter {
+public:
+    static constexpr const char* HEADER =
+        "timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state\n";
+
+    /**
+     * @param with_milliseconds Write ISO timestamps with milliseconds
+     */
+    explicit SpeedLogCsvFormatter(bool with_milliseconds = false)
+        : with_milliseconds_(with_milliseconds)
+    {
+    }
+
+    /**
+     * @brief ExpressionState name as written to the log
+     */
+    static const char* stateName(quint8 state) {
+        switch (state) {
+            case 0: return "RELAXED";
+            case 1: return "NORMAL";
+            case 2: return "ALERT";
+            case 3: return "WARNING";
+            case 4: return "SCARED";
+            default: return "UNKNOWN";
+        }
+    }
+
+    /**
+     * @brief Append one row including the newline
+     */
+    void appendRow(QByteArray& out, const SpeedLogRecord& record) {
+        const qint64 key = with_milliseconds_ ? record.wall_ms : record.wall_ms / 1000;
+        if (key != cached_key_) {
+            cached_key_ = key;
+            cached_timestamp_ = with_milliseconds_
+                ? QDateTime::fromMSecsSinceEpoch(key).toString(Qt::ISODateWithMs).toUtf8()
+                : QDateTime::fromMSecsSinceEpoch(key * 1000).toString(Qt::ISODate).toUtf8();
+        }
+        out += cached_timestamp_;
+        out += ',';
+        out += QByteArray::number(record.raw_speed, 'g', 6);
+        out += ',';
+        out += QByteArray::number(record.smoothed_speed, 'g', 6);
+        out += ',';
+        out += stateName(record.state);
+        out += '\n';
+    }
+
+private:
+    bool with_milliseconds_;
+    qint64 cached_key_ = -1;         ///< Second (or ms) of cached_timestamp_
+    QByteArray cached_timestamp_;
+};
+
+/**
+ * @brief Parses DataLogger CSV rows back into SpeedLogRecords
+ *
+ * Accepts rows written by SpeedLogCsvFormatter and by DataLogger's
+ * synchronous path, with or without milliseconds. Timestamps without
+ * milliseconds give wall_ms on a whole second.
+ */
+class SpeedLogCsvParser {
+public:
+    /**
+     * @brief ExpressionState value of a state name
+     *
+     * The low three bits of the first letter are distinct for the five
+     * names (R=2, N=6, A=1, W=7, S=3), so one table lookup and one compare
+     * decide.
+     *
+     * @return State, or -1 for an unknown name
+     */
+    static int stateFromName(const char* name, int length) {
+        static constexpr qint8 STATE_BY_HASH[8] = {-1, 2, 0, 4, -1, -1, 1, 3};
+        if (length <= 0) {
+            return -1;
+        }
+        const int state = STATE_BY_HASH[static_cast<unsigned char>(name[0]) & 7];
+        if (state < 0) {
+            return -1;
+        }
+        const char* known = SpeedLogCsvFormatter::stateName(static_cast<quint8>(state));
+        if (static_cast<int>(std::strlen(known)) != length || std::memcmp(known, name, length) != 0) {
+            return -1;
+        }
+        return state;
+    }
+
+    /**
+     * @brief Parse one row
+     * @param line Row text without the newline (a trailing '\r' is ignored)
+     * @param length Row length
+     * @param record Set on success
+     * @return false for the header, comments ('#') and malformed rows
+     */
+    static bool parseRow(const char* line, int length, SpeedLogRecord* record) {
+        if (length > 0 && line[length - 1] == '\r') {
+            --length;
+        }
+        if (length == 0 || line[0] == '#') {
+            return false;
+        }
+
+        const char* fields[4];
+        int lengths[4];
+        int field = 0;
+        int start = 0;
+        for (int i = 0; i <= length && field < 4; ++i) {
+            if (i == length || line[i] == ',') {
+                fields[field] = line + start;
+                lengths[field] = i - start;
+                ++field;
+                start = i + 1;
+            }
+        }
+        if (field != 4 || start <= length) {
+            return false;
+        }
+
+        const QDateTime time = QDateTime::fromString(QString::fromLatin1(fields[0], lengths[0]),
+                                                     Qt::ISODateWithMs);
+        const int state = stateFromName(fields[3], lengths[3]);
+        bool raw_ok = false;
+        bool smoothed_ok = false;
+        record->raw_speed = QByteArray::fromRawData(fields[1], lengths[1]).toDouble(&raw_ok);
+        record->smoothed_speed = QByteArray::fromRawData(fields[2], lengths[2]).toDouble(&smoothed_ok);
+        if (!time.isValid() || state < 0 || !raw_ok || !smoothed_ok) {
+            return false;
+        }
+        record->wall_ms = time.toMSecsSinceEpoch();
+        record->state = static_cast<quint8>(state);
+        return true;
+    }
+};
@@ -1,23 +1,49 @@
 #pragma once
 
 #include <QObject>
-#include <QQueue>
+#include <QString>
+#include <QVariantMap>
+#include "business_logic/speed_filters.h"
 
 /**
  * @brief Monitors and processes vehicle speed data with noise filtering
  * 
- * Applies moving average filter to smooth out noisy speed readings
- * and detects abnormal values.
+ * Smooths noisy speed readings with a selectable filter policy (moving
+ * average by default, see speed_filters.h) and detects abnormal values.
+ * Timestamped samples are smoothed by their actual spacing, and the
+ * spacing itself is tracked so transport stalls and bursts can be told
+ * apart from real changes in speed.
  */
 class SpeedMonitor : public QObject {
     Q_OBJECT
 
 public:
+    static constexpr int MIN_WINDOW_SIZE = 1;    ///< Smallest moving average window
+    static constexpr int MAX_WINDOW_SIZE =
+        static_cast<int>(MovingAverageFilter::MAX_WINDOW_SIZE);   ///< Largest moving average window
+    static constexpr double NOMINAL_SAMPLE_PERIOD_S = 0.1;       ///< dt assumed per sample (10 Hz)
+    static constexpr int DEFAULT_HORIZON_MS = 2000;              ///< Oldest sample kept in a window
+    static constexpr int DEFAULT_STALL_THRESHOLD_MS = 500;       ///< Gap counted as a transport stall
+    static constexpr double BURST_GAP_MS = 2.0;                  ///< Gap counted as part of a burst
+
+    /**
+     * @brief Inter-sample gaps seen by onSpeedSample()
+     */
+    struct GapStatistics {
+        quint64 intervals = 0;       ///< Gaps measured (samples - 1)
+        double last_gap_ms = 0.0;
+        double mean_gap_ms = 0.0;
+        double max_gap_ms = 0.0;
+        quint64 stalls = 0;          ///< Gaps above the stall threshold
+        quint64 burst_samples = 0;   ///< Samples arriving within BURST_GAP_MS of the previous one
+        quint64 out_of_order = 0;    ///< Samples timestamped before their predecessor
+    };
+
     explicit SpeedMonitor(int window_size = 5, QObject* parent = nullptr);
     ~SpeedMonitor();
 
     /**
-     * @brief Set the moving average window size
+     * @brief Set the window size for window-based filters
      * @param size Number of samples to average (1-20)
      */
     void setWindowSize(int size);
@@ -39,13 +65,70 @@ public:
      */
     void reset();
 
+    /**
+     * @brief Replace the smoothing policy
+     *
+     * Window-based policies are resized to windowSize(). Filter state starts
+     * fresh.
+     * @param filter Policy instance with its parameters
+     */
+    void setFilter(const SpeedFilter& filter);
+
+    /**
+     * @brief Name of the active smoothing policy (e.g. "moving_average")
+     */
+    QString filterName() const;
+
+    /**
+     * @brief Set how old a sample may get before window-based filters drop it
+     * @param horizon_ms Age limit in milliseconds, 0 to keep the whole window
+     */
+    void setHorizonMs(int horizon_ms);
+
+    /**
+     * @brief Get the sample age limit
+     * @return Horizon in milliseconds (0 = disabled)
+     */
+    int horizonMs() const { return horizon_ms_; }
+
+    /**
+     * @brief Set the gap above which a stall is counted and reported
+     * @param threshold_ms Threshold in milliseconds (> 0)
+     */
+    void setStallThresholdMs(int threshold_ms);
+
+    /**
+     * @brief Get inter-sample gap statistics since the last reset
+     */
+    GapStatistics gapStatistics() const { return gap_stats_; }
+
+    /**
+     * @brief Gap statistics as a map (intervals, last_gap_ms, mean_gap_ms,
+     *        max_gap_ms, stalls, burst_samples, out_of_order)
+     */
+    QVariantMap gapSummary() const;
+
 public slots:
     /**
      * @brief Process new raw speed reading
+     *
+     * Assumes NOMINAL_SAMPLE_PERIOD_S since the previous sample.
      * @param raw_speed Speed in km/h
      */
     void onRawSpeedUpdate(double raw_speed);
 
+    /**
+     * @brief Process a timestamped raw speed reading
+     *
+     * The filter is advanced by the time since the previous timestamped
+     * sample, and the gap is added to gapStatistics(). The first sample
+     * after a reset assumes NOMINAL_SAMPLE_PERIOD_S; out-of-order samples
+     * count as simultaneous.
+     * @param raw_speed Speed in km/h
+     * @param timestamp_ns Monotonic sample time in nanoseconds
+     */
+    void onSpeedSample(double raw_speed, qint64 timestamp_ns);
+
 signals:
     /**
      * @brief Emitted when smoothed speed is calculated
@@ -59,6 +142,12 @@ signals:
      */
     void abnormalSpeedDetected(double raw_speed);
 
+    /**
+     * @brief Emitted when the gap before a sample exceeds the stall threshold
+     * @param gap_ms Time since the previous sample in milliseconds
+     */
+    void transportStallDetected(double gap_ms);
+
 private:
     /**
      * @brief Validate if speed is within acceptable range
@@ -68,14 +157,31 @@ private:
     bool isValidSpeed(double speed) const;
 
     /**
-     * @brief Calculate moving average from current samples
-     * @return Average speed
+     * @brief Validate, filter and publish one sample
+     * @param raw_speed Speed in km/h
+     * @param dt_s Time since the previous sample in seconds
+     */
+    void process(double raw_speed, double dt_s);
+
+    /**
+     * @brief Add one inter-sample gap to the statistics
+     * @param gap_ms Gap in milliseconds
+     */
+    void recordGap(double gap_ms);
+
+    /**
+     * @brief Push the horizon into window-based filters
      */
-    double calculateAverage() const;
+    void applyHorizon();
 
     int window_size_;                    ///< Moving average window size
-    QQueue<double> speed_samples_;       ///< Ring buffer of speed samples
+    SpeedFilter filter_;                 ///< Active smoothing policy
     double smoothed_speed_;              ///< Last calculated smoothed speed
+    int horizon_ms_;                     ///< Sample age limit, 0 = disabled
+    int stall_threshold_ms_;             ///< Gap reported as a stall
+    qint64 last_sample_ns_;              ///< Previous timestamped sample, 0 = none
+    qint64 last_filtered_ns_;            ///< Previous sample that reached the filter, 0 = none
+    GapStatistics gap_stats_;
     
     static constexpr double MIN_SPEED = 0.0;     ///< Minimum valid speed (km/h)
     static constexpr double MAX_SPEED = 300.0;   ///< Maximum valid speed (km/h)
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include <array>
+#include "log_time_index.h"
+#include "speed_log_record.h"
+
+/**
+ * @brief One rollup interval: speed aggregate plus time spent in each state
+ */
+struct RollupBucket {
+    qint64 start_ms = 0;                                      ///< Interval start, ms since epoch
+    SpeedAggregate speed;
+    std::array<qint64, SpeedAggregate::STATE_SLOTS> state_ms{};   ///< Dwell time per ExpressionState
+
+    bool isEmpty() const { return speed.isEmpty(); }
+};
+
+/**
+ * @brief Incremental 1 s / 1 min / 1 h rollups of the speed stream
+ *
+ * Every tier keeps its open bucket and a fixed ring of closed buckets;
+ * add() touches one bucket per tier, so a sample costs O(1) whatever the
+ * history length. Dwell time between two samples is credited to the state
+ * of the earlier one and split at bucket boundaries; a bucket the gap
+ * spans without a sample is kept with its dwell time and no speed data.
+ * Gaps longer than the maximum gap (stalls, app restarts) are not counted.
+ *
+ * Each tier is persisted to its own file in the rollup directory. Closed
+ * buckets are appended when a minute closes and on flush(), open buckets
+ * on close(); a file is rewritten with just the ring once it holds twice
+ * the ring's capacity.
+ * All integers are little-endian.
+ *
+ *   header (16 bytes)
+ *     magic "CSRU", u16 version, u16 header size, u32 tier ms, u32 reserved
+ *   entry (128 bytes), repeated
+ *     i64 start ms, i64 first wall ms, i64 last wall ms, u32 count,
+ *     i32 min raw, i32 max raw, i32 min smoothed, i32 max smoothed
+ *     (centi-km/h), u32 reserved, i64 raw sum, i64 smoothed sum,
+ *     u32 state ms[6], u32 state counts[6], u64 reserved[2]
+ *
+ * Not thread-safe; feed and query it from one thread.
+ */
+class SpeedRollup {
+public:
+    enum class Tier {
+        Second,
+        Minute,
+        Hour
+    };
+
+    static constexpr int TIER_COUNT = 3;
+    static constexpr char FILE_MAGIC[4] = {'C', 'S', 'R', 'U'};
+    static constexpr quint16 VERSION = 1;
+    static constexpr int HEADER_SIZE = 16;
+    static constexpr int ENTRY_SIZE = 128;
+    static constexpr qint64 DEFAULT_MAX_GAP_MS = 2000;
+
+    /**
+     * @brief Bucket length of a tier
+     */
+    static qint64 tierMs(Tier tier);
+
+    /**
+     * @brief Closed buckets kept in memory: 1 h of seconds, 1 day of minutes, 30 days of hours
+     */
+    static int tierCapacity(Tier tier);
+
+    /**
+     * @brief Short tier name ("1s", "1m", "1h")
+     */
+    static const char* tierName(Tier tier);
+
+    /**
+     * @brief Tier for a name; false if unknown
+     */
+    static bool tierFromName(const QString& name, Tier* tier);
+
+    /**
+     * @brief Rollup file of a tier
+     */
+    static QString tierPath(const QString& dir, Tier tier);
+
+    SpeedRollup();
+    ~SpeedRollup();
+
+    SpeedRollup(const SpeedRollup&) = delete;
+    SpeedRollup& operator=(const SpeedRollup&) = delete;
+
+    /**
+     * @brief Load the tiers persisted in dir and append to their files from now on
+     *
+     * Missing or invalid files start empty. Without open() the rollups
+     * live in memory only.
+     * @return false if a tier file cannot be opened for writing
+     */
+    bool open(const QString& dir);
+
+    /**
+     * @brief Write pending and open buckets and close the files
+     *
+     * A sample that falls into a saved open bucket after open() continues
+     * it instead of starting a second bucket for the same interval.
+     */
+    void close();
+
+    bool isOpen() const { return !dir_.isEmpty(); }
+
+    /**
+     * @brief Directory given to open(), empty when closed
+     */
+    const QString& directory() const { return dir_; }
+
+    /**
+     * @brief Longest sample gap still counted as dwell time
+     */
+    void setMaxGapMs(qint64 max_gap_ms) { max_gap_ms_ = qMax<qint64>(0, max_gap_ms); }
+    qint64 maxGapMs() const { return max_gap_ms_; }
+
+    /**
+     * @brief Add one sample to all tiers
+     */
+    void add(const SpeedLogRecord& record);
+
+    /**
+     * @brief Append the buckets closed since the last write to the tier files
+     * @return false if a write failed
+     */
+    bool flush();
+
+    /**
+     * @brief Buckets starting in [from_ms, to_ms), oldest first
+     *
+     * Includes the open bucket, so the newest entry may still change.
+     */
+    QVector<RollupBucket> buckets(Tier tier, qint64 from_ms, qint64 to_ms) const;
+
+    /**
+     * @brief The newest buckets, oldest first, open bucket included
+     * @param count Maximum number of buckets
+     */
+    QVector<RollupBucket> recent(Tier tier, int count) const;
+
+    /**
+     * @brief Bucket still receiving samples, nullptr before the first sample
+     */
+    const RollupBucket* current(Tier tier) const;
+
+    /**
+     * @brief Number of closed buckets held for a tier
+     */
+    int closedCount(Tier tier) const;
+
+private:
+    struct TierState {
+        qint64 bucket_ms = 0;
+        QVector<RollupBucket> ring;        ///< Closed buckets, capacity slots
+        int head = 0;                      ///< Oldest closed bucket
+        int count = 0;
+        bool has_open = false;
+        RollupBucket open;
+        QVector<RollupBucket> pending;     ///< Closed, not yet written
+        QFile file;
+        int rows_in_file = 0;
+
+        const RollupBucket& at(int index) const { return ring[(head + index) % ring.size()]; }
+        void push(const RollupBucket& bucket);
+    };
+
+    void addToTier(TierState& tier, const SpeedLogRecord& record);
+    bool loadTier(TierState& tier, const QString& path);
+    bool writePending(TierState& tier);
+    bool compact(TierState& tier);
+
+    std::array<TierState, TIER_COUNT> tiers_;
+    QString dir_;
+    qint64 max_gap_ms_ = DEFAULT_MAX_GAP_MS;
+    bool has_last_ = false;
+    qint64 last_ms_ = 0;                   ///< Time of the previous sample
+    int last_state_ = 0;                   ///< Its state slot
+};
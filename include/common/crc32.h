@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief CRC-32 (IEEE 802.3 polynomial, same values as zlib's crc32())
+ *
+ * Table-driven, one byte per step. Used to detect torn or partially
+ * written log blocks after a power loss, not for security.
+ */
+class Crc32 {
+    // Defined before update() so its table can be built at compile time
+    static constexpr std::array<std::uint32_t, 256> makeTable() {
+        std::array<std::uint32_t, 256> table{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t value = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? 0xedb88320u ^ (value >> 1) : value >> 1;
+            }
+            table[i] = value;
+        }
+        return table;
+    }
+
+public:
+    /**
+     * @brief Checksum of one buffer
+     */
+    static std::uint32_t compute(const void* data, std::size_t size) {
+        return update(0, data, size);
+    }
+
+    /**
+     * @brief Continue a checksum with more data
+     * @param crc Value returned for the preceding data (0 to start)
+     */
+    static std::uint32_t update(std::uint32_t crc, const void* data, std::size_t size) {
+        static constexpr std::array<std::uint32_t, 256> TABLE = makeTable();
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        crc = ~crc;
+        for (std::size_t i = 0; i < size; ++i) {
+            crc = TABLE[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+};
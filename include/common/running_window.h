@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+/**
+ * @brief Fixed-capacity sliding window with an O(1) running sum
+ *
+ * Samples live in a contiguous ring; push() evicts the oldest sample once
+ * the window is full and updates a Kahan-compensated sum, so mean() costs
+ * O(1) and nothing is allocated after construction. The sum is also
+ * recomputed exactly every RESUM_INTERVAL pushes to bound long-run drift.
+ *
+ * @tparam Capacity Largest supported window size
+ */
+template <std::size_t Capacity>
+class RunningWindow {
+    static_assert(Capacity >= 1, "Capacity must be at least 1");
+
+public:
+    static constexpr std::size_t RESUM_INTERVAL = 4096;
+
+    explicit RunningWindow(std::size_t window_size = Capacity) {
+        setWindowSize(window_size);
+    }
+
+    /**
+     * @brief Change the window size, dropping the oldest samples if needed
+     * @param window_size Clamped to [1, Capacity]
+     */
+    void setWindowSize(std::size_t window_size) {
+        window_size_ = window_size < 1 ? 1 : (window_size > Capacity ? Capacity : window_size);
+        if (count_ <= window_size_) {
+            return;
+        }
+
+        // Drop the oldest samples
+        head_ = wrap(head_ + count_ - window_size_);
+        count_ = window_size_;
+        resum();
+    }
+
+    std::size_t windowSize() const { return window_size_; }
+    static constexpr std::size_t capacity() { return Capacity; }
+
+    /**
+     * @brief Add a sample, evicting the oldest once the window is full
+     */
+    void push(double value) {
+        if (count_ == window_size_) {
+            add(-samples_[head_]);
+            head_ = wrap(head_ + 1);
+        } else {
+            ++count_;
+        }
+        samples_[wrap(head_ + count_ - 1)] = value;
+        add(value);
+
+        if (++pushes_since_resum_ >= RESUM_INTERVAL) {
+            resum();
+        }
+    }
+
+    /**
+     * @brief Remove the oldest sample (no-op when empty)
+     */
+    void popOldest() {
+        if (count_ == 0) {
+            return;
+        }
+        add(-samples_[head_]);
+        head_ = wrap(head_ + 1);
+        if (--count_ == 0) {
+            clear();
+        }
+    }
+
+    /**
+     * @brief Remove all samples
+     */
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+        sum_ = 0.0;
+        compensation_ = 0.0;
+        pushes_since_resum_ = 0;
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    bool full() const { return count_ == window_size_; }
+
+    /**
+     * @brief Sample by age
+     * @param index 0 = oldest, size() - 1 = newest
+     */
+    double at(std::size_t index) const { return samples_[wrap(head_ + index)]; }
+
+    double oldest() const { return at(0); }
+    double newest() const { return at(count_ - 1); }
+
+    double sum() const { return sum_ + compensation_; }
+    double mean() const { return count_ == 0 ? 0.0 : sum() / static_cast<double>(count_); }
+
+private:
+    // Indices never exceed 2 * Capacity, so one conditional subtract wraps them
+    static std::size_t wrap(std::size_t index) {
+        return index >= Capacity ? index - Capacity : index;
+    }
+
+    // Kahan-Babuska (Neumaier) summation: also exact when |value| > |sum|
+    void add(double value) {
+        const double total = sum_ + value;
+        if ((sum_ >= 0 ? sum_ : -sum_) >= (value >= 0 ? value : -value)) {
+            compensation_ += (sum_ - total) + value;
+        } else {
+            compensation_ += (value - total) + sum_;
+        }
+        sum_ = total;
+    }
+
+    void resum() {
+        sum_ = 0.0;
+        compensation_ = 0.0;
+        for (std::size_t i = 0; i < count_; ++i) {
+            add(at(i));
+        }
+        pushes_since_resum_ = 0;
+    }
+
+    std::array<double, Capacity> samples_{};
+    std::size_t window_size_ = Capacity;   ///< Active window (<= Capacity)
+    std::size_t head_ = 0;                 ///< Slot of the oldest sample
+    std::size_t count_ = 0;                ///< Samples currently held
+    double sum_ = 0.0;                     ///< Running sum
+    double compensation_ = 0.0;            ///< Accumulated rounding error
+    std::size_t pushes_since_resum_ = 0;
+};
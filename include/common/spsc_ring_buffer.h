@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Bounded single-producer/single-consumer ring buffer
+ *
+ * Lock-free and allocation-free after construction. Exactly one thread may
+ * call tryPush() and exactly one (other) thread may call tryPop(); size()
+ * may be called from either side and is approximate while both are active.
+ *
+ * @tparam T Element type (copied in and out, should be trivially copyable)
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, std::size_t Capacity>
+class SpscRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity must be a power of two");
+
+public:
+    SpscRingBuffer() = default;
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /**
+     * @brief Append an element (producer side)
+     * @param value Element to copy in
+     * @return false if the buffer is full
+     */
+    bool tryPush(const T& value) {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ == Capacity) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ == Capacity) {
+                return false;
+            }
+        }
+        buffer_[head & MASK] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer side)
+     * @param value Receives the element
+     * @return false if the buffer is empty
+     */
+    bool tryPop(T& value) {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cached_head_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail == cached_head_) {
+                return false;
+            }
+        }
+        value = buffer_[tail & MASK];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of queued elements
+     */
+    std::size_t size() const {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1;
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(CACHE_LINE) std::atomic<std::size_t> head_{0};  ///< Next slot to write
+    std::size_t cached_tail_ = 0;                           ///< Producer's view of tail_
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail_{0};  ///< Next slot to read
+    std::size_t cached_head_ = 0;                           ///< Consumer's view of head_
+    alignas(CACHE_LINE) std::array<T, Capacity> buffer_{};
+};
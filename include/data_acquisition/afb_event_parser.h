@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Decoded AFB event envelope
+ *
+ * Fixed-size storage so that decoding never touches the heap. Names and
+ * units are copied as ASCII into inline buffers.
+ */
+struct AfbEvent {
+    static constexpr int MAX_NAME_LENGTH = 128;  ///< Longest accepted event name
+    static constexpr int MAX_UNIT_LENGTH = 16;   ///< Longest accepted unit string
+
+    char name[MAX_NAME_LENGTH] = {};   ///< Event name, e.g. "vss/Vehicle.Speed"
+    int name_length = 0;               ///< Length of name (without terminator)
+    std::uint32_t name_hash = 0;       ///< FNV-1a hash of name
+
+    double value = 0.0;                ///< data.value (or data itself if scalar)
+    bool has_value = false;            ///< true if a numeric/boolean value was found
+    bool value_is_bool = false;        ///< true if value came from a boolean (1.0 / 0.0)
+
+    char unit[MAX_UNIT_LENGTH] = {};   ///< data.unit
+    int unit_length = 0;               ///< Length of unit (without terminator)
+    bool has_unit = false;             ///< true if data.unit was present
+
+    std::int64_t timestamp_ms = 0;     ///< data.timestamp (source time, ms)
+    bool has_timestamp = false;        ///< true if data.timestamp was present
+
+    /**
+     * @brief Compare the event name against an ASCII string
+     * @param other Null-terminated string
+     * @return true if equal
+     */
+    bool nameEquals(const char* other) const;
+
+    /**
+     * @brief Compare the unit against an ASCII string
+     * @param other Null-terminated string
+     * @return true if equal
+     */
+    bool unitEquals(const char* other) const;
+};
+
+/**
+ * @brief Single-pass, allocation-free decoder for AFB event frames
+ *
+ * Understands exactly the envelope the VSS binding pushes:
+ * {"jtype":"afb-event","event":"vss/<path>","data":{"value":..,"unit":..,"timestamp":..}}
+ * Anything it cannot decode with certainty (escaped names, numbers outside
+ * the exactly-representable range, non-numeric values, malformed or
+ * truncated input) is reported as Unsupported so the caller can fall back
+ * to QJsonDocument.
+ */
+class AfbEventParser {
+public:
+    enum class Result {
+        Event,        ///< Frame is an event and was decoded into AfbEvent
+        NotEvent,     ///< Frame is a well-formed object without "event" (e.g. a reply)
+        Unsupported   ///< Frame could not be decoded; use the generic JSON path
+    };
+
+    /**
+     * @brief Decode a frame
+     * @param data Frame contents (UTF-8 as char, or UTF-16 as char16_t)
+     * @param length Number of code units
+     * @param event Output; only meaningful when Result::Event is returned
+     * @return Decode result
+     */
+    template <typename CharT>
+    static Result parse(const CharT* data, std::size_t length, AfbEvent& event);
+
+    /**
+     * @brief Decode a CBOR-encoded frame (binary WebSocket message)
+     *
+     * Expects the same envelope as the JSON form, encoded as a CBOR map with
+     * definite lengths. Text strings are read in place.
+     * @param data Frame bytes
+     * @param length Number of bytes
+     * @param event Output; only meaningful when Result::Event is returned
+     * @return Decode result
+     */
+    static Result parseCbor(const std::uint8_t* data, std::size_t length, AfbEvent& event);
+
+    /**
+     * @brief FNV-1a hash used for event names
+     * @param name ASCII name
+     * @param length Length of name
+     * @return 32-bit hash
+     */
+    static std::uint32_t hashName(const char* name, std::size_t length);
+
+    /**
+     * @brief Convert a floating-point timestamp to milliseconds
+     * @param value Timestamp as decoded from the frame
+     * @param timestamp_ms Receives the truncated value
+     * @return false if value is not finite or outside the int64 range
+     */
+    static bool timestampFromDouble(double value, std::int64_t& timestamp_ms);
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QByteArray>
+#include <cstdint>
+
+/**
+ * @brief Location and scaling of one signal inside a CAN frame (DBC semantics)
+ */
+struct CanSignalDefinition {
+    quint32 can_id = 0;          ///< Arbitration ID
+    bool extended = false;       ///< 29-bit identifier
+    int start_bit = 0;           ///< DBC start bit (LSB for Intel, MSB for Motorola)
+    int length = 16;             ///< Signal length in bits (1-64)
+    bool big_endian = false;     ///< Motorola byte order
+    bool is_signed = false;      ///< Two's complement raw value
+    double factor = 0.01;        ///< Physical = raw * factor + offset (must yield km/h)
+    double offset = 0.0;
+
+    /**
+     * @brief Check that the layout fits a classic 8-byte CAN frame
+     */
+    bool isValid() const;
+};
+
+/**
+ * @brief One classic CAN frame
+ */
+struct CanFrame {
+    static constexpr int MAX_DATA_LENGTH = 8;
+
+    quint32 can_id = 0;
+    bool extended = false;
+    std::uint8_t data[MAX_DATA_LENGTH] = {};
+    int length = 0;                  ///< DLC in bytes
+    std::int64_t timestamp_us = 0;   ///< Capture time (candump logs), 0 if unknown
+};
+
+/**
+ * @brief Decodes raw CAN frames into physical signal values
+ *
+ * Used by the direct CAN data sources; the default AFB path never sees
+ * raw frames.
+ */
+class CanSignalDecoder {
+public:
+    /**
+     * @brief Extract and scale a signal
+     * @param signal Signal definition
+     * @param frame Frame (ID is not checked here)
+     * @param value Output physical value
+     * @return false if the signal does not fit the frame's DLC
+     */
+    static bool decode(const CanSignalDefinition& signal, const CanFrame& frame, double& value);
+
+    /**
+     * @brief Check whether a frame carries a signal
+     */
+    static bool matches(const CanSignalDefinition& signal, const CanFrame& frame) {
+        return frame.can_id == signal.can_id && frame.extended == signal.extended;
+    }
+
+    /**
+     * @brief Parse one line of a candump log (candump -l / -L format)
+     *
+     * Example: "(1436509052.249713) vcan0 123#DEADBEEF". Remote frames and
+     * CAN FD frames are rejected.
+     * @param line Log line
+     * @param frame Output frame
+     * @return true if a data frame was parsed
+     */
+    static bool parseCandumpLine(const QByteArray& line, CanFrame& frame);
+};
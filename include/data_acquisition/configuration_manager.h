@@ -3,11 +3,23 @@
 #include <QObject>
 #include <QString>
 #include <QJsonObject>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <memory>
+#include "data_acquisition/can_signal.h"
+
+class QFileSystemWatcher;
 
 /**
  * @brief Manages application configuration
  * 
  * Loads and saves CarSpeedBoy specific settings (not vehicle protocol settings)
+ *
+ * With config_reload.watch set, the loaded file is watched and re-read
+ * when it changes. Each section is compared with the configuration in
+ * use and only the signals of changed sections are emitted, so only the
+ * affected component reconfigures.
  */
 class ConfigurationManager : public QObject {
     Q_OBJECT
@@ -20,12 +32,35 @@ public:
         double warning_max = 120.0;
     };
 
+    /**
+     * @brief One expression band; the list replaces speed_thresholds when set
+     */
+    struct ExpressionBandConfig {
+        QString name;
+        double max_kmh = 0.0;            ///< Inclusive upper edge, unused for the last band
+        double hysteresis_kmh = 2.0;     ///< Edge raised by this while speed falls
+    };
+
+    /**
+     * @brief Expression state debouncing
+     *
+     * hysteresis_mode is "directional" (legacy: edges raised while speed
+     * falls) or "symmetric" (leave a band only hysteresis beyond its edges).
+     */
+    struct ExpressionTransitionConfig {
+        QString hysteresis_mode = "directional";
+        int min_dwell_ms = 0;            ///< New state must persist this long, 0 = immediate
+    };
+
     struct DisplaySettings {
         QString units = "km/h";
         QString theme = "dark";
         QString language = "en";
         bool show_speed_number = true;
         bool fullscreen = false;
+        bool extrapolate_speed = true;          ///< Project speed to each rendered frame
+        int extrapolation_max_lead_ms = 200;    ///< Longest projection past the last sample
+        int extrapolation_stale_ms = 500;       ///< Hold the last value after this
     };
 
     struct CharacterSettings {
@@ -39,6 +74,44 @@ public:
         QString token = "";
         int reconnect_interval_ms = 1000;
         int max_retries = 5;
+        bool binary_frames = false;   ///< Negotiate CBOR event frames
+        bool io_thread = false;       ///< Run socket and decoding on a dedicated thread
+    };
+
+    struct VssConfig {
+        QStringList signal_paths = {"Vehicle.Speed"};
+        int update_rate_hz = 10;
+    };
+
+    /**
+     * @brief SpeedMonitor filter policy and its parameters
+     *
+     * filter is one of "moving_average", "ema", "median", "one_euro", "kalman".
+     */
+    struct SmoothingConfig {
+        QString filter = "moving_average";
+        int window_size = 5;                    ///< moving_average / median
+        int horizon_ms = 2000;                  ///< Drop window samples older than this, 0 = off
+        int stall_threshold_ms = 500;           ///< Sample gap reported as a transport stall
+        int ema_time_constant_ms = 300;
+        double one_euro_min_cutoff_hz = 1.0;
+        double one_euro_beta = 0.05;
+        double kalman_process_noise = 50.0;     ///< Jerk spectral density
+        double kalman_measurement_noise = 1.0;  ///< (km/h)^2
+    };
+
+    /**
+     * @brief Where speed samples come from
+     *
+     * "afb" (default) uses the AFB WebSocket. "socketcan" and "candump" read
+     * CAN frames directly and need a build with ENABLE_CAN_BACKEND.
+     */
+    struct DataSourceConfig {
+        QString type = "afb";
+        QString can_interface = "vcan0";
+        QString candump_file;
+        double replay_speed = 1.0;          ///< candump time scale, 0 = as fast as possible
+        CanSignalDefinition speed_signal;   ///< Frame layout and scaling to km/h
     };
 
     struct LoggingConfig {
@@ -46,17 +119,54 @@ public:
         QString level = "info";
         QString log_dir = "/var/log/carspeedboy";
         int max_file_size_mb = 10;
-        int max_files = 5;
+        int max_files = 5;              ///< Files kept in log_dir, 0 = unlimited
+        int max_total_size_mb = 0;      ///< Total size kept in log_dir, 0 = unlimited
+        int max_age_days = 0;           ///< Delete closed files older than this, 0 = never
+        QString rotation_interval = "none";   ///< "none", "hourly" or "daily" (plus size)
+        bool async_writer = true;       ///< Format and write on a background thread
+        int flush_interval_ms = 1000;   ///< Background writer batch interval
+        bool durable_commits = false;   ///< fdatasync + checksum each batch; CSV gains '#commit' lines
+        int commit_max_records = 0;     ///< Commit early at this many queued records, 0 = off
+        QString format = "csv";         ///< "csv" or "columnar" (.cslog)
+        int time_index_bucket_s = 0;    ///< Sidecar time index bucket length, 0 = no index
+        bool rollups = true;            ///< Keep 1 s / 1 min / 1 h speed rollups in log_dir
+    };
+
+    struct ReloadConfig {
+        bool watch = false;             ///< Reload the config file when it changes on disk
+        int debounce_ms = 300;          ///< Quiet time before reloading (editors write in steps)
     };
 
     explicit ConfigurationManager(QObject* parent = nullptr);
+    ~ConfigurationManager() override;
 
     bool loadFromFile(const QString& config_path);
     bool saveToFile(const QString& config_path);
 
+    /**
+     * @brief Re-read the loaded file and apply what changed
+     *
+     * The file is parsed over the defaults, as on a fresh start, and
+     * compared with the current configuration section by section. A file
+     * that cannot be read or parsed leaves the configuration unchanged.
+     * @return false if the file could not be read or parsed
+     */
+    bool reload();
+
+    /**
+     * @brief Whether the loaded file is being watched for changes
+     */
+    bool isWatching() const { return watcher_ != nullptr; }
+
     SpeedThresholds getSpeedThresholds() const { return speed_thresholds_; }
     void setSpeedThresholds(const SpeedThresholds& thresholds);
 
+    QVector<ExpressionBandConfig> getExpressionBands() const { return expression_bands_; }
+    void setExpressionBands(const QVector<ExpressionBandConfig>& bands);
+
+    ExpressionTransitionConfig getExpressionTransitionConfig() const { return expression_transitions_; }
+    void setExpressionTransitionConfig(const ExpressionTransitionConfig& config);
+
     DisplaySettings getDisplaySettings() const { return display_settings_; }
     void setDisplaySettings(const DisplaySettings& settings);
 
@@ -69,20 +179,74 @@ public:
     LoggingConfig getLoggingConfig() const { return logging_config_; }
     void setLoggingConfig(const LoggingConfig& config);
 
+    VssConfig getVssConfig() const { return vss_config_; }
+    void setVssConfig(const VssConfig& config);
+
+    SmoothingConfig getSmoothingConfig() const { return smoothing_config_; }
+    void setSmoothingConfig(const SmoothingConfig& config);
+
+    DataSourceConfig getDataSourceConfig() const { return data_source_config_; }
+    void setDataSourceConfig(const DataSourceConfig& config);
+
+    ReloadConfig getReloadConfig() const { return reload_config_; }
+    void setReloadConfig(const ReloadConfig& config);
+
     void resetToDefaults();
 
 signals:
+    /**
+     * @brief Something changed; emitted after the section signals below
+     */
     void configurationChanged();
 
+    void expressionConfigChanged();   ///< speed_thresholds, expression_bands or expression_transitions
+    void smoothingConfigChanged();
+    void displaySettingsChanged();
+    void characterSettingsChanged();
+    void afbConfigChanged();
+    void vssConfigChanged();
+    void dataSourceConfigChanged();
+    void loggingConfigChanged();
+
+private slots:
+    void onWatchedPathChanged();
+    void onReloadTimeout();
+
 private:
     void loadDefaults();
     void parseJSON(const QJsonObject& config);
     QJsonObject toJSON() const;
 
+    /**
+     * @brief Read and parse config_path
+     * @return false (with a warning) if it is missing or not a JSON object
+     */
+    static bool readConfigFile(const QString& config_path, QByteArray* data, QJsonObject* config);
+
+    /**
+     * @brief Emit the signals of the sections that differ between two toJSON() snapshots
+     * @return Names of the changed sections
+     */
+    QStringList emitChangedSections(const QJsonObject& before, const QJsonObject& after);
+
+    /**
+     * @brief Start, update or stop watching the loaded file per reload_config_
+     */
+    void updateWatch();
+
     SpeedThresholds speed_thresholds_;
+    QVector<ExpressionBandConfig> expression_bands_;   ///< Empty = use speed_thresholds_
+    ExpressionTransitionConfig expression_transitions_;
     DisplaySettings display_settings_;
     CharacterSettings character_settings_;
     AFBConnectionConfig afb_config_;
     LoggingConfig logging_config_;
+    VssConfig vss_config_;
+    SmoothingConfig smoothing_config_;
+    DataSourceConfig data_source_config_;
+    ReloadConfig reload_config_;
     QString config_file_path_;
+    QByteArray loaded_data_;                        ///< File contents last applied
+    std::unique_ptr<QFileSystemWatcher> watcher_;   ///< Set while watching
+    QTimer reload_timer_;                           ///< Debounces file change events
 };
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+#include <functional>
+#include "common/spsc_ring_buffer.h"
+#include "data_acquisition/vehicle_sample.h"
+
+/**
+ * @brief Hands decoded samples from the acquisition thread to the GUI thread
+ *
+ * The producer (VehicleDataManager on its I/O thread) pushes into a bounded
+ * SPSC ring buffer. At most one queued wake-up is outstanding at any time,
+ * so a burst of samples costs one event-loop round trip instead of one
+ * queued signal copy per sample. When the consumer falls behind, new
+ * samples are dropped and counted rather than blocking acquisition.
+ */
+class SampleChannel : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr std::size_t CAPACITY = 1024;
+
+    explicit SampleChannel(QObject* parent = nullptr);
+
+    /**
+     * @brief Queue a sample (producer thread only)
+     * @param sample Sample to queue
+     * @return false if the queue was full and the sample was dropped
+     */
+    bool push(const VehicleSample& sample);
+
+    /**
+     * @brief Drain all queued samples (consumer thread only)
+     * @param handler Called once per sample, oldest first
+     * @return Number of samples handled
+     */
+    int consume(const std::function<void(const VehicleSample&)>& handler);
+
+    /**
+     * @brief Current number of queued samples
+     */
+    int depth() const { return static_cast<int>(queue_.size()); }
+
+    /**
+     * @brief Highest depth observed by the consumer
+     */
+    int highWaterMark() const { return high_water_mark_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Total samples accepted
+     */
+    quint64 pushedCount() const { return pushed_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Total samples dropped because the queue was full
+     */
+    quint64 droppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+signals:
+    /**
+     * @brief Emitted when samples become available after the queue was drained
+     */
+    void samplesAvailable();
+
+private:
+    SpscRingBuffer<VehicleSample, CAPACITY> queue_;
+    std::atomic<bool> wakeup_pending_{false};
+    std::atomic<int> high_water_mark_{0};
+    std::atomic<quint64> pushed_{0};
+    std::atomic<quint64> dropped_{0};
+};
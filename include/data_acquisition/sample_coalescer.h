@@ -0,0 +1,91 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include "data_acquisition/vehicle_sample.h"
+
+/**
+ * @brief Limits downstream delivery to the configured VSS update rate
+ *
+ * Keeps only the latest sample per signal between ticks. The first sample
+ * after an idle period is delivered immediately (no added latency); later
+ * samples within the same interval overwrite each other and are delivered
+ * together at the end of the interval. The timer stops when nothing is
+ * pending, so an idle bus costs no wake-ups.
+ */
+class SampleCoalescer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SampleCoalescer(int update_rate_hz = 10, QObject* parent = nullptr);
+
+    /**
+     * @brief Set the maximum delivery rate
+     * @param hz Deliveries per second per signal; 0 disables coalescing
+     */
+    void setUpdateRate(int hz);
+
+    /**
+     * @brief Get the maximum delivery rate
+     * @return Rate in Hz (0 = pass-through)
+     */
+    int updateRate() const { return update_rate_hz_; }
+
+    /**
+     * @brief Total samples submitted
+     */
+    quint64 submittedCount() const { return submitted_count_; }
+
+    /**
+     * @brief Total samples delivered downstream
+     */
+    quint64 deliveredCount() const { return delivered_count_; }
+
+    /**
+     * @brief Samples overwritten by a newer value before delivery
+     */
+    quint64 coalescedCount() const { return coalesced_count_; }
+
+    /**
+     * @brief Number of signals waiting for the next tick
+     */
+    int pendingCount() const { return pending_ids_.size(); }
+
+public slots:
+    /**
+     * @brief Submit a new sample
+     * @param sample Decoded sample
+     */
+    void submit(const VehicleSample& sample);
+
+    /**
+     * @brief Deliver everything pending immediately
+     */
+    void flush();
+
+signals:
+    /**
+     * @brief Emitted for each delivered sample
+     * @param sample Latest sample of a signal
+     */
+    void sampleReady(const VehicleSample& sample);
+
+private slots:
+    void onTick();
+
+private:
+    void deliver(const VehicleSample& sample);
+
+    int update_rate_hz_;
+    int interval_ms_;
+    QTimer tick_timer_;                  ///< Runs only while samples keep arriving
+
+    QVector<VehicleSample> latest_;      ///< Signal ID -> latest sample
+    QVector<bool> pending_;              ///< Signal ID -> waiting for delivery
+    QVector<int> pending_ids_;           ///< Pending IDs in arrival order
+
+    quint64 submitted_count_ = 0;
+    quint64 delivered_count_ = 0;
+    quint64 coalesced_count_ = 0;
+};
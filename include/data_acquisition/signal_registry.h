@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <cstdint>
+
+struct AfbEvent;
+
+/**
+ * @brief Latest value received for one VSS signal
+ */
+struct SignalSlot {
+    enum class Type {
+        Number,
+        Boolean
+    };
+
+    Type type = Type::Number;       ///< Kind of the last value
+    double value = 0.0;             ///< Last value (booleans as 0/1)
+    std::int64_t timestamp_ms = 0;  ///< Source timestamp if provided, else 0
+    quint64 update_count = 0;       ///< Number of updates received
+    bool valid = false;             ///< true once a value has been received
+};
+
+/**
+ * @brief Interns VSS signal paths to dense integer IDs
+ *
+ * Paths are registered once at subscribe time. Incoming events are then
+ * resolved with a single hash probe (the event name hash is computed by
+ * AfbEventParser while scanning) and a length/byte compare, instead of
+ * string comparisons per handler.
+ */
+class SignalRegistry {
+public:
+    static constexpr int INVALID_ID = -1;
+
+    SignalRegistry();
+
+    /**
+     * @brief Register a signal path
+     * @param path VSS path, e.g. "Vehicle.Speed"
+     * @return Signal ID (existing ID if already registered)
+     */
+    int intern(const QString& path);
+
+    /**
+     * @brief Resolve a decoded event to its signal ID
+     * @param event Decoded event (name is "vss/<path>")
+     * @return Signal ID, or INVALID_ID if not registered
+     */
+    int find(const AfbEvent& event) const;
+
+    /**
+     * @brief Resolve a signal path to its ID
+     * @param path VSS path
+     * @return Signal ID, or INVALID_ID if not registered
+     */
+    int findPath(const QString& path) const;
+
+    /**
+     * @brief Get the VSS path for an ID
+     */
+    QString path(int id) const { return paths_.value(id); }
+
+    /**
+     * @brief Number of registered signals
+     */
+    int size() const { return paths_.size(); }
+
+    /**
+     * @brief Latest-value slot for a signal
+     */
+    SignalSlot& slot(int id) { return slots_[id]; }
+    const SignalSlot& slot(int id) const { return slots_[id]; }
+
+    /**
+     * @brief Remove all signals
+     */
+    void clear();
+
+    static constexpr const char* EVENT_PREFIX = "vss/";
+
+private:
+    struct Bucket {
+        std::uint32_t hash = 0;
+        int id = INVALID_ID;
+    };
+
+    int lookup(const char* name, int length, std::uint32_t hash) const;
+    void rehash(int bucket_count);
+
+    QVector<QString> paths_;             ///< ID -> VSS path
+    QVector<QByteArray> event_names_;    ///< ID -> "vss/<path>" as ASCII
+    QVector<SignalSlot> slots_;          ///< ID -> latest value
+    QVector<Bucket> buckets_;            ///< Open-addressing table (power of two)
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "data_acquisition/can_signal.h"
+#include "data_acquisition/vehicle_data_source.h"
+
+class QSocketNotifier;
+
+/**
+ * @brief Reads the speed signal straight from a SocketCAN interface
+ *
+ * Opens a raw CAN socket filtered to the signal's ID (vcan0 works for
+ * bench testing) and decodes frames as they arrive. Linux only; built with
+ * ENABLE_CAN_BACKEND.
+ */
+class SocketCanSource : public VehicleDataSource {
+    Q_OBJECT
+
+public:
+    SocketCanSource(const QString& interface_name, const CanSignalDefinition& signal,
+                    QObject* parent = nullptr);
+    ~SocketCanSource() override;
+
+    bool start() override;
+    void stop() override;
+    QString description() const override;
+
+    quint64 framesRead() const { return frames_read_; }
+    quint64 decodeErrors() const { return decode_errors_; }
+
+private slots:
+    void onReadable();
+
+private:
+    QString interface_name_;
+    CanSignalDefinition signal_;
+    int socket_fd_;
+    QSocketNotifier* notifier_;
+    quint64 frames_read_;
+    quint64 decode_errors_;
+};
@@ -4,12 +4,20 @@
 #include <QWebSocket>
 #include <QString>
 #include <QJsonObject>
+#include <QStringList>
 #include <chrono>
+#include "data_acquisition/signal_registry.h"
+#include "data_acquisition/vehicle_sample.h"
+
+struct AfbEvent;
+class SampleChannel;
+class VehicleDataSource;
 
 /**
  * @brief Manages vehicle data acquisition from AGL VSS
  * 
- * Connects to AFB WebSocket API and subscribes to Vehicle.Speed signal
+ * Connects to AFB WebSocket API and subscribes to the configured VSS
+ * signals (Vehicle.Speed is always included).
  */
 class VehicleDataManager : public QObject {
     Q_OBJECT
@@ -27,9 +35,88 @@ public:
     bool initialize(const QString& url, const QString& token);
 
     /**
-     * @brief Subscribe to Vehicle.Speed signal
+     * @brief Drop the current connection and connect to url
+     *
+     * The old socket is closed first; the new connection is opened once it
+     * is down, without the retry backoff, and subscribes again. A direct
+     * data source is restarted instead.
+     */
+    void reconnectTo(const QString& url, const QString& token);
+
+    /**
+     * @brief Set the VSS signals to subscribe to
+     *
+     * Paths are interned to integer IDs immediately; Vehicle.Speed is
+     * always registered. Takes effect on the next subscription.
+     * @param paths VSS paths, e.g. "Vehicle.Speed"
+     */
+    void setSignals(const QStringList& paths);
+
+    /**
+     * @brief Subscribe to all registered signals
+     */
+    void subscribeToSignals();
+
+    /**
+     * @brief Get the ID assigned to a signal path
+     * @param path VSS path
+     * @return Signal ID, or SignalRegistry::INVALID_ID if not registered
+     */
+    int signalId(const QString& path) const { return registry_.findPath(path); }
+
+    /**
+     * @brief Get the latest value received for a signal
+     * @param signal_id Signal ID
+     * @return Latest-value slot, or nullptr for an unknown ID
+     */
+    const SignalSlot* latestValue(int signal_id) const;
+
+    /**
+     * @brief Access the signal registry
+     */
+    const SignalRegistry& signalRegistry() const { return registry_; }
+
+    /**
+     * @brief Deliver samples through a channel instead of signals
+     *
+     * Used when this object runs on a dedicated I/O thread: decoded samples
+     * are pushed into the channel and speedUpdated/signalUpdated are not
+     * emitted. Must be set before the object is moved to its thread.
+     * @param channel Channel owned by the consumer, or nullptr for signals
+     */
+    void setSampleChannel(SampleChannel* channel) { sample_channel_ = channel; }
+
+    /**
+     * @brief Replace the AFB WebSocket with another data source
+     *
+     * initialize() then starts the source instead of connecting, and its
+     * decoded speeds go through the same validation and speedUpdated path.
+     * Takes ownership (the source becomes a child and follows this object
+     * across threads). Must be set before initialize().
+     * @param source Data source, or nullptr for the AFB WebSocket
+     */
+    void setDataSource(VehicleDataSource* source);
+
+    /**
+     * @brief Active alternative data source
+     * @return Source, or nullptr when the AFB WebSocket is used
+     */
+    VehicleDataSource* dataSource() const { return data_source_; }
+
+    /**
+     * @brief Request CBOR-encoded binary event frames at subscribe time
+     *
+     * If the binding rejects the format, the subscription is repeated
+     * without it and events keep arriving as JSON text frames.
+     * @param enabled true to negotiate binary frames
+     */
+    void setPreferBinaryFrames(bool enabled) { prefer_binary_frames_ = enabled; }
+
+    /**
+     * @brief Check whether events are currently negotiated as binary frames
+     * @return true if the last subscription requested CBOR and was not rejected
      */
-    void subscribeToSpeed();
+    bool binaryFramesActive() const { return binary_frames_active_; }
 
     /**
      * @brief Get current cached speed value
@@ -50,6 +137,8 @@ public:
 
 signals:
     void speedUpdated(double speed);
+    void signalUpdated(int signal_id, double value);
+    void sampleReceived(const VehicleSample& sample);
     void connectionEstablished();
     void connectionLost();
     void errorOccurred(const QString& error);
@@ -58,20 +147,38 @@ private slots:
     void onConnected();
     void onDisconnected();
     void onTextMessageReceived(const QString& message);
+    void onBinaryMessageReceived(const QByteArray& message);
     void onError(QAbstractSocket::SocketError error);
+    void onSourceSpeed(double speed, qint64 received_ns, qint64 source_timestamp_ms);
 
 private:
-    void handleSpeedUpdate(const QJsonObject& data);
+    void handleEvent(const AfbEvent& event);
+    void handleSpeedEvent(const AfbEvent& event);
+    void handleSubscribeReply(const QJsonObject& reply);
+    void publishSpeed(double speed, std::int64_t timestamp_ms);
+    void deliverSample(VehicleSample sample);
+    static bool eventFromJson(const QJsonObject& obj, AfbEvent& event);
     void reconnect();
 
     QWebSocket websocket_;
+    SignalRegistry registry_;
+    int speed_signal_id_;
+    SampleChannel* sample_channel_;
+    VehicleDataSource* data_source_;   ///< Owned child; nullptr uses websocket_
+    std::int64_t frame_received_ns_;   ///< Monotonic receive time of the frame being decoded
     QString afb_url_;
     QString auth_token_;
     double current_speed_;
-    std::chrono::system_clock::time_point last_update_;
+    std::chrono::steady_clock::time_point last_update_;
     bool is_connected_;
     int retry_count_;
+    bool prefer_binary_frames_;
+    bool binary_frames_supported_;     ///< Cleared once the binding rejects CBOR
+    bool binary_frames_active_;
+    bool awaiting_format_reply_;       ///< Set while a CBOR subscribe is unanswered
+    bool reconnect_pending_;           ///< reconnectTo() closed the socket; reopen on disconnect
 
     static constexpr int MAX_RETRIES = 5;
     static constexpr int DATA_TIMEOUT_MS = 5000;
+    static constexpr const char* SPEED_PATH = "Vehicle.Speed";
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <memory>
+#include "data_acquisition/configuration_manager.h"
+
+/**
+ * @brief Alternative producer of speed samples behind VehicleDataManager
+ *
+ * The default path is the AFB WebSocket owned by VehicleDataManager itself.
+ * A data source replaces it: VehicleDataManager starts the source instead
+ * of opening the socket and feeds every decoded value through the same
+ * publishSpeed/speedUpdated path, so latency and behaviour can be compared
+ * with and without the middleware hop.
+ */
+class VehicleDataSource : public QObject {
+    Q_OBJECT
+
+public:
+    using QObject::QObject;
+    ~VehicleDataSource() override = default;
+
+    /**
+     * @brief Start producing samples (called on the manager's thread)
+     * @return true if the source is running
+     */
+    virtual bool start() = 0;
+
+    /**
+     * @brief Stop producing samples
+     */
+    virtual void stop() = 0;
+
+    /**
+     * @brief Human-readable description for logs
+     */
+    virtual QString description() const = 0;
+
+    /**
+     * @brief Create the source selected in the configuration
+     * @param config Data source configuration
+     * @return Source, or nullptr for "afb" (the built-in WebSocket path) or
+     *         when the requested backend is not compiled in
+     */
+    static std::unique_ptr<VehicleDataSource> create(
+        const ConfigurationManager::DataSourceConfig& config);
+
+signals:
+    /**
+     * @brief Emitted for every decoded speed value
+     * @param speed_kmh Speed in km/h
+     * @param received_ns Monotonic time the frame was read (steady clock)
+     * @param source_timestamp_ms Capture timestamp, 0 if unknown
+     */
+    void speedDecoded(double speed_kmh, qint64 received_ns, qint64 source_timestamp_ms);
+
+    /**
+     * @brief Emitted when the source cannot continue
+     */
+    void errorOccurred(const QString& message);
+
+    /**
+     * @brief Emitted when a finite source (e.g. a log file) has been fully read
+     */
+    void finished();
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QMetaType>
+#include <cstdint>
+
+/**
+ * @brief One decoded signal value handed from acquisition to business logic
+ *
+ * Plain data so it can travel through SpscRingBuffer without allocation.
+ */
+struct VehicleSample {
+    int signal_id = -1;                  ///< SignalRegistry ID
+    double value = 0.0;                  ///< Decoded value
+    std::int64_t received_ns = 0;        ///< Monotonic receive time (steady clock)
+    std::int64_t source_timestamp_ms = 0;  ///< AFB event timestamp, 0 if absent
+    std::int64_t decoded_ns = 0;         ///< Monotonic time decoding finished
+};
+
+// Declare metatype for use in signals/slots
+Q_DECLARE_METATYPE(VehicleSample)
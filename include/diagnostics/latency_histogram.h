@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @brief Fixed-memory log-linear latency histogram
+ *
+ * Values are recorded in nanoseconds into 16 sub-buckets per power of two
+ * (about 6% relative resolution) from 1 ns up to ~68 s; larger values are
+ * clamped into the last bucket. Recording is O(1) and allocation-free.
+ *
+ * One thread may record while any number of threads read; readers see a
+ * consistent-enough snapshot for diagnostics (counters are relaxed atomics).
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int MAX_EXPONENT = 36;   ///< 2^36 ns ~ 68.7 s
+    static constexpr int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Record one latency value
+     * @param ns Latency in nanoseconds (negative values count as 0)
+     */
+    void record(std::int64_t ns);
+
+    /**
+     * @brief Clear all recorded values
+     */
+    void reset();
+
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::int64_t minNs() const;
+    std::int64_t maxNs() const { return max_.load(std::memory_order_relaxed); }
+    double meanNs() const;
+
+    /**
+     * @brief Estimate a percentile
+     * @param percentile Value in [0, 100]
+     * @return Upper bound of the bucket containing the percentile, in ns
+     */
+    std::int64_t percentileNs(double percentile) const;
+
+    /**
+     * @brief Map a value to its bucket index
+     */
+    static int bucketIndex(std::uint64_t ns);
+
+    /**
+     * @brief Largest value that maps to a bucket
+     */
+    static std::uint64_t bucketUpperBound(int index);
+
+private:
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::int64_t> min_{std::numeric_limits<std::int64_t>::max()};
+    std::atomic<std::int64_t> max_{0};
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "diagnostics/latency_histogram.h"
+#include <QVariantMap>
+#include <array>
+#include <cstdint>
+
+/**
+ * @brief Per-stage latency histograms for the speed pipeline
+ *
+ * Every stage records the time elapsed since the sample's monotonic receive
+ * stamp (VehicleSample::received_ns), so each histogram is cumulative and
+ * FrameSwapped is the end-to-end latency from socket to screen.
+ *
+ * Each stage must be recorded from a single thread; FrameSwapped is
+ * typically recorded on the scene graph render thread, all others on the
+ * GUI thread.
+ */
+class LatencyTracker {
+public:
+    enum class Stage {
+        Decode,          ///< Frame received -> sample decoded
+        Dispatch,        ///< -> sample handed to business logic (queue + coalescing)
+        Smoothing,       ///< -> SpeedMonitor produced a smoothed value
+        StateMachine,    ///< -> ExpressionStateMachine evaluated
+        PropertyUpdate,  ///< -> QML property change notified
+        FrameSwapped,    ///< -> next frame presented
+        Count
+    };
+
+    static constexpr int STAGE_COUNT = static_cast<int>(Stage::Count);
+
+    /**
+     * @brief Record the latency of a stage
+     * @param stage Pipeline stage
+     * @param received_ns Monotonic receive time of the sample
+     * @param now_ns Monotonic time the stage completed
+     */
+    void record(Stage stage, std::int64_t received_ns, std::int64_t now_ns);
+
+    /**
+     * @brief Histogram for a stage
+     */
+    const LatencyHistogram& histogram(Stage stage) const {
+        return histograms_[static_cast<int>(stage)];
+    }
+
+    /**
+     * @brief Clear all histograms
+     */
+    void reset();
+
+    /**
+     * @brief Snapshot of all stages
+     * @return Map of stage name -> {count, min_us, mean_us, p50_us, p99_us, max_us}
+     */
+    QVariantMap summary() const;
+
+    /**
+     * @brief Write one line per stage to the log
+     */
+    void logReport() const;
+
+    /**
+     * @brief Stage name as used in reports
+     */
+    static const char* stageName(Stage stage);
+
+    /**
+     * @brief Current monotonic time (steady clock) in nanoseconds
+     */
+    static std::int64_t nowNs();
+
+private:
+    std::array<LatencyHistogram, STAGE_COUNT> histograms_;
+};
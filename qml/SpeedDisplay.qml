@@ -7,6 +7,9 @@ Rectangle {
     property real currentSpeed: 0.0
     property string currentExpression: "RELAXED"
     property string speedUnit: "km/h"
+    // Set when currentSpeed is updated every frame (extrapolated in C++);
+    // the animations below would only trail behind it
+    property bool perFrameUpdates: false
     property color backgroundColor: "#2d2d2d"
     property color textColor: "#ffffff"
     property color accentColor: "#00ff00"
@@ -54,6 +57,7 @@ Rectangle {
                 
                 // Smooth animation
                 Behavior on text {
+                    enabled: !perFrameUpdates
                     NumberAnimation { duration: 200 }
                 }
             }
@@ -93,6 +97,7 @@ Rectangle {
                 }
                 
                 Behavior on width {
+                    enabled: !perFrameUpdates
                     NumberAnimation { duration: 300; easing.type: Easing.OutQuad }
                 }
             }
@@ -158,6 +158,7 @@ Window {
                         
                         currentSpeed: mainWindow.currentSpeed
                         currentExpression: mainWindow.currentExpression
+                        perFrameUpdates: connectionStatus === "Connected"
                     }
                     
                     // Raw data display
@@ -265,6 +266,24 @@ Window {
         }
     }
     
+    // Live data from the C++ backend; displaySpeed is refreshed every frame
+    Connections {
+        target: appController
+        
+        function onSpeedChanged(speed) {
+            mainWindow.rawSpeed = Math.round(speed)
+            mainWindow.connectionStatus = "Connected"
+        }
+        
+        function onDisplaySpeedChanged(speed) {
+            mainWindow.currentSpeed = speed
+        }
+        
+        function onExpressionStateChanged(state) {
+            mainWindow.currentExpression = state.toUpperCase()
+        }
+    }
+    
     // Demo mode - simulate speed changes for testing
     Timer {
         id: demoTimer
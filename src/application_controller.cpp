@@ -1,21 +1,32 @@
 #include "application_controller.h"
 #include "data_acquisition/vehicle_data_manager.h"
 #include "data_acquisition/configuration_manager.h"
+#include "data_acquisition/vehicle_data_source.h"
 #include "business_logic/speed_monitor.h"
+#include "business_logic/speed_extrapolator.h"
 #include "business_logic/expression_state_machine.h"
+#include "business_logic/pipeline_config.h"
 #include "business_logic/data_logger.h"
+#include "business_logic/speed_rollup.h"
 #include "business_logic/alert_manager.h"
+#include "diagnostics/latency_tracker.h"
 #include <QCoreApplication>
+#include <QDateTime>
 #include <QDebug>
+#include <QTimer>
 
 ApplicationController::ApplicationController(QObject* parent)
     : QObject(parent)
     , config_manager_(std::make_unique<ConfigurationManager>())
     , vehicle_data_manager_(std::make_unique<VehicleDataManager>())
     , speed_monitor_(std::make_unique<SpeedMonitor>())
+    , speed_extrapolator_(std::make_unique<SpeedExtrapolator>())
     , state_machine_(std::make_unique<ExpressionStateMachine>())
     , data_logger_(std::make_unique<DataLogger>())
+    , speed_rollup_(std::make_unique<SpeedRollup>())
     , alert_manager_(std::make_unique<AlertManager>())
+    , sample_coalescer_(std::make_unique<SampleCoalescer>())
+    , latency_tracker_(std::make_unique<LatencyTracker>())
 {
     qInfo() << "ApplicationController created";
 }
@@ -36,38 +47,206 @@ bool ApplicationController::initialize() {
     // Get AFB connection config
     auto afb_config = config_manager_->getAFBConfig();
     
-    // Initialize vehicle data manager
-    if (!vehicle_data_manager_->initialize(afb_config.url, afb_config.token)) {
-        qCritical() << "Failed to initialize vehicle data manager";
-        return false;
+    // Configure vehicle data manager
+    signal_paths_ = config_manager_->getVssConfig().signal_paths;
+    vehicle_data_manager_->setPreferBinaryFrames(afb_config.binary_frames);
+    vehicle_data_manager_->setSignals(signal_paths_);
+    speed_signal_id_ = vehicle_data_manager_->signalId("Vehicle.Speed");
+    
+    // Optional direct CAN source instead of the AFB WebSocket
+    auto data_source = VehicleDataSource::create(config_manager_->getDataSourceConfig());
+    if (data_source) {
+        vehicle_data_manager_->setDataSource(data_source.release());
     }
     
-    // Setup speed thresholds
-    auto thresholds = config_manager_->getSpeedThresholds();
-    state_machine_->setThresholds(
-        thresholds.relaxed_max,
-        thresholds.normal_max,
-        thresholds.alert_max,
-        thresholds.warning_max
-    );
+    applySmoothingConfig();
+    configureLogging(true);
+    applyDisplaySettings();
+    applyExpressionConfig();
+    
+    // Deliver at most vss.update_rate_hz updates per signal downstream
+    sample_coalescer_->setUpdateRate(config_manager_->getVssConfig().update_rate_hz);
+    
+    // A reloaded config.json reconfigures only the components whose section changed
+    connect(config_manager_.get(), &ConfigurationManager::expressionConfigChanged,
+            this, &ApplicationController::applyExpressionConfig);
+    connect(config_manager_.get(), &ConfigurationManager::smoothingConfigChanged,
+            this, &ApplicationController::applySmoothingConfig);
+    connect(config_manager_.get(), &ConfigurationManager::displaySettingsChanged,
+            this, &ApplicationController::applyDisplaySettings);
+    connect(config_manager_.get(), &ConfigurationManager::loggingConfigChanged,
+            this, &ApplicationController::onLoggingConfigChanged);
+    connect(config_manager_.get(), &ConfigurationManager::vssConfigChanged,
+            this, &ApplicationController::onVssConfigChanged);
+    connect(config_manager_.get(), &ConfigurationManager::dataSourceConfigChanged,
+            this, &ApplicationController::onDataSourceConfigChanged);
+    connect(config_manager_.get(), &ConfigurationManager::afbConfigChanged,
+            this, &ApplicationController::scheduleReconnect);
     
     // Connect signals
-    connect(vehicle_data_manager_.get(), &VehicleDataManager::speedUpdated,
-            this, &ApplicationController::onSpeedUpdate);
+    connect(sample_coalescer_.get(), &SampleCoalescer::sampleReady,
+            this, &ApplicationController::onSampleReady);
+    
+    connect(speed_monitor_.get(), &SpeedMonitor::smoothedSpeedUpdated,
+            this, &ApplicationController::onSmoothedSpeedUpdate);
     
     connect(vehicle_data_manager_.get(), &VehicleDataManager::errorOccurred,
             this, &ApplicationController::onVehicleDataError);
     
     connect(state_machine_.get(), &ExpressionStateMachine::stateStringChanged,
             this, &ApplicationController::expressionStateChanged);
+    connect(state_machine_.get(), &ExpressionStateMachine::stateChanged,
+            alert_manager_.get(), &AlertManager::onStateChanged);
     
-    // Subscribe to speed data
-    vehicle_data_manager_->subscribeToSpeed();
+    if (afb_config.io_thread) {
+        // Socket and decoding run on their own thread; samples arrive via the channel
+        startAcquisitionThread();
+    } else {
+        connect(vehicle_data_manager_.get(), &VehicleDataManager::sampleReceived,
+                sample_coalescer_.get(), &SampleCoalescer::submit);
+        
+        // Initialize vehicle data manager
+        if (!vehicle_data_manager_->initialize(afb_config.url, afb_config.token)) {
+            qCritical() << "Failed to initialize vehicle data manager";
+            return false;
+        }
+        
+        // Subscribe to configured VSS signals
+        vehicle_data_manager_->subscribeToSignals();
+    }
     
     qInfo() << "Initialization complete";
     return true;
 }
 
+void ApplicationController::applySmoothingConfig() {
+    PipelineConfig::applySmoothing(*config_manager_, *speed_monitor_);
+}
+
+void ApplicationController::configureLogging(bool startup) {
+    // Writer settings only change while it is stopped; stopping drains the queue
+    data_logger_->stopWriter();
+    
+    // The writer thread keeps file I/O off the speed path
+    const auto logging = config_manager_->getLoggingConfig();
+    data_logger_->setLogDirectory(logging.log_dir);
+    data_logger_->setEnabled(logging.enabled);
+    data_logger_->setMaxFileSize(static_cast<qint64>(logging.max_file_size_mb) * 1024 * 1024);
+    if (logging.format == "columnar") {
+        data_logger_->setFormat(DataLogger::Format::Columnar);
+    } else {
+        if (logging.format != "csv") {
+            qWarning() << "Unknown logging format" << logging.format << "- using csv";
+        }
+        data_logger_->setFormat(DataLogger::Format::Csv);
+    }
+    if (logging.rotation_interval == "hourly") {
+        data_logger_->setRotationInterval(DataLogger::RotationInterval::Hourly);
+    } else if (logging.rotation_interval == "daily") {
+        data_logger_->setRotationInterval(DataLogger::RotationInterval::Daily);
+    } else {
+        if (logging.rotation_interval != "none") {
+            qWarning() << "Unknown logging rotation_interval" << logging.rotation_interval;
+        }
+        data_logger_->setRotationInterval(DataLogger::RotationInterval::None);
+    }
+    if (startup) {
+        data_logger_->recoverLogFiles();
+    }
+    if (startup || data_logger_->timeIndexBucketMs() != logging.time_index_bucket_s * 1000) {
+        data_logger_->setTimeIndex(logging.time_index_bucket_s * 1000);
+    }
+    LogRetention::Policy retention;
+    retention.max_files = logging.max_files;
+    retention.max_total_bytes = static_cast<qint64>(logging.max_total_size_mb) * 1024 * 1024;
+    retention.max_age_ms = static_cast<qint64>(logging.max_age_days) * 24 * 3600 * 1000;
+    data_logger_->setRetention(retention);
+    DataLogger::CommitPolicy commit;
+    commit.durable = logging.durable_commits;
+    commit.max_records = logging.commit_max_records;
+    data_logger_->setCommitPolicy(commit);
+    if (logging.enabled && logging.async_writer) {
+        data_logger_->startWriter(logging.flush_interval_ms);
+    }
+    
+    if (!logging.rollups) {
+        speed_rollup_->close();
+    } else if (speed_rollup_->directory() != logging.log_dir) {
+        speed_rollup_->open(logging.log_dir);
+    }
+}
+
+void ApplicationController::onLoggingConfigChanged() {
+    configureLogging(false);
+}
+
+void ApplicationController::applyDisplaySettings() {
+    // Per-frame speed extrapolation
+    const auto display = config_manager_->getDisplaySettings();
+    extrapolate_speed_ = display.extrapolate_speed;
+    SpeedExtrapolator::Settings extrapolation;
+    extrapolation.max_lead_s = display.extrapolation_max_lead_ms / 1000.0;
+    extrapolation.stale_after_s = display.extrapolation_stale_ms / 1000.0;
+    speed_extrapolator_->setSettings(extrapolation);
+}
+
+void ApplicationController::applyExpressionConfig() {
+    PipelineConfig::applyExpression(*config_manager_, *state_machine_);
+}
+
+void ApplicationController::onVssConfigChanged() {
+    const auto vss = config_manager_->getVssConfig();
+    sample_coalescer_->setUpdateRate(vss.update_rate_hz);
+    
+    // New signals need a fresh subscription
+    if (vss.signal_paths != signal_paths_) {
+        signal_paths_ = vss.signal_paths;
+        scheduleReconnect();
+    }
+}
+
+void ApplicationController::onDataSourceConfigChanged() {
+    source_changed_ = true;
+    scheduleReconnect();
+}
+
+void ApplicationController::scheduleReconnect() {
+    // One reconnect for all acquisition sections changed by the same reload
+    if (!reconnect_scheduled_) {
+        reconnect_scheduled_ = true;
+        QTimer::singleShot(0, this, &ApplicationController::reconnectAcquisition);
+    }
+}
+
+void ApplicationController::reconnectAcquisition() {
+    reconnect_scheduled_ = false;
+    const auto afb_config = config_manager_->getAFBConfig();
+    if (afb_config.io_thread != (io_thread_ != nullptr)) {
+        qWarning() << "afb.io_thread takes effect after a restart";
+    }
+    
+    const bool replace_source = source_changed_;
+    source_changed_ = false;
+    const auto source_config = config_manager_->getDataSourceConfig();
+    const QStringList signal_paths = signal_paths_;
+    VehicleDataManager* manager = vehicle_data_manager_.get();
+    auto reconnect = [manager, afb_config, replace_source, source_config, signal_paths]() {
+        if (replace_source) {
+            manager->setDataSource(VehicleDataSource::create(source_config).release());
+        }
+        manager->setPreferBinaryFrames(afb_config.binary_frames);
+        manager->setSignals(signal_paths);
+        manager->reconnectTo(afb_config.url, afb_config.token);
+    };
+    
+    if (io_thread_) {
+        // The manager and its data source live on the I/O thread
+        QMetaObject::invokeMethod(manager, reconnect, Qt::QueuedConnection);
+    } else {
+        reconnect();
+    }
+}
+
 int ApplicationController::run() {
     qInfo() << "CarSpeedBoy running";
     return QCoreApplication::exec();
@@ -76,27 +255,227 @@ int ApplicationController::run() {
 void ApplicationController::shutdown() {
     qInfo() << "Shutting down CarSpeedBoy...";
     
-    if (vehicle_data_manager_) {
+    if (io_thread_) {
+        stopAcquisitionThread();
+    } else if (vehicle_data_manager_) {
         vehicle_data_manager_->shutdown();
     }
     
+    if (sample_coalescer_ && sample_coalescer_->submittedCount() > 0) {
+        qInfo() << "Samples submitted:" << sample_coalescer_->submittedCount()
+                << "delivered:" << sample_coalescer_->deliveredCount()
+                << "coalesced:" << sample_coalescer_->coalescedCount();
+    }
+    
+    if (data_logger_) {
+        data_logger_->stopWriter();
+    }
+    
+    if (speed_rollup_) {
+        speed_rollup_->close();
+    }
+    
+    if (latency_tracker_) {
+        latency_tracker_->logReport();
+    }
+    
+    if (state_machine_) {
+        const auto& transitions = state_machine_->transitionStatistics();
+        qInfo() << "Expression transitions:" << transitions.transitions
+                << "held by hysteresis:" << transitions.held_by_hysteresis
+                << "suppressed by dwell:" << transitions.suppressed_by_dwell;
+    }
+    
+    if (speed_monitor_) {
+        const auto gaps = speed_monitor_->gapStatistics();
+        qInfo() << "Sample gaps: mean" << gaps.mean_gap_ms << "ms max" << gaps.max_gap_ms
+                << "ms stalls:" << gaps.stalls << "burst samples:" << gaps.burst_samples;
+    }
+    
     qInfo() << "Shutdown complete";
 }
 
+QVariantMap ApplicationController::latencyStatistics() const {
+    return latency_tracker_->summary();
+}
+
+QVariantMap ApplicationController::sampleGapStatistics() const {
+    return speed_monitor_->gapSummary();
+}
+
+QVariantList ApplicationController::recentAlerts(int count) const {
+    return alert_manager_->recentAlerts(count);
+}
+
+QVariantList ApplicationController::alertsBetween(const QDateTime& from, const QDateTime& to) const {
+    return alert_manager_->alertsBetween(from, to);
+}
+
+QVariantList ApplicationController::speedRollup(const QString& tier, int count) const {
+    QVariantList result;
+    SpeedRollup::Tier rollup_tier;
+    if (!SpeedRollup::tierFromName(tier, &rollup_tier)) {
+        qWarning() << "Unknown rollup tier" << tier;
+        return result;
+    }
+    for (const RollupBucket& bucket : speed_rollup_->recent(rollup_tier, count)) {
+        QVariantMap states;
+        for (int i = 0; i < SpeedAggregate::STATE_SLOTS; ++i) {
+            if (bucket.state_ms[i] > 0) {
+                states[SpeedLogCsvFormatter::stateName(static_cast<quint8>(i))] = bucket.state_ms[i];
+            }
+        }
+        QVariantMap entry;
+        entry["start_ms"] = bucket.start_ms;
+        entry["count"] = static_cast<qulonglong>(bucket.speed.count);
+        entry["min_kmh"] = bucket.speed.minSmoothedKmh();
+        entry["max_kmh"] = bucket.speed.maxSmoothedKmh();
+        entry["mean_kmh"] = bucket.speed.meanSmoothedKmh();
+        entry["state_ms"] = states;
+        result.append(entry);
+    }
+    return result;
+}
+
+void ApplicationController::onFrameSwapped() {
+    const std::int64_t received_ns = frame_pending_ns_.exchange(0, std::memory_order_acq_rel);
+    latency_tracker_->record(LatencyTracker::Stage::FrameSwapped, received_ns,
+                             LatencyTracker::nowNs());
+}
+
+void ApplicationController::onBeforeFrame() {
+    if (extrapolate_speed_ && speed_extrapolator_->hasData()) {
+        setDisplaySpeed(speed_extrapolator_->speedAt(LatencyTracker::nowNs()));
+    }
+}
+
+void ApplicationController::setDisplaySpeed(double speed) {
+    // Sub-0.01 km/h changes are invisible; skipping them lets rendering idle
+    if (qAbs(speed - display_speed_) < 0.01) {
+        return;
+    }
+    display_speed_ = speed;
+    emit displaySpeedChanged(display_speed_);
+}
+
 void ApplicationController::onSpeedUpdate(double speed) {
+    // Smooth first; the state machine runs on the filtered value.
+    // Samples carry their receive time so bursts are weighted by real spacing.
+    if (current_received_ns_ > 0) {
+        speed_monitor_->onSpeedSample(speed, current_received_ns_);
+    } else {
+        speed_monitor_->onRawSpeedUpdate(speed);
+    }
+    
+    if (extrapolate_speed_ && speed >= SpeedExtrapolator::MIN_SPEED
+        && speed <= SpeedExtrapolator::MAX_SPEED) {
+        const std::int64_t now_ns = LatencyTracker::nowNs();
+        speed_extrapolator_->addSample(speed,
+                                       current_received_ns_ > 0 ? current_received_ns_ : now_ns);
+        setDisplaySpeed(speed_extrapolator_->speedAt(now_ns));
+    }
+    
     emit speedChanged(speed);
+    latency_tracker_->record(LatencyTracker::Stage::PropertyUpdate, current_received_ns_,
+                             LatencyTracker::nowNs());
     
-    // Update state machine
-    state_machine_->updateSpeed(speed);
+    // The next presented frame shows this value
+    frame_pending_ns_.store(current_received_ns_, std::memory_order_release);
     
     // Log data
-    // TODO: Implement data logging
+    data_logger_->logSpeedData(speed, speed_monitor_->smoothedSpeed(),
+                               state_machine_->getCurrentState());
+    SpeedLogRecord rollup_record;
+    rollup_record.wall_ms = QDateTime::currentMSecsSinceEpoch();
+    rollup_record.raw_speed = speed;
+    rollup_record.smoothed_speed = speed_monitor_->smoothedSpeed();
+    rollup_record.state = static_cast<quint8>(state_machine_->getCurrentState());
+    speed_rollup_->add(rollup_record);
     
     qDebug() << "Speed updated:" << speed << "km/h - State:" 
              << state_machine_->getStateString();
 }
 
+void ApplicationController::onSmoothedSpeedUpdate(double speed) {
+    latency_tracker_->record(LatencyTracker::Stage::Smoothing, current_received_ns_,
+                             LatencyTracker::nowNs());
+    
+    if (!extrapolate_speed_) {
+        setDisplaySpeed(speed);
+    }
+    
+    // Update state machine; the dwell time runs on sample receive time
+    if (current_received_ns_ > 0) {
+        state_machine_->updateSpeed(speed, current_received_ns_);
+    } else {
+        state_machine_->updateSpeed(speed);
+    }
+    latency_tracker_->record(LatencyTracker::Stage::StateMachine, current_received_ns_,
+                             LatencyTracker::nowNs());
+}
+
 void ApplicationController::onVehicleDataError(const QString& error) {
     qWarning() << "Vehicle data error:" << error;
     emit errorOccurred(error);
 }
+
+void ApplicationController::onSamplesAvailable() {
+    sample_channel_->consume([this](const VehicleSample& sample) {
+        sample_coalescer_->submit(sample);
+    });
+}
+
+void ApplicationController::onSampleReady(const VehicleSample& sample) {
+    if (sample.signal_id == speed_signal_id_) {
+        latency_tracker_->record(LatencyTracker::Stage::Decode, sample.received_ns,
+                                 sample.decoded_ns);
+        latency_tracker_->record(LatencyTracker::Stage::Dispatch, sample.received_ns,
+                                 LatencyTracker::nowNs());
+        
+        current_received_ns_ = sample.received_ns;
+        onSpeedUpdate(sample.value);
+        current_received_ns_ = 0;
+    }
+}
+
+void ApplicationController::startAcquisitionThread() {
+    sample_channel_ = std::make_unique<SampleChannel>();
+    connect(sample_channel_.get(), &SampleChannel::samplesAvailable,
+            this, &ApplicationController::onSamplesAvailable, Qt::QueuedConnection);
+    vehicle_data_manager_->setSampleChannel(sample_channel_.get());
+    
+    io_thread_ = std::make_unique<QThread>();
+    io_thread_->setObjectName("carspeedboy-io");
+    vehicle_data_manager_->moveToThread(io_thread_.get());
+    io_thread_->start();
+    
+    // From here on the manager may only be touched from its own thread
+    const auto afb_config = config_manager_->getAFBConfig();
+    VehicleDataManager* manager = vehicle_data_manager_.get();
+    QMetaObject::invokeMethod(manager, [manager, afb_config]() {
+        manager->initialize(afb_config.url, afb_config.token);
+    }, Qt::QueuedConnection);
+    
+    qInfo() << "Vehicle data acquisition running on dedicated I/O thread";
+}
+
+void ApplicationController::stopAcquisitionThread() {
+    // Close the socket on the I/O thread and hand the manager back for destruction
+    VehicleDataManager* manager = vehicle_data_manager_.get();
+    QThread* owner_thread = thread();
+    QMetaObject::invokeMethod(manager, [manager, owner_thread]() {
+        manager->shutdown();
+        manager->moveToThread(owner_thread);
+    }, Qt::BlockingQueuedConnection);
+    
+    io_thread_->quit();
+    io_thread_->wait();
+    io_thread_.reset();
+    
+    // Deliver whatever was still queued
+    onSamplesAvailable();
+    
+    qInfo() << "I/O thread stopped - samples:" << sample_channel_->pushedCount()
+            << "dropped:" << sample_channel_->droppedCount()
+            << "max queue depth:" << sample_channel_->highWaterMark();
+}
@@ -1,10 +1,29 @@
 #include "business_logic/alert_manager.h"
 #include <QDebug>
-#include <QDateTime>
+#include <QVariantMap>
+#include <chrono>
+
+namespace {
+
+// Indexed by message id (= ExpressionState)
+const char* const ALERT_MESSAGES[] = {
+    "Normal operation",
+    "Normal operation",
+    "Speed is getting high. Please be cautious.",
+    "Speed is very high! Slow down.",
+    "CRITICAL: Speed is dangerously high! Reduce speed immediately!",
+};
+
+constexpr int MESSAGE_COUNT = sizeof(ALERT_MESSAGES) / sizeof(ALERT_MESSAGES[0]);
+
+}  // namespace
 
 AlertManager::AlertManager(QObject* parent)
     : QObject(parent)
     , current_alert_level_(AlertLevel::NONE)
+    , next_sequence_(0)
+    , wall_base_ms_(QDateTime::currentMSecsSinceEpoch())
+    , mono_base_ns_(nowNs())
 {
     qInfo() << "AlertManager created";
 }
@@ -26,7 +45,7 @@ void AlertManager::onStateChanged(ExpressionState old_state, ExpressionState new
             qInfo() << "Alert cleared";
         } else {
             QString message = generateAlertMessage(new_state);
-            addToHistory(new_level, message);
+            addToHistory(new_level, new_state);
             emit alertTriggered(new_level, message);
             qInfo() << "Alert triggered:" << static_cast<int>(new_level) << message;
         }
@@ -54,34 +73,78 @@ AlertManager::AlertLevel AlertManager::determineAlertLevel(ExpressionState state
 }
 
 QString AlertManager::generateAlertMessage(ExpressionState state) const {
-    switch (state) {
-        case ExpressionState::ALERT:
-            return "Speed is getting high. Please be cautious.";
-        
-        case ExpressionState::WARNING:
-            return "Speed is very high! Slow down.";
-        
-        case ExpressionState::SCARED:
-            return "CRITICAL: Speed is dangerously high! Reduce speed immediately!";
-        
-        default:
-            return "Normal operation";
+    return alertMessage(static_cast<int>(state));
+}
+
+QString AlertManager::alertMessage(int message_id) {
+    if (message_id < 0 || message_id >= MESSAGE_COUNT) {
+        return QString("Unknown alert");
     }
+    return QString::fromLatin1(ALERT_MESSAGES[message_id]);
 }
 
-void AlertManager::addToHistory(AlertLevel level, const QString& message) {
-    QString timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
-    QString entry = QString("[%1] Level %2: %3")
-        .arg(timestamp)
-        .arg(static_cast<int>(level))
-        .arg(message);
+void AlertManager::addToHistory(AlertLevel level, ExpressionState state) {
+    AlertRecord record;
+    record.timestamp_ns = nowNs();
+    record.level = static_cast<quint8>(level);
+    record.state = static_cast<quint8>(state);
+    record.message_id = static_cast<quint16>(state);
+    record.sequence = next_sequence_++;
     
-    alert_history_.enqueue(entry);
+    // Overwrites the oldest entry once MAX_HISTORY_SIZE is reached
+    alert_history_.append(record);
     
-    // Maintain maximum history size
-    while (alert_history_.size() > MAX_HISTORY_SIZE) {
-        alert_history_.dequeue();
+    qDebug() << "Alert history entry added: level" << static_cast<int>(record.level)
+             << "sequence" << record.sequence;
+}
+
+QVariantList AlertManager::recentAlerts(int count) const {
+    QVariantList alerts;
+    if (count <= 0) {
+        return alerts;
     }
+    alerts.reserve(qMin(count, alertHistorySize()));
+    alert_history_.forEachRecent(static_cast<std::size_t>(count), [&](const AlertRecord& record) {
+        alerts.append(toVariant(record));
+    });
+    return alerts;
+}
+
+QVariantList AlertManager::alertsBetween(const QDateTime& from, const QDateTime& to) const {
+    // Map wall-clock bounds onto the monotonic timestamps
+    const qint64 from_ns = mono_base_ns_ + (from.toMSecsSinceEpoch() - wall_base_ms_) * 1000000;
+    const qint64 to_ns = mono_base_ns_ + (to.toMSecsSinceEpoch() - wall_base_ms_) * 1000000;
     
-    qDebug() << "Alert history entry added:" << entry;
+    QVariantList alerts;
+    alert_history_.forEachInRange(from_ns, to_ns, [&](const AlertRecord& record) {
+        alerts.append(toVariant(record));
+    });
+    return alerts;
+}
+
+QDateTime AlertManager::alertTime(const AlertRecord& record) const {
+    return QDateTime::fromMSecsSinceEpoch(
+        wall_base_ms_ + (record.timestamp_ns - mono_base_ns_) / 1000000);
+}
+
+QString AlertManager::formatAlert(const AlertRecord& record) const {
+    return QString("[%1] Level %2: %3")
+        .arg(alertTime(record).toString(Qt::ISODate))
+        .arg(static_cast<int>(record.level))
+        .arg(alertMessage(record.message_id));
+}
+
+QVariantMap AlertManager::toVariant(const AlertRecord& record) const {
+    QVariantMap alert;
+    alert["time"] = alertTime(record);
+    alert["level"] = static_cast<int>(record.level);
+    alert["state"] = static_cast<int>(record.state);
+    alert["message"] = alertMessage(record.message_id);
+    alert["text"] = formatAlert(record);
+    return alert;
+}
+
+qint64 AlertManager::nowNs() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
 }
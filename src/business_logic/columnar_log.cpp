@@ -0,0 +1,417 @@
+#include "business_logic/columnar_log.h"
+#include "common/crc32.h"
+#include <QDebug>
+#include <QFileInfo>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unistd.h>
+
+namespace {
+
+constexpr int CHECKSUM_OFFSET = 36;   // Block header field; covers the bytes before it and the payload
+
+bool fitsInt16(qint32 delta) {
+    return delta >= std::numeric_limits<qint16>::min() && delta <= std::numeric_limits<qint16>::max();
+}
+
+bool fitsInt8(qint32 delta) {
+    return delta >= std::numeric_limits<qint8>::min() && delta <= std::numeric_limits<qint8>::max();
+}
+
+// Narrowest width (1 or 2 bytes) holding every value
+quint8 columnWidth(const std::vector<qint32>& values, bool is_signed) {
+    for (const qint32 value : values) {
+        if (is_signed ? !fitsInt8(value) : value > std::numeric_limits<quint8>::max()) {
+            return 2;
+        }
+    }
+    return 1;
+}
+
+uchar* packColumn(const std::vector<qint32>& values, quint8 width, uchar* out) {
+    if (width == 1) {
+        for (const qint32 value : values) {
+            *out++ = static_cast<uchar>(value);
+        }
+    } else {
+        for (const qint32 value : values) {
+            qToLittleEndian<quint16>(static_cast<quint16>(value), out);
+            out += 2;
+        }
+    }
+    return out;
+}
+
+// Running sum of a delta column; store(i, value) receives each record's value
+template <typename Delta, typename Value, typename Store>
+const uchar* unpackColumn(const uchar* in, int count, Value start, Store store) {
+    Value value = start;
+    for (int i = 0; i < count; ++i) {
+        if constexpr (sizeof(Delta) == 1) {
+            value += static_cast<Delta>(in[i]);
+        } else {
+            value += static_cast<Delta>(qFromLittleEndian<quint16>(in + i * sizeof(Delta)));
+        }
+        store(i, value);
+    }
+    return in + count * sizeof(Delta);
+}
+
+} // namespace
+
+qint32 ColumnarLog::toCentiKmh(double speed) {
+    // Non-finite values cannot be represented; the logger never produces them
+    if (!std::isfinite(speed)) {
+        return 0;
+    }
+    const double limit = 2.0e7;   // 200,000 km/h keeps block deltas in range
+    return static_cast<qint32>(std::lround(qBound(-limit, speed * SPEED_SCALE, limit)));
+}
+
+ColumnarLogWriter::ColumnarLogWriter(int block_capacity)
+    : block_capacity_(qBound(1, block_capacity, MAX_BLOCK_CAPACITY))
+{
+    time_deltas_.reserve(block_capacity_);
+    raw_deltas_.reserve(block_capacity_);
+    smoothed_deltas_.reserve(block_capacity_);
+    states_.reserve(block_capacity_);
+}
+
+ColumnarLogWriter::~ColumnarLogWriter() {
+    close();
+}
+
+bool ColumnarLogWriter::open(const QString& path, QString* error) {
+    close();
+
+    // Appending after a torn block would hide everything behind it
+    qint64 valid_bytes = 0;
+    if (QFile::exists(path) && QFileInfo(path).size() > 0) {
+        ColumnarLogReader reader;
+        if (!reader.open(path, error)) {
+            return false;
+        }
+        valid_bytes = reader.validBytes();
+    }
+
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadWrite)) {
+        if (error) {
+            *error = file_.errorString();
+        }
+        return false;
+    }
+
+    if (file_.size() == 0) {
+        uchar header[ColumnarLog::FILE_HEADER_SIZE] = {};
+        std::memcpy(header, ColumnarLog::FILE_MAGIC, 4);
+        qToLittleEndian<quint16>(ColumnarLog::VERSION, header + 4);
+        qToLittleEndian<quint16>(ColumnarLog::FILE_HEADER_SIZE, header + 6);
+        qToLittleEndian<quint32>(static_cast<quint32>(block_capacity_), header + 8);
+        if (file_.write(reinterpret_cast<const char*>(header), sizeof(header)) != sizeof(header)) {
+            if (error) {
+                *error = file_.errorString();
+            }
+            file_.close();
+            return false;
+        }
+    } else {
+        if (valid_bytes < file_.size()) {
+            qWarning() << "Truncating torn columnar log tail:" << path << file_.size() << "->"
+                       << valid_bytes << "bytes";
+            file_.resize(valid_bytes);
+        }
+        file_.seek(valid_bytes);
+    }
+
+    file_size_ = file_.size();
+    return true;
+}
+
+void ColumnarLogWriter::close() {
+    if (!file_.isOpen()) {
+        return;
+    }
+    flush();
+    file_.close();
+}
+
+bool ColumnarLogWriter::fits(qint64 wall_ms, qint32 raw, qint32 smoothed) const {
+    const qint64 dt = wall_ms - last_ms_;
+    return dt >= 0 && dt <= std::numeric_limits<quint16>::max()
+        && fitsInt16(raw - last_raw_) && fitsInt16(smoothed - last_smoothed_);
+}
+
+bool ColumnarLogWriter::append(const SpeedLogRecord& record) {
+    const qint32 raw = ColumnarLog::toCentiKmh(record.raw_speed);
+    const qint32 smoothed = ColumnarLog::toCentiKmh(record.smoothed_speed);
+
+    bool ok = true;
+    if (!states_.empty() && !fits(record.wall_ms, raw, smoothed)) {
+        ok = writeBlock();
+    }
+
+    if (states_.empty()) {
+        first_ms_ = last_ms_ = record.wall_ms;
+        first_raw_ = last_raw_ = raw;
+        first_smoothed_ = last_smoothed_ = smoothed;
+    }
+    time_deltas_.push_back(static_cast<qint32>(record.wall_ms - last_ms_));
+    raw_deltas_.push_back(raw - last_raw_);
+    smoothed_deltas_.push_back(smoothed - last_smoothed_);
+    states_.push_back(record.state);
+    last_ms_ = record.wall_ms;
+    last_raw_ = raw;
+    last_smoothed_ = smoothed;
+
+    if (static_cast<int>(states_.size()) >= block_capacity_) {
+        ok = writeBlock() && ok;
+    }
+    return ok;
+}
+
+bool ColumnarLogWriter::flush() {
+    if (!file_.isOpen()) {
+        return false;
+    }
+    const bool ok = states_.empty() || writeBlock();
+    return file_.flush() && ok;
+}
+
+bool ColumnarLogWriter::sync() {
+    if (!flush()) {
+        return false;
+    }
+    return ::fdatasync(file_.handle()) == 0;
+}
+
+bool ColumnarLogWriter::writeBlock() {
+    const quint32 count = static_cast<quint32>(states_.size());
+    ColumnarLog::BlockLayout layout;
+    layout.time_width = columnWidth(time_deltas_, false);
+    layout.raw_width = columnWidth(raw_deltas_, true);
+    layout.smoothed_width = columnWidth(smoothed_deltas_, true);
+    layout.state_bits = 4;
+    for (const quint8 state : states_) {
+        if (state > 0x0f) {
+            layout.state_bits = 8;
+            break;
+        }
+    }
+
+    QByteArray block(ColumnarLog::BLOCK_HEADER_SIZE + layout.payloadSize(count), '\0');
+    uchar* out = reinterpret_cast<uchar*>(block.data());
+
+    qToLittleEndian<quint32>(ColumnarLog::BLOCK_MAGIC, out);
+    qToLittleEndian<quint32>(count, out + 4);
+    qToLittleEndian<qint64>(first_ms_, out + 8);
+    qToLittleEndian<qint64>(last_ms_, out + 16);
+    qToLittleEndian<qint32>(first_raw_, out + 24);
+    qToLittleEndian<qint32>(first_smoothed_, out + 28);
+    out[32] = layout.time_width;
+    out[33] = layout.raw_width;
+    out[34] = layout.smoothed_width;
+    out[35] = layout.state_bits;
+
+    uchar* column = out + ColumnarLog::BLOCK_HEADER_SIZE;
+    column = packColumn(time_deltas_, layout.time_width, column);
+    column = packColumn(raw_deltas_, layout.raw_width, column);
+    column = packColumn(smoothed_deltas_, layout.smoothed_width, column);
+    if (layout.state_bits == 8) {
+        std::memcpy(column, states_.data(), count);
+    } else {
+        for (quint32 i = 0; i < count; ++i) {
+            column[i / 2] |= static_cast<uchar>(states_[i] << (i % 2 * 4));
+        }
+    }
+
+    const quint32 crc = Crc32::update(Crc32::compute(out, CHECKSUM_OFFSET),
+                                      out + ColumnarLog::BLOCK_HEADER_SIZE,
+                                      block.size() - ColumnarLog::BLOCK_HEADER_SIZE);
+    qToLittleEndian<quint32>(crc, out + CHECKSUM_OFFSET);
+
+    time_deltas_.clear();
+    raw_deltas_.clear();
+    smoothed_deltas_.clear();
+    states_.clear();
+
+    if (!file_.isOpen() || file_.write(block) != block.size()) {
+        qWarning() << "Failed to write columnar log block:" << file_.fileName();
+        return false;
+    }
+    file_size_ += block.size();
+    ++blocks_written_;
+    return true;
+}
+
+ColumnarLogReader::~ColumnarLogReader() {
+    close();
+}
+
+bool ColumnarLogReader::open(const QString& path, QString* error) {
+    close();
+
+    auto fail = [this, error](const QString& reason) {
+        if (error) {
+            *error = reason;
+        }
+        close();
+        return false;
+    };
+
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        return fail(file_.errorString());
+    }
+    size_ = file_.size();
+    if (size_ < ColumnarLog::FILE_HEADER_SIZE) {
+        return fail("file too short");
+    }
+    data_ = file_.map(0, size_);
+    if (!data_) {
+        return fail("cannot map file: " + file_.errorString());
+    }
+
+    if (std::memcmp(data_, ColumnarLog::FILE_MAGIC, 4) != 0) {
+        return fail("not a columnar speed log");
+    }
+    const quint16 version = qFromLittleEndian<quint16>(data_ + 4);
+    const quint16 header_size = qFromLittleEndian<quint16>(data_ + 6);
+    if (version < 1 || version > ColumnarLog::VERSION || header_size < ColumnarLog::FILE_HEADER_SIZE
+        || header_size > size_) {
+        return fail(QString("unsupported columnar log version %1").arg(version));
+    }
+
+    // Walk the block headers; payloads are only touched when decoded
+    qint64 offset = header_size;
+    while (offset + ColumnarLog::BLOCK_HEADER_SIZE <= size_) {
+        const uchar* header = data_ + offset;
+        BlockInfo info;
+        info.offset = offset;
+        info.count = qFromLittleEndian<quint32>(header + 4);
+        info.first_ms = qFromLittleEndian<qint64>(header + 8);
+        info.last_ms = qFromLittleEndian<qint64>(header + 16);
+        info.layout.time_width = header[32];
+        info.layout.raw_width = header[33];
+        info.layout.smoothed_width = header[34];
+        info.layout.state_bits = header[35];
+
+        const qint64 end = offset + ColumnarLog::BLOCK_HEADER_SIZE
+            + info.layout.payloadSize(info.count);
+        if (qFromLittleEndian<quint32>(header) != ColumnarLog::BLOCK_MAGIC || info.count == 0
+            || !info.layout.isValid() || end > size_) {
+            break;
+        }
+        if (version >= 2) {
+            const quint32 crc = Crc32::update(Crc32::compute(header, CHECKSUM_OFFSET),
+                                              header + ColumnarLog::BLOCK_HEADER_SIZE,
+                                              end - offset - ColumnarLog::BLOCK_HEADER_SIZE);
+            if (crc != qFromLittleEndian<quint32>(header + CHECKSUM_OFFSET)) {
+                break;
+            }
+        }
+
+        if (!blocks_.isEmpty() && info.first_ms < blocks_.last().last_ms) {
+            ordered_ = false;
+        }
+        blocks_.append(info);
+        record_count_ += info.count;
+        offset = end;
+    }
+    valid_bytes_ = offset;
+    truncated_ = offset != size_;
+    if (truncated_) {
+        qWarning() << "Columnar log has" << (size_ - offset) << "trailing bytes after block"
+                   << blocks_.size() << ":" << path;
+    }
+    return true;
+}
+
+void ColumnarLogReader::close() {
+    if (data_) {
+        file_.unmap(const_cast<uchar*>(data_));
+        data_ = nullptr;
+    }
+    if (file_.isOpen()) {
+        file_.close();
+    }
+    size_ = 0;
+    blocks_.clear();
+    record_count_ = 0;
+    valid_bytes_ = 0;
+    truncated_ = false;
+    ordered_ = true;
+}
+
+int ColumnarLogReader::decodeBlock(int block, SpeedLogRecord* out) const {
+    if (block < 0 || block >= blocks_.size()) {
+        return 0;
+    }
+
+    const BlockInfo& info = blocks_[block];
+    const ColumnarLog::BlockLayout& layout = info.layout;
+    const uchar* header = data_ + info.offset;
+    const int count = static_cast<int>(info.count);
+    const uchar* column = header + ColumnarLog::BLOCK_HEADER_SIZE;
+
+    // One pass per column keeps each inner loop free of width checks
+    auto store_time = [out](int i, qint64 value) { out[i].wall_ms = value; };
+    auto store_raw = [out](int i, qint32 value) { out[i].raw_speed = value / ColumnarLog::SPEED_SCALE; };
+    auto store_smoothed = [out](int i, qint32 value) {
+        out[i].smoothed_speed = value / ColumnarLog::SPEED_SCALE;
+    };
+
+    column = layout.time_width == 1
+        ? unpackColumn<quint8>(column, count, info.first_ms, store_time)
+        : unpackColumn<quint16>(column, count, info.first_ms, store_time);
+    const qint32 first_raw = qFromLittleEndian<qint32>(header + 24);
+    column = layout.raw_width == 1
+        ? unpackColumn<qint8>(column, count, first_raw, store_raw)
+        : unpackColumn<qint16>(column, count, first_raw, store_raw);
+    const qint32 first_smoothed = qFromLittleEndian<qint32>(header + 28);
+    column = layout.smoothed_width == 1
+        ? unpackColumn<qint8>(column, count, first_smoothed, store_smoothed)
+        : unpackColumn<qint16>(column, count, first_smoothed, store_smoothed);
+
+    for (int i = 0; i < count; ++i) {
+        out[i].state = layout.state_bits == 8 ? column[i] : (column[i / 2] >> (i % 2 * 4)) & 0x0f;
+    }
+    return count;
+}
+
+QVector<SpeedLogRecord> ColumnarLogReader::readBlock(int block) const {
+    if (block < 0 || block >= blocks_.size()) {
+        return {};
+    }
+    QVector<SpeedLogRecord> records(static_cast<int>(blocks_[block].count));
+    records.resize(decodeBlock(block, records.data()));
+    return records;
+}
+
+QVector<SpeedLogRecord> ColumnarLogReader::readAll() const {
+    QVector<SpeedLogRecord> records(static_cast<int>(record_count_));
+    SpeedLogRecord* out = records.data();
+    for (int i = 0; i < blocks_.size(); ++i) {
+        out += decodeBlock(i, out);
+    }
+    return records;
+}
+
+int ColumnarLogReader::firstBlockEndingAtOrAfter(qint64 from_ms) const {
+    if (!ordered_) {
+        return 0;
+    }
+    int low = 0;
+    int high = blocks_.size();
+    while (low < high) {
+        const int mid = low + (high - low) / 2;
+        if (blocks_[mid].last_ms < from_ms) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
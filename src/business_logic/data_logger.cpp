@@ -1,6 +1,10 @@
 #include "business_logic/data_logger.h"
+#include "business_logic/log_recovery.h"
 #include <QDir>
 #include <QDebug>
+#include <QFileInfo>
+#include <chrono>
+#include <unistd.h>
 
 DataLogger::DataLogger(const QString& log_dir, QObject* parent)
     : QObject(parent)
@@ -9,6 +13,14 @@ DataLogger::DataLogger(const QString& log_dir, QObject* parent)
     , log_stream_(nullptr)
     , enabled_(true)
     , max_file_size_(DEFAULT_MAX_SIZE)
+    , file_size_(0)
+    , records_in_file_(0)
+    , format_(Format::Csv)
+    , rotation_interval_(RotationInterval::None)
+    , next_rotation_ms_(0)
+    , time_index_bucket_ms_(0)
+    , writer_stop_(false)
+    , flush_interval_ms_(DEFAULT_FLUSH_INTERVAL_MS)
 {
     // Create log directory if it doesn't exist
     QDir dir;
@@ -24,7 +36,9 @@ DataLogger::DataLogger(const QString& log_dir, QObject* parent)
 }
 
 DataLogger::~DataLogger() {
+    stopWriter();
     closeLogFile();
+    waitForRetention();
     qInfo() << "DataLogger destroyed";
 }
 
@@ -38,8 +52,168 @@ void DataLogger::setMaxFileSize(qint64 size_bytes) {
     qInfo() << "Max log file size set to:" << size_bytes << "bytes";
 }
 
+void DataLogger::setRotationInterval(RotationInterval interval) {
+    rotation_interval_ = interval;
+    next_rotation_ms_ = nextRotationMs(QDateTime::currentMSecsSinceEpoch());
+    qInfo() << "Log rotation interval:"
+            << (interval == RotationInterval::Hourly ? "hourly"
+                : interval == RotationInterval::Daily ? "daily" : "none");
+}
+
+void DataLogger::setRetention(const LogRetention::Policy& policy) {
+    if (!retention_) {
+        const QStringList patterns{"speed_log_*.csv",
+                                   QString("speed_log_*.%1").arg(ColumnarLog::FILE_SUFFIX)};
+        retention_ = std::make_unique<LogRetention>(log_dir_, patterns);
+    }
+    retention_->setPolicy(policy);
+    
+    // The only directory scan; rotations keep the index up to date afterwards
+    waitForRetention();
+    const int files = retention_->scan(current_log_file_);
+    qInfo() << "Log retention: max files" << policy.max_files << "max bytes"
+            << policy.max_total_bytes << "max age" << policy.max_age_ms << "ms,"
+            << files << "existing files";
+    schedulePrune();
+}
+
+void DataLogger::waitForRetention() {
+    if (retention_thread_.joinable()) {
+        retention_thread_.join();
+    }
+}
+
+void DataLogger::setCommitPolicy(const CommitPolicy& policy) {
+    commit_policy_ = policy;
+    commit_policy_.max_records = qBound(0, policy.max_records, QUEUE_CAPACITY);
+    qInfo() << "Log commits:" << (policy.durable ? "durable" : "buffered")
+            << "max records" << commit_policy_.max_records;
+}
+
+int DataLogger::recoverLogFiles() {
+    const QStringList patterns{"speed_log_*.csv",
+                               QString("speed_log_*.%1").arg(ColumnarLog::FILE_SUFFIX)};
+    const QFileInfoList files = QDir(log_dir_).entryInfoList(patterns, QDir::Files);
+    const QString active = QFileInfo(current_log_file_).absoluteFilePath();
+    
+    int truncated = 0;
+    for (const QFileInfo& info : files) {
+        if (info.absoluteFilePath() == active) {
+            continue;
+        }
+        if (LogRecovery::recoverFile(info.absoluteFilePath()).truncated()) {
+            ++truncated;
+        }
+    }
+    qInfo() << "Log recovery checked" << files.size() << "files, truncated" << truncated;
+    return truncated;
+}
+
+void DataLogger::setTimeIndex(int bucket_ms) {
+    time_index_bucket_ms_ = qMax(0, bucket_ms);
+    if (time_index_) {
+        time_index_->close();
+        time_index_.reset();
+    }
+    unindexed_records_.clear();
+    openTimeIndex();
+    qInfo() << "Log time index:" << (time_index_bucket_ms_ > 0 ? "enabled" : "disabled")
+            << "bucket" << time_index_bucket_ms_ << "ms";
+}
+
+bool DataLogger::setFormat(Format format) {
+    if (writer_.joinable()) {
+        qWarning() << "Cannot change log format while the writer is running";
+        return false;
+    }
+    if (format == format_) {
+        return true;
+    }
+    
+    const QString previous_file = current_log_file_;
+    const bool previous_empty = records_in_file_ == 0;
+    closeLogFile();
+    if (previous_empty && !previous_file.isEmpty()) {
+        removeLogFile(previous_file);
+    }
+    
+    format_ = format;
+    openLogFile();
+    qInfo() << "Log format set to" << (format_ == Format::Columnar ? "columnar" : "csv");
+    return true;
+}
+
+bool DataLogger::setLogDirectory(const QString& log_dir) {
+    if (writer_.joinable()) {
+        qWarning() << "Cannot change log directory while the writer is running";
+        return false;
+    }
+    if (log_dir == log_dir_) {
+        return true;
+    }
+    
+    const QString previous_file = current_log_file_;
+    const bool previous_empty = records_in_file_ == 0;
+    closeLogFile();
+    if (previous_empty && !previous_file.isEmpty()) {
+        removeLogFile(previous_file);
+    }
+    
+    // The retention index belongs to the old directory
+    waitForRetention();
+    retention_.reset();
+    
+    log_dir_ = log_dir;
+    if (!QDir().mkpath(log_dir_)) {
+        qWarning() << "Failed to create log directory:" << log_dir_;
+    }
+    openLogFile();
+    qInfo() << "Log directory set to" << log_dir_;
+    return true;
+}
+
 void DataLogger::logSpeedData(double raw_speed, double smoothed_speed, ExpressionState state) {
-    if (!enabled_ || !log_stream_) {
+    logSpeedDataAt(raw_speed, smoothed_speed, state, QDateTime::currentMSecsSinceEpoch());
+}
+
+void DataLogger::logSpeedDataAt(double raw_speed, double smoothed_speed, ExpressionState state,
+                                qint64 wall_ms) {
+    if (!enabled_) {
+        return;
+    }
+    
+    // Async mode hands a fixed-size record to the writer thread and never blocks;
+    // the columnar writer only buffers it until its block is full
+    if (writer_.joinable() || format_ == Format::Columnar) {
+        SpeedLogRecord record;
+        record.wall_ms = wall_ms;
+        record.raw_speed = raw_speed;
+        record.smoothed_speed = smoothed_speed;
+        record.state = static_cast<quint8>(state);
+        if (writer_.joinable()) {
+            if (!queue_.tryPush(record)) {
+                dropped_records_.fetch_add(1, std::memory_order_relaxed);
+            }
+            // Lock-free notify; a wakeup lost to the race costs at most one interval
+            if (commit_policy_.max_records > 0
+                && queueDepth() >= commit_policy_.max_records) {
+                writer_wakeup_.notify_one();
+            }
+        } else if (columnar_writer_) {
+            checkAndRotate();
+            const qint64 offset = columnar_writer_->fileSize();
+            columnar_writer_->append(record);
+            ++records_in_file_;
+            if (time_index_) {
+                unindexed_records_.append(record);
+                indexWrittenRecords(offset);
+                time_index_->flush();
+            }
+        }
+        return;
+    }
+    
+    if (!log_stream_) {
         return;
     }
     
@@ -47,13 +221,26 @@ void DataLogger::logSpeedData(double raw_speed, double smoothed_speed, Expressio
     checkAndRotate();
     
     // Write log entry
-    QString timestamp = QDateTime::currentDateTime().toString(Qt::ISODate);
+    const QDateTime now = QDateTime::fromMSecsSinceEpoch(wall_ms);
+    const qint64 offset = log_file_->size();
+    QString timestamp = now.toString(Qt::ISODate);
     *log_stream_ << timestamp << ","
                 << raw_speed << ","
                 << smoothed_speed << ","
                 << stateToString(state) << "\n";
     
     log_stream_->flush();
+    ++records_in_file_;
+    
+    if (time_index_) {
+        SpeedLogRecord record;
+        record.wall_ms = wall_ms;
+        record.raw_speed = raw_speed;
+        record.smoothed_speed = smoothed_speed;
+        record.state = static_cast<quint8>(state);
+        time_index_->add(record, offset, log_file_->size());
+        time_index_->flush();
+    }
     
     qDebug() << "Logged:" << timestamp << raw_speed << smoothed_speed << stateToString(state);
 }
@@ -62,9 +249,32 @@ bool DataLogger::openLogFile() {
     closeLogFile();
     
     // Generate log file name with current date
-    QString filename = QString("speed_log_%1.csv")
-        .arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
-    current_log_file_ = log_dir_ + "/" + filename;
+    const QDateTime now = QDateTime::currentDateTime();
+    const QString stem = log_dir_ + "/speed_log_" + now.toString("yyyyMMdd_hhmmss");
+    const QString suffix = format_ == Format::Columnar ? ColumnarLog::FILE_SUFFIX : "csv";
+    current_log_file_ = stem + "." + suffix;
+    
+    // Several rotations within one second get numbered files
+    for (int n = 1; QFile::exists(current_log_file_); ++n) {
+        current_log_file_ = QString("%1_%2.%3").arg(stem).arg(n).arg(suffix);
+    }
+    records_in_file_ = 0;
+    next_rotation_ms_ = nextRotationMs(now.toMSecsSinceEpoch());
+    
+    if (format_ == Format::Columnar) {
+        auto writer = std::make_unique<ColumnarLogWriter>();
+        QString error;
+        if (!writer->open(current_log_file_, &error)) {
+            qCritical() << "Failed to open log file:" << current_log_file_ << error;
+            emit loggingError("Failed to open log file: " + current_log_file_);
+            return false;
+        }
+        columnar_writer_ = std::move(writer);
+        file_size_ = columnar_writer_->fileSize();
+        openTimeIndex();
+        qInfo() << "Opened columnar log file:" << current_log_file_;
+        return true;
+    }
     
     log_file_ = new QFile(current_log_file_);
     
@@ -82,12 +292,61 @@ bool DataLogger::openLogFile() {
     if (log_file_->size() == 0) {
         writeHeader();
     }
+    file_size_ = log_file_->size();
+    openTimeIndex();
     
     qInfo() << "Opened log file:" << current_log_file_;
     return true;
 }
 
+void DataLogger::openTimeIndex() {
+    if (time_index_bucket_ms_ <= 0 || current_log_file_.isEmpty()) {
+        return;
+    }
+    auto index = std::make_unique<LogTimeIndexWriter>(time_index_bucket_ms_);
+    if (!index->open(LogTimeIndex::indexPath(current_log_file_))) {
+        emit loggingError("Failed to open log index: " + LogTimeIndex::indexPath(current_log_file_));
+        return;
+    }
+    time_index_ = std::move(index);
+}
+
+void DataLogger::indexWrittenRecords(qint64 block_offset) {
+    const int written = unindexed_records_.size() - columnar_writer_->pendingRecords();
+    if (written <= 0) {
+        return;
+    }
+    
+    // Columnar offsets only bound the blocks; readers seek with the block index
+    const qint64 end_offset = columnar_writer_->fileSize();
+    for (int i = 0; i < written; ++i) {
+        time_index_->add(unindexed_records_.at(i), block_offset, end_offset);
+    }
+    unindexed_records_.remove(0, written);
+}
+
+void DataLogger::removeLogFile(const QString& path) {
+    QFile::remove(path);
+    QFile::remove(LogTimeIndex::indexPath(path));
+}
+
 void DataLogger::closeLogFile() {
+    if (columnar_writer_) {
+        const qint64 offset = columnar_writer_->fileSize();
+        columnar_writer_->close();
+        if (time_index_) {
+            indexWrittenRecords(offset);
+        }
+        columnar_writer_.reset();
+    }
+    unindexed_records_.clear();
+    
+    // After the log, so the last bucket only covers written rows
+    if (time_index_) {
+        time_index_->close();
+        time_index_.reset();
+    }
+    
     if (log_stream_) {
         log_stream_->flush();
         delete log_stream_;
@@ -102,36 +361,231 @@ void DataLogger::closeLogFile() {
 }
 
 void DataLogger::checkAndRotate() {
-    if (!log_file_) {
+    if (!log_file_ && !columnar_writer_) {
+        return;
+    }
+    
+    // Check file size and the time boundary
+    const qint64 size = columnar_writer_ ? columnar_writer_->fileSize() : log_file_->size();
+    if (size >= max_file_size_) {
+        qInfo() << "Log file size limit reached, rotating...";
+        rotateLogFile();
+    } else if (next_rotation_ms_ > 0 && QDateTime::currentMSecsSinceEpoch() >= next_rotation_ms_) {
+        qInfo() << "Log rotation interval reached, rotating...";
+        rotateLogFile();
+    }
+}
+
+void DataLogger::rotateLogFile() {
+    const QString old_file = current_log_file_;
+    const bool old_empty = records_in_file_ == 0;
+    
+    if (!openLogFile()) {
+        return;
+    }
+    
+    // A time-based rotation with nothing logged would leave a header-only file
+    if (old_empty) {
+        removeLogFile(old_file);
+    } else if (retention_) {
+        retention_->addFile(old_file, QFileInfo(old_file).size(), QDateTime::currentMSecsSinceEpoch());
+        schedulePrune();
+    }
+    
+    emit logFileRotated(current_log_file_);
+    qInfo() << "Rotated from" << old_file << "to" << current_log_file_;
+}
+
+void DataLogger::schedulePrune() {
+    if (!retention_) {
+        return;
+    }
+    
+    // Rotations are minutes apart; the previous prune has long finished
+    waitForRetention();
+    const qint64 active_bytes = file_size_;
+    retention_thread_ = std::thread([this, active_bytes]() {
+        const QStringList removed = retention_->prune(QDateTime::currentMSecsSinceEpoch(), active_bytes);
+        for (const QString& path : removed) {
+            QFile::remove(LogTimeIndex::indexPath(path));
+        }
+        if (!removed.isEmpty()) {
+            qInfo() << "Removed" << removed.size() << "old log files," << retention_->fileCount()
+                    << "kept," << retention_->totalBytes() << "bytes";
+            emit logFilesRemoved(removed);
+        }
+    });
+}
+
+qint64 DataLogger::nextRotationMs(qint64 now_ms) const {
+    const QDateTime now = QDateTime::fromMSecsSinceEpoch(now_ms);
+    switch (rotation_interval_) {
+        case RotationInterval::Hourly:
+            return QDateTime(now.date(), QTime(now.time().hour(), 0)).addSecs(3600).toMSecsSinceEpoch();
+        case RotationInterval::Daily:
+            return QDateTime(now.date().addDays(1), QTime(0, 0)).toMSecsSinceEpoch();
+        default:
+            return 0;
+    }
+}
+
+bool DataLogger::startWriter(int flush_interval_ms) {
+    if (writer_.joinable()) {
+        qWarning() << "DataLogger writer already running";
+        return false;
+    }
+    if (flush_interval_ms <= 0) {
+        qWarning() << "Invalid log flush interval:" << flush_interval_ms << "ms";
+        return false;
+    }
+    
+    flush_interval_ms_ = flush_interval_ms;
+    writer_stop_ = false;
+    max_queue_depth_.store(0, std::memory_order_relaxed);
+    writer_ = std::thread(&DataLogger::writerLoop, this);
+    
+    qInfo() << "DataLogger writer started, flush interval:" << flush_interval_ms_ << "ms";
+    return true;
+}
+
+void DataLogger::stopWriter() {
+    if (!writer_.joinable()) {
         return;
     }
     
-    // Check file size
-    if (log_file_->size() >= max_file_size_) {
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        writer_stop_ = true;
+    }
+    writer_wakeup_.notify_one();
+    writer_.join();
+    
+    qInfo() << "DataLogger writer stopped - written:" << writtenRecords()
+            << "dropped:" << droppedRecords() << "max queue depth:" << maxQueueDepth()
+            << "commits:" << commits();
+}
+
+void DataLogger::writerLoop() {
+    std::unique_lock<std::mutex> lock(writer_mutex_);
+    bool stop = false;
+    while (!stop) {
+        writer_wakeup_.wait_for(lock, std::chrono::milliseconds(flush_interval_ms_), [this]() {
+            return writer_stop_ || (commit_policy_.max_records > 0
+                                    && queueDepth() >= commit_policy_.max_records);
+        });
+        // A stop requested before the first wait still drains the queue once
+        stop = writer_stop_;
+        
+        // File I/O happens without the lock; stopWriter() only needs it to set the flag
+        lock.unlock();
+        drainQueue();
+        lock.lock();
+    }
+}
+
+void DataLogger::drainQueue() {
+    const int depth = queueDepth();
+    if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+        max_queue_depth_.store(depth, std::memory_order_relaxed);
+    }
+    
+    QByteArray batch;
+    batch.reserve(depth * 48);
+    quint64 count = 0;
+    SpeedLogRecord record;
+    while (queue_.tryPop(record)) {
+        // Records past the time boundary go to the next file
+        if (next_rotation_ms_ > 0 && record.wall_ms >= next_rotation_ms_) {
+            writeBatch(batch, count);
+            count = 0;
+            qInfo() << "Log rotation interval reached, rotating...";
+            rotateLogFile();
+        }
+        
+        // Columnar: the writer buffers a block and writes it when full
+        if (columnar_writer_) {
+            const qint64 offset = columnar_writer_->fileSize();
+            if (!columnar_writer_->append(record)) {
+                emit loggingError("Failed to write log file: " + current_log_file_);
+            }
+            if (time_index_) {
+                unindexed_records_.append(record);
+                indexWrittenRecords(offset);
+            }
+        } else {
+            const qint64 offset = file_size_ + batch.size();
+            csv_formatter_.appendRow(batch, record);
+            if (time_index_) {
+                time_index_->add(record, offset, file_size_ + batch.size());
+            }
+        }
+        ++count;
+    }
+    writeBatch(batch, count);
+    
+    if (file_size_ >= max_file_size_) {
         qInfo() << "Log file size limit reached, rotating...";
-        QString old_file = current_log_file_;
+        rotateLogFile();
+    }
+}
+
+void DataLogger::writeBatch(QByteArray& batch, quint64 count) {
+    if (count == 0) {
+        return;
+    }
+    
+    bool ok = true;
+    if (columnar_writer_) {
+        // Durable: the batch becomes its own checksummed block
+        if (commit_policy_.durable) {
+            const qint64 offset = columnar_writer_->fileSize();
+            ok = columnar_writer_->sync();
+            if (time_index_) {
+                indexWrittenRecords(offset);
+            }
+        }
+        file_size_ = columnar_writer_->fileSize();
+    } else if (log_file_) {
+        if (commit_policy_.durable) {
+            batch += LogRecovery::commitMarker(count, batch);
+        }
         
-        if (openLogFile()) {
-            emit logFileRotated(current_log_file_);
-            qInfo() << "Rotated from" << old_file << "to" << current_log_file_;
+        // One write and one flush per batch; size is tracked instead of queried
+        const qint64 written = log_file_->write(batch);
+        ok = log_file_->flush() && written == batch.size();
+        if (ok && commit_policy_.durable) {
+            ok = ::fdatasync(log_file_->handle()) == 0;
+        }
+        batch.truncate(0);
+        if (written < 0) {
+            emit loggingError("Failed to write log file: " + current_log_file_);
+            return;
         }
+        file_size_ += written;
+    } else {
+        return;
     }
+    
+    if (!ok) {
+        emit loggingError("Failed to commit log file: " + current_log_file_);
+    }
+    
+    // Buckets closed by this batch; their rows are on disk now
+    if (time_index_) {
+        time_index_->flush();
+    }
+    records_in_file_ += count;
+    commits_.fetch_add(1, std::memory_order_relaxed);
+    written_records_.fetch_add(count, std::memory_order_relaxed);
 }
 
 void DataLogger::writeHeader() {
     if (log_stream_) {
-        *log_stream_ << "timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state\n";
+        *log_stream_ << SpeedLogCsvFormatter::HEADER;
         log_stream_->flush();
     }
 }
 
 QString DataLogger::stateToString(ExpressionState state) const {
-    switch (state) {
-        case ExpressionState::RELAXED: return "RELAXED";
-        case ExpressionState::NORMAL: return "NORMAL";
-        case ExpressionState::ALERT: return "ALERT";
-        case ExpressionState::WARNING: return "WARNING";
-        case ExpressionState::SCARED: return "SCARED";
-        default: return "UNKNOWN";
-    }
+    return QString::fromLatin1(SpeedLogCsvFormatter::stateName(static_cast<quint8>(state)));
 }
@@ -1,23 +1,31 @@
 #include "business_logic/expression_state_machine.h"
 #include <QDebug>
+#include <chrono>
+
+namespace {
+
+constexpr int EXPRESSION_COUNT = 5;
+
+const char* const EXPRESSION_NAMES[EXPRESSION_COUNT] = {
+    "relaxed", "normal", "alert", "warning", "scared"
+};
+
+}  // namespace
 
 ExpressionStateMachine::ExpressionStateMachine(QObject* parent)
     : QObject(parent)
+    , current_band_(0)
     , current_state_(ExpressionState::RELAXED)
-    , relaxed_max_(20.0)
-    , normal_max_(60.0)
-    , alert_max_(100.0)
-    , warning_max_(120.0)
-    , last_speed_(0.0)
 {
+    setBands(SpeedBandTable::defaultBands());
 }
 
 void ExpressionStateMachine::setThresholds(double relaxed, double normal, 
                                            double alert, double warning) {
-    relaxed_max_ = relaxed;
-    normal_max_ = normal;
-    alert_max_ = alert;
-    warning_max_ = warning;
+    if (!setBands(SpeedBandTable::defaultBands(relaxed, normal, alert, warning,
+                                               hysteresis_margin_))) {
+        return;
+    }
     
     qInfo() << "Speed thresholds set:" 
             << "relaxed=" << relaxed
@@ -26,48 +34,97 @@ void ExpressionStateMachine::setThresholds(double relaxed, double normal,
             << "warning=" << warning;
 }
 
-void ExpressionStateMachine::updateSpeed(double speed) {
-    ExpressionState new_state = determineState(speed);
+bool ExpressionStateMachine::setBands(const QVector<SpeedBand>& bands) {
+    QString error;
+    if (!band_table_.setBands(bands, &error)) {
+        qWarning() << "Invalid expression bands:" << error;
+        return false;
+    }
     
-    if (new_state != current_state_) {
-        ExpressionState old_state = current_state_;
-        setState(new_state);
-        emit stateChanged(old_state, new_state);
-        emit stateStringChanged(getStateString());
+    band_expressions_.clear();
+    const int count = band_table_.bandCount();
+    for (int band = 0; band < count; ++band) {
+        int expression = -1;
+        for (int i = 0; i < EXPRESSION_COUNT; ++i) {
+            if (band_table_.bandName(band) == EXPRESSION_NAMES[i]) {
+                expression = i;
+            }
+        }
+        if (expression < 0) {
+            // Spread unnamed bands over the five expressions
+            expression = count > 1 ? (band * (EXPRESSION_COUNT - 1) + (count - 1) / 2) / (count - 1)
+                                   : 0;
+        }
+        band_expressions_.append(static_cast<ExpressionState>(expression));
     }
     
-    last_speed_ = speed;
+    // Re-evaluate against the new table on the next sample; a change
+    // pending under the old table must not commit against this one
+    const int band = qMin(current_band_, count - 1);
+    tracker_.reset(band);
+    qInfo() << "Expression bands:" << count;
+    
+    // The same band index may map to a different expression now
+    setBand(band);
+    return true;
+}
+
+void ExpressionStateMachine::setHysteresisMode(HysteresisMode mode) {
+    tracker_.setMode(mode);
+    qInfo() << "Expression hysteresis:"
+            << (mode == HysteresisMode::Symmetric ? "symmetric" : "directional");
+}
+
+void ExpressionStateMachine::setMinDwellMs(int dwell_ms) {
+    if (dwell_ms < 0) {
+        qWarning() << "Invalid dwell time:" << dwell_ms << "ms";
+        return;
+    }
+    tracker_.setMinDwellNs(static_cast<qint64>(dwell_ms) * 1000000);
+    qInfo() << "Expression minimum dwell:" << dwell_ms << "ms";
 }
 
-ExpressionState ExpressionStateMachine::determineState(double speed) const {
-    // Apply hysteresis to prevent rapid state changes
-    double margin = (speed > last_speed_) ? 0 : hysteresis_margin_;
+void ExpressionStateMachine::updateSpeed(double speed) {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    updateSpeed(speed, std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+void ExpressionStateMachine::updateSpeed(double speed, qint64 timestamp_ns) {
+    const int new_band = tracker_.update(band_table_, speed, timestamp_ns);
     
-    if (speed <= relaxed_max_ + margin) {
-        return ExpressionState::RELAXED;
-    } else if (speed <= normal_max_ + margin) {
-        return ExpressionState::NORMAL;
-    } else if (speed <= alert_max_ + margin) {
-        return ExpressionState::ALERT;
-    } else if (speed <= warning_max_ + margin) {
-        return ExpressionState::WARNING;
-    } else {
-        return ExpressionState::SCARED;
+    if (new_band != current_band_) {
+        setBand(new_band);
     }
 }
 
-void ExpressionStateMachine::setState(ExpressionState new_state) {
-    current_state_ = new_state;
-    qDebug() << "State changed to:" << getStateString();
+QVector<int> ExpressionStateMachine::classify(const QVector<double>& speeds,
+                                              const QVector<qint64>& timestamps_ns) const {
+    return tracker_.classify(band_table_, speeds, timestamps_ns);
 }
 
-QString ExpressionStateMachine::getStateString() const {
-    switch (current_state_) {
-        case ExpressionState::RELAXED: return "relaxed";
-        case ExpressionState::NORMAL: return "normal";
-        case ExpressionState::ALERT: return "alert";
-        case ExpressionState::WARNING: return "warning";
-        case ExpressionState::SCARED: return "scared";
-        default: return "unknown";
+ExpressionState ExpressionStateMachine::expressionForBand(int band) const {
+    return band >= 0 && band < band_expressions_.size() ? band_expressions_[band]
+                                                       : ExpressionState::RELAXED;
+}
+
+void ExpressionStateMachine::setBand(int new_band) {
+    const int old_band = current_band_;
+    const ExpressionState old_state = current_state_;
+    
+    current_band_ = new_band;
+    current_state_ = expressionForBand(new_band);
+    
+    if (current_band_ != old_band) {
+        qDebug() << "Band changed to:" << currentBandName();
+        emit bandChanged(old_band, new_band);
+    }
+    if (current_state_ != old_state) {
+        qDebug() << "State changed to:" << getStateString();
+        emit stateChanged(old_state, current_state_);
+        emit stateStringChanged(getStateString());
     }
 }
+
+QString ExpressionStateMachine::getStateString() const {
+    return EXPRESSION_NAMES[static_cast<int>(current_state_)];
+}
@@ -0,0 +1,140 @@
+#include "business_logic/log_recovery.h"
+#include "business_logic/columnar_log.h"
+#include "common/crc32.h"
+#include <QDebug>
+#include <QFile>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool startsWith(const char* data, qint64 length, const char* prefix) {
+    const qint64 prefix_length = static_cast<qint64>(std::strlen(prefix));
+    return length >= prefix_length && std::memcmp(data, prefix, prefix_length) == 0;
+}
+
+// Record count and checksum of a marker line, or false if the line is not a marker
+bool parseMarker(const char* line, qint64 length, quint64* records, quint32* crc) {
+    if (!startsWith(line, length, LogRecovery::COMMIT_PREFIX)) {
+        return false;
+    }
+    const QByteArray text(line, static_cast<int>(length));
+    const QList<QByteArray> fields = text.split(',');
+    if (fields.size() != 3) {
+        return false;
+    }
+    bool records_ok = false;
+    bool crc_ok = false;
+    *records = fields[1].toULongLong(&records_ok);
+    *crc = fields[2].toUInt(&crc_ok, 16);
+    return records_ok && crc_ok;
+}
+
+// A complete data row: four fields, not a comment
+bool isRow(const char* line, qint64 length) {
+    if (length == 0 || line[0] == '#') {
+        return false;
+    }
+    return std::count(line, line + length, ',') == 3;
+}
+
+} // namespace
+
+QByteArray LogRecovery::commitMarker(quint64 records, const QByteArray& rows) {
+    const quint32 crc = Crc32::compute(rows.constData(), static_cast<std::size_t>(rows.size()));
+    return QByteArray(COMMIT_PREFIX) + QByteArray::number(records) + ','
+        + QByteArray::number(crc, 16).rightJustified(8, '0') + '\n';
+}
+
+qint64 LogRecovery::validCsvBytes(const QByteArray& data) {
+    const char* bytes = data.constData();
+    const qint64 size = data.size();
+
+    // The header line is never part of a commit
+    const qint64 header_end = data.indexOf('\n') + 1;
+    if (header_end <= 0) {
+        return 0;
+    }
+
+    // A marker covers the rows of its own batch only. Rows written without
+    // durable commits (buffered writer, synchronous logging) may precede or
+    // follow a commit in the same file; they are kept as long as they are
+    // complete rows.
+    QVector<qint64> row_starts;         // Rows since the previous marker
+    qint64 valid_end = header_end;
+    qint64 pos = header_end;
+    while (pos < size) {
+        const char* newline = static_cast<const char*>(std::memchr(bytes + pos, '\n', size - pos));
+        if (!newline) {
+            break;
+        }
+        const qint64 length = newline - (bytes + pos);
+        if (std::memchr(bytes + pos, '\0', length)) {
+            break;
+        }
+
+        quint64 records = 0;
+        quint32 crc = 0;
+        if (parseMarker(bytes + pos, length, &records, &crc)) {
+            // A commit that does not verify is dropped together with its rows
+            if (records == 0 || records > static_cast<quint64>(row_starts.size())) {
+                return row_starts.isEmpty() ? valid_end : row_starts.first();
+            }
+            const qint64 batch_start = row_starts.at(row_starts.size() - static_cast<int>(records));
+            if (Crc32::compute(bytes + batch_start, pos - batch_start) != crc) {
+                return batch_start;
+            }
+            row_starts.clear();
+        } else if (isRow(bytes + pos, length)) {
+            row_starts.append(pos);
+        } else {
+            break;
+        }
+        pos += length + 1;
+        valid_end = pos;
+    }
+    return valid_end;
+}
+
+LogRecovery::Result LogRecovery::recoverFile(const QString& path) {
+    Result result;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Cannot open log file for recovery:" << path;
+        result.ok = false;
+        return result;
+    }
+    result.original_bytes = file.size();
+    result.recovered_bytes = result.original_bytes;
+
+    if (path.endsWith(QString(".") + ColumnarLog::FILE_SUFFIX)) {
+        ColumnarLogReader reader;
+        if (!reader.open(path)) {
+            result.ok = false;
+            return result;
+        }
+        result.recovered_bytes = reader.validBytes();
+    } else {
+        // A complete last line without NUL fill means nothing was torn
+        const qint64 tail = qMin<qint64>(result.original_bytes, TAIL_CHECK_BYTES);
+        file.seek(result.original_bytes - tail);
+        const QByteArray end = file.read(tail);
+        if (end.isEmpty() || (end.endsWith('\n') && !end.contains('\0'))) {
+            return result;
+        }
+        file.seek(0);
+        result.recovered_bytes = validCsvBytes(file.readAll());
+    }
+
+    if (result.truncated()) {
+        if (!file.resize(result.recovered_bytes)) {
+            qWarning() << "Failed to truncate torn log file:" << path;
+            result.ok = false;
+            return result;
+        }
+        qWarning() << "Recovered torn log file:" << path << result.original_bytes << "->"
+                   << result.recovered_bytes << "bytes";
+    }
+    return result;
+}
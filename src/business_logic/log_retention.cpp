@@ -0,0 +1,143 @@
+#include "business_logic/log_retention.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+
+LogRetention::LogRetention(const QString& dir, const QStringList& name_filters)
+    : dir_(dir)
+    , name_filters_(name_filters)
+{
+}
+
+void LogRetention::setPolicy(const Policy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+    policy_.max_files = qMax(policy_.max_files, 0);
+    policy_.max_total_bytes = qMax<qint64>(policy_.max_total_bytes, 0);
+    policy_.max_age_ms = qMax<qint64>(policy_.max_age_ms, 0);
+}
+
+LogRetention::Policy LogRetention::policy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+int LogRetention::scan(const QString& exclude) {
+    const QFileInfoList files = QDir(dir_).entryInfoList(name_filters_, QDir::Files);
+    const QString excluded = exclude.isEmpty() ? QString() : QFileInfo(exclude).absoluteFilePath();
+
+    std::deque<Entry> entries;
+    qint64 total_bytes = 0;
+    for (const QFileInfo& info : files) {
+        if (info.absoluteFilePath() == excluded) {
+            continue;
+        }
+        entries.push_back({info.absoluteFilePath(), info.size(),
+                           info.lastModified().toMSecsSinceEpoch()});
+        total_bytes += info.size();
+    }
+
+    // Names carry the start time, so they break ties between equal mtimes
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.modified_ms != b.modified_ms ? a.modified_ms < b.modified_ms : a.path < b.path;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_ = std::move(entries);
+    total_bytes_ = total_bytes;
+    return static_cast<int>(entries_.size());
+}
+
+void LogRetention::addFile(const QString& path, qint64 size, qint64 modified_ms) {
+    const QString absolute = QFileInfo(path).absoluteFilePath();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Reopening a file (same start second) must not index it twice
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->path == absolute) {
+            total_bytes_ -= it->size;
+            entries_.erase(it);
+            break;
+        }
+    }
+    entries_.push_back({absolute, size, modified_ms});
+    total_bytes_ += size;
+}
+
+int LogRetention::expiredCount(qint64 now_ms, qint64 active_bytes) const {
+    int count = 0;
+    int files = static_cast<int>(entries_.size()) + 1;   // plus the active file
+    qint64 bytes = total_bytes_ + active_bytes;
+
+    for (const Entry& entry : entries_) {
+        const bool too_many = policy_.max_files > 0 && files > policy_.max_files;
+        const bool too_big = policy_.max_total_bytes > 0 && bytes > policy_.max_total_bytes;
+        const bool too_old = policy_.max_age_ms > 0 && now_ms - entry.modified_ms > policy_.max_age_ms;
+        if (!too_many && !too_big && !too_old) {
+            break;
+        }
+        ++count;
+        --files;
+        bytes -= entry.size;
+    }
+    return count;
+}
+
+QStringList LogRetention::selectExpired(qint64 now_ms, qint64 active_bytes) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int count = expiredCount(now_ms, active_bytes);
+
+    QStringList paths;
+    for (int i = 0; i < count; ++i) {
+        paths.append(entries_[i].path);
+    }
+    return paths;
+}
+
+QStringList LogRetention::prune(qint64 now_ms, qint64 active_bytes) {
+    std::deque<Entry> expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const int count = expiredCount(now_ms, active_bytes);
+        for (int i = 0; i < count; ++i) {
+            total_bytes_ -= entries_.front().size;
+            expired.push_back(std::move(entries_.front()));
+            entries_.pop_front();
+        }
+    }
+
+    // Deleting happens without the lock; a file that cannot be removed is
+    // dropped from the index anyway so it is not retried on every rotation
+    QStringList removed;
+    for (const Entry& entry : expired) {
+        if (QFile::remove(entry.path) || !QFile::exists(entry.path)) {
+            removed.append(entry.path);
+        } else {
+            qWarning() << "Failed to remove old log file:" << entry.path;
+        }
+    }
+    return removed;
+}
+
+int LogRetention::fileCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(entries_.size());
+}
+
+qint64 LogRetention::totalBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_bytes_;
+}
+
+QVector<LogRetention::Entry> LogRetention::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    QVector<Entry> entries;
+    entries.reserve(static_cast<int>(entries_.size()));
+    for (const Entry& entry : entries_) {
+        entries.append(entry);
+    }
+    return entries;
+}
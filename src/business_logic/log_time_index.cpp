@@ -0,0 +1,267 @@
+#include "business_logic/log_time_index.h"
+#include "business_logic/speed_log_csv_scanner.h"
+#include <QDebug>
+#include <QtEndian>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Floor division, so buckets before 1970 do not straddle zero
+qint64 bucketKey(qint64 wall_ms, int bucket_ms) {
+    const qint64 key = wall_ms / bucket_ms;
+    return (wall_ms % bucket_ms < 0) ? key - 1 : key;
+}
+
+void encodeBucket(const LogTimeIndex::Bucket& bucket, uchar* out) {
+    const SpeedAggregate& stats = bucket.stats;
+    std::memset(out, 0, LogTimeIndex::ENTRY_SIZE);
+    qToLittleEndian<qint64>(stats.first_ms, out);
+    qToLittleEndian<qint64>(stats.last_ms, out + 8);
+    qToLittleEndian<qint64>(bucket.offset, out + 16);
+    qToLittleEndian<qint64>(bucket.end_offset, out + 24);
+    qToLittleEndian<quint32>(static_cast<quint32>(stats.count), out + 32);
+    qToLittleEndian<qint32>(stats.min_raw, out + 36);
+    qToLittleEndian<qint32>(stats.max_raw, out + 40);
+    qToLittleEndian<qint32>(stats.min_smoothed, out + 44);
+    qToLittleEndian<qint32>(stats.max_smoothed, out + 48);
+    qToLittleEndian<qint64>(stats.sum_raw, out + 56);
+    qToLittleEndian<qint64>(stats.sum_smoothed, out + 64);
+    for (int i = 0; i < SpeedAggregate::STATE_SLOTS; ++i) {
+        qToLittleEndian<quint32>(static_cast<quint32>(stats.state_counts[i]), out + 72 + i * 4);
+    }
+}
+
+LogTimeIndex::Bucket decodeBucket(const uchar* in) {
+    LogTimeIndex::Bucket bucket;
+    SpeedAggregate& stats = bucket.stats;
+    stats.first_ms = qFromLittleEndian<qint64>(in);
+    stats.last_ms = qFromLittleEndian<qint64>(in + 8);
+    bucket.offset = qFromLittleEndian<qint64>(in + 16);
+    bucket.end_offset = qFromLittleEndian<qint64>(in + 24);
+    stats.count = qFromLittleEndian<quint32>(in + 32);
+    stats.min_raw = qFromLittleEndian<qint32>(in + 36);
+    stats.max_raw = qFromLittleEndian<qint32>(in + 40);
+    stats.min_smoothed = qFromLittleEndian<qint32>(in + 44);
+    stats.max_smoothed = qFromLittleEndian<qint32>(in + 48);
+    stats.sum_raw = qFromLittleEndian<qint64>(in + 56);
+    stats.sum_smoothed = qFromLittleEndian<qint64>(in + 64);
+    for (int i = 0; i < SpeedAggregate::STATE_SLOTS; ++i) {
+        stats.state_counts[i] = qFromLittleEndian<quint32>(in + 72 + i * 4);
+    }
+    return bucket;
+}
+
+} // namespace
+
+void SpeedAggregate::add(const SpeedLogRecord& record) {
+    const qint32 raw = ColumnarLog::toCentiKmh(record.raw_speed);
+    const qint32 smoothed = ColumnarLog::toCentiKmh(record.smoothed_speed);
+    if (count == 0) {
+        first_ms = last_ms = record.wall_ms;
+        min_raw = max_raw = raw;
+        min_smoothed = max_smoothed = smoothed;
+    } else {
+        first_ms = qMin(first_ms, record.wall_ms);
+        last_ms = qMax(last_ms, record.wall_ms);
+        min_raw = qMin(min_raw, raw);
+        max_raw = qMax(max_raw, raw);
+        min_smoothed = qMin(min_smoothed, smoothed);
+        max_smoothed = qMax(max_smoothed, smoothed);
+    }
+    ++count;
+    sum_raw += raw;
+    sum_smoothed += smoothed;
+    ++state_counts[qMin<int>(record.state, STATE_SLOTS - 1)];
+}
+
+void SpeedAggregate::merge(const SpeedAggregate& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    first_ms = qMin(first_ms, other.first_ms);
+    last_ms = qMax(last_ms, other.last_ms);
+    min_raw = qMin(min_raw, other.min_raw);
+    max_raw = qMax(max_raw, other.max_raw);
+    min_smoothed = qMin(min_smoothed, other.min_smoothed);
+    max_smoothed = qMax(max_smoothed, other.max_smoothed);
+    count += other.count;
+    sum_raw += other.sum_raw;
+    sum_smoothed += other.sum_smoothed;
+    for (int i = 0; i < STATE_SLOTS; ++i) {
+        state_counts[i] += other.state_counts[i];
+    }
+}
+
+bool LogTimeIndex::load(const QString& index_path) {
+    buckets_.clear();
+    QFile file(index_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    const auto* bytes = reinterpret_cast<const uchar*>(data.constData());
+    if (data.size() < HEADER_SIZE || std::memcmp(bytes, FILE_MAGIC, 4) != 0
+        || qFromLittleEndian<quint16>(bytes + 4) != VERSION) {
+        qWarning() << "Invalid log index:" << index_path;
+        return false;
+    }
+    const int header_size = qFromLittleEndian<quint16>(bytes + 6);
+    bucket_ms_ = static_cast<int>(qFromLittleEndian<quint32>(bytes + 8));
+    if (header_size < HEADER_SIZE || header_size > data.size() || bucket_ms_ <= 0) {
+        qWarning() << "Invalid log index:" << index_path;
+        return false;
+    }
+
+    const int count = (data.size() - header_size) / ENTRY_SIZE;
+    buckets_.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        buckets_.append(decodeBucket(bytes + header_size + i * ENTRY_SIZE));
+    }
+    return true;
+}
+
+bool LogTimeIndex::build(const QString& log_path, int bucket_ms) {
+    buckets_.clear();
+    bucket_ms_ = bucket_ms;
+    LogTimeIndexWriter writer(bucket_ms);
+
+    if (log_path.endsWith(QString(".") + ColumnarLog::FILE_SUFFIX)) {
+        ColumnarLogReader reader;
+        if (!reader.open(log_path) || !writer.open(indexPath(log_path))) {
+            return false;
+        }
+        const QVector<ColumnarLogReader::BlockInfo>& blocks = reader.blocks();
+        std::vector<SpeedLogRecord> records;
+        for (int i = 0; i < blocks.size(); ++i) {
+            const qint64 end = i + 1 < blocks.size() ? blocks[i + 1].offset : reader.validBytes();
+            records.resize(blocks[i].count);
+            const int count = reader.decodeBlock(i, records.data());
+            for (int j = 0; j < count; ++j) {
+                writer.add(records[j], blocks[i].offset, end);
+            }
+        }
+    } else {
+        QFile file(log_path);
+        if (!file.open(QIODevice::ReadOnly) || !writer.open(indexPath(log_path))) {
+            return false;
+        }
+        // An incomplete last row is left for the next build
+        const QByteArray data = file.readAll();
+        SpeedLogCsvScanner scanner;
+        scanner.scan(data.constData(), data.size(),
+                     [&writer](const SpeedLogRecord& record, qint64 offset, qint64 end) {
+            writer.add(record, offset, end);
+        });
+    }
+
+    writer.close();
+    return load(indexPath(log_path));
+}
+
+qint64 LogTimeIndex::indexedBytes() const {
+    qint64 end = 0;
+    for (const Bucket& bucket : buckets_) {
+        end = qMax(end, bucket.end_offset);
+    }
+    return end;
+}
+
+void LogTimeIndex::clampTo(qint64 log_size) {
+    // Buckets are in file order, so everything after the first bad one goes too
+    for (int i = 0; i < buckets_.size(); ++i) {
+        if (buckets_[i].end_offset > log_size) {
+            buckets_.resize(i);
+            return;
+        }
+    }
+}
+
+LogTimeIndexWriter::LogTimeIndexWriter(int bucket_ms)
+    : bucket_ms_(qMax(1, bucket_ms))
+{
+}
+
+LogTimeIndexWriter::~LogTimeIndexWriter() {
+    close();
+}
+
+bool LogTimeIndexWriter::open(const QString& index_path) {
+    close();
+    file_.setFileName(index_path);
+    if (!file_.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to open log index:" << index_path << file_.errorString();
+        return false;
+    }
+
+    uchar header[LogTimeIndex::HEADER_SIZE] = {};
+    std::memcpy(header, LogTimeIndex::FILE_MAGIC, 4);
+    qToLittleEndian<quint16>(LogTimeIndex::VERSION, header + 4);
+    qToLittleEndian<quint16>(LogTimeIndex::HEADER_SIZE, header + 6);
+    qToLittleEndian<quint32>(static_cast<quint32>(bucket_ms_), header + 8);
+    if (file_.write(reinterpret_cast<const char*>(header), sizeof(header)) != sizeof(header)) {
+        qWarning() << "Failed to write log index:" << index_path << file_.errorString();
+        file_.close();
+        return false;
+    }
+    has_open_ = false;
+    closed_.clear();
+    buckets_written_ = 0;
+    return true;
+}
+
+void LogTimeIndexWriter::close() {
+    if (!file_.isOpen()) {
+        return;
+    }
+    if (has_open_) {
+        closed_.append(open_);
+        has_open_ = false;
+    }
+    flush();
+    file_.close();
+}
+
+void LogTimeIndexWriter::add(const SpeedLogRecord& record, qint64 offset, qint64 end_offset) {
+    const qint64 key = bucketKey(record.wall_ms, bucket_ms_);
+    if (has_open_ && key != bucket_key_) {
+        closed_.append(open_);
+        has_open_ = false;
+    }
+    if (!has_open_) {
+        open_ = LogTimeIndex::Bucket();
+        open_.offset = offset;
+        bucket_key_ = key;
+        has_open_ = true;
+    }
+    open_.end_offset = end_offset;
+    open_.stats.add(record);
+}
+
+bool LogTimeIndexWriter::flush() {
+    if (closed_.isEmpty() || !file_.isOpen()) {
+        return true;
+    }
+    const bool ok = write(closed_);
+    closed_.clear();
+    return ok;
+}
+
+bool LogTimeIndexWriter::write(const QVector<LogTimeIndex::Bucket>& buckets) {
+    QByteArray data(buckets.size() * LogTimeIndex::ENTRY_SIZE, '\0');
+    auto* out = reinterpret_cast<uchar*>(data.data());
+    for (const LogTimeIndex::Bucket& bucket : buckets) {
+        encodeBucket(bucket, out);
+        out += LogTimeIndex::ENTRY_SIZE;
+    }
+    if (file_.write(data) != data.size() || !file_.flush()) {
+        qWarning() << "Failed to write log index:" << file_.fileName() << file_.errorString();
+        return false;
+    }
+    buckets_written_ += static_cast<quint64>(buckets.size());
+    return true;
+}
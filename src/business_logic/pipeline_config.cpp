@@ -0,0 +1,61 @@
+#include "business_logic/pipeline_config.h"
+#include "business_logic/expression_state_machine.h"
+#include "business_logic/speed_monitor.h"
+#include <QDebug>
+
+SpeedFilter PipelineConfig::makeSpeedFilter(const ConfigurationManager::SmoothingConfig& config) {
+    if (config.filter == EmaFilter::NAME) {
+        return EmaFilter(config.ema_time_constant_ms / 1000.0);
+    }
+    if (config.filter == MedianFilter::NAME) {
+        return MedianFilter();
+    }
+    if (config.filter == OneEuroFilter::NAME) {
+        return OneEuroFilter(config.one_euro_min_cutoff_hz, config.one_euro_beta);
+    }
+    if (config.filter == KalmanFilter::NAME) {
+        return KalmanFilter(config.kalman_process_noise, config.kalman_measurement_noise);
+    }
+    if (config.filter != MovingAverageFilter::NAME) {
+        qWarning() << "Unknown smoothing filter" << config.filter << "- using moving average";
+    }
+    return MovingAverageFilter();
+}
+
+void PipelineConfig::applySmoothing(const ConfigurationManager& config, SpeedMonitor& monitor) {
+    const auto smoothing = config.getSmoothingConfig();
+    monitor.setWindowSize(smoothing.window_size);
+    monitor.setFilter(makeSpeedFilter(smoothing));
+    monitor.setHorizonMs(smoothing.horizon_ms);
+    monitor.setStallThresholdMs(smoothing.stall_threshold_ms);
+}
+
+void PipelineConfig::applyExpression(const ConfigurationManager& config,
+                                     ExpressionStateMachine& state_machine) {
+    // Custom expression bands replace speed_thresholds. Only one table is
+    // applied, so a reload does not pass through the default table and
+    // emit a state change for it.
+    bool custom_bands = false;
+    const auto band_config = config.getExpressionBands();
+    if (!band_config.isEmpty()) {
+        QVector<SpeedBand> bands;
+        for (const auto& entry : band_config) {
+            bands.append({entry.name, entry.max_kmh, entry.hysteresis_kmh});
+        }
+        custom_bands = state_machine.setBands(bands);
+        if (!custom_bands) {
+            qWarning() << "Using speed_thresholds expression bands";
+        }
+    }
+    if (!custom_bands) {
+        const auto thresholds = config.getSpeedThresholds();
+        state_machine.setThresholds(thresholds.relaxed_max, thresholds.normal_max,
+                                    thresholds.alert_max, thresholds.warning_max);
+    }
+
+    const auto transitions = config.getExpressionTransitionConfig();
+    state_machine.setHysteresisMode(transitions.hysteresis_mode == "symmetric"
+                                        ? HysteresisMode::Symmetric
+                                        : HysteresisMode::Directional);
+    state_machine.setMinDwellMs(transitions.min_dwell_ms);
+}
@@ -0,0 +1,183 @@
+#include "business_logic/speed_band_table.h"
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+
+SpeedBandTable::SpeedBandTable() {
+    setBands(defaultBands());
+}
+
+QVector<SpeedBand> SpeedBandTable::defaultBands(double relaxed_max, double normal_max,
+                                                double alert_max, double warning_max,
+                                                double hysteresis_kmh) {
+    return {
+        {"relaxed", relaxed_max, hysteresis_kmh},
+        {"normal", normal_max, hysteresis_kmh},
+        {"alert", alert_max, hysteresis_kmh},
+        {"warning", warning_max, hysteresis_kmh},
+        {"scared", warning_max, hysteresis_kmh},
+    };
+}
+
+bool SpeedBandTable::setBands(const QVector<SpeedBand>& bands, QString* error) {
+    auto fail = [error](const QString& reason) {
+        if (error) {
+            *error = reason;
+        }
+        return false;
+    };
+
+    if (bands.isEmpty()) {
+        return fail("no bands");
+    }
+
+    QSet<QString> names;
+    std::vector<double> rising;
+    std::vector<double> falling;
+    for (int i = 0; i < bands.size(); ++i) {
+        const SpeedBand& band = bands[i];
+        if (band.name.isEmpty() || names.contains(band.name)) {
+            return fail(QString("band %1: missing or duplicate name").arg(i));
+        }
+        names.insert(band.name);
+
+        // The last band is open-ended; its edge is not used
+        if (i == bands.size() - 1) {
+            break;
+        }
+        if (!std::isfinite(band.max_kmh) || !std::isfinite(band.hysteresis_kmh)
+            || band.hysteresis_kmh < 0.0) {
+            return fail(QString("band %1: invalid edge or hysteresis").arg(band.name));
+        }
+        if (!rising.empty() && (band.max_kmh <= rising.back()
+                                || band.max_kmh + band.hysteresis_kmh <= falling.back())) {
+            return fail(QString("band %1: edges must increase").arg(band.name));
+        }
+        rising.push_back(band.max_kmh);
+        falling.push_back(band.max_kmh + band.hysteresis_kmh);
+    }
+
+    bands_ = bands;
+    rising_edges_ = std::move(rising);
+    falling_edges_ = std::move(falling);
+    return true;
+}
+
+QString SpeedBandTable::bandName(int band) const {
+    return band >= 0 && band < bands_.size() ? bands_[band].name : QString("unknown");
+}
+
+int SpeedBandTable::indexOf(const QString& name) const {
+    for (int i = 0; i < bands_.size(); ++i) {
+        if (bands_[i].name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SpeedBandTable::classifySymmetric(double speed, int current_band) const {
+    const int band = countEdgesBelow(rising_edges_.data(), rising_edges_.size(), speed);
+    if (current_band < 0 || current_band >= bands_.size()) {
+        return band;
+    }
+    if (band > current_band
+        && speed <= rising_edges_[current_band] + bands_[current_band].hysteresis_kmh) {
+        return current_band;
+    }
+    if (band < current_band
+        && speed > rising_edges_[current_band - 1] - bands_[current_band - 1].hysteresis_kmh) {
+        return current_band;
+    }
+    return band;
+}
+
+void SpeedBandTable::classify(const double* speeds, std::size_t count, double previous_speed,
+                              int* bands) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        bands[i] = classify(speeds[i], previous_speed);
+        previous_speed = speeds[i];
+    }
+}
+
+QVector<int> SpeedBandTable::classify(const QVector<double>& speeds) const {
+    QVector<int> bands(speeds.size());
+    classify(speeds.constData(), static_cast<std::size_t>(speeds.size()), 0.0, bands.data());
+    return bands;
+}
+
+int SpeedBandTable::countEdgesBelow(const double* edges, std::size_t count, double speed) {
+    if (count <= LINEAR_SCAN_MAX_EDGES) {
+        // Edges are inclusive upper bounds: count those strictly below speed
+        int below = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            below += speed > edges[i];
+        }
+        return below;
+    }
+    return static_cast<int>(std::lower_bound(edges, edges + count, speed) - edges);
+}
+
+BandTracker::BandTracker(HysteresisMode mode, qint64 min_dwell_ns)
+    : mode_(mode)
+    , min_dwell_ns_(qMax<qint64>(min_dwell_ns, 0))
+{
+}
+
+int BandTracker::update(const SpeedBandTable& table, double speed, qint64 timestamp_ns) {
+    ++statistics_.samples;
+    band_ = qBound(0, band_, table.bandCount() - 1);
+
+    const int candidate = mode_ == HysteresisMode::Symmetric
+        ? table.classifySymmetric(speed, band_)
+        : table.classify(speed, last_speed_);
+    last_speed_ = speed;
+
+    if (candidate == band_) {
+        // Past an edge by less than the hysteresis
+        if (table.classify(speed, speed - 1.0) != band_) {
+            ++statistics_.held_by_hysteresis;
+        }
+        if (pending_band_ >= 0) {
+            ++statistics_.suppressed_by_dwell;
+            pending_band_ = -1;
+        }
+        return band_;
+    }
+
+    // Restart the dwell timer unless still heading the same way
+    if (pending_band_ < 0 || (pending_band_ > band_) != (candidate > band_)) {
+        if (pending_band_ >= 0) {
+            ++statistics_.suppressed_by_dwell;
+        }
+        pending_since_ns_ = timestamp_ns;
+    }
+    pending_band_ = candidate;
+
+    if (timestamp_ns - pending_since_ns_ >= min_dwell_ns_) {
+        band_ = candidate;
+        pending_band_ = -1;
+        ++statistics_.transitions;
+    }
+    return band_;
+}
+
+QVector<int> BandTracker::classify(const SpeedBandTable& table, const QVector<double>& speeds,
+                                   const QVector<qint64>& timestamps_ns) const {
+    BandTracker tracker(mode_, min_dwell_ns_);
+    const bool timed = timestamps_ns.size() == speeds.size();
+
+    QVector<int> bands(speeds.size());
+    for (int i = 0; i < speeds.size(); ++i) {
+        const qint64 timestamp_ns = timed ? timestamps_ns[i] : i * DEFAULT_SAMPLE_PERIOD_NS;
+        bands[i] = tracker.update(table, speeds[i], timestamp_ns);
+    }
+    return bands;
+}
+
+void BandTracker::reset(int band) {
+    band_ = band;
+    last_speed_ = 0.0;
+    pending_band_ = -1;
+    pending_since_ns_ = 0;
+}
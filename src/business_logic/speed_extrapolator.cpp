@@ -0,0 +1,77 @@
+#include "business_logic/speed_extrapolator.h"
+#include <algorithm>
+#include <cmath>
+
+SpeedExtrapolator::SpeedExtrapolator()
+    : SpeedExtrapolator(Settings())
+{
+}
+
+SpeedExtrapolator::SpeedExtrapolator(const Settings& settings)
+    : last_sample_ns_(0)
+{
+    setSettings(settings);
+}
+
+void SpeedExtrapolator::addSample(double speed_kmh, std::int64_t timestamp_ns) {
+    if (!std::isfinite(speed_kmh) || timestamp_ns <= 0) {
+        return;
+    }
+    if (hasData() && timestamp_ns < last_sample_ns_) {
+        return;
+    }
+
+    // After a stall the old trend says nothing about the new data
+    if (isStale(timestamp_ns)) {
+        filter_.reset();
+    }
+
+    const double dt_s = hasData() ? (timestamp_ns - last_sample_ns_) / 1e9 : 0.0;
+    filter_.update(speed_kmh, dt_s);
+    last_sample_ns_ = timestamp_ns;
+}
+
+double SpeedExtrapolator::speedAt(std::int64_t timestamp_ns) const {
+    if (!hasData()) {
+        return 0.0;
+    }
+
+    const double base = filter_.speed();
+    const double dt_s = std::max<std::int64_t>(timestamp_ns - last_sample_ns_, 0) / 1e9;
+    if (dt_s >= settings_.stale_after_s) {
+        return std::clamp(base, MIN_SPEED, MAX_SPEED);
+    }
+
+    double offset = estimatedAcceleration() * std::min(dt_s, settings_.max_lead_s);
+
+    // Fade out between max_lead and stale_after so the fallback is continuous
+    if (dt_s > settings_.max_lead_s) {
+        offset *= (settings_.stale_after_s - dt_s) /
+                  (settings_.stale_after_s - settings_.max_lead_s);
+    }
+
+    return std::clamp(base + offset, MIN_SPEED, MAX_SPEED);
+}
+
+bool SpeedExtrapolator::isStale(std::int64_t now_ns) const {
+    return !hasData() || (now_ns - last_sample_ns_) / 1e9 >= settings_.stale_after_s;
+}
+
+double SpeedExtrapolator::estimatedAcceleration() const {
+    const double limit = settings_.max_acceleration_kmh_s;
+    return std::clamp(filter_.acceleration(), -limit, limit);
+}
+
+void SpeedExtrapolator::setSettings(const Settings& settings) {
+    settings_ = settings;
+    settings_.max_lead_s = std::max(settings_.max_lead_s, 0.0);
+    settings_.stale_after_s = std::max(settings_.stale_after_s, settings_.max_lead_s);
+    settings_.max_acceleration_kmh_s = std::max(settings_.max_acceleration_kmh_s, 0.0);
+    filter_ = KalmanFilter(settings_.process_noise, settings_.measurement_noise);
+    last_sample_ns_ = 0;
+}
+
+void SpeedExtrapolator::reset() {
+    filter_.reset();
+    last_sample_ns_ = 0;
+}
@@ -0,0 +1,226 @@
+#include "business_logic/speed_log_csv_scanner.h"
+#include <QtAlgorithms>
+#include <QtEndian>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPEED_LOG_CSV_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Powers of ten that are exact in a double (Clinger fast path)
+constexpr double POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,
+    1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+};
+constexpr int MAX_EXACT_DIGITS = 15;
+
+constexpr quint64 BYTE_ONES = 0x0101010101010101ULL;
+constexpr quint64 BYTE_LOW7 = 0x7f7f7f7f7f7f7f7fULL;
+
+inline bool isDigit(char c) {
+    return static_cast<unsigned>(c - '0') < 10;
+}
+
+inline int twoDigits(const char* text) {
+    return (text[0] - '0') * 10 + (text[1] - '0');
+}
+
+// 0x80 in every byte of word that equals byte, 0 elsewhere (no false positives)
+inline quint64 matchBytes(quint64 word, char byte) {
+    const quint64 x = word ^ (BYTE_ONES * static_cast<unsigned char>(byte));
+    return ~(((x & BYTE_LOW7) + BYTE_LOW7) | x | BYTE_LOW7);
+}
+
+// Eight bytes at a time; text[begin, end) is scanned, positions appended at count
+int findDelimitersScalar(const char* text, int begin, int end, quint32* out, int count) {
+    int pos = begin;
+    for (; pos + 8 <= end; pos += 8) {
+        const quint64 word = qFromLittleEndian<quint64>(text + pos);
+        quint64 mask = matchBytes(word, ',') | matchBytes(word, '\n');
+        while (mask != 0) {
+            out[count++] = static_cast<quint32>(pos + qCountTrailingZeroBits(mask) / 8);
+            mask &= mask - 1;
+        }
+    }
+    for (; pos < end; ++pos) {
+        if (text[pos] == ',' || text[pos] == '\n') {
+            out[count++] = static_cast<quint32>(pos);
+        }
+    }
+    return count;
+}
+
+#ifdef SPEED_LOG_CSV_AVX2
+__attribute__((target("avx2")))
+int findDelimitersAvx2(const char* text, int length, quint32* out) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    int count = 0;
+    int pos = 0;
+    for (; pos + 64 <= length; pos += 64) {
+        const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos));
+        const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos + 32));
+        const quint32 low_mask = static_cast<quint32>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(low, comma), _mm256_cmpeq_epi8(low, newline))));
+        const quint32 high_mask = static_cast<quint32>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(high, comma), _mm256_cmpeq_epi8(high, newline))));
+        quint64 mask = low_mask | (static_cast<quint64>(high_mask) << 32);
+        while (mask != 0) {
+            out[count++] = static_cast<quint32>(pos + qCountTrailingZeroBits(mask));
+            mask &= mask - 1;
+        }
+    }
+    return findDelimitersScalar(text, pos, length, out, count);
+}
+#endif
+
+/**
+ * @brief [-]digits[.digits] with at most 15 digits
+ *
+ * The mantissa is then exact in a double and so is the power of ten, so
+ * one division rounds exactly like a full decimal conversion. Everything
+ * else is left to the caller's fallback.
+ */
+bool parseDecimal(const char* text, int length, double* value) {
+    const char* pos = text;
+    const char* end = text + length;
+    const bool negative = pos < end && *pos == '-';
+    if (negative) {
+        ++pos;
+    }
+    const char* int_start = pos;
+    quint64 mantissa = 0;
+    int digits = 0;
+    while (pos < end && isDigit(*pos)) {
+        mantissa = mantissa * 10 + static_cast<quint64>(*pos - '0');
+        ++digits;
+        ++pos;
+    }
+    if (pos == int_start || (*int_start == '0' && pos - int_start > 1)) {
+        return false;
+    }
+    int fraction = 0;
+    if (pos < end && *pos == '.') {
+        ++pos;
+        while (pos < end && isDigit(*pos)) {
+            mantissa = mantissa * 10 + static_cast<quint64>(*pos - '0');
+            ++digits;
+            ++fraction;
+            ++pos;
+        }
+        if (fraction == 0) {
+            return false;
+        }
+    }
+    if (pos != end || digits > MAX_EXACT_DIGITS) {
+        return false;
+    }
+    const double result = static_cast<double>(mantissa) / POW10[fraction];
+    *value = negative ? -result : result;
+    return true;
+}
+
+} // namespace
+
+bool SpeedLogCsvScanner::hasAvx2() {
+#ifdef SPEED_LOG_CSV_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+SpeedLogCsvScanner::SpeedLogCsvScanner(bool use_simd)
+    : use_avx2_(use_simd && hasAvx2())
+{
+}
+
+int SpeedLogCsvScanner::findDelimiters(const char* text, int length) {
+    if (positions_.size() < static_cast<std::size_t>(length)) {
+        positions_.resize(static_cast<std::size_t>(length));
+    }
+#ifdef SPEED_LOG_CSV_AVX2
+    if (use_avx2_) {
+        return findDelimitersAvx2(text, length, positions_.data());
+    }
+#endif
+    return findDelimitersScalar(text, 0, length, positions_.data(), 0);
+}
+
+bool SpeedLogCsvScanner::parseRow(const char* line, int length, const int* commas, int comma_count,
+                                  SpeedLogRecord* record) {
+    if (comma_count == 3) {
+        const int end = (length > 0 && line[length - 1] == '\r') ? length - 1 : length;
+        const int state = SpeedLogCsvParser::stateFromName(line + commas[2] + 1, end - commas[2] - 1);
+        if (state >= 0
+            && parseTimestamp(line, commas[0], &record->wall_ms)
+            && parseDecimal(line + commas[0] + 1, commas[1] - commas[0] - 1, &record->raw_speed)
+            && parseDecimal(line + commas[1] + 1, commas[2] - commas[1] - 1, &record->smoothed_speed)) {
+            record->state = static_cast<quint8>(state);
+            ++stats_.records;
+            return true;
+        }
+    }
+
+    if (length == 0 || line[0] == '#' || (length == 1 && line[0] == '\r')) {
+        ++stats_.ignored;
+        return false;
+    }
+    // Whatever the fast paths did not take parses (or fails) exactly as before
+    if (SpeedLogCsvParser::parseRow(line, length, record)) {
+        ++stats_.records;
+        ++stats_.slow_rows;
+        return true;
+    }
+    if (length >= 10 && std::memcmp(line, "timestamp,", 10) == 0) {
+        ++stats_.ignored;
+    } else {
+        ++stats_.malformed;
+    }
+    return false;
+}
+
+bool SpeedLogCsvScanner::parseTimestamp(const char* text, int length, qint64* wall_ms) {
+    // YYYY-MM-DDTHH:MM:SS[.mmm] in local time, as DataLogger writes it
+    if ((length != 19 && length != 23) || text[16] != ':' || !isDigit(text[17]) || !isDigit(text[18])) {
+        return false;
+    }
+    const int second = twoDigits(text + 17);
+    if (second > 59) {
+        return false;
+    }
+    int millisecond = 0;
+    if (length == 23) {
+        if (text[19] != '.' || !isDigit(text[20]) || !isDigit(text[21]) || !isDigit(text[22])) {
+            return false;
+        }
+        millisecond = (text[20] - '0') * 100 + twoDigits(text + 21);
+    }
+
+    // Zone offsets only change on whole minutes
+    if (!minute_cached_ || std::memcmp(text, cached_minute_, sizeof(cached_minute_)) != 0) {
+        static constexpr char LAYOUT[] = "0000-00-00T00:00";
+        for (int i = 0; i < 16; ++i) {
+            if (LAYOUT[i] == '0' ? !isDigit(text[i]) : text[i] != LAYOUT[i]) {
+                return false;
+            }
+        }
+        const QDate date(twoDigits(text) * 100 + twoDigits(text + 2), twoDigits(text + 5),
+                         twoDigits(text + 8));
+        const QTime time(twoDigits(text + 11), twoDigits(text + 14));
+        if (!date.isValid() || !time.isValid()) {
+            return false;
+        }
+        const QDateTime minute_start(date, time, Qt::LocalTime);
+        if (!minute_start.isValid()) {
+            return false;   // Skipped by a DST change; QDateTime::fromString decides
+        }
+        std::memcpy(cached_minute_, text, sizeof(cached_minute_));
+        cached_minute_ms_ = minute_start.toMSecsSinceEpoch();
+        minute_cached_ = true;
+    }
+    *wall_ms = cached_minute_ms_ + second * 1000 + millisecond;
+    return true;
+}
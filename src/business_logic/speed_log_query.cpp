@@ -0,0 +1,200 @@
+#include "business_logic/speed_log_query.h"
+#include "business_logic/columnar_log.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct ByteRange {
+    qint64 offset;
+    qint64 end_offset;
+};
+
+void addRecord(const SpeedLogRecord& record, SpeedAggregate* aggregate,
+               QVector<SpeedLogRecord>* records) {
+    if (aggregate) {
+        aggregate->add(record);
+    }
+    if (records) {
+        records->append(record);
+    }
+}
+
+} // namespace
+
+SpeedLogQuery::SpeedLogQuery(const QString& log_dir)
+    : log_dir_(log_dir)
+{
+}
+
+QStringList SpeedLogQuery::logFiles() const {
+    const QStringList patterns{"speed_log_*.csv",
+                               QString("speed_log_*.%1").arg(ColumnarLog::FILE_SUFFIX)};
+    // Names start with the file's start time, so name order is time order
+    const QFileInfoList files = QDir(log_dir_).entryInfoList(patterns, QDir::Files, QDir::Name);
+    QStringList paths;
+    for (const QFileInfo& info : files) {
+        paths.append(info.absoluteFilePath());
+    }
+    return paths;
+}
+
+SpeedAggregate SpeedLogQuery::aggregate(qint64 from_ms, qint64 to_ms) {
+    stats_ = Stats();
+    SpeedAggregate result;
+    for (const QString& path : logFiles()) {
+        queryFile(path, from_ms, to_ms, &result, nullptr);
+    }
+    return result;
+}
+
+QVector<SpeedLogRecord> SpeedLogQuery::records(qint64 from_ms, qint64 to_ms) {
+    stats_ = Stats();
+    QVector<SpeedLogRecord> result;
+    for (const QString& path : logFiles()) {
+        queryFile(path, from_ms, to_ms, nullptr, &result);
+    }
+    return result;
+}
+
+bool SpeedLogQuery::loadIndex(const QString& log_path, qint64 log_size, LogTimeIndex* index) {
+    if (index->load(LogTimeIndex::indexPath(log_path))) {
+        index->clampTo(log_size);
+        return true;
+    }
+    if (!build_missing_) {
+        return false;
+    }
+    if (!index->build(log_path)) {
+        qWarning() << "Failed to index log file:" << log_path;
+        return false;
+    }
+    ++stats_.indexes_built;
+    return true;
+}
+
+void SpeedLogQuery::queryFile(const QString& log_path, qint64 from_ms, qint64 to_ms,
+                              SpeedAggregate* aggregate, QVector<SpeedLogRecord>* records) {
+    if (from_ms >= to_ms) {
+        return;
+    }
+    const bool columnar = log_path.endsWith(QString(".") + ColumnarLog::FILE_SUFFIX);
+    const qint64 log_size = QFileInfo(log_path).size();
+    const quint64 rows_before = stats_.rows_read;
+    const int buckets_before = stats_.index_buckets;
+
+    LogTimeIndex index;
+    const bool indexed = loadIndex(log_path, log_size, &index);
+
+    // Whole buckets come from the index; the rest is read from the log
+    QVector<ByteRange> ranges;
+    for (const LogTimeIndex::Bucket& bucket : index.buckets()) {
+        const SpeedAggregate& stats = bucket.stats;
+        if (stats.last_ms < from_ms || stats.first_ms >= to_ms) {
+            continue;
+        }
+        if (aggregate && stats.first_ms >= from_ms && stats.last_ms < to_ms) {
+            aggregate->merge(stats);
+            ++stats_.index_buckets;
+            continue;
+        }
+        ranges.append({bucket.offset, bucket.end_offset});
+    }
+    const qint64 indexed_bytes = indexed ? index.indexedBytes() : 0;
+
+    if (columnar) {
+        if (!ranges.isEmpty() || indexed_bytes < log_size) {
+            queryColumnar(log_path, index, indexed_bytes < log_size, from_ms, to_ms, aggregate, records);
+        }
+    } else {
+        if (indexed_bytes < log_size) {
+            ranges.append({indexed_bytes, log_size});
+        }
+        if (!ranges.isEmpty()) {
+            // Adjacent buckets become one read
+            std::sort(ranges.begin(), ranges.end(), [](const ByteRange& a, const ByteRange& b) {
+                return a.offset < b.offset;
+            });
+            QVector<ByteRange> merged;
+            for (const ByteRange& range : ranges) {
+                if (!merged.isEmpty() && range.offset <= merged.last().end_offset) {
+                    merged.last().end_offset = qMax(merged.last().end_offset, range.end_offset);
+                } else {
+                    merged.append(range);
+                }
+            }
+
+            QFile file(log_path);
+            if (!file.open(QIODevice::ReadOnly)) {
+                qWarning() << "Cannot open log file:" << log_path;
+                return;
+            }
+            for (const ByteRange& range : merged) {
+                readCsvRange(file, range.offset, range.end_offset, from_ms, to_ms, aggregate, records);
+            }
+        }
+    }
+
+    if (stats_.rows_read > rows_before || stats_.index_buckets > buckets_before) {
+        ++stats_.files;
+    }
+}
+
+void SpeedLogQuery::queryColumnar(const QString& log_path, const LogTimeIndex& index, bool has_tail,
+                                  qint64 from_ms, qint64 to_ms, SpeedAggregate* aggregate,
+                                  QVector<SpeedLogRecord>* records) {
+    // The log's own block index does the seeking
+    ColumnarLogReader reader;
+    if (!reader.open(log_path)) {
+        return;
+    }
+    auto visit = [&](const SpeedLogRecord& record) {
+        ++stats_.rows_read;
+        addRecord(record, aggregate, records);
+    };
+    if (!aggregate) {
+        reader.forEachInRange(from_ms, to_ms, visit);
+        return;
+    }
+
+    // Buckets cut by the range ends, then whatever the index has not seen
+    qint64 indexed_last_ms = std::numeric_limits<qint64>::min();
+    std::vector<std::pair<qint64, qint64>> windows;
+    for (const LogTimeIndex::Bucket& bucket : index.buckets()) {
+        const SpeedAggregate& stats = bucket.stats;
+        indexed_last_ms = qMax(indexed_last_ms, stats.last_ms);
+        const bool overlaps = stats.last_ms >= from_ms && stats.first_ms < to_ms;
+        const bool whole = stats.first_ms >= from_ms && stats.last_ms < to_ms;
+        if (overlaps && !whole) {
+            windows.emplace_back(qMax(from_ms, stats.first_ms), qMin(to_ms, stats.last_ms + 1));
+        }
+    }
+    if (has_tail) {
+        windows.emplace_back(index.buckets().isEmpty() ? from_ms : qMax(from_ms, indexed_last_ms + 1),
+                             to_ms);
+    }
+    for (const auto& window : windows) {
+        reader.forEachInRange(window.first, window.second, visit);
+    }
+}
+
+void SpeedLogQuery::readCsvRange(QFile& file, qint64 offset, qint64 end_offset, qint64 from_ms,
+                                 qint64 to_ms, SpeedAggregate* aggregate,
+                                 QVector<SpeedLogRecord>* records) {
+    if (!file.seek(offset)) {
+        return;
+    }
+    // A row still being written has no newline yet and is left out
+    const QByteArray data = file.read(end_offset - offset);
+    csv_scanner_.scan(data.constData(), data.size(), [&](const SpeedLogRecord& record, qint64, qint64) {
+        ++stats_.rows_read;
+        if (record.wall_ms >= from_ms && record.wall_ms < to_ms) {
+            addRecord(record, aggregate, records);
+        }
+    });
+}
@@ -1,19 +1,26 @@
 #include "business_logic/speed_monitor.h"
 #include <QDebug>
-#include <numeric>
+#include <algorithm>
+#include <type_traits>
 
 SpeedMonitor::SpeedMonitor(int window_size, QObject* parent)
     : QObject(parent)
     , window_size_(window_size)
+    , filter_(MovingAverageFilter())
     , smoothed_speed_(0.0)
+    , horizon_ms_(DEFAULT_HORIZON_MS)
+    , stall_threshold_ms_(DEFAULT_STALL_THRESHOLD_MS)
+    , last_sample_ns_(0)
+    , last_filtered_ns_(0)
 {
-    if (window_size_ < 1) {
-        window_size_ = 1;
-        qWarning() << "Window size too small, using 1";
-    } else if (window_size_ > 20) {
-        window_size_ = 20;
-        qWarning() << "Window size too large, using 20";
+    if (window_size_ < MIN_WINDOW_SIZE) {
+        window_size_ = MIN_WINDOW_SIZE;
+        qWarning() << "Window size too small, using" << MIN_WINDOW_SIZE;
+    } else if (window_size_ > MAX_WINDOW_SIZE) {
+        window_size_ = MAX_WINDOW_SIZE;
+        qWarning() << "Window size too large, using" << MAX_WINDOW_SIZE;
     }
+    setFilter(MovingAverageFilter(static_cast<std::size_t>(window_size_)));
     
     qInfo() << "SpeedMonitor created with window size:" << window_size_;
 }
@@ -23,28 +30,57 @@ SpeedMonitor::~SpeedMonitor() {
 }
 
 void SpeedMonitor::setWindowSize(int size) {
-    if (size < 1 || size > 20) {
+    if (size < MIN_WINDOW_SIZE || size > MAX_WINDOW_SIZE) {
         qWarning() << "Invalid window size:" << size << "(must be 1-20)";
         return;
     }
     
     window_size_ = size;
     
-    // Trim samples if new window is smaller
-    while (speed_samples_.size() > window_size_) {
-        speed_samples_.dequeue();
-    }
+    // Trims the oldest samples if the new window is smaller
+    std::visit([this](auto& filter) {
+        using Filter = std::decay_t<decltype(filter)>;
+        if constexpr (Filter::USES_WINDOW) {
+            filter.setWindowSize(static_cast<std::size_t>(window_size_));
+        }
+    }, filter_);
     
     qInfo() << "Window size changed to:" << window_size_;
 }
 
 void SpeedMonitor::reset() {
-    speed_samples_.clear();
+    std::visit([](auto& filter) { filter.reset(); }, filter_);
     smoothed_speed_ = 0.0;
+    last_sample_ns_ = 0;
+    last_filtered_ns_ = 0;
+    gap_stats_ = GapStatistics();
     qInfo() << "SpeedMonitor reset";
 }
 
 void SpeedMonitor::onRawSpeedUpdate(double raw_speed) {
+    process(raw_speed, NOMINAL_SAMPLE_PERIOD_S);
+}
+
+void SpeedMonitor::onSpeedSample(double raw_speed, qint64 timestamp_ns) {
+    if (last_sample_ns_ != 0) {
+        recordGap((timestamp_ns - last_sample_ns_) / 1e6);
+    }
+    last_sample_ns_ = timestamp_ns;
+    
+    if (!isValidSpeed(raw_speed)) {
+        process(raw_speed, 0.0);   // rejected; dt carries over to the next valid sample
+        return;
+    }
+    
+    double dt_s = NOMINAL_SAMPLE_PERIOD_S;
+    if (last_filtered_ns_ != 0) {
+        dt_s = std::max<qint64>(timestamp_ns - last_filtered_ns_, 0) / 1e9;
+    }
+    last_filtered_ns_ = std::max(timestamp_ns, last_filtered_ns_);
+    process(raw_speed, dt_s);
+}
+
+void SpeedMonitor::process(double raw_speed, double dt_s) {
     // Validate speed
     if (!isValidSpeed(raw_speed)) {
         qWarning() << "Abnormal speed detected:" << raw_speed << "km/h";
@@ -52,33 +88,97 @@ void SpeedMonitor::onRawSpeedUpdate(double raw_speed) {
         return;
     }
     
-    // Add to sample queue
-    speed_samples_.enqueue(raw_speed);
-    
-    // Maintain window size
-    if (speed_samples_.size() > window_size_) {
-        speed_samples_.dequeue();
-    }
-    
-    // Calculate smoothed speed
-    smoothed_speed_ = calculateAverage();
+    // Statically dispatched per policy; no allocation
+    smoothed_speed_ = std::visit([raw_speed, dt_s](auto& filter) {
+        return filter.update(raw_speed, dt_s);
+    }, filter_);
     
     qDebug() << "Speed update - Raw:" << raw_speed 
-             << "Smoothed:" << smoothed_speed_
-             << "Samples:" << speed_samples_.size();
+             << "Smoothed:" << smoothed_speed_;
     
     emit smoothedSpeedUpdated(smoothed_speed_);
 }
 
-bool SpeedMonitor::isValidSpeed(double speed) const {
-    return speed >= MIN_SPEED && speed <= MAX_SPEED;
+void SpeedMonitor::setFilter(const SpeedFilter& filter) {
+    filter_ = filter;
+    std::visit([this](auto& active) {
+        using Filter = std::decay_t<decltype(active)>;
+        active.reset();
+        if constexpr (Filter::USES_WINDOW) {
+            active.setWindowSize(static_cast<std::size_t>(window_size_));
+        }
+    }, filter_);
+    applyHorizon();
+    last_filtered_ns_ = 0;
+    qInfo() << "Speed filter:" << filterName();
+}
+
+void SpeedMonitor::setHorizonMs(int horizon_ms) {
+    if (horizon_ms < 0) {
+        qWarning() << "Invalid smoothing horizon:" << horizon_ms << "ms";
+        return;
+    }
+    horizon_ms_ = horizon_ms;
+    applyHorizon();
+    qInfo() << "Smoothing horizon:" << horizon_ms_ << "ms";
+}
+
+void SpeedMonitor::setStallThresholdMs(int threshold_ms) {
+    if (threshold_ms <= 0) {
+        qWarning() << "Invalid stall threshold:" << threshold_ms << "ms";
+        return;
+    }
+    stall_threshold_ms_ = threshold_ms;
+}
+
+void SpeedMonitor::applyHorizon() {
+    const double horizon_s = horizon_ms_ / 1000.0;
+    std::visit([horizon_s](auto& filter) {
+        using Filter = std::decay_t<decltype(filter)>;
+        if constexpr (Filter::USES_WINDOW) {
+            filter.setHorizon(horizon_s);
+        }
+    }, filter_);
 }
 
-double SpeedMonitor::calculateAverage() const {
-    if (speed_samples_.isEmpty()) {
-        return 0.0;
+void SpeedMonitor::recordGap(double gap_ms) {
+    if (gap_ms < 0.0) {
+        ++gap_stats_.out_of_order;
+        return;
     }
     
-    double sum = std::accumulate(speed_samples_.begin(), speed_samples_.end(), 0.0);
-    return sum / speed_samples_.size();
+    ++gap_stats_.intervals;
+    gap_stats_.last_gap_ms = gap_ms;
+    gap_stats_.mean_gap_ms += (gap_ms - gap_stats_.mean_gap_ms) / gap_stats_.intervals;
+    gap_stats_.max_gap_ms = std::max(gap_stats_.max_gap_ms, gap_ms);
+    
+    if (gap_ms < BURST_GAP_MS) {
+        ++gap_stats_.burst_samples;
+    } else if (gap_ms > stall_threshold_ms_) {
+        ++gap_stats_.stalls;
+        qInfo() << "Speed samples stalled for" << gap_ms << "ms";
+        emit transportStallDetected(gap_ms);
+    }
+}
+
+QVariantMap SpeedMonitor::gapSummary() const {
+    QVariantMap summary;
+    summary["intervals"] = gap_stats_.intervals;
+    summary["last_gap_ms"] = gap_stats_.last_gap_ms;
+    summary["mean_gap_ms"] = gap_stats_.mean_gap_ms;
+    summary["max_gap_ms"] = gap_stats_.max_gap_ms;
+    summary["stalls"] = gap_stats_.stalls;
+    summary["burst_samples"] = gap_stats_.burst_samples;
+    summary["out_of_order"] = gap_stats_.out_of_order;
+    return summary;
+}
+
+QString SpeedMonitor::filterName() const {
+    return std::visit([](const auto& filter) {
+        return QString(std::decay_t<decltype(filter)>::NAME);
+    }, filter_);
+}
+
+bool SpeedMonitor::isValidSpeed(double speed) const {
+    return speed >= MIN_SPEED && speed <= MAX_SPEED;
 }
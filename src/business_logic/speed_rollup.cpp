@@ -0,0 +1,379 @@
+#include "business_logic/speed_rollup.h"
+#include <QDebug>
+#include <QDir>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// Floor division, so buckets before 1970 do not straddle zero
+qint64 bucketStart(qint64 wall_ms, qint64 bucket_ms) {
+    qint64 key = wall_ms / bucket_ms;
+    if (wall_ms % bucket_ms < 0) {
+        --key;
+    }
+    return key * bucket_ms;
+}
+
+void encodeBucket(const RollupBucket& bucket, uchar* out) {
+    const SpeedAggregate& stats = bucket.speed;
+    std::memset(out, 0, SpeedRollup::ENTRY_SIZE);
+    qToLittleEndian<qint64>(bucket.start_ms, out);
+    qToLittleEndian<qint64>(stats.first_ms, out + 8);
+    qToLittleEndian<qint64>(stats.last_ms, out + 16);
+    qToLittleEndian<quint32>(static_cast<quint32>(stats.count), out + 24);
+    qToLittleEndian<qint32>(stats.min_raw, out + 28);
+    qToLittleEndian<qint32>(stats.max_raw, out + 32);
+    qToLittleEndian<qint32>(stats.min_smoothed, out + 36);
+    qToLittleEndian<qint32>(stats.max_smoothed, out + 40);
+    qToLittleEndian<qint64>(stats.sum_raw, out + 48);
+    qToLittleEndian<qint64>(stats.sum_smoothed, out + 56);
+    for (int i = 0; i < SpeedAggregate::STATE_SLOTS; ++i) {
+        qToLittleEndian<quint32>(static_cast<quint32>(bucket.state_ms[i]), out + 64 + i * 4);
+        qToLittleEndian<quint32>(static_cast<quint32>(stats.state_counts[i]), out + 88 + i * 4);
+    }
+}
+
+RollupBucket decodeBucket(const uchar* in) {
+    RollupBucket bucket;
+    SpeedAggregate& stats = bucket.speed;
+    bucket.start_ms = qFromLittleEndian<qint64>(in);
+    stats.first_ms = qFromLittleEndian<qint64>(in + 8);
+    stats.last_ms = qFromLittleEndian<qint64>(in + 16);
+    stats.count = qFromLittleEndian<quint32>(in + 24);
+    stats.min_raw = qFromLittleEndian<qint32>(in + 28);
+    stats.max_raw = qFromLittleEndian<qint32>(in + 32);
+    stats.min_smoothed = qFromLittleEndian<qint32>(in + 36);
+    stats.max_smoothed = qFromLittleEndian<qint32>(in + 40);
+    stats.sum_raw = qFromLittleEndian<qint64>(in + 48);
+    stats.sum_smoothed = qFromLittleEndian<qint64>(in + 56);
+    for (int i = 0; i < SpeedAggregate::STATE_SLOTS; ++i) {
+        bucket.state_ms[i] = qFromLittleEndian<quint32>(in + 64 + i * 4);
+        stats.state_counts[i] = qFromLittleEndian<quint32>(in + 88 + i * 4);
+    }
+    return bucket;
+}
+
+QByteArray encodeHeader(qint64 tier_ms) {
+    QByteArray header(SpeedRollup::HEADER_SIZE, '\0');
+    auto* out = reinterpret_cast<uchar*>(header.data());
+    std::memcpy(out, SpeedRollup::FILE_MAGIC, 4);
+    qToLittleEndian<quint16>(SpeedRollup::VERSION, out + 4);
+    qToLittleEndian<quint16>(SpeedRollup::HEADER_SIZE, out + 6);
+    qToLittleEndian<quint32>(static_cast<quint32>(tier_ms), out + 8);
+    return header;
+}
+
+QByteArray encodeBuckets(const QVector<RollupBucket>& buckets) {
+    QByteArray data(buckets.size() * SpeedRollup::ENTRY_SIZE, '\0');
+    auto* out = reinterpret_cast<uchar*>(data.data());
+    for (const RollupBucket& bucket : buckets) {
+        encodeBucket(bucket, out);
+        out += SpeedRollup::ENTRY_SIZE;
+    }
+    return data;
+}
+
+} // namespace
+
+qint64 SpeedRollup::tierMs(Tier tier) {
+    switch (tier) {
+        case Tier::Second: return 1000;
+        case Tier::Minute: return 60 * 1000;
+        case Tier::Hour: return 3600 * 1000;
+    }
+    return 1000;
+}
+
+int SpeedRollup::tierCapacity(Tier tier) {
+    switch (tier) {
+        case Tier::Second: return 3600;
+        case Tier::Minute: return 24 * 60;
+        case Tier::Hour: return 30 * 24;
+    }
+    return 1;
+}
+
+const char* SpeedRollup::tierName(Tier tier) {
+    switch (tier) {
+        case Tier::Second: return "1s";
+        case Tier::Minute: return "1m";
+        case Tier::Hour: return "1h";
+    }
+    return "";
+}
+
+bool SpeedRollup::tierFromName(const QString& name, Tier* tier) {
+    for (int i = 0; i < TIER_COUNT; ++i) {
+        if (name == tierName(static_cast<Tier>(i))) {
+            *tier = static_cast<Tier>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+QString SpeedRollup::tierPath(const QString& dir, Tier tier) {
+    return dir + "/speed_rollup_" + tierName(tier) + ".dat";
+}
+
+SpeedRollup::SpeedRollup() {
+    for (int i = 0; i < TIER_COUNT; ++i) {
+        const Tier tier = static_cast<Tier>(i);
+        tiers_[i].bucket_ms = tierMs(tier);
+        tiers_[i].ring.resize(tierCapacity(tier));
+    }
+}
+
+SpeedRollup::~SpeedRollup() {
+    close();
+}
+
+void SpeedRollup::TierState::push(const RollupBucket& bucket) {
+    // A bucket written again (open at shutdown, reopened after restart) replaces its first copy
+    if (count > 0 && at(count - 1).start_ms == bucket.start_ms) {
+        ring[(head + count - 1) % ring.size()] = bucket;
+        return;
+    }
+    ring[(head + count) % ring.size()] = bucket;
+    if (count < ring.size()) {
+        ++count;
+    } else {
+        head = (head + 1) % ring.size();
+    }
+}
+
+bool SpeedRollup::open(const QString& dir) {
+    close();
+    if (!QDir().mkpath(dir)) {
+        qWarning() << "Failed to create rollup directory:" << dir;
+        return false;
+    }
+    dir_ = dir;
+
+    bool ok = true;
+    for (int i = 0; i < TIER_COUNT; ++i) {
+        ok = loadTier(tiers_[i], tierPath(dir, static_cast<Tier>(i))) && ok;
+    }
+    return ok;
+}
+
+void SpeedRollup::close() {
+    if (!isOpen()) {
+        return;
+    }
+    // Open buckets are saved too; a restart within them picks them up again
+    for (TierState& tier : tiers_) {
+        if (tier.has_open) {
+            tier.pending.append(tier.open);
+        }
+    }
+    flush();
+    for (TierState& tier : tiers_) {
+        tier.file.close();
+    }
+    dir_.clear();
+}
+
+bool SpeedRollup::loadTier(TierState& tier, const QString& path) {
+    tier.head = 0;
+    tier.count = 0;
+    tier.pending.clear();
+    tier.rows_in_file = 0;
+    tier.file.setFileName(path);
+    if (!tier.file.open(QIODevice::ReadWrite)) {
+        qWarning() << "Failed to open rollup file:" << path << tier.file.errorString();
+        return false;
+    }
+
+    const QByteArray data = tier.file.readAll();
+    const auto* bytes = reinterpret_cast<const uchar*>(data.constData());
+    const bool valid = data.size() >= HEADER_SIZE && std::memcmp(bytes, FILE_MAGIC, 4) == 0
+        && qFromLittleEndian<quint16>(bytes + 4) == VERSION
+        && qFromLittleEndian<quint16>(bytes + 6) == HEADER_SIZE
+        && qFromLittleEndian<quint32>(bytes + 8) == static_cast<quint32>(tier.bucket_ms);
+    if (!valid) {
+        if (!data.isEmpty()) {
+            qWarning() << "Invalid rollup file, starting a new one:" << path;
+        }
+        const QByteArray header = encodeHeader(tier.bucket_ms);
+        if (!tier.file.resize(0) || !tier.file.seek(0)
+            || tier.file.write(header) != header.size() || !tier.file.flush()) {
+            qWarning() << "Failed to write rollup file:" << path << tier.file.errorString();
+            tier.file.close();
+            return false;
+        }
+        return true;
+    }
+
+    // Keep the newest ring's worth; a torn last entry is cut off so appends stay aligned
+    const int rows = (data.size() - HEADER_SIZE) / ENTRY_SIZE;
+    const int first = qMax(0, rows - tier.ring.size());
+    for (int i = first; i < rows; ++i) {
+        tier.push(decodeBucket(bytes + HEADER_SIZE + i * ENTRY_SIZE));
+    }
+    tier.rows_in_file = rows;
+    const qint64 valid_size = HEADER_SIZE + static_cast<qint64>(rows) * ENTRY_SIZE;
+    if (valid_size != data.size() && !tier.file.resize(valid_size)) {
+        qWarning() << "Failed to truncate rollup file:" << path << tier.file.errorString();
+    }
+    if (rows >= 2 * tier.ring.size()) {
+        return compact(tier);
+    }
+    return tier.file.seek(valid_size);
+}
+
+void SpeedRollup::add(const SpeedLogRecord& record) {
+    for (TierState& tier : tiers_) {
+        addToTier(tier, record);
+    }
+    has_last_ = true;
+    last_ms_ = record.wall_ms;
+    last_state_ = qMin<int>(record.state, SpeedAggregate::STATE_SLOTS - 1);
+
+    // Seconds are written in minute-sized batches
+    if (isOpen() && !tiers_[static_cast<int>(Tier::Minute)].pending.isEmpty()) {
+        flush();
+    }
+}
+
+void SpeedRollup::addToTier(TierState& tier, const SpeedLogRecord& record) {
+    const qint64 now = record.wall_ms;
+    const qint64 gap = now - last_ms_;
+    const bool dwell = has_last_ && gap > 0 && gap <= max_gap_ms_;
+    const qint64 start = bucketStart(now, tier.bucket_ms);
+
+    if (tier.has_open && tier.open.start_ms != start) {
+        if (dwell) {
+            const qint64 end = qMin(tier.open.start_ms + tier.bucket_ms, now);
+            tier.open.state_ms[last_state_] += qMax<qint64>(0, end - qMax(last_ms_, tier.open.start_ms));
+        }
+        tier.push(tier.open);
+        tier.pending.append(tier.open);
+        tier.has_open = false;
+
+        // Whole buckets inside the gap get its dwell time and no samples
+        if (dwell) {
+            for (qint64 skipped = tier.open.start_ms + tier.bucket_ms; skipped < start;
+                 skipped += tier.bucket_ms) {
+                RollupBucket bucket;
+                bucket.start_ms = skipped;
+                bucket.state_ms[last_state_] = tier.bucket_ms;
+                tier.push(bucket);
+                tier.pending.append(bucket);
+            }
+        }
+    }
+    if (!tier.has_open) {
+        if (tier.count > 0 && tier.at(tier.count - 1).start_ms == start) {
+            tier.open = tier.at(tier.count - 1);   // Saved at the last close
+            --tier.count;
+        } else {
+            tier.open = RollupBucket();
+            tier.open.start_ms = start;
+        }
+        tier.has_open = true;
+    }
+    if (dwell) {
+        tier.open.state_ms[last_state_] += qMax<qint64>(0, now - qMax(last_ms_, start));
+    }
+    tier.open.speed.add(record);
+}
+
+bool SpeedRollup::flush() {
+    bool ok = true;
+    for (TierState& tier : tiers_) {
+        ok = writePending(tier) && ok;
+    }
+    return ok;
+}
+
+bool SpeedRollup::writePending(TierState& tier) {
+    if (tier.pending.isEmpty() || !tier.file.isOpen()) {
+        tier.pending.clear();
+        return true;
+    }
+    const QByteArray data = encodeBuckets(tier.pending);
+    const int rows = tier.pending.size();
+    tier.pending.clear();
+    if (tier.file.write(data) != data.size() || !tier.file.flush()) {
+        qWarning() << "Failed to write rollup file:" << tier.file.fileName() << tier.file.errorString();
+        return false;
+    }
+    tier.rows_in_file += rows;
+    if (tier.rows_in_file >= 2 * tier.ring.size()) {
+        return compact(tier);
+    }
+    return true;
+}
+
+bool SpeedRollup::compact(TierState& tier) {
+    const QString path = tier.file.fileName();
+    QVector<RollupBucket> rows;
+    rows.reserve(tier.count);
+    for (int i = 0; i < tier.count; ++i) {
+        rows.append(tier.at(i));
+    }
+
+    // QSaveFile renames over the old file, so a power cut leaves one of the two
+    QSaveFile compacted(path);
+    const QByteArray data = encodeHeader(tier.bucket_ms) + encodeBuckets(rows);
+    if (!compacted.open(QIODevice::WriteOnly) || compacted.write(data) != data.size()) {
+        qWarning() << "Failed to compact rollup file:" << path << compacted.errorString();
+        compacted.cancelWriting();
+        return false;
+    }
+    tier.file.close();
+    if (!compacted.commit()) {
+        qWarning() << "Failed to replace rollup file:" << path << compacted.errorString();
+    }
+    tier.file.setFileName(path);
+    if (!tier.file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Failed to open rollup file:" << path << tier.file.errorString();
+        return false;
+    }
+    tier.rows_in_file = rows.size();
+    return true;
+}
+
+QVector<RollupBucket> SpeedRollup::buckets(Tier tier, qint64 from_ms, qint64 to_ms) const {
+    const TierState& state = tiers_[static_cast<int>(tier)];
+    QVector<RollupBucket> result;
+    for (int i = 0; i < state.count; ++i) {
+        const RollupBucket& bucket = state.at(i);
+        if (bucket.start_ms >= from_ms && bucket.start_ms < to_ms) {
+            result.append(bucket);
+        }
+    }
+    if (state.has_open && state.open.start_ms >= from_ms && state.open.start_ms < to_ms) {
+        result.append(state.open);
+    }
+    return result;
+}
+
+QVector<RollupBucket> SpeedRollup::recent(Tier tier, int count) const {
+    const TierState& state = tiers_[static_cast<int>(tier)];
+    QVector<RollupBucket> result;
+    if (count <= 0) {
+        return result;
+    }
+    const int closed = qMin(state.count, state.has_open ? count - 1 : count);
+    result.reserve(closed + 1);
+    for (int i = state.count - closed; i < state.count; ++i) {
+        result.append(state.at(i));
+    }
+    if (state.has_open) {
+        result.append(state.open);
+    }
+    return result;
+}
+
+const RollupBucket* SpeedRollup::current(Tier tier) const {
+    const TierState& state = tiers_[static_cast<int>(tier)];
+    return state.has_open ? &state.open : nullptr;
+}
+
+int SpeedRollup::closedCount(Tier tier) const {
+    return tiers_[static_cast<int>(tier)].count;
+}
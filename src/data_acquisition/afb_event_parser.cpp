@@ -0,0 +1,838 @@
+#include "data_acquisition/afb_event_parser.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+constexpr std::uint32_t FNV_OFFSET_BASIS = 2166136261u;
+constexpr std::uint32_t FNV_PRIME = 16777619u;
+
+// Powers of ten that are exact in a double (Clinger fast path)
+constexpr double POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+constexpr int MAX_EXACT_POW10 = 22;
+constexpr int MAX_EXACT_DIGITS = 15;
+constexpr int MAX_NESTING = 32;
+
+/**
+ * @brief Cursor over a frame of code units
+ *
+ * All helpers return false on malformed or unsupported input; the caller
+ * then reports Result::Unsupported.
+ */
+template <typename CharT>
+class Scanner {
+public:
+    Scanner(const CharT* data, std::size_t length)
+        : pos_(data)
+        , end_(data + length)
+    {
+    }
+
+    void skipWhitespace() {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\n' || *pos_ == '\r')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char expected) {
+        skipWhitespace();
+        if (pos_ < end_ && *pos_ == static_cast<CharT>(expected)) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char expected) {
+        skipWhitespace();
+        return pos_ < end_ && *pos_ == static_cast<CharT>(expected);
+    }
+
+    /**
+     * @brief true if only whitespace is left
+     */
+    bool atEnd() {
+        skipWhitespace();
+        return pos_ == end_;
+    }
+
+    /**
+     * @brief Read a string that must be plain ASCII without escapes
+     * @param out Destination buffer
+     * @param capacity Buffer size including terminator
+     * @param length Receives string length
+     */
+    bool readAsciiString(char* out, int capacity, int& length) {
+        if (!consume('"')) {
+            return false;
+        }
+        length = 0;
+        while (pos_ < end_) {
+            const auto c = static_cast<std::uint32_t>(*pos_++);
+            if (c == '"') {
+                out[length] = '\0';
+                return true;
+            }
+            if (c == '\\' || c < 0x20 || c > 0x7e || length + 1 >= capacity) {
+                return false;
+            }
+            out[length++] = static_cast<char>(c);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Read an object key and the following colon
+     *
+     * Keys that do not fit or contain escapes come back empty, which never
+     * matches a key we care about.
+     */
+    bool readKeyName(char* out, int capacity, int& length) {
+        if (!consume('"')) {
+            return false;
+        }
+        length = 0;
+        bool fits = true;
+        while (pos_ < end_) {
+            const auto c = static_cast<std::uint32_t>(*pos_++);
+            if (c == '"') {
+                out[fits ? length : 0] = '\0';
+                if (!fits) {
+                    length = 0;
+                }
+                return consume(':');
+            }
+            if (c == '\\') {
+                fits = false;
+                if (pos_ >= end_) {
+                    return false;
+                }
+                ++pos_;
+                continue;
+            }
+            if (fits && length + 1 < capacity && c < 0x80) {
+                out[length++] = static_cast<char>(c);
+            } else {
+                fits = false;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Parse a JSON number using the exact fast path
+     *
+     * Numbers that cannot be converted exactly with a single multiply or
+     * divide are rejected rather than rounded differently from Qt.
+     */
+    bool readNumber(double& value, bool& is_integer, std::int64_t& integer) {
+        skipWhitespace();
+        bool negative = false;
+        if (pos_ < end_ && *pos_ == '-') {
+            negative = true;
+            ++pos_;
+        }
+
+        std::uint64_t mantissa = 0;
+        int digits = 0;
+        int exponent = 0;
+        bool any_digit = false;
+
+        while (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9') {
+            any_digit = true;
+            if (digits > 0 || *pos_ != '0') {
+                if (digits >= 18) {
+                    return false;
+                }
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*pos_ - '0');
+                ++digits;
+            }
+            ++pos_;
+        }
+        if (!any_digit) {
+            return false;
+        }
+
+        is_integer = true;
+        if (pos_ < end_ && *pos_ == '.') {
+            is_integer = false;
+            ++pos_;
+            bool any_fraction = false;
+            while (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9') {
+                any_fraction = true;
+                if (digits > 0 || *pos_ != '0') {
+                    if (digits >= 18) {
+                        return false;
+                    }
+                    mantissa = mantissa * 10 + static_cast<std::uint64_t>(*pos_ - '0');
+                    ++digits;
+                }
+                --exponent;
+                ++pos_;
+            }
+            if (!any_fraction) {
+                return false;
+            }
+        }
+
+        if (pos_ < end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+            is_integer = false;
+            ++pos_;
+            bool negative_exp = false;
+            if (pos_ < end_ && (*pos_ == '+' || *pos_ == '-')) {
+                negative_exp = (*pos_ == '-');
+                ++pos_;
+            }
+            int exp_value = 0;
+            bool any_exp = false;
+            while (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9') {
+                any_exp = true;
+                if (exp_value > 1000) {
+                    return false;
+                }
+                exp_value = exp_value * 10 + static_cast<int>(*pos_ - '0');
+                ++pos_;
+            }
+            if (!any_exp) {
+                return false;
+            }
+            exponent += negative_exp ? -exp_value : exp_value;
+        }
+
+        if (is_integer) {
+            integer = negative ? -static_cast<std::int64_t>(mantissa)
+                               : static_cast<std::int64_t>(mantissa);
+        }
+
+        if (digits > MAX_EXACT_DIGITS && !is_integer) {
+            return false;
+        }
+        if (exponent < -MAX_EXACT_POW10 || exponent > MAX_EXACT_POW10) {
+            return false;
+        }
+
+        double result = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            result /= POW10[-exponent];
+        } else if (exponent > 0) {
+            result *= POW10[exponent];
+        }
+        value = negative ? -result : result;
+        return true;
+    }
+
+    bool readLiteral(const char* literal) {
+        skipWhitespace();
+        for (const char* l = literal; *l != '\0'; ++l) {
+            if (pos_ >= end_ || *pos_ != static_cast<CharT>(*l)) {
+                return false;
+            }
+            ++pos_;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Skip over any JSON value
+     */
+    bool skipValue() {
+        skipWhitespace();
+        if (pos_ >= end_) {
+            return false;
+        }
+        switch (static_cast<std::uint32_t>(*pos_)) {
+            case '"':
+                return skipString();
+            case '{':
+            case '[':
+                return skipContainer();
+            case 't':
+                return readLiteral("true");
+            case 'f':
+                return readLiteral("false");
+            case 'n':
+                return readLiteral("null");
+            default: {
+                double value;
+                bool is_integer;
+                std::int64_t integer;
+                if (readNumber(value, is_integer, integer)) {
+                    return true;
+                }
+                return skipNumberToken();
+            }
+        }
+    }
+
+private:
+    bool skipString() {
+        ++pos_;  // opening quote
+        while (pos_ < end_) {
+            const CharT c = *pos_++;
+            if (c == '"') {
+                return true;
+            }
+            if (c == '\\') {
+                if (pos_ >= end_) {
+                    return false;
+                }
+                ++pos_;
+            }
+        }
+        return false;
+    }
+
+    bool skipContainer() {
+        // Track open brackets without recursion; strings may contain brackets
+        char stack[MAX_NESTING];
+        int depth = 0;
+        while (pos_ < end_) {
+            const CharT c = *pos_;
+            if (c == '"') {
+                if (!skipString()) {
+                    return false;
+                }
+                continue;
+            }
+            ++pos_;
+            if (c == '{' || c == '[') {
+                if (depth >= MAX_NESTING) {
+                    return false;
+                }
+                stack[depth++] = (c == '{') ? '}' : ']';
+            } else if (c == '}' || c == ']') {
+                if (depth == 0 || stack[depth - 1] != static_cast<char>(c)) {
+                    return false;
+                }
+                if (--depth == 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Numbers outside the fast path are still valid JSON to skip over
+    bool skipNumberToken() {
+        const CharT* start = pos_;
+        while (pos_ < end_ && ((*pos_ >= '0' && *pos_ <= '9') || *pos_ == '-' || *pos_ == '+' ||
+                               *pos_ == '.' || *pos_ == 'e' || *pos_ == 'E')) {
+            ++pos_;
+        }
+        return pos_ != start;
+    }
+
+    const CharT* pos_;
+    const CharT* end_;
+};
+
+template <typename CharT>
+bool parseData(Scanner<CharT>& scanner, AfbEvent& event) {
+    scanner.skipWhitespace();
+
+    // Some bindings push a bare scalar as data; only numbers are decoded here
+    if (!scanner.peek('{')) {
+        bool is_integer;
+        std::int64_t integer;
+        if (!scanner.readNumber(event.value, is_integer, integer)) {
+            return false;
+        }
+        event.has_value = true;
+        return true;
+    }
+
+    scanner.consume('{');
+    if (scanner.consume('}')) {
+        return true;
+    }
+
+    char key[16];
+    int key_length = 0;
+    do {
+        if (!scanner.readKeyName(key, sizeof(key), key_length)) {
+            return false;
+        }
+        if (key_length == 5 && std::memcmp(key, "value", 5) == 0) {
+            // Non-numeric values (booleans included) are left to the generic path
+            bool is_integer;
+            std::int64_t integer;
+            if (!scanner.readNumber(event.value, is_integer, integer)) {
+                return false;
+            }
+            event.has_value = true;
+        } else if (key_length == 4 && std::memcmp(key, "unit", 4) == 0) {
+            if (!scanner.readAsciiString(event.unit, AfbEvent::MAX_UNIT_LENGTH,
+                                         event.unit_length)) {
+                return false;
+            }
+            event.has_unit = true;
+        } else if (key_length == 9 && std::memcmp(key, "timestamp", 9) == 0) {
+            double value;
+            bool is_integer = false;
+            std::int64_t integer = 0;
+            if (!scanner.readNumber(value, is_integer, integer)) {
+                return false;
+            }
+            if (is_integer) {
+                event.timestamp_ms = integer;
+                event.has_timestamp = true;
+            } else {
+                // Out-of-range timestamps are dropped rather than wrapped
+                event.has_timestamp = AfbEventParser::timestampFromDouble(value, event.timestamp_ms);
+            }
+        } else if (!scanner.skipValue()) {
+            return false;
+        }
+    } while (scanner.consume(','));
+
+    return scanner.consume('}');
+}
+
+/**
+ * @brief Cursor over a CBOR byte stream (RFC 8949 subset)
+ *
+ * Only definite-length items are accepted; the VSS binding never streams
+ * chunked strings for event frames.
+ */
+class CborScanner {
+public:
+    enum MajorType : std::uint8_t {
+        UNSIGNED = 0,
+        NEGATIVE = 1,
+        BYTES = 2,
+        TEXT = 3,
+        ARRAY = 4,
+        MAP = 5,
+        TAG = 6,
+        SIMPLE = 7
+    };
+
+    CborScanner(const std::uint8_t* data, std::size_t length)
+        : pos_(data)
+        , end_(data + length)
+    {
+    }
+
+    /**
+     * @brief Read an item header
+     * @param major Receives the major type
+     * @param argument Receives the length/value argument
+     * @param info Receives the raw additional information bits
+     */
+    bool readHeader(std::uint8_t& major, std::uint64_t& argument, std::uint8_t& info) {
+        if (pos_ >= end_) {
+            return false;
+        }
+        const std::uint8_t initial = *pos_++;
+        major = initial >> 5;
+        info = initial & 0x1f;
+
+        if (info < 24) {
+            argument = info;
+            return true;
+        }
+        int bytes = 0;
+        switch (info) {
+            case 24:
+                bytes = 1;
+                break;
+            case 25:
+                bytes = 2;
+                break;
+            case 26:
+                bytes = 4;
+                break;
+            case 27:
+                bytes = 8;
+                break;
+            default:
+                return false;  // Reserved or indefinite length
+        }
+        if (end_ - pos_ < bytes) {
+            return false;
+        }
+        argument = 0;
+        for (int i = 0; i < bytes; ++i) {
+            argument = (argument << 8) | *pos_++;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read a text string in place
+     * @param text Receives a pointer into the frame
+     * @param length Receives the string length
+     */
+    bool readText(const char*& text, std::size_t& length) {
+        std::uint8_t major;
+        std::uint64_t argument;
+        std::uint8_t info;
+        if (!readHeader(major, argument, info) || major != TEXT ||
+            argument > static_cast<std::uint64_t>(end_ - pos_)) {
+            return false;
+        }
+        text = reinterpret_cast<const char*>(pos_);
+        length = static_cast<std::size_t>(argument);
+        pos_ += length;
+        return true;
+    }
+
+    /**
+     * @brief Read a number (integer, half/single/double float or boolean)
+     */
+    bool readNumber(double& value, std::int64_t& integer, bool& is_integer, bool& is_bool) {
+        std::uint8_t major;
+        std::uint64_t argument;
+        std::uint8_t info;
+        if (!readHeader(major, argument, info)) {
+            return false;
+        }
+        is_integer = false;
+        is_bool = false;
+        switch (major) {
+            case UNSIGNED:
+                if (argument > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+                    return false;
+                }
+                integer = static_cast<std::int64_t>(argument);
+                value = static_cast<double>(argument);
+                is_integer = true;
+                return true;
+            case NEGATIVE:
+                if (argument > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+                    return false;
+                }
+                integer = -1 - static_cast<std::int64_t>(argument);
+                value = static_cast<double>(integer);
+                is_integer = true;
+                return true;
+            case SIMPLE:
+                return readSimple(info, argument, value, is_bool);
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief Skip over any item
+     */
+    bool skipItem(int depth = 0) {
+        if (depth > MAX_NESTING) {
+            return false;
+        }
+        std::uint8_t major;
+        std::uint64_t argument;
+        std::uint8_t info;
+        if (!readHeader(major, argument, info)) {
+            return false;
+        }
+        switch (major) {
+            case UNSIGNED:
+            case NEGATIVE:
+            case SIMPLE:
+                return true;
+            case BYTES:
+            case TEXT:
+                if (argument > static_cast<std::uint64_t>(end_ - pos_)) {
+                    return false;
+                }
+                pos_ += argument;
+                return true;
+            case ARRAY:
+            case MAP: {
+                const std::uint64_t items = (major == MAP) ? argument * 2 : argument;
+                // Every item needs at least one byte; reject absurd counts early
+                if (items > static_cast<std::uint64_t>(end_ - pos_)) {
+                    return false;
+                }
+                for (std::uint64_t i = 0; i < items; ++i) {
+                    if (!skipItem(depth + 1)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case TAG:
+                return skipItem(depth + 1);
+            default:
+                return false;
+        }
+    }
+
+    /**
+     * @brief true if every byte has been consumed
+     */
+    bool atEnd() const { return pos_ == end_; }
+
+    /**
+     * @brief Peek at the major type of the next item
+     */
+    bool peekMajor(std::uint8_t& major) const {
+        if (pos_ >= end_) {
+            return false;
+        }
+        major = *pos_ >> 5;
+        return true;
+    }
+
+private:
+    // NaN and infinities are rejected: no signal value can be non-finite
+    static bool readSimple(std::uint8_t info, std::uint64_t argument, double& value,
+                           bool& is_bool) {
+        switch (info) {
+            case 20:  // false
+            case 21:  // true
+                value = (info == 21) ? 1.0 : 0.0;
+                is_bool = true;
+                return true;
+            case 25:
+                value = halfToDouble(static_cast<std::uint16_t>(argument));
+                return std::isfinite(value);
+            case 26: {
+                const auto bits = static_cast<std::uint32_t>(argument);
+                float f;
+                std::memcpy(&f, &bits, sizeof(f));
+                value = f;
+                return std::isfinite(value);
+            }
+            case 27:
+                std::memcpy(&value, &argument, sizeof(value));
+                return std::isfinite(value);
+            default:
+                return false;
+        }
+    }
+
+    static double halfToDouble(std::uint16_t half) {
+        const int exponent = (half >> 10) & 0x1f;
+        const int mantissa = half & 0x3ff;
+        double value;
+        if (exponent == 0) {
+            value = std::ldexp(mantissa, -24);
+        } else if (exponent != 31) {
+            value = std::ldexp(mantissa + 1024, exponent - 25);
+        } else {
+            value = (mantissa == 0) ? HUGE_VAL : NAN;
+        }
+        return (half & 0x8000) ? -value : value;
+    }
+
+    const std::uint8_t* pos_;
+    const std::uint8_t* end_;
+};
+
+bool copyAscii(const char* text, std::size_t length, char* out, int capacity, int& out_length) {
+    if (length + 1 > static_cast<std::size_t>(capacity)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < length; ++i) {
+        const auto c = static_cast<std::uint8_t>(text[i]);
+        if (c < 0x20 || c > 0x7e) {
+            return false;
+        }
+        out[i] = text[i];
+    }
+    out[length] = '\0';
+    out_length = static_cast<int>(length);
+    return true;
+}
+
+bool keyEquals(const char* key, std::size_t length, const char* expected) {
+    return std::strlen(expected) == length && std::memcmp(key, expected, length) == 0;
+}
+
+bool parseCborData(CborScanner& scanner, AfbEvent& event) {
+    std::uint8_t major;
+    if (!scanner.peekMajor(major)) {
+        return false;
+    }
+
+    if (major != CborScanner::MAP) {
+        std::int64_t integer;
+        bool is_integer;
+        bool is_bool;
+        if (!scanner.readNumber(event.value, integer, is_integer, is_bool)) {
+            return false;
+        }
+        event.has_value = true;
+        event.value_is_bool = is_bool;
+        return true;
+    }
+
+    std::uint64_t entries;
+    std::uint8_t info;
+    if (!scanner.readHeader(major, entries, info)) {
+        return false;
+    }
+    for (std::uint64_t i = 0; i < entries; ++i) {
+        const char* key;
+        std::size_t key_length;
+        if (!scanner.readText(key, key_length)) {
+            return false;
+        }
+        if (keyEquals(key, key_length, "value")) {
+            std::int64_t integer;
+            bool is_integer;
+            bool is_bool;
+            if (!scanner.readNumber(event.value, integer, is_integer, is_bool)) {
+                return false;
+            }
+            event.has_value = true;
+            event.value_is_bool = is_bool;
+        } else if (keyEquals(key, key_length, "unit")) {
+            const char* unit;
+            std::size_t unit_length;
+            if (!scanner.readText(unit, unit_length) ||
+                !copyAscii(unit, unit_length, event.unit, AfbEvent::MAX_UNIT_LENGTH,
+                           event.unit_length)) {
+                return false;
+            }
+            event.has_unit = true;
+        } else if (keyEquals(key, key_length, "timestamp")) {
+            double value;
+            std::int64_t integer;
+            bool is_integer;
+            bool is_bool;
+            if (!scanner.readNumber(value, integer, is_integer, is_bool) || is_bool) {
+                return false;
+            }
+            if (is_integer) {
+                event.timestamp_ms = integer;
+                event.has_timestamp = true;
+            } else {
+                // Out-of-range timestamps are dropped rather than wrapped
+                event.has_timestamp = AfbEventParser::timestampFromDouble(value, event.timestamp_ms);
+            }
+        } else if (!scanner.skipItem()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool AfbEvent::nameEquals(const char* other) const {
+    return std::strcmp(name, other) == 0;
+}
+
+bool AfbEvent::unitEquals(const char* other) const {
+    return std::strcmp(unit, other) == 0;
+}
+
+std::uint32_t AfbEventParser::hashName(const char* name, std::size_t length) {
+    std::uint32_t hash = FNV_OFFSET_BASIS;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<std::uint8_t>(name[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+bool AfbEventParser::timestampFromDouble(double value, std::int64_t& timestamp_ms) {
+    // 2^63 is exact in a double; NaN fails both comparisons
+    constexpr double LIMIT = 9223372036854775808.0;
+    if (!(value >= -LIMIT && value < LIMIT)) {
+        return false;
+    }
+    timestamp_ms = static_cast<std::int64_t>(value);
+    return true;
+}
+
+template <typename CharT>
+AfbEventParser::Result AfbEventParser::parse(const CharT* data, std::size_t length,
+                                             AfbEvent& event) {
+    event = AfbEvent();
+    Scanner<CharT> scanner(data, length);
+
+    if (!scanner.consume('{')) {
+        return Result::Unsupported;
+    }
+    if (scanner.consume('}')) {
+        return Result::NotEvent;
+    }
+
+    bool has_event = false;
+    char key[16];
+    int key_length = 0;
+
+    do {
+        if (!scanner.readKeyName(key, sizeof(key), key_length)) {
+            return Result::Unsupported;
+        }
+        if (key_length == 5 && std::memcmp(key, "event", 5) == 0) {
+            if (!scanner.readAsciiString(event.name, AfbEvent::MAX_NAME_LENGTH,
+                                         event.name_length)) {
+                return Result::Unsupported;
+            }
+            event.name_hash = hashName(event.name, static_cast<std::size_t>(event.name_length));
+            has_event = true;
+        } else if (key_length == 4 && std::memcmp(key, "data", 4) == 0) {
+            if (!parseData(scanner, event)) {
+                return Result::Unsupported;
+            }
+        } else if (!scanner.skipValue()) {
+            return Result::Unsupported;
+        }
+    } while (scanner.consume(','));
+
+    // Truncated or unbalanced frames are rejected, as QJsonDocument would
+    if (!scanner.consume('}') || !scanner.atEnd()) {
+        return Result::Unsupported;
+    }
+    return has_event ? Result::Event : Result::NotEvent;
+}
+
+// Frames arrive as UTF-8 bytes (binary/raw) or as QString UTF-16 code units
+template AfbEventParser::Result AfbEventParser::parse<char>(const char*, std::size_t, AfbEvent&);
+template AfbEventParser::Result AfbEventParser::parse<char16_t>(const char16_t*, std::size_t,
+                                                                AfbEvent&);
+
+AfbEventParser::Result AfbEventParser::parseCbor(const std::uint8_t* data, std::size_t length,
+                                                 AfbEvent& event) {
+    event = AfbEvent();
+    CborScanner scanner(data, length);
+
+    std::uint8_t major;
+    std::uint64_t entries;
+    std::uint8_t info;
+    if (!scanner.readHeader(major, entries, info) || major != CborScanner::MAP) {
+        return Result::Unsupported;
+    }
+
+    bool has_event = false;
+    for (std::uint64_t i = 0; i < entries; ++i) {
+        const char* key;
+        std::size_t key_length;
+        if (!scanner.readText(key, key_length)) {
+            return Result::Unsupported;
+        }
+        if (keyEquals(key, key_length, "event")) {
+            const char* name;
+            std::size_t name_length;
+            if (!scanner.readText(name, name_length) ||
+                !copyAscii(name, name_length, event.name, AfbEvent::MAX_NAME_LENGTH,
+                           event.name_length)) {
+                return Result::Unsupported;
+            }
+            event.name_hash = hashName(event.name, name_length);
+            has_event = true;
+        } else if (keyEquals(key, key_length, "data")) {
+            if (!parseCborData(scanner, event)) {
+                return Result::Unsupported;
+            }
+        } else if (!scanner.skipItem()) {
+            return Result::Unsupported;
+        }
+    }
+
+    // A frame is exactly one map, as with the JSON form
+    if (!scanner.atEnd()) {
+        return Result::Unsupported;
+    }
+    return has_event ? Result::Event : Result::NotEvent;
+}
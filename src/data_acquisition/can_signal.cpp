@@ -0,0 +1,145 @@
+#include "data_acquisition/can_signal.h"
+
+namespace {
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+}  // namespace
+
+bool CanSignalDefinition::isValid() const {
+    if (length < 1 || length > 64 || start_bit < 0 || start_bit > 63) {
+        return false;
+    }
+    if (!big_endian) {
+        return start_bit + length <= 64;
+    }
+    const int msb = (start_bit / 8) * 8 + (7 - start_bit % 8);
+    return msb + length <= 64;
+}
+
+bool CanSignalDecoder::decode(const CanSignalDefinition& signal, const CanFrame& frame,
+                              double& value) {
+    if (!signal.isValid()) {
+        return false;
+    }
+    
+    const int frame_bits = frame.length * 8;
+    std::uint64_t raw;
+    
+    if (signal.big_endian) {
+        // Motorola: start bit is the MSB; count bits from byte 0's MSB
+        const int msb = (signal.start_bit / 8) * 8 + (7 - signal.start_bit % 8);
+        if (msb + signal.length > frame_bits) {
+            return false;
+        }
+        std::uint64_t word = 0;
+        for (int i = 0; i < CanFrame::MAX_DATA_LENGTH; ++i) {
+            word = (word << 8) | frame.data[i];
+        }
+        raw = word >> (64 - msb - signal.length);
+    } else {
+        // Intel: start bit is the LSB, bytes in ascending significance
+        if (signal.start_bit + signal.length > frame_bits) {
+            return false;
+        }
+        std::uint64_t word = 0;
+        for (int i = CanFrame::MAX_DATA_LENGTH - 1; i >= 0; --i) {
+            word = (word << 8) | frame.data[i];
+        }
+        raw = word >> signal.start_bit;
+    }
+    
+    if (signal.length < 64) {
+        raw &= (std::uint64_t(1) << signal.length) - 1;
+    }
+    
+    double physical;
+    if (signal.is_signed) {
+        // Sign-extend from the signal's top bit
+        if (signal.length < 64 && (raw >> (signal.length - 1)) != 0) {
+            raw |= ~std::uint64_t(0) << signal.length;
+        }
+        physical = static_cast<double>(static_cast<std::int64_t>(raw));
+    } else {
+        physical = static_cast<double>(raw);
+    }
+    
+    value = physical * signal.factor + signal.offset;
+    return true;
+}
+
+bool CanSignalDecoder::parseCandumpLine(const QByteArray& line, CanFrame& frame) {
+    frame = CanFrame();
+    
+    // "(seconds.micros) interface id#data"
+    const QByteArray trimmed = line.trimmed();
+    if (!trimmed.startsWith('(')) {
+        return false;
+    }
+    const int close = trimmed.indexOf(')');
+    if (close < 0) {
+        return false;
+    }
+    
+    const QByteArray stamp = trimmed.mid(1, close - 1);
+    const int dot = stamp.indexOf('.');
+    bool ok_seconds = false;
+    bool ok_micros = true;
+    const qint64 seconds = stamp.left(dot < 0 ? stamp.size() : dot).toLongLong(&ok_seconds);
+    const qint64 micros = dot < 0
+        ? 0
+        : stamp.mid(dot + 1).leftJustified(6, '0', true).toLongLong(&ok_micros);
+    if (!ok_seconds || !ok_micros) {
+        return false;
+    }
+    frame.timestamp_us = seconds * 1000000 + micros;
+    
+    const QList<QByteArray> fields = trimmed.mid(close + 1).simplified().split(' ');
+    if (fields.size() < 2) {
+        return false;
+    }
+    
+    const QByteArray& payload = fields[1];
+    const int hash = payload.indexOf('#');
+    if (hash <= 0) {
+        return false;
+    }
+    
+    // Remote ("#R") and CAN FD ("##") frames carry nothing we decode
+    const QByteArray data = payload.mid(hash + 1);
+    if (data.startsWith('R') || data.startsWith('#')) {
+        return false;
+    }
+    
+    bool ok = false;
+    frame.can_id = payload.left(hash).toUInt(&ok, 16);
+    if (!ok) {
+        return false;
+    }
+    frame.extended = hash > 3;
+    
+    if (data.size() % 2 != 0 || data.size() / 2 > CanFrame::MAX_DATA_LENGTH) {
+        return false;
+    }
+    for (int i = 0; i < data.size() / 2; ++i) {
+        const int high = hexValue(data[2 * i]);
+        const int low = hexValue(data[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        frame.data[i] = static_cast<std::uint8_t>((high << 4) | low);
+    }
+    frame.length = data.size() / 2;
+    return true;
+}
@@ -1,42 +1,185 @@
 #include "data_acquisition/configuration_manager.h"
 #include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QDebug>
+#include <initializer_list>
 
 ConfigurationManager::ConfigurationManager(QObject* parent)
     : QObject(parent)
 {
     loadDefaults();
+    reload_timer_.setSingleShot(true);
+    connect(&reload_timer_, &QTimer::timeout, this, &ConfigurationManager::onReloadTimeout);
 }
 
-bool ConfigurationManager::loadFromFile(const QString& config_path) {
-    config_file_path_ = config_path;
-    
+ConfigurationManager::~ConfigurationManager() = default;
+
+bool ConfigurationManager::readConfigFile(const QString& config_path, QByteArray* data,
+                                          QJsonObject* config) {
     QFile file(config_path);
     if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Config file not found:" << config_path << "Using defaults.";
+        qWarning() << "Config file not found:" << config_path;
         return false;
     }
     
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
+    *data = file.readAll();
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(*data, &error);
     
     if (!doc.isObject()) {
-        qWarning() << "Invalid config file format";
+        qWarning() << "Invalid config file format:" << config_path << error.errorString();
         return false;
     }
+    *config = doc.object();
+    return true;
+}
+
+bool ConfigurationManager::loadFromFile(const QString& config_path) {
+    config_file_path_ = config_path;
     
-    parseJSON(doc.object());
+    QByteArray data;
+    QJsonObject config;
+    if (!readConfigFile(config_path, &data, &config)) {
+        qWarning() << "Using defaults.";
+        return false;
+    }
+    
+    parseJSON(config);
+    loaded_data_ = data;
     qInfo() << "Configuration loaded from:" << config_path;
+    updateWatch();
     return true;
 }
 
+bool ConfigurationManager::reload() {
+    if (config_file_path_.isEmpty()) {
+        return false;
+    }
+    
+    QByteArray data;
+    QJsonObject config;
+    if (!readConfigFile(config_file_path_, &data, &config)) {
+        qWarning() << "Keeping the current configuration";
+        return false;
+    }
+    if (data == loaded_data_) {
+        return true;   // Touched or rewritten unchanged
+    }
+    loaded_data_ = data;
+    
+    const QJsonObject before = toJSON();
+    loadDefaults();
+    parseJSON(config);
+    const QStringList changed = emitChangedSections(before, toJSON());
+    if (changed.isEmpty()) {
+        qInfo() << "Configuration reloaded, nothing changed";
+        return true;
+    }
+    qInfo() << "Configuration reloaded, changed:" << changed.join(", ");
+    if (changed.contains("config_reload")) {
+        updateWatch();
+    }
+    emit configurationChanged();
+    return true;
+}
+
+QStringList ConfigurationManager::emitChangedSections(const QJsonObject& before,
+                                                      const QJsonObject& after) {
+    QStringList changed;
+    auto differs = [&](std::initializer_list<const char*> keys) {
+        bool any = false;
+        for (const char* key : keys) {
+            if (before.value(key) != after.value(key)) {
+                changed.append(key);
+                any = true;
+            }
+        }
+        return any;
+    };
+    
+    if (differs({"speed_thresholds", "expression_bands", "expression_transitions"})) {
+        emit expressionConfigChanged();
+    }
+    if (differs({"smoothing"})) {
+        emit smoothingConfigChanged();
+    }
+    if (differs({"display"})) {
+        emit displaySettingsChanged();
+    }
+    if (differs({"character"})) {
+        emit characterSettingsChanged();
+    }
+    if (differs({"afb"})) {
+        emit afbConfigChanged();
+    }
+    if (differs({"vss"})) {
+        emit vssConfigChanged();
+    }
+    if (differs({"source"})) {
+        emit dataSourceConfigChanged();
+    }
+    if (differs({"logging"})) {
+        emit loggingConfigChanged();
+    }
+    differs({"config_reload"});   // Handled here
+    return changed;
+}
+
+void ConfigurationManager::updateWatch() {
+    if (!reload_config_.watch || config_file_path_.isEmpty()) {
+        if (watcher_) {
+            watcher_.reset();
+            reload_timer_.stop();
+            qInfo() << "Stopped watching" << config_file_path_;
+        }
+        return;
+    }
+    
+    if (!watcher_) {
+        watcher_ = std::make_unique<QFileSystemWatcher>();
+        connect(watcher_.get(), &QFileSystemWatcher::fileChanged,
+                this, &ConfigurationManager::onWatchedPathChanged);
+        connect(watcher_.get(), &QFileSystemWatcher::directoryChanged,
+                this, &ConfigurationManager::onWatchedPathChanged);
+        qInfo() << "Watching" << config_file_path_ << "for changes";
+    }
+    reload_timer_.setInterval(qMax(0, reload_config_.debounce_ms));
+    
+    // Editors that save by renaming a new file over the old one end the
+    // file watch; the directory watch sees the new file appear
+    const QFileInfo info(config_file_path_);
+    if (!watcher_->directories().contains(info.absolutePath())) {
+        watcher_->addPath(info.absolutePath());
+    }
+    if (info.exists() && !watcher_->files().contains(info.absoluteFilePath())) {
+        watcher_->addPath(info.absoluteFilePath());
+    }
+}
+
+void ConfigurationManager::onWatchedPathChanged() {
+    reload_timer_.start();
+}
+
+void ConfigurationManager::onReloadTimeout() {
+    updateWatch();
+    reload();
+}
+
 void ConfigurationManager::loadDefaults() {
     speed_thresholds_ = SpeedThresholds();
+    expression_bands_.clear();
+    expression_transitions_ = ExpressionTransitionConfig();
     display_settings_ = DisplaySettings();
     character_settings_ = CharacterSettings();
     afb_config_ = AFBConnectionConfig();
     logging_config_ = LoggingConfig();
+    vss_config_ = VssConfig();
+    smoothing_config_ = SmoothingConfig();
+    data_source_config_ = DataSourceConfig();
+    reload_config_ = ReloadConfig();
 }
 
 void ConfigurationManager::parseJSON(const QJsonObject& config) {
@@ -49,6 +192,27 @@ void ConfigurationManager::parseJSON(const QJsonObject& config) {
         speed_thresholds_.warning_max = thresholds["warning_max"].toDouble(120.0);
     }
     
+    // Expression bands
+    if (config.contains("expression_bands")) {
+        expression_bands_.clear();
+        for (const auto& value : config["expression_bands"].toArray()) {
+            auto band = value.toObject();
+            ExpressionBandConfig entry;
+            entry.name = band["name"].toString();
+            entry.max_kmh = band["max_kmh"].toDouble(0.0);
+            entry.hysteresis_kmh = band["hysteresis_kmh"].toDouble(2.0);
+            expression_bands_.append(entry);
+        }
+    }
+    
+    // Expression transitions
+    if (config.contains("expression_transitions")) {
+        auto transitions = config["expression_transitions"].toObject();
+        expression_transitions_.hysteresis_mode =
+            transitions["hysteresis_mode"].toString("directional");
+        expression_transitions_.min_dwell_ms = transitions["min_dwell_ms"].toInt(0);
+    }
+    
     // AFB configuration
     if (config.contains("afb")) {
         auto afb = config["afb"].toObject();
@@ -56,6 +220,59 @@ void ConfigurationManager::parseJSON(const QJsonObject& config) {
         afb_config_.token = afb["token"].toString("");
         afb_config_.reconnect_interval_ms = afb["reconnect_interval_ms"].toInt(1000);
         afb_config_.max_retries = afb["max_retries"].toInt(5);
+        afb_config_.binary_frames = afb["binary_frames"].toBool(false);
+        afb_config_.io_thread = afb["io_thread"].toBool(false);
+    }
+    
+    // VSS signals
+    if (config.contains("vss")) {
+        auto vss = config["vss"].toObject();
+        QStringList paths;
+        for (const auto& value : vss["signals"].toArray()) {
+            const QString path = value.toString();
+            if (!path.isEmpty() && !paths.contains(path)) {
+                paths.append(path);
+            }
+        }
+        if (!paths.isEmpty()) {
+            vss_config_.signal_paths = paths;
+        }
+        vss_config_.update_rate_hz = vss["update_rate_hz"].toInt(10);
+    }
+    
+    // Smoothing filter
+    if (config.contains("smoothing")) {
+        auto smoothing = config["smoothing"].toObject();
+        smoothing_config_.filter = smoothing["filter"].toString("moving_average");
+        smoothing_config_.window_size = smoothing["window_size"].toInt(5);
+        smoothing_config_.horizon_ms = smoothing["horizon_ms"].toInt(2000);
+        smoothing_config_.stall_threshold_ms = smoothing["stall_threshold_ms"].toInt(500);
+        smoothing_config_.ema_time_constant_ms = smoothing["ema_time_constant_ms"].toInt(300);
+        smoothing_config_.one_euro_min_cutoff_hz = smoothing["one_euro_min_cutoff_hz"].toDouble(1.0);
+        smoothing_config_.one_euro_beta = smoothing["one_euro_beta"].toDouble(0.05);
+        smoothing_config_.kalman_process_noise = smoothing["kalman_process_noise"].toDouble(50.0);
+        smoothing_config_.kalman_measurement_noise =
+            smoothing["kalman_measurement_noise"].toDouble(1.0);
+    }
+    
+    // Data source
+    if (config.contains("source")) {
+        auto source = config["source"].toObject();
+        data_source_config_.type = source["type"].toString("afb");
+        data_source_config_.can_interface = source["can_interface"].toString("vcan0");
+        data_source_config_.candump_file = source["candump_file"].toString();
+        data_source_config_.replay_speed = source["replay_speed"].toDouble(1.0);
+        
+        auto signal = source["speed_signal"].toObject();
+        CanSignalDefinition& speed = data_source_config_.speed_signal;
+        speed.can_id = static_cast<quint32>(signal["can_id"].toInt(0));
+        speed.extended = signal["extended"].toBool(false);
+        speed.start_bit = signal["start_bit"].toInt(0);
+        speed.length = signal["length"].toInt(16);
+        speed.big_endian = signal["byte_order"].toString("little_endian") == "big_endian";
+        speed.is_signed = signal["signed"].toBool(false);
+        speed.factor = signal["factor"].toDouble(0.01);
+        speed.offset = signal["offset"].toDouble(0.0);
     }
     
     // Display settings
@@ -66,6 +283,10 @@ void ConfigurationManager::parseJSON(const QJsonObject& config) {
         display_settings_.language = display["language"].toString("en");
         display_settings_.show_speed_number = display["show_speed_number"].toBool(true);
         display_settings_.fullscreen = display["fullscreen"].toBool(false);
+        display_settings_.extrapolate_speed = display["extrapolate_speed"].toBool(true);
+        display_settings_.extrapolation_max_lead_ms =
+            display["extrapolation_max_lead_ms"].toInt(200);
+        display_settings_.extrapolation_stale_ms = display["extrapolation_stale_ms"].toInt(500);
     }
     
     // Character settings
@@ -84,6 +305,23 @@ void ConfigurationManager::parseJSON(const QJsonObject& config) {
         logging_config_.log_dir = logging["log_dir"].toString("/var/log/carspeedboy");
         logging_config_.max_file_size_mb = logging["max_file_size_mb"].toInt(10);
         logging_config_.max_files = logging["max_files"].toInt(5);
+        logging_config_.max_total_size_mb = logging["max_total_size_mb"].toInt(0);
+        logging_config_.max_age_days = logging["max_age_days"].toInt(0);
+        logging_config_.rotation_interval = logging["rotation_interval"].toString("none");
+        logging_config_.async_writer = logging["async_writer"].toBool(true);
+        logging_config_.flush_interval_ms = logging["flush_interval_ms"].toInt(1000);
+        logging_config_.durable_commits = logging["durable_commits"].toBool(false);
+        logging_config_.commit_max_records = logging["commit_max_records"].toInt(0);
+        logging_config_.format = logging["format"].toString("csv");
+        logging_config_.time_index_bucket_s = logging["time_index_bucket_s"].toInt(0);
+        logging_config_.rollups = logging["rollups"].toBool(true);
+    }
+    
+    // Config file watching
+    if (config.contains("config_reload")) {
+        auto reload = config["config_reload"].toObject();
+        reload_config_.watch = reload["watch"].toBool(false);
+        reload_config_.debounce_ms = reload["debounce_ms"].toInt(300);
     }
 }
 
@@ -118,14 +356,74 @@ QJsonObject ConfigurationManager::toJSON() const {
     thresholds["warning_max"] = speed_thresholds_.warning_max;
     config["speed_thresholds"] = thresholds;
     
+    // Expression bands
+    if (!expression_bands_.isEmpty()) {
+        QJsonArray bands;
+        for (const auto& entry : expression_bands_) {
+            QJsonObject band;
+            band["name"] = entry.name;
+            band["max_kmh"] = entry.max_kmh;
+            band["hysteresis_kmh"] = entry.hysteresis_kmh;
+            bands.append(band);
+        }
+        config["expression_bands"] = bands;
+    }
+    
+    // Expression transitions
+    QJsonObject transitions;
+    transitions["hysteresis_mode"] = expression_transitions_.hysteresis_mode;
+    transitions["min_dwell_ms"] = expression_transitions_.min_dwell_ms;
+    config["expression_transitions"] = transitions;
+    
     // AFB configuration
     QJsonObject afb;
     afb["url"] = afb_config_.url;
     afb["token"] = afb_config_.token;
     afb["reconnect_interval_ms"] = afb_config_.reconnect_interval_ms;
     afb["max_retries"] = afb_config_.max_retries;
+    afb["binary_frames"] = afb_config_.binary_frames;
+    afb["io_thread"] = afb_config_.io_thread;
     config["afb"] = afb;
     
+    // VSS signals
+    QJsonObject vss;
+    vss["signals"] = QJsonArray::fromStringList(vss_config_.signal_paths);
+    vss["update_rate_hz"] = vss_config_.update_rate_hz;
+    config["vss"] = vss;
+    
+    // Smoothing filter
+    QJsonObject smoothing;
+    smoothing["filter"] = smoothing_config_.filter;
+    smoothing["window_size"] = smoothing_config_.window_size;
+    smoothing["horizon_ms"] = smoothing_config_.horizon_ms;
+    smoothing["stall_threshold_ms"] = smoothing_config_.stall_threshold_ms;
+    smoothing["ema_time_constant_ms"] = smoothing_config_.ema_time_constant_ms;
+    smoothing["one_euro_min_cutoff_hz"] = smoothing_config_.one_euro_min_cutoff_hz;
+    smoothing["one_euro_beta"] = smoothing_config_.one_euro_beta;
+    smoothing["kalman_process_noise"] = smoothing_config_.kalman_process_noise;
+    smoothing["kalman_measurement_noise"] = smoothing_config_.kalman_measurement_noise;
+    config["smoothing"] = smoothing;
+    
+    // Data source
+    QJsonObject source;
+    source["type"] = data_source_config_.type;
+    source["can_interface"] = data_source_config_.can_interface;
+    source["candump_file"] = data_source_config_.candump_file;
+    source["replay_speed"] = data_source_config_.replay_speed;
+    
+    const CanSignalDefinition& speed = data_source_config_.speed_signal;
+    QJsonObject signal;
+    signal["can_id"] = static_cast<qint64>(speed.can_id);
+    signal["extended"] = speed.extended;
+    signal["start_bit"] = speed.start_bit;
+    signal["length"] = speed.length;
+    signal["byte_order"] = speed.big_endian ? "big_endian" : "little_endian";
+    signal["signed"] = speed.is_signed;
+    signal["factor"] = speed.factor;
+    signal["offset"] = speed.offset;
+    source["speed_signal"] = signal;
+    config["source"] = source;
+    
     // Display settings
     QJsonObject display;
     display["units"] = display_settings_.units;
@@ -133,6 +431,9 @@ QJsonObject ConfigurationManager::toJSON() const {
     display["language"] = display_settings_.language;
     display["show_speed_number"] = display_settings_.show_speed_number;
     display["fullscreen"] = display_settings_.fullscreen;
+    display["extrapolate_speed"] = display_settings_.extrapolate_speed;
+    display["extrapolation_max_lead_ms"] = display_settings_.extrapolation_max_lead_ms;
+    display["extrapolation_stale_ms"] = display_settings_.extrapolation_stale_ms;
     config["display"] = display;
     
     // Character settings
@@ -149,37 +450,97 @@ QJsonObject ConfigurationManager::toJSON() const {
     logging["log_dir"] = logging_config_.log_dir;
     logging["max_file_size_mb"] = logging_config_.max_file_size_mb;
     logging["max_files"] = logging_config_.max_files;
+    logging["max_total_size_mb"] = logging_config_.max_total_size_mb;
+    logging["max_age_days"] = logging_config_.max_age_days;
+    logging["rotation_interval"] = logging_config_.rotation_interval;
+    logging["async_writer"] = logging_config_.async_writer;
+    logging["flush_interval_ms"] = logging_config_.flush_interval_ms;
+    logging["durable_commits"] = logging_config_.durable_commits;
+    logging["commit_max_records"] = logging_config_.commit_max_records;
+    logging["format"] = logging_config_.format;
+    logging["time_index_bucket_s"] = logging_config_.time_index_bucket_s;
+    logging["rollups"] = logging_config_.rollups;
     config["logging"] = logging;
     
+    // Config file watching
+    QJsonObject reload;
+    reload["watch"] = reload_config_.watch;
+    reload["debounce_ms"] = reload_config_.debounce_ms;
+    config["config_reload"] = reload;
+    
     return config;
 }
 
 void ConfigurationManager::setSpeedThresholds(const SpeedThresholds& thresholds) {
     speed_thresholds_ = thresholds;
+    emit expressionConfigChanged();
+    emit configurationChanged();
+}
+
+void ConfigurationManager::setExpressionBands(const QVector<ExpressionBandConfig>& bands) {
+    expression_bands_ = bands;
+    emit expressionConfigChanged();
+    emit configurationChanged();
+}
+
+void ConfigurationManager::setExpressionTransitionConfig(const ExpressionTransitionConfig& config) {
+    expression_transitions_ = config;
+    emit expressionConfigChanged();
     emit configurationChanged();
 }
 
 void ConfigurationManager::setDisplaySettings(const DisplaySettings& settings) {
     display_settings_ = settings;
+    emit displaySettingsChanged();
     emit configurationChanged();
 }
 
 void ConfigurationManager::setCharacterSettings(const CharacterSettings& settings) {
     character_settings_ = settings;
+    emit characterSettingsChanged();
     emit configurationChanged();
 }
 
 void ConfigurationManager::setAFBConfig(const AFBConnectionConfig& config) {
     afb_config_ = config;
+    emit afbConfigChanged();
     emit configurationChanged();
 }
 
 void ConfigurationManager::setLoggingConfig(const LoggingConfig& config) {
     logging_config_ = config;
+    emit loggingConfigChanged();
+    emit configurationChanged();
+}
+
+void ConfigurationManager::setVssConfig(const VssConfig& config) {
+    vss_config_ = config;
+    emit vssConfigChanged();
+    emit configurationChanged();
+}
+
+void ConfigurationManager::setSmoothingConfig(const SmoothingConfig& config) {
+    smoothing_config_ = config;
+    emit smoothingConfigChanged();
+    emit configurationChanged();
+}
+
+void ConfigurationManager::setDataSourceConfig(const DataSourceConfig& config) {
+    data_source_config_ = config;
+    emit dataSourceConfigChanged();
+    emit configurationChanged();
+}
+
+void ConfigurationManager::setReloadConfig(const ReloadConfig& config) {
+    reload_config_ = config;
+    updateWatch();
     emit configurationChanged();
 }
 
 void ConfigurationManager::resetToDefaults() {
+    const QJsonObject before = toJSON();
     loadDefaults();
+    emitChangedSections(before, toJSON());
+    updateWatch();
     emit configurationChanged();
 }
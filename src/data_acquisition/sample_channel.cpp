@@ -0,0 +1,38 @@
+#include "data_acquisition/sample_channel.h"
+
+SampleChannel::SampleChannel(QObject* parent)
+    : QObject(parent)
+{
+}
+
+bool SampleChannel::push(const VehicleSample& sample) {
+    if (!queue_.tryPush(sample)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    pushed_.fetch_add(1, std::memory_order_relaxed);
+
+    // Only the first sample after a drain schedules a wake-up
+    if (!wakeup_pending_.exchange(true, std::memory_order_acq_rel)) {
+        emit samplesAvailable();
+    }
+    return true;
+}
+
+int SampleChannel::consume(const std::function<void(const VehicleSample&)>& handler) {
+    // Clear before draining so a push racing with us schedules a new wake-up
+    wakeup_pending_.store(false, std::memory_order_release);
+
+    const int depth = static_cast<int>(queue_.size());
+    if (depth > high_water_mark_.load(std::memory_order_relaxed)) {
+        high_water_mark_.store(depth, std::memory_order_relaxed);
+    }
+
+    int handled = 0;
+    VehicleSample sample;
+    while (queue_.tryPop(sample)) {
+        handler(sample);
+        ++handled;
+    }
+    return handled;
+}
@@ -0,0 +1,85 @@
+#include "data_acquisition/sample_coalescer.h"
+#include <QDebug>
+
+SampleCoalescer::SampleCoalescer(int update_rate_hz, QObject* parent)
+    : QObject(parent)
+    , update_rate_hz_(0)
+    , interval_ms_(0)
+{
+    tick_timer_.setTimerType(Qt::PreciseTimer);
+    connect(&tick_timer_, &QTimer::timeout, this, &SampleCoalescer::onTick);
+    setUpdateRate(update_rate_hz);
+}
+
+void SampleCoalescer::setUpdateRate(int hz) {
+    if (hz < 0 || hz > 1000) {
+        qWarning() << "Invalid update rate:" << hz << "Hz (must be 0-1000)";
+        return;
+    }
+
+    update_rate_hz_ = hz;
+    interval_ms_ = (hz > 0) ? 1000 / hz : 0;
+    tick_timer_.setInterval(interval_ms_);
+
+    if (interval_ms_ == 0) {
+        tick_timer_.stop();
+        flush();
+    }
+
+    qInfo() << "Sample coalescing rate:" << (hz > 0 ? QString::number(hz) + " Hz" : "off");
+}
+
+void SampleCoalescer::submit(const VehicleSample& sample) {
+    if (sample.signal_id < 0) {
+        return;
+    }
+    submitted_count_++;
+
+    if (interval_ms_ == 0) {
+        deliver(sample);
+        return;
+    }
+
+    // Leading edge: nothing delivered recently, so pass straight through
+    if (!tick_timer_.isActive()) {
+        deliver(sample);
+        tick_timer_.start();
+        return;
+    }
+
+    // Slots grow only the first time a signal ID is seen
+    if (sample.signal_id >= latest_.size()) {
+        latest_.resize(sample.signal_id + 1);
+        pending_.resize(sample.signal_id + 1);
+    }
+
+    if (pending_[sample.signal_id]) {
+        coalesced_count_++;
+    } else {
+        pending_[sample.signal_id] = true;
+        pending_ids_.append(sample.signal_id);
+    }
+    latest_[sample.signal_id] = sample;
+}
+
+void SampleCoalescer::flush() {
+    for (int id : pending_ids_) {
+        pending_[id] = false;
+        deliver(latest_[id]);
+    }
+    pending_ids_.clear();
+}
+
+void SampleCoalescer::onTick() {
+    if (pending_ids_.isEmpty()) {
+        // Idle for a full interval: next sample takes the leading edge again
+        tick_timer_.stop();
+        return;
+    }
+    flush();
+}
+
+void SampleCoalescer::deliver(const VehicleSample& sample) {
+    delivered_count_++;
+    emit sampleReady(sample);
+}
@@ -0,0 +1,99 @@
+#include "data_acquisition/signal_registry.h"
+#include "data_acquisition/afb_event_parser.h"
+#include <QDebug>
+#include <cstring>
+
+namespace {
+constexpr int INITIAL_BUCKETS = 16;
+}
+
+SignalRegistry::SignalRegistry() {
+    buckets_.resize(INITIAL_BUCKETS);
+}
+
+int SignalRegistry::intern(const QString& path) {
+    const int existing = findPath(path);
+    if (existing != INVALID_ID) {
+        return existing;
+    }
+
+    QByteArray event_name = QByteArray(EVENT_PREFIX) + path.toLatin1();
+    if (event_name.size() >= AfbEvent::MAX_NAME_LENGTH) {
+        qWarning() << "Signal path too long, not registered:" << path;
+        return INVALID_ID;
+    }
+
+    const int id = paths_.size();
+    paths_.append(path);
+    event_names_.append(event_name);
+    slots_.append(SignalSlot());
+
+    // Keep the load factor at or below 1/2 so probes stay short
+    if (paths_.size() * 2 > buckets_.size()) {
+        rehash(buckets_.size() * 2);
+    } else {
+        const auto hash = AfbEventParser::hashName(event_name.constData(),
+                                                   static_cast<std::size_t>(event_name.size()));
+        const int mask = buckets_.size() - 1;
+        int index = static_cast<int>(hash) & mask;
+        while (buckets_[index].id != INVALID_ID) {
+            index = (index + 1) & mask;
+        }
+        buckets_[index].hash = hash;
+        buckets_[index].id = id;
+    }
+
+    return id;
+}
+
+int SignalRegistry::find(const AfbEvent& event) const {
+    return lookup(event.name, event.name_length, event.name_hash);
+}
+
+int SignalRegistry::findPath(const QString& path) const {
+    const QByteArray event_name = QByteArray(EVENT_PREFIX) + path.toLatin1();
+    const auto hash = AfbEventParser::hashName(event_name.constData(),
+                                               static_cast<std::size_t>(event_name.size()));
+    return lookup(event_name.constData(), event_name.size(), hash);
+}
+
+void SignalRegistry::clear() {
+    paths_.clear();
+    event_names_.clear();
+    slots_.clear();
+    buckets_.fill(Bucket());
+}
+
+int SignalRegistry::lookup(const char* name, int length, std::uint32_t hash) const {
+    const int mask = buckets_.size() - 1;
+    int index = static_cast<int>(hash) & mask;
+
+    while (buckets_[index].id != INVALID_ID) {
+        const Bucket& bucket = buckets_[index];
+        if (bucket.hash == hash) {
+            const QByteArray& candidate = event_names_[bucket.id];
+            if (candidate.size() == length && std::memcmp(candidate.constData(), name, length) == 0) {
+                return bucket.id;
+            }
+        }
+        index = (index + 1) & mask;
+    }
+    return INVALID_ID;
+}
+
+void SignalRegistry::rehash(int bucket_count) {
+    buckets_.fill(Bucket(), bucket_count);
+    const int mask = bucket_count - 1;
+
+    for (int id = 0; id < event_names_.size(); ++id) {
+        const QByteArray& name = event_names_[id];
+        const auto hash = AfbEventParser::hashName(name.constData(),
+                                                   static_cast<std::size_t>(name.size()));
+        int index = static_cast<int>(hash) & mask;
+        while (buckets_[index].id != INVALID_ID) {
+            index = (index + 1) & mask;
+        }
+        buckets_[index].hash = hash;
+        buckets_[index].id = id;
+    }
+}
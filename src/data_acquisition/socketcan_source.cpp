@@ -0,0 +1,132 @@
+#include "data_acquisition/socketcan_source.h"
+#include <QDebug>
+#include <QSocketNotifier>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+std::int64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+}  // namespace
+
+SocketCanSource::SocketCanSource(const QString& interface_name,
+                                 const CanSignalDefinition& signal, QObject* parent)
+    : VehicleDataSource(parent)
+    , interface_name_(interface_name)
+    , signal_(signal)
+    , socket_fd_(-1)
+    , notifier_(nullptr)
+    , frames_read_(0)
+    , decode_errors_(0)
+{
+}
+
+SocketCanSource::~SocketCanSource() {
+    stop();
+}
+
+bool SocketCanSource::start() {
+    stop();
+    
+    const unsigned int if_index = if_nametoindex(interface_name_.toLocal8Bit().constData());
+    if (if_index == 0) {
+        qWarning() << "CAN interface not found:" << interface_name_;
+        emit errorOccurred("CAN interface not found: " + interface_name_);
+        return false;
+    }
+    
+    socket_fd_ = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (socket_fd_ < 0) {
+        qWarning() << "Cannot open CAN socket:" << std::strerror(errno);
+        emit errorOccurred("Cannot open CAN socket");
+        return false;
+    }
+    
+    // Let the kernel drop everything except the speed frame
+    can_filter filter;
+    filter.can_id = signal_.extended ? (signal_.can_id | CAN_EFF_FLAG) : signal_.can_id;
+    filter.can_mask = signal_.extended ? (CAN_EFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG)
+                                       : (CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG);
+    setsockopt(socket_fd_, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter));
+    
+    sockaddr_can address;
+    std::memset(&address, 0, sizeof(address));
+    address.can_family = AF_CAN;
+    address.can_ifindex = static_cast<int>(if_index);
+    if (bind(socket_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        qWarning() << "Cannot bind CAN socket to" << interface_name_ << ":" << std::strerror(errno);
+        emit errorOccurred("Cannot bind CAN socket to " + interface_name_);
+        stop();
+        return false;
+    }
+    
+    notifier_ = new QSocketNotifier(socket_fd_, QSocketNotifier::Read, this);
+    connect(notifier_, &QSocketNotifier::activated, this, &SocketCanSource::onReadable);
+    
+    qInfo() << "Reading" << description();
+    return true;
+}
+
+void SocketCanSource::stop() {
+    if (notifier_) {
+        notifier_->setEnabled(false);
+        delete notifier_;
+        notifier_ = nullptr;
+    }
+    if (socket_fd_ >= 0) {
+        ::close(socket_fd_);
+        socket_fd_ = -1;
+    }
+}
+
+QString SocketCanSource::description() const {
+    return QString("SocketCAN %1, ID 0x%2").arg(interface_name_).arg(signal_.can_id, 0, 16);
+}
+
+void SocketCanSource::onReadable() {
+    can_frame raw;
+    
+    // Drain everything queued so one wakeup handles a burst
+    while (true) {
+        const ssize_t bytes = read(socket_fd_, &raw, sizeof(raw));
+        if (bytes < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                qWarning() << "CAN read failed:" << std::strerror(errno);
+                emit errorOccurred("CAN read failed");
+            }
+            return;
+        }
+        if (bytes != static_cast<ssize_t>(sizeof(raw))) {
+            continue;
+        }
+        
+        const std::int64_t received_ns = monotonicNowNs();
+        ++frames_read_;
+        
+        CanFrame frame;
+        frame.extended = (raw.can_id & CAN_EFF_FLAG) != 0;
+        frame.can_id = raw.can_id & (frame.extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+        frame.length = qMin<int>(raw.can_dlc, CanFrame::MAX_DATA_LENGTH);
+        std::memcpy(frame.data, raw.data, static_cast<std::size_t>(frame.length));
+        
+        double speed = 0.0;
+        if (!CanSignalDecoder::matches(signal_, frame) ||
+            !CanSignalDecoder::decode(signal_, frame, speed)) {
+            ++decode_errors_;
+            continue;
+        }
+        emit speedDecoded(speed, received_ns, 0);
+    }
+}
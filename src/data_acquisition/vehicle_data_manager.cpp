@@ -1,21 +1,49 @@
 #include "data_acquisition/vehicle_data_manager.h"
+#include "data_acquisition/afb_event_parser.h"
+#include "data_acquisition/sample_channel.h"
+#include "data_acquisition/vehicle_data_source.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QDebug>
 #include <QTimer>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+std::int64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+}  // namespace
 
 VehicleDataManager::VehicleDataManager(QObject* parent)
     : QObject(parent)
+    , websocket_(QString(), QWebSocketProtocol::VersionLatest, this)
+    , sample_channel_(nullptr)
+    , data_source_(nullptr)
+    , frame_received_ns_(0)
     , current_speed_(0.0)
     , is_connected_(false)
     , retry_count_(0)
+    , prefer_binary_frames_(false)
+    , binary_frames_supported_(true)
+    , binary_frames_active_(false)
+    , awaiting_format_reply_(false)
+    , reconnect_pending_(false)
 {
+    speed_signal_id_ = registry_.intern(SPEED_PATH);
+    
     connect(&websocket_, &QWebSocket::connected,
             this, &VehicleDataManager::onConnected);
     connect(&websocket_, &QWebSocket::disconnected,
             this, &VehicleDataManager::onDisconnected);
     connect(&websocket_, &QWebSocket::textMessageReceived,
             this, &VehicleDataManager::onTextMessageReceived);
+    connect(&websocket_, &QWebSocket::binaryMessageReceived,
+            this, &VehicleDataManager::onBinaryMessageReceived);
     connect(&websocket_, QOverload<QAbstractSocket::SocketError>::of(&QWebSocket::error),
             this, &VehicleDataManager::onError);
 }
@@ -28,6 +56,16 @@ bool VehicleDataManager::initialize(const QString& url, const QString& token) {
     afb_url_ = url;
     auth_token_ = token;
     
+    if (data_source_) {
+        qInfo() << "Using data source:" << data_source_->description();
+        if (!data_source_->start()) {
+            return false;
+        }
+        is_connected_ = true;
+        emit connectionEstablished();
+        return true;
+    }
+    
     QString ws_url = afb_url_;
     if (!token.isEmpty()) {
         ws_url += QString("?token=%1").arg(token);
@@ -41,24 +79,93 @@ bool VehicleDataManager::initialize(const QString& url, const QString& token) {
     return true;
 }
 
-void VehicleDataManager::subscribeToSpeed() {
+void VehicleDataManager::reconnectTo(const QString& url, const QString& token) {
+    afb_url_ = url;
+    auth_token_ = token;
+    retry_count_ = 0;
+    binary_frames_supported_ = true;   // A different binding may accept CBOR
+    
+    if (data_source_) {
+        websocket_.abort();   // Switching from the AFB to a direct source
+        data_source_->stop();
+        is_connected_ = false;
+        initialize(url, token);
+        return;
+    }
+    if (websocket_.state() == QAbstractSocket::ConnectedState) {
+        qInfo() << "Closing AFB connection to reconnect";
+        reconnect_pending_ = true;
+        websocket_.close();
+        return;
+    }
+    websocket_.abort();   // Attempt still connecting to the old endpoint
+    initialize(url, token);
+}
+
+void VehicleDataManager::setDataSource(VehicleDataSource* source) {
+    if (data_source_) {
+        data_source_->stop();
+        delete data_source_;
+    }
+    
+    data_source_ = source;
+    if (data_source_) {
+        data_source_->setParent(this);
+        connect(data_source_, &VehicleDataSource::speedDecoded,
+                this, &VehicleDataManager::onSourceSpeed);
+        connect(data_source_, &VehicleDataSource::errorOccurred,
+                this, &VehicleDataManager::errorOccurred);
+    }
+}
+
+void VehicleDataManager::setSignals(const QStringList& paths) {
+    for (const QString& path : paths) {
+        if (registry_.intern(path) == SignalRegistry::INVALID_ID) {
+            emit errorOccurred("Cannot register signal: " + path);
+        }
+    }
+    qInfo() << "Registered" << registry_.size() << "VSS signals";
+}
+
+void VehicleDataManager::subscribeToSignals() {
+    if (data_source_) {
+        // Direct sources deliver the speed signal only; nothing to subscribe
+        return;
+    }
     if (!is_connected_) {
         qWarning() << "Not connected, cannot subscribe";
         return;
     }
     
-    QJsonObject request;
-    request["api"] = "vss";
-    request["verb"] = "subscribe";
-    
-    QJsonObject args;
-    args["path"] = "Vehicle.Speed";
-    request["args"] = args;
+    // Ask for CBOR frames unless the binding already turned them down
+    binary_frames_active_ = prefer_binary_frames_ && binary_frames_supported_;
+    awaiting_format_reply_ = binary_frames_active_;
     
-    QString message = QJsonDocument(request).toJson(QJsonDocument::Compact);
-    websocket_.sendTextMessage(message);
+    for (int id = 0; id < registry_.size(); ++id) {
+        QJsonObject request;
+        request["api"] = "vss";
+        request["verb"] = "subscribe";
+        
+        QJsonObject args;
+        args["path"] = registry_.path(id);
+        if (binary_frames_active_) {
+            args["format"] = "cbor";
+        }
+        request["args"] = args;
+        
+        QString message = QJsonDocument(request).toJson(QJsonDocument::Compact);
+        websocket_.sendTextMessage(message);
+    }
     
-    qInfo() << "Subscribed to Vehicle.Speed";
+    qInfo() << "Subscribed to" << registry_.size() << "VSS signals"
+            << (binary_frames_active_ ? "(binary frames requested)" : "");
+}
+
+const SignalSlot* VehicleDataManager::latestValue(int signal_id) const {
+    if (signal_id < 0 || signal_id >= registry_.size()) {
+        return nullptr;
+    }
+    return &registry_.slot(signal_id);
 }
 
 bool VehicleDataManager::isDataValid() const {
@@ -66,7 +173,7 @@ bool VehicleDataManager::isDataValid() const {
         return false;
     }
     
-    auto now = std::chrono::system_clock::now();
+    auto now = std::chrono::steady_clock::now();
     auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - last_update_
     );
@@ -75,6 +182,11 @@ bool VehicleDataManager::isDataValid() const {
 }
 
 void VehicleDataManager::shutdown() {
+    if (data_source_) {
+        data_source_->stop();
+        is_connected_ = false;
+        return;
+    }
     if (is_connected_) {
         websocket_.close();
         is_connected_ = false;
@@ -87,13 +199,22 @@ void VehicleDataManager::onConnected() {
     retry_count_ = 0;
     emit connectionEstablished();
     
-    // Auto-subscribe to speed
-    subscribeToSpeed();
+    // Auto-subscribe to configured signals
+    subscribeToSignals();
 }
 
 void VehicleDataManager::onDisconnected() {
-    qWarning() << "Disconnected from AFB";
+    if (data_source_) {
+        return;   // The WebSocket was closed for a direct source
+    }
     is_connected_ = false;
+    if (reconnect_pending_) {
+        // Closed by reconnectTo(); open the new connection right away
+        reconnect_pending_ = false;
+        initialize(afb_url_, auth_token_);
+        return;
+    }
+    qWarning() << "Disconnected from AFB";
     emit connectionLost();
     
     // Schedule reconnect
@@ -101,6 +222,30 @@ void VehicleDataManager::onDisconnected() {
 }
 
 void VehicleDataManager::onTextMessageReceived(const QString& message) {
+    frame_received_ns_ = monotonicNowNs();
+    
+    // Fast path: decode the event envelope in place without building a DOM
+    AfbEvent event;
+    const auto result = AfbEventParser::parse(
+        reinterpret_cast<const char16_t*>(message.utf16()),
+        static_cast<std::size_t>(message.size()),
+        event
+    );
+    
+    if (result == AfbEventParser::Result::Event) {
+        if (binary_frames_active_) {
+            // Binding ignored the format argument and keeps sending text
+            binary_frames_active_ = false;
+            awaiting_format_reply_ = false;
+        }
+        handleEvent(event);
+        return;
+    }
+    if (result == AfbEventParser::Result::NotEvent && !awaiting_format_reply_) {
+        return;
+    }
+    
+    // Fallback for frames the fast decoder does not understand
     QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
     if (!doc.isObject()) {
         qWarning() << "Invalid JSON received";
@@ -110,9 +255,30 @@ void VehicleDataManager::onTextMessageReceived(const QString& message) {
     QJsonObject obj = doc.object();
     
     // Check if this is a VSS event
-    if (obj.contains("event") && obj["event"].toString() == "vss/Vehicle.Speed") {
-        QJsonObject data = obj["data"].toObject();
-        handleSpeedUpdate(data);
+    if (obj.contains("event")) {
+        if (eventFromJson(obj, event)) {
+            handleEvent(event);
+        }
+    } else if (awaiting_format_reply_ && obj.contains("request")) {
+        handleSubscribeReply(obj);
+    }
+}
+
+void VehicleDataManager::onBinaryMessageReceived(const QByteArray& message) {
+    frame_received_ns_ = monotonicNowNs();
+    
+    AfbEvent event;
+    const auto result = AfbEventParser::parseCbor(
+        reinterpret_cast<const std::uint8_t*>(message.constData()),
+        static_cast<std::size_t>(message.size()),
+        event
+    );
+    
+    if (result == AfbEventParser::Result::Event) {
+        awaiting_format_reply_ = false;
+        handleEvent(event);
+    } else if (result == AfbEventParser::Result::Unsupported) {
+        qWarning() << "Invalid binary frame received (" << message.size() << "bytes)";
     }
 }
 
@@ -121,30 +287,146 @@ void VehicleDataManager::onError(QAbstractSocket::SocketError error) {
     emit errorOccurred(websocket_.errorString());
 }
 
-void VehicleDataManager::handleSpeedUpdate(const QJsonObject& data) {
-    if (!data.contains("value")) {
+void VehicleDataManager::onSourceSpeed(double speed, qint64 received_ns,
+                                       qint64 source_timestamp_ms) {
+    frame_received_ns_ = received_ns;
+    publishSpeed(speed, source_timestamp_ms);
+}
+
+void VehicleDataManager::handleEvent(const AfbEvent& event) {
+    const int id = registry_.find(event);
+    if (id == SignalRegistry::INVALID_ID) {
+        return;
+    }
+    
+    if (id == speed_signal_id_) {
+        handleSpeedEvent(event);
+        return;
+    }
+    
+    if (!event.has_value || !std::isfinite(event.value)) {
+        return;
+    }
+    
+    SignalSlot& slot = registry_.slot(id);
+    slot.type = event.value_is_bool ? SignalSlot::Type::Boolean : SignalSlot::Type::Number;
+    slot.value = event.value;
+    slot.timestamp_ms = event.has_timestamp ? event.timestamp_ms : 0;
+    slot.update_count++;
+    slot.valid = true;
+    
+    deliverSample({id, event.value, frame_received_ns_, slot.timestamp_ms});
+}
+
+void VehicleDataManager::handleSpeedEvent(const AfbEvent& event) {
+    if (!event.has_value) {
         qWarning() << "Speed data missing 'value' field";
         return;
     }
+    if (event.value_is_bool) {
+        qWarning() << "Speed value is not a number";
+        return;
+    }
     
-    double speed = data["value"].toDouble();
-    QString unit = data["unit"].toString("km/h");
+    if (event.has_unit && !event.unitEquals("km/h")) {
+        qWarning() << "Unexpected unit:" << event.unit;
+        return;
+    }
+    
+    publishSpeed(event.value, event.has_timestamp ? event.timestamp_ms : 0);
+}
+
+bool VehicleDataManager::eventFromJson(const QJsonObject& obj, AfbEvent& event) {
+    event = AfbEvent();
+    
+    const QByteArray name = obj["event"].toString().toLatin1();
+    if (name.size() >= AfbEvent::MAX_NAME_LENGTH) {
+        return false;
+    }
+    std::memcpy(event.name, name.constData(), static_cast<std::size_t>(name.size()));
+    event.name_length = name.size();
+    event.name_hash = AfbEventParser::hashName(name.constData(),
+                                               static_cast<std::size_t>(name.size()));
+    
+    const QJsonValue data = obj["data"];
+    QJsonValue value = data;
+    if (data.isObject()) {
+        const QJsonObject data_obj = data.toObject();
+        value = data_obj["value"];
+        
+        if (data_obj.contains("unit")) {
+            const QByteArray unit = data_obj["unit"].toString().toLatin1();
+            if (unit.size() >= AfbEvent::MAX_UNIT_LENGTH) {
+                return false;
+            }
+            std::memcpy(event.unit, unit.constData(), static_cast<std::size_t>(unit.size()));
+            event.unit_length = unit.size();
+            event.has_unit = true;
+        }
+        if (data_obj.contains("timestamp")) {
+            event.has_timestamp = AfbEventParser::timestampFromDouble(
+                data_obj["timestamp"].toDouble(), event.timestamp_ms);
+        }
+    }
+    
+    if (value.isDouble()) {
+        event.value = value.toDouble();
+        event.has_value = true;
+    } else if (value.isBool()) {
+        event.value = value.toBool() ? 1.0 : 0.0;
+        event.value_is_bool = true;
+        event.has_value = true;
+    }
+    return true;
+}
+
+void VehicleDataManager::handleSubscribeReply(const QJsonObject& reply) {
+    awaiting_format_reply_ = false;
     
-    if (unit != "km/h") {
-        qWarning() << "Unexpected unit:" << unit;
+    const QString status = reply["request"].toObject()["status"].toString();
+    if (status == "success") {
+        qInfo() << "Binding accepted binary event frames";
         return;
     }
     
-    // Validate speed
-    if (speed < 0 || speed > 300) {
+    // Binding does not know the format argument: fall back to JSON text frames
+    qWarning() << "Binary frames rejected (" << status << "), falling back to JSON";
+    binary_frames_supported_ = false;
+    subscribeToSignals();
+}
+
+void VehicleDataManager::publishSpeed(double speed, std::int64_t timestamp_ms) {
+    // Validate speed (NaN fails every comparison)
+    if (!std::isfinite(speed) || speed < 0 || speed > 300) {
         qWarning() << "Invalid speed value:" << speed;
         return;
     }
     
     current_speed_ = speed;
-    last_update_ = std::chrono::system_clock::now();
+    last_update_ = std::chrono::steady_clock::now();
+    
+    SignalSlot& slot = registry_.slot(speed_signal_id_);
+    slot.value = speed;
+    slot.timestamp_ms = timestamp_ms;
+    slot.update_count++;
+    slot.valid = true;
+    
+    deliverSample({speed_signal_id_, speed, frame_received_ns_, timestamp_ms});
+}
+
+void VehicleDataManager::deliverSample(VehicleSample sample) {
+    sample.decoded_ns = monotonicNowNs();
+    
+    if (sample_channel_) {
+        sample_channel_->push(sample);
+        return;
+    }
     
-    emit speedUpdated(speed);
+    if (sample.signal_id == speed_signal_id_) {
+        emit speedUpdated(sample.value);
+    }
+    emit signalUpdated(sample.signal_id, sample.value);
+    emit sampleReceived(sample);
 }
 
 void VehicleDataManager::reconnect() {
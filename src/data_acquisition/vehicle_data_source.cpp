@@ -0,0 +1,33 @@
+#include "data_acquisition/vehicle_data_source.h"
+#include <QDebug>
+
+#ifdef CARSPEEDBOY_CAN_BACKEND
+#include "data_acquisition/candump_log_source.h"
+#include "data_acquisition/socketcan_source.h"
+#endif
+
+std::unique_ptr<VehicleDataSource> VehicleDataSource::create(
+    const ConfigurationManager::DataSourceConfig& config) {
+    if (config.type == "afb") {
+        return nullptr;
+    }
+    
+#ifdef CARSPEEDBOY_CAN_BACKEND
+    if (!config.speed_signal.isValid()) {
+        qWarning() << "Invalid speed signal definition, using AFB";
+        return nullptr;
+    }
+    if (config.type == "socketcan") {
+        return std::make_unique<SocketCanSource>(config.can_interface, config.speed_signal);
+    }
+    if (config.type == "candump") {
+        return std::make_unique<CandumpLogSource>(config.candump_file, config.speed_signal,
+                                                  config.replay_speed);
+    }
+    qWarning() << "Unknown data source type:" << config.type << "- using AFB";
+#else
+    qWarning() << "Data source" << config.type
+               << "requires a build with ENABLE_CAN_BACKEND - using AFB";
+#endif
+    return nullptr;
+}
@@ -0,0 +1,98 @@
+#include "diagnostics/latency_histogram.h"
+
+namespace {
+
+int highestBit(std::uint64_t value) {
+    return 63 - __builtin_clzll(value);
+}
+
+}  // namespace
+
+int LatencyHistogram::bucketIndex(std::uint64_t ns) {
+    if (ns < static_cast<std::uint64_t>(SUB_BUCKETS)) {
+        return static_cast<int>(ns);
+    }
+    int msb = highestBit(ns);
+    if (msb > MAX_EXPONENT) {
+        return BUCKET_COUNT - 1;
+    }
+    const int group = msb - SUB_BUCKET_BITS + 1;
+    const int sub = static_cast<int>((ns >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+    return group * SUB_BUCKETS + sub;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(int index) {
+    if (index < SUB_BUCKETS) {
+        return static_cast<std::uint64_t>(index);
+    }
+    const int group = index / SUB_BUCKETS;
+    const int sub = index % SUB_BUCKETS;
+    const std::uint64_t lower = static_cast<std::uint64_t>(SUB_BUCKETS + sub) << (group - 1);
+    return lower + (std::uint64_t(1) << (group - 1)) - 1;
+}
+
+void LatencyHistogram::record(std::int64_t ns) {
+    if (ns < 0) {
+        ns = 0;
+    }
+    const auto value = static_cast<std::uint64_t>(ns);
+    buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    // Single writer: plain compare is enough
+    if (ns < min_.load(std::memory_order_relaxed)) {
+        min_.store(ns, std::memory_order_relaxed);
+    }
+    if (ns > max_.load(std::memory_order_relaxed)) {
+        max_.store(ns, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<std::int64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+std::int64_t LatencyHistogram::minNs() const {
+    return count() == 0 ? 0 : min_.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::meanNs() const {
+    const std::uint64_t n = count();
+    return n == 0 ? 0.0
+                  : static_cast<double>(sum_.load(std::memory_order_relaxed)) /
+                        static_cast<double>(n);
+}
+
+std::int64_t LatencyHistogram::percentileNs(double percentile) const {
+    const std::uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    } else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+
+    auto target = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(n) + 0.5);
+    if (target == 0) {
+        target = 1;
+    }
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            const auto bound = static_cast<std::int64_t>(bucketUpperBound(i));
+            return bound < maxNs() ? bound : maxNs();
+        }
+    }
+    return maxNs();
+}
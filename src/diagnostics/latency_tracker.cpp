@@ -0,0 +1,73 @@
+#include "diagnostics/latency_tracker.h"
+#include <QDebug>
+#include <chrono>
+
+namespace {
+
+double toMicroseconds(double ns) {
+    return ns / 1000.0;
+}
+
+}  // namespace
+
+void LatencyTracker::record(Stage stage, std::int64_t received_ns, std::int64_t now_ns) {
+    if (received_ns <= 0) {
+        return;
+    }
+    histograms_[static_cast<int>(stage)].record(now_ns - received_ns);
+}
+
+void LatencyTracker::reset() {
+    for (auto& histogram : histograms_) {
+        histogram.reset();
+    }
+}
+
+QVariantMap LatencyTracker::summary() const {
+    QVariantMap result;
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const LatencyHistogram& histogram = histograms_[i];
+        QVariantMap stage;
+        stage["count"] = static_cast<qulonglong>(histogram.count());
+        stage["min_us"] = toMicroseconds(histogram.minNs());
+        stage["mean_us"] = toMicroseconds(histogram.meanNs());
+        stage["p50_us"] = toMicroseconds(histogram.percentileNs(50.0));
+        stage["p99_us"] = toMicroseconds(histogram.percentileNs(99.0));
+        stage["max_us"] = toMicroseconds(histogram.maxNs());
+        result[stageName(static_cast<Stage>(i))] = stage;
+    }
+    return result;
+}
+
+void LatencyTracker::logReport() const {
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        const LatencyHistogram& histogram = histograms_[i];
+        if (histogram.count() == 0) {
+            continue;
+        }
+        qInfo().nospace() << "Latency " << stageName(static_cast<Stage>(i))
+                          << ": n=" << histogram.count()
+                          << " p50=" << toMicroseconds(histogram.percentileNs(50.0)) << "us"
+                          << " p99=" << toMicroseconds(histogram.percentileNs(99.0)) << "us"
+                          << " max=" << toMicroseconds(histogram.maxNs()) << "us";
+    }
+}
+
+const char* LatencyTracker::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Decode: return "decode";
+        case Stage::Dispatch: return "dispatch";
+        case Stage::Smoothing: return "smoothing";
+        case Stage::StateMachine: return "state_machine";
+        case Stage::PropertyUpdate: return "property_update";
+        case Stage::FrameSwapped: return "frame_swapped";
+        case Stage::Count: break;
+    }
+    return "unknown";
+}
+
+std::int64_t LatencyTracker::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
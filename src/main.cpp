@@ -2,6 +2,7 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QQuickWindow>
 #include <QDebug>
 
 int main(int argc, char* argv[]) {
@@ -39,6 +40,21 @@ int main(int argc, char* argv[]) {
     
     engine.load(url);
     
+    // Close the latency measurement at the frame that shows each sample and
+    // drive the per-frame speed extrapolation
+    if (!engine.rootObjects().isEmpty()) {
+        auto* window = qobject_cast<QQuickWindow*>(engine.rootObjects().first());
+        if (window) {
+            QObject::connect(window, &QQuickWindow::frameSwapped,
+                             &controller, &ApplicationController::onFrameSwapped,
+                             Qt::DirectConnection);
+            
+            // Sample the extrapolated speed once per frame, before sync
+            QObject::connect(window, &QQuickWindow::afterAnimating,
+                             &controller, &ApplicationController::onBeforeFrame);
+        }
+    }
+    
     qInfo() << "CarSpeedBoy running";
     
     return app.exec();
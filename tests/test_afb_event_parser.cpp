@@ -0,0 +1,272 @@
+#include <QtTest/QtTest>
+#include <QCborMap>
+#include <QCborValue>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "afb_event_parser.h"
+
+/**
+ * @brief Unit tests for AfbEventParser
+ */
+class TestAfbEventParser : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Test cases
+    void testSpeedEvent();
+    void testSpeedEventUtf16();
+    void testReplyIsNotEvent();
+    void testScalarData();
+    void testBooleanValue();
+    void testUnsupportedFrames_data();
+    void testUnsupportedFrames();
+    void testMatchesQJsonDocument_data();
+    void testMatchesQJsonDocument();
+    void testNameHash();
+    void testTimestampOutOfRange();
+    void testCborSpeedEvent();
+    void testCborScalarData();
+    void testCborUnsupportedFrames();
+    void testCborNonFiniteValue();
+
+private:
+    AfbEventParser::Result parseUtf8(const QByteArray& frame, AfbEvent& event);
+    AfbEventParser::Result parseCbor(const QByteArray& frame, AfbEvent& event);
+};
+
+void TestAfbEventParser::initTestCase() {
+    qInfo() << "Starting AfbEventParser tests";
+}
+
+void TestAfbEventParser::cleanupTestCase() {
+    qInfo() << "AfbEventParser tests completed";
+}
+
+AfbEventParser::Result TestAfbEventParser::parseUtf8(const QByteArray& frame, AfbEvent& event) {
+    return AfbEventParser::parse(frame.constData(), static_cast<std::size_t>(frame.size()), event);
+}
+
+AfbEventParser::Result TestAfbEventParser::parseCbor(const QByteArray& frame, AfbEvent& event) {
+    return AfbEventParser::parseCbor(reinterpret_cast<const std::uint8_t*>(frame.constData()),
+                                     static_cast<std::size_t>(frame.size()), event);
+}
+
+void TestAfbEventParser::testSpeedEvent() {
+    const QByteArray frame =
+        R"({"jtype":"afb-event","event":"vss/Vehicle.Speed",)"
+        R"("data":{"path":"Vehicle.Speed","value":65.5,"unit":"km/h","timestamp":1699964123456}})";
+
+    AfbEvent event;
+    QCOMPARE(parseUtf8(frame, event), AfbEventParser::Result::Event);
+    QVERIFY(event.nameEquals("vss/Vehicle.Speed"));
+    QVERIFY(event.has_value);
+    QCOMPARE(event.value, 65.5);
+    QVERIFY(event.has_unit);
+    QVERIFY(event.unitEquals("km/h"));
+    QVERIFY(event.has_timestamp);
+    QCOMPARE(event.timestamp_ms, static_cast<std::int64_t>(1699964123456LL));
+}
+
+void TestAfbEventParser::testSpeedEventUtf16() {
+    const QString frame = R"({ "event" : "vss/Vehicle.Speed", "data" : { "value" : 42.25 } })";
+
+    AfbEvent event;
+    const auto result = AfbEventParser::parse(reinterpret_cast<const char16_t*>(frame.utf16()),
+                                              static_cast<std::size_t>(frame.size()), event);
+    QCOMPARE(result, AfbEventParser::Result::Event);
+    QVERIFY(event.nameEquals("vss/Vehicle.Speed"));
+    QCOMPARE(event.value, 42.25);
+    QVERIFY(!event.has_unit);
+}
+
+void TestAfbEventParser::testReplyIsNotEvent() {
+    const QByteArray frame =
+        R"({"jtype":"afb-reply","request":{"status":"success","info":"a \"quoted\" }"},)"
+        R"("response":[1,2,{"nested":[true,false,null]}]})";
+
+    AfbEvent event;
+    QCOMPARE(parseUtf8(frame, event), AfbEventParser::Result::NotEvent);
+}
+
+void TestAfbEventParser::testScalarData() {
+    AfbEvent event;
+    QCOMPARE(parseUtf8(R"({"event":"vss/Vehicle.Speed","data":-3})", event),
+             AfbEventParser::Result::Event);
+    QVERIFY(event.has_value);
+    QCOMPARE(event.value, -3.0);
+}
+
+void TestAfbEventParser::testBooleanValue() {
+    // Booleans are left to QJsonDocument rather than converted here
+    AfbEvent event;
+    QCOMPARE(parseUtf8(R"({"event":"vss/Vehicle.IsMoving","data":{"value":true}})", event),
+             AfbEventParser::Result::Unsupported);
+    QCOMPARE(parseUtf8(R"({"event":"vss/Vehicle.IsMoving","data":false})", event),
+             AfbEventParser::Result::Unsupported);
+}
+
+void TestAfbEventParser::testUnsupportedFrames_data() {
+    QTest::addColumn<QByteArray>("frame");
+
+    QTest::newRow("not json") << QByteArray("garbage");
+    QTest::newRow("array") << QByteArray("[1,2,3]");
+    QTest::newRow("truncated") << QByteArray(R"({"event":"vss/Vehicle.Speed","data":{"val)");
+    QTest::newRow("escaped name") << QByteArray(R"({"event":"vss\/Vehicle.Speed","data":1})");
+    QTest::newRow("huge exponent") << QByteArray(R"({"event":"e","data":{"value":1e400}})");
+    QTest::newRow("string value") << QByteArray(R"({"event":"e","data":{"value":"fast"}})");
+    QTest::newRow("null data") << QByteArray(R"({"event":"e","data":null})");
+    QTest::newRow("truncated after data") << QByteArray(R"({"event":"e","data":1,"jtype":"afb)");
+    QTest::newRow("unclosed object") << QByteArray(R"({"event":"e","data":1)");
+    QTest::newRow("unbalanced tail") << QByteArray(R"({"event":"e","data":1,"x":[1}})");
+    QTest::newRow("trailing garbage") << QByteArray(R"({"event":"e","data":1}})");
+}
+
+void TestAfbEventParser::testUnsupportedFrames() {
+    QFETCH(QByteArray, frame);
+
+    AfbEvent event;
+    QCOMPARE(parseUtf8(frame, event), AfbEventParser::Result::Unsupported);
+}
+
+void TestAfbEventParser::testMatchesQJsonDocument_data() {
+    QTest::addColumn<QByteArray>("number");
+
+    QTest::newRow("zero") << QByteArray("0");
+    QTest::newRow("integer") << QByteArray("120");
+    QTest::newRow("one decimal") << QByteArray("65.5");
+    QTest::newRow("tenth") << QByteArray("0.1");
+    QTest::newRow("many decimals") << QByteArray("88.123456789");
+    QTest::newRow("exponent") << QByteArray("1.25e2");
+    QTest::newRow("negative") << QByteArray("-0.75");
+}
+
+void TestAfbEventParser::testMatchesQJsonDocument() {
+    QFETCH(QByteArray, number);
+
+    const QByteArray frame = R"({"event":"vss/Vehicle.Speed","data":{"value":)" + number + "}}";
+    const double expected =
+        QJsonDocument::fromJson(frame).object()["data"].toObject()["value"].toDouble();
+
+    AfbEvent event;
+    QCOMPARE(parseUtf8(frame, event), AfbEventParser::Result::Event);
+    QCOMPARE(event.value, expected);
+}
+
+void TestAfbEventParser::testNameHash() {
+    AfbEvent event;
+    QCOMPARE(parseUtf8(R"({"event":"vss/Vehicle.Speed","data":1})", event),
+             AfbEventParser::Result::Event);
+    QCOMPARE(event.name_hash, AfbEventParser::hashName("vss/Vehicle.Speed", 17));
+    QVERIFY(event.name_hash != AfbEventParser::hashName("vss/Vehicle.Speee", 17));
+}
+
+void TestAfbEventParser::testTimestampOutOfRange() {
+    AfbEvent event;
+    QCOMPARE(parseUtf8(R"({"event":"e","data":{"value":1,"timestamp":1e22}})", event),
+             AfbEventParser::Result::Event);
+    QVERIFY(event.has_value);
+    QVERIFY(!event.has_timestamp);
+
+    QCOMPARE(parseUtf8(R"({"event":"e","data":{"value":1,"timestamp":1.7e12}})", event),
+             AfbEventParser::Result::Event);
+    QVERIFY(event.has_timestamp);
+    QCOMPARE(event.timestamp_ms, static_cast<std::int64_t>(1700000000000LL));
+
+    std::int64_t timestamp_ms = 0;
+    QVERIFY(!AfbEventParser::timestampFromDouble(1e30, timestamp_ms));
+    QVERIFY(!AfbEventParser::timestampFromDouble(-1e30, timestamp_ms));
+    QVERIFY(!AfbEventParser::timestampFromDouble(qQNaN(), timestamp_ms));
+    QVERIFY(AfbEventParser::timestampFromDouble(-1.5, timestamp_ms));
+    QCOMPARE(timestamp_ms, static_cast<std::int64_t>(-1));
+}
+
+void TestAfbEventParser::testCborSpeedEvent() {
+    QCborMap data;
+    data[QStringLiteral("path")] = QStringLiteral("Vehicle.Speed");
+    data[QStringLiteral("value")] = 65.5;
+    data[QStringLiteral("unit")] = QStringLiteral("km/h");
+    data[QStringLiteral("timestamp")] = Q_INT64_C(1699964123456);
+
+    QCborMap frame;
+    frame[QStringLiteral("jtype")] = QStringLiteral("afb-event");
+    frame[QStringLiteral("event")] = QStringLiteral("vss/Vehicle.Speed");
+    frame[QStringLiteral("data")] = data;
+
+    AfbEvent event;
+    QCOMPARE(parseCbor(frame.toCborValue().toCbor(), event), AfbEventParser::Result::Event);
+    QVERIFY(event.nameEquals("vss/Vehicle.Speed"));
+    QCOMPARE(event.value, 65.5);
+    QVERIFY(event.unitEquals("km/h"));
+    QCOMPARE(event.timestamp_ms, static_cast<std::int64_t>(1699964123456LL));
+}
+
+void TestAfbEventParser::testCborScalarData() {
+    QCborMap frame;
+    frame[QStringLiteral("event")] = QStringLiteral("vss/Vehicle.Speed");
+    frame[QStringLiteral("data")] = 88;
+
+    AfbEvent event;
+    QCOMPARE(parseCbor(frame.toCborValue().toCbor(), event), AfbEventParser::Result::Event);
+    QCOMPARE(event.value, 88.0);
+}
+
+void TestAfbEventParser::testCborUnsupportedFrames() {
+    AfbEvent event;
+
+    // Not a map
+    QCOMPARE(parseCbor(QCborValue(42).toCbor(), event), AfbEventParser::Result::Unsupported);
+
+    // Indefinite-length map
+    QCOMPARE(parseCbor(QByteArray::fromHex("bf656576656e74ff"), event),
+             AfbEventParser::Result::Unsupported);
+
+    // Truncated frame
+    QCborMap frame;
+    frame[QStringLiteral("event")] = QStringLiteral("vss/Vehicle.Speed");
+    frame[QStringLiteral("data")] = 88.5;
+    const QByteArray bytes = frame.toCborValue().toCbor();
+    QCOMPARE(parseCbor(bytes.left(bytes.size() - 3), event), AfbEventParser::Result::Unsupported);
+
+    // Trailing bytes after the map
+    QCOMPARE(parseCbor(bytes + QByteArray::fromHex("00"), event),
+             AfbEventParser::Result::Unsupported);
+}
+
+void TestAfbEventParser::testCborNonFiniteValue() {
+    // NaN or infinity must never reach the speed path
+    for (const double value : {qQNaN(), qInf(), -qInf()}) {
+        QCborMap data;
+        data[QStringLiteral("value")] = value;
+        QCborMap frame;
+        frame[QStringLiteral("event")] = QStringLiteral("vss/Vehicle.Speed");
+        frame[QStringLiteral("data")] = data;
+
+        AfbEvent event;
+        QCOMPARE(parseCbor(frame.toCborValue().toCbor(), event),
+                 AfbEventParser::Result::Unsupported);
+    }
+
+    // A float timestamp beyond int64 is dropped, the value kept
+    QCborMap data;
+    data[QStringLiteral("value")] = 50.0;
+    data[QStringLiteral("timestamp")] = 1e30;
+    QCborMap frame;
+    frame[QStringLiteral("event")] = QStringLiteral("vss/Vehicle.Speed");
+    frame[QStringLiteral("data")] = data;
+    AfbEvent event;
+    QCOMPARE(parseCbor(frame.toCborValue().toCbor(), event), AfbEventParser::Result::Event);
+    QCOMPARE(event.value, 50.0);
+    QVERIFY(!event.has_timestamp);
+
+    // Half and single precision NaN as bare data: f9 7e00, fa 7fc00000
+    QCOMPARE(parseCbor(QByteArray::fromHex("a2656576656e7461656464617461f97e00"), event),
+             AfbEventParser::Result::Unsupported);
+    QCOMPARE(parseCbor(QByteArray::fromHex("a2656576656e7461656464617461fa7fc00000"), event),
+             AfbEventParser::Result::Unsupported);
+}
+
+QTEST_MAIN(TestAfbEventParser)
+#include "test_afb_event_parser.moc"
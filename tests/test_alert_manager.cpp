@@ -0,0 +1,149 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <type_traits>
+#include "alert_manager.h"
+
+/**
+ * @brief Unit tests for AlertManager and its history ring
+ */
+class TestAlertManager : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testAlertLevels();
+    void testHistoryRecordLayout();
+    void testHistoryWrapsAtCapacity();
+    void testRecentAlerts();
+    void testRangeQuery();
+    void testFormatting();
+
+private:
+    // Alternate ALERT/NORMAL so every call adds one history entry
+    void raiseAlerts(int count);
+
+    AlertManager* alert_manager_;
+};
+
+void TestAlertManager::initTestCase() {
+    qInfo() << "Starting AlertManager tests";
+}
+
+void TestAlertManager::cleanupTestCase() {
+    qInfo() << "AlertManager tests completed";
+}
+
+void TestAlertManager::init() {
+    alert_manager_ = new AlertManager();
+}
+
+void TestAlertManager::cleanup() {
+    delete alert_manager_;
+    alert_manager_ = nullptr;
+}
+
+void TestAlertManager::raiseAlerts(int count) {
+    for (int i = 0; i < count; ++i) {
+        alert_manager_->onStateChanged(ExpressionState::NORMAL, ExpressionState::ALERT);
+        alert_manager_->onStateChanged(ExpressionState::ALERT, ExpressionState::NORMAL);
+    }
+}
+
+void TestAlertManager::testAlertLevels() {
+    QSignalSpy triggeredSpy(alert_manager_, &AlertManager::alertTriggered);
+    QSignalSpy clearedSpy(alert_manager_, &AlertManager::alertCleared);
+
+    alert_manager_->onStateChanged(ExpressionState::NORMAL, ExpressionState::WARNING);
+    QCOMPARE(alert_manager_->currentAlertLevel(), AlertManager::AlertLevel::WARNING);
+    alert_manager_->onStateChanged(ExpressionState::WARNING, ExpressionState::SCARED);
+    alert_manager_->onStateChanged(ExpressionState::SCARED, ExpressionState::RELAXED);
+
+    QCOMPARE(triggeredSpy.count(), 2);
+    QCOMPARE(clearedSpy.count(), 1);
+    QCOMPARE(alert_manager_->alertHistorySize(), 2);
+}
+
+void TestAlertManager::testHistoryRecordLayout() {
+    static_assert(sizeof(AlertRecord) == 16, "AlertRecord should stay compact");
+    static_assert(std::is_trivially_copyable<AlertRecord>::value, "AlertRecord must be POD-like");
+
+    alert_manager_->onStateChanged(ExpressionState::NORMAL, ExpressionState::SCARED);
+    const AlertRecord& record = alert_manager_->history().at(0);
+    QCOMPARE(record.level, quint8(AlertManager::AlertLevel::CRITICAL));
+    QCOMPARE(record.state, quint8(ExpressionState::SCARED));
+    QCOMPARE(record.sequence, quint32(0));
+}
+
+void TestAlertManager::testHistoryWrapsAtCapacity() {
+    raiseAlerts(AlertManager::MAX_HISTORY_SIZE + 25);
+
+    const auto& history = alert_manager_->history();
+    QCOMPARE(alert_manager_->alertHistorySize(), AlertManager::MAX_HISTORY_SIZE);
+    QCOMPARE(history.at(0).sequence, quint32(25));
+    QCOMPARE(history.at(history.size() - 1).sequence,
+             quint32(AlertManager::MAX_HISTORY_SIZE + 24));
+
+    alert_manager_->clearHistory();
+    QCOMPARE(alert_manager_->alertHistorySize(), 0);
+}
+
+void TestAlertManager::testRecentAlerts() {
+    raiseAlerts(5);
+
+    const QVariantList recent = alert_manager_->recentAlerts(3);
+    QCOMPARE(recent.size(), 3);
+
+    // Newest first
+    QCOMPARE(alert_manager_->history().at(4).sequence, quint32(4));
+    QCOMPARE(recent.at(0).toMap()["level"].toInt(), int(AlertManager::AlertLevel::INFO));
+    QVERIFY(recent.at(0).toMap()["time"].toDateTime() >= recent.at(2).toMap()["time"].toDateTime());
+
+    QCOMPARE(alert_manager_->recentAlerts(50).size(), 5);
+    QVERIFY(alert_manager_->recentAlerts(0).isEmpty());
+}
+
+void TestAlertManager::testRangeQuery() {
+    AlertHistory<8> history;
+    for (int i = 0; i < 12; ++i) {
+        AlertRecord record;
+        record.timestamp_ns = i * 100;
+        record.sequence = static_cast<quint32>(i);
+        history.append(record);
+    }
+
+    // Records 4..11 remain
+    QCOMPARE(history.countInRange(0, 2000), std::size_t(8));
+    QCOMPARE(history.countInRange(500, 800), std::size_t(3));
+    QCOMPARE(history.countInRange(1200, 2000), std::size_t(0));
+
+    QList<quint32> sequences;
+    history.forEachInRange(450, 700, [&](const AlertRecord& record) {
+        sequences.append(record.sequence);
+    });
+    QCOMPARE(sequences, QList<quint32>({5, 6}));
+
+    // Wall-clock query through the manager
+    raiseAlerts(3);
+    const QDateTime now = QDateTime::currentDateTime();
+    QCOMPARE(alert_manager_->alertsBetween(now.addSecs(-60), now.addSecs(60)).size(), 3);
+    QVERIFY(alert_manager_->alertsBetween(now.addSecs(60), now.addSecs(120)).isEmpty());
+}
+
+void TestAlertManager::testFormatting() {
+    alert_manager_->onStateChanged(ExpressionState::NORMAL, ExpressionState::WARNING);
+
+    const AlertRecord& record = alert_manager_->history().at(0);
+    const QString text = alert_manager_->formatAlert(record);
+    QVERIFY(text.startsWith("["));
+    QVERIFY(text.endsWith("] Level 2: Speed is very high! Slow down."));
+    QCOMPARE(alert_manager_->recentAlerts(1).at(0).toMap()["text"].toString(), text);
+    QCOMPARE(AlertManager::alertMessage(-1), QString("Unknown alert"));
+}
+
+QTEST_MAIN(TestAlertManager)
+#include "test_alert_manager.moc"
@@ -0,0 +1,138 @@
+#include <QtTest/QtTest>
+#include "can_signal.h"
+
+/**
+ * @brief Unit tests for CanSignalDecoder
+ */
+class TestCanSignal : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Test cases
+    void testLittleEndianDecode();
+    void testBigEndianDecode();
+    void testSignedDecode();
+    void testSignalOutsideFrame();
+    void testParseCandumpLine();
+    void testRejectUnsupportedCandumpLines();
+
+private:
+    static CanFrame frame(std::initializer_list<std::uint8_t> bytes);
+};
+
+void TestCanSignal::initTestCase() {
+    qInfo() << "Starting CanSignal tests";
+}
+
+void TestCanSignal::cleanupTestCase() {
+    qInfo() << "CanSignal tests completed";
+}
+
+CanFrame TestCanSignal::frame(std::initializer_list<std::uint8_t> bytes) {
+    CanFrame result;
+    for (std::uint8_t byte : bytes) {
+        result.data[result.length++] = byte;
+    }
+    return result;
+}
+
+void TestCanSignal::testLittleEndianDecode() {
+    CanSignalDefinition signal;
+    signal.start_bit = 8;
+    signal.length = 16;
+    signal.factor = 0.01;
+
+    // 0x1234 = 4660 -> 46.60 km/h, stored LSB first from byte 1
+    double value = 0.0;
+    QVERIFY(CanSignalDecoder::decode(signal, frame({0xFF, 0x34, 0x12, 0xFF}), value));
+    QCOMPARE(value, 46.60);
+
+    // Sub-byte field: 4 bits starting at bit 4 of byte 0
+    signal.start_bit = 4;
+    signal.length = 4;
+    signal.factor = 1.0;
+    signal.offset = -1.0;
+    QVERIFY(CanSignalDecoder::decode(signal, frame({0xA5}), value));
+    QCOMPARE(value, 9.0);
+}
+
+void TestCanSignal::testBigEndianDecode() {
+    CanSignalDefinition signal;
+    signal.big_endian = true;
+    signal.start_bit = 7;   // MSB of byte 0 (DBC numbering)
+    signal.length = 16;
+    signal.factor = 0.01;
+
+    double value = 0.0;
+    QVERIFY(CanSignalDecoder::decode(signal, frame({0x12, 0x34}), value));
+    QCOMPARE(value, 46.60);
+
+    // 12 bits with MSB at bit 3 of byte 1: low nibble of byte 1 + byte 2
+    signal.start_bit = 11;
+    signal.length = 12;
+    signal.factor = 1.0;
+    QVERIFY(CanSignalDecoder::decode(signal, frame({0x00, 0xF1, 0x23}), value));
+    QCOMPARE(value, 291.0);
+}
+
+void TestCanSignal::testSignedDecode() {
+    CanSignalDefinition signal;
+    signal.length = 8;
+    signal.is_signed = true;
+    signal.factor = 1.0;
+
+    double value = 0.0;
+    QVERIFY(CanSignalDecoder::decode(signal, frame({0xFE}), value));
+    QCOMPARE(value, -2.0);
+    QVERIFY(CanSignalDecoder::decode(signal, frame({0x7F}), value));
+    QCOMPARE(value, 127.0);
+}
+
+void TestCanSignal::testSignalOutsideFrame() {
+    CanSignalDefinition signal;
+    signal.start_bit = 8;
+    signal.length = 16;
+
+    double value = 0.0;
+    QVERIFY(!CanSignalDecoder::decode(signal, frame({0x01, 0x02}), value));
+
+    signal.length = 0;
+    QVERIFY(!signal.isValid());
+}
+
+void TestCanSignal::testParseCandumpLine() {
+    CanFrame result;
+    QVERIFY(CanSignalDecoder::parseCandumpLine("(1436509052.249713) vcan0 123#DEADBEEF\n", result));
+    QCOMPARE(result.can_id, quint32(0x123));
+    QVERIFY(!result.extended);
+    QCOMPARE(result.length, 4);
+    QCOMPARE(result.data[0], std::uint8_t(0xDE));
+    QCOMPARE(result.data[3], std::uint8_t(0xEF));
+    QCOMPARE(result.timestamp_us, qint64(1436509052249713));
+
+    QVERIFY(CanSignalDecoder::parseCandumpLine("(1.5) can1 18FEF100#00", result));
+    QVERIFY(result.extended);
+    QCOMPARE(result.can_id, quint32(0x18FEF100));
+    QCOMPARE(result.timestamp_us, qint64(1500000));
+
+    // Zero-length data frame
+    QVERIFY(CanSignalDecoder::parseCandumpLine("(1.0) vcan0 100#", result));
+    QCOMPARE(result.length, 0);
+}
+
+void TestCanSignal::testRejectUnsupportedCandumpLines() {
+    CanFrame result;
+    QVERIFY(!CanSignalDecoder::parseCandumpLine("", result));
+    QVERIFY(!CanSignalDecoder::parseCandumpLine("vcan0 123#00", result));
+    QVERIFY(!CanSignalDecoder::parseCandumpLine("(1.0) vcan0 123#R", result));
+    QVERIFY(!CanSignalDecoder::parseCandumpLine("(1.0) vcan0 123##1001122", result));
+    QVERIFY(!CanSignalDecoder::parseCandumpLine("(1.0) vcan0 123#0", result));
+    QVERIFY(!CanSignalDecoder::parseCandumpLine("(1.0) vcan0 123#000102030405060708", result));
+    QVERIFY(!CanSignalDecoder::parseCandumpLine("(1.0) vcan0 123#ZZ", result));
+}
+
+QTEST_MAIN(TestCanSignal)
+#include "test_can_signal.moc"
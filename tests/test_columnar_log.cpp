@@ -0,0 +1,216 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "columnar_log.h"
+
+/**
+ * @brief Unit tests for ColumnarLogWriter / ColumnarLogReader
+ */
+class TestColumnarLog : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testRoundTrip();
+    void testBlockSplitOnDeltaOverflow();
+    void testAppendToExistingFile();
+    void testTruncatedTail();
+    void testRangeQuery();
+    void testRejectsForeignFile();
+    void testSizeAgainstCsv();
+    void testCsvExportMatchesSchema();
+
+private:
+    static SpeedLogRecord record(qint64 wall_ms, double raw, double smoothed, quint8 state);
+    static QVector<SpeedLogRecord> drive(int count, qint64 start_ms = 1700000000000);
+    QString path(const QString& name) const { return temp_dir_->filePath(name); }
+    bool writeAll(const QString& file, const QVector<SpeedLogRecord>& records,
+                  int block_capacity = ColumnarLogWriter::DEFAULT_BLOCK_CAPACITY);
+
+    QTemporaryDir* temp_dir_;
+};
+
+void TestColumnarLog::init() {
+    temp_dir_ = new QTemporaryDir();
+    QVERIFY(temp_dir_->isValid());
+}
+
+void TestColumnarLog::cleanup() {
+    delete temp_dir_;
+    temp_dir_ = nullptr;
+}
+
+SpeedLogRecord TestColumnarLog::record(qint64 wall_ms, double raw, double smoothed, quint8 state) {
+    SpeedLogRecord r;
+    r.wall_ms = wall_ms;
+    r.raw_speed = raw;
+    r.smoothed_speed = smoothed;
+    r.state = state;
+    return r;
+}
+
+QVector<SpeedLogRecord> TestColumnarLog::drive(int count, qint64 start_ms) {
+    QVector<SpeedLogRecord> records;
+    for (int i = 0; i < count; ++i) {
+        const double speed = 60.0 + 40.0 * std::sin(i * 0.01);
+        records.append(record(start_ms + i * 100, speed + (i % 3) * 0.25, speed,
+                              static_cast<quint8>(i / 200 % 5)));
+    }
+    return records;
+}
+
+bool TestColumnarLog::writeAll(const QString& file, const QVector<SpeedLogRecord>& records,
+                               int block_capacity) {
+    ColumnarLogWriter writer(block_capacity);
+    if (!writer.open(file)) {
+        return false;
+    }
+    for (const auto& r : records) {
+        if (!writer.append(r)) {
+            return false;
+        }
+    }
+    writer.close();
+    return true;
+}
+
+void TestColumnarLog::testRoundTrip() {
+    const QVector<SpeedLogRecord> records = drive(2500);
+    QVERIFY(writeAll(path("drive.cslog"), records, 1000));
+
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(path("drive.cslog")));
+    QCOMPARE(reader.recordCount(), quint64(2500));
+    QCOMPARE(reader.blocks().size(), 3);
+    QVERIFY(!reader.truncated());
+
+    const QVector<SpeedLogRecord> decoded = reader.readAll();
+    QCOMPARE(decoded.size(), records.size());
+    for (int i = 0; i < records.size(); ++i) {
+        QCOMPARE(decoded[i].wall_ms, records[i].wall_ms);
+        QVERIFY(qAbs(decoded[i].raw_speed - records[i].raw_speed) <= 0.005 + 1e-9);
+        QVERIFY(qAbs(decoded[i].smoothed_speed - records[i].smoothed_speed) <= 0.005 + 1e-9);
+        QCOMPARE(decoded[i].state, records[i].state);
+    }
+
+    // forEach decodes the same records
+    int visited = 0;
+    reader.forEach([&](const SpeedLogRecord& r) {
+        QCOMPARE(r.wall_ms, records[visited].wall_ms);
+        ++visited;
+    });
+    QCOMPARE(visited, 2500);
+}
+
+void TestColumnarLog::testBlockSplitOnDeltaOverflow() {
+    const qint64 t0 = 1700000000000;
+    QVector<SpeedLogRecord> records = {
+        record(t0, 10.0, 10.0, 0),
+        record(t0 + 100, 12.0, 11.0, 0),
+        record(t0 + 100 + 70000, 12.0, 11.0, 0),    // gap > 65.535 s
+        record(t0 + 70200, 400.0, 11.0, 4),         // speed jump > 327 km/h
+        record(t0 + 70100, 400.0, 11.0, 4),         // clock stepped back
+    };
+    QVERIFY(writeAll(path("split.cslog"), records));
+
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(path("split.cslog")));
+    QCOMPARE(reader.blocks().size(), 4);
+    const QVector<SpeedLogRecord> decoded = reader.readAll();
+    QCOMPARE(decoded.size(), records.size());
+    for (int i = 0; i < records.size(); ++i) {
+        QCOMPARE(decoded[i].wall_ms, records[i].wall_ms);
+        QCOMPARE(decoded[i].raw_speed, records[i].raw_speed);
+    }
+}
+
+void TestColumnarLog::testAppendToExistingFile() {
+    QVERIFY(writeAll(path("append.cslog"), drive(10)));
+    QVERIFY(writeAll(path("append.cslog"), drive(5, 1700000010000)));
+
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(path("append.cslog")));
+    QCOMPARE(reader.recordCount(), quint64(15));
+    QCOMPARE(reader.blocks().size(), 2);
+}
+
+void TestColumnarLog::testTruncatedTail() {
+    QVERIFY(writeAll(path("cut.cslog"), drive(300), 100));
+    QFile file(path("cut.cslog"));
+    QVERIFY(file.resize(file.size() - 10));
+
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(path("cut.cslog")));
+    QVERIFY(reader.truncated());
+    QCOMPARE(reader.blocks().size(), 2);
+    QCOMPARE(reader.readAll().size(), 200);
+}
+
+void TestColumnarLog::testRangeQuery() {
+    const QVector<SpeedLogRecord> records = drive(1000);
+    QVERIFY(writeAll(path("range.cslog"), records, 64));
+
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(path("range.cslog")));
+
+    const qint64 from = records[250].wall_ms;
+    const qint64 to = records[750].wall_ms;
+    QVector<qint64> times;
+    reader.forEachInRange(from, to, [&](const SpeedLogRecord& r) { times.append(r.wall_ms); });
+    QCOMPARE(times.size(), 500);
+    QCOMPARE(times.first(), from);
+    QCOMPARE(times.last(), records[749].wall_ms);
+}
+
+void TestColumnarLog::testRejectsForeignFile() {
+    QFile csv(path("speed_log.csv"));
+    QVERIFY(csv.open(QIODevice::WriteOnly));
+    csv.write(SpeedLogCsvFormatter::HEADER);
+    csv.close();
+
+    ColumnarLogReader reader;
+    QString error;
+    QVERIFY(!reader.open(path("speed_log.csv"), &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!reader.isOpen());
+
+    ColumnarLogWriter writer;
+    QVERIFY(!writer.open(path("speed_log.csv")));
+}
+
+void TestColumnarLog::testSizeAgainstCsv() {
+    const QVector<SpeedLogRecord> records = drive(36000);   // one hour at 10 Hz
+    QVERIFY(writeAll(path("hour.cslog"), records));
+
+    SpeedLogCsvFormatter formatter;
+    QByteArray csv(SpeedLogCsvFormatter::HEADER);
+    for (const auto& r : records) {
+        formatter.appendRow(csv, r);
+    }
+
+    const qint64 columnar_size = QFileInfo(path("hour.cslog")).size();
+    qInfo() << "CSV:" << csv.size() << "bytes, columnar:" << columnar_size << "bytes";
+    QVERIFY(columnar_size * 10 < csv.size());
+}
+
+void TestColumnarLog::testCsvExportMatchesSchema() {
+    SpeedLogCsvFormatter formatter;
+    QByteArray row;
+    formatter.appendRow(row, record(1700000000123, 42.5, 41.0, 1));
+    const QList<QByteArray> fields = row.trimmed().split(',');
+    QCOMPARE(fields.size(), 4);
+    QVERIFY(QDateTime::fromString(QString::fromLatin1(fields[0]), Qt::ISODate).isValid());
+    QCOMPARE(fields[1], QByteArray("42.5"));
+    QCOMPARE(fields[2], QByteArray("41"));
+    QCOMPARE(fields[3], QByteArray("NORMAL"));
+
+    SpeedLogCsvFormatter with_ms(true);
+    row.clear();
+    with_ms.appendRow(row, record(1700000000123, 42.5, 41.0, 1));
+    QVERIFY(row.split(',').first().endsWith(".123"));
+}
+
+QTEST_MAIN(TestColumnarLog)
+#include "test_columnar_log.moc"
@@ -1,5 +1,8 @@
 #include <QtTest/QtTest>
+#include <QSaveFile>
+#include <QTemporaryDir>
 #include <QTemporaryFile>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include "configuration_manager.h"
@@ -25,7 +28,14 @@ private slots:
     void testAFBConfiguration();
     void testDisplaySettings();
     void testLoggingConfiguration();
+    void testVssConfiguration();
+    void testExpressionBands();
     void testSaveConfiguration();
+    void testReloadEmitsChangedSections();
+    void testReloadUnchangedFile();
+    void testReloadKeepsConfigOnError();
+    void testSetterEmitsSectionSignal();
+    void testWatchReloadsFile();
 
 private:
     ConfigurationManager* config_manager_;
@@ -184,6 +194,51 @@ void TestConfigurationManager::testLoggingConfiguration() {
     QCOMPARE(loaded.level, QString("error"));
 }
 
+void TestConfigurationManager::testVssConfiguration() {
+    // Default subscribes to speed only
+    auto defaults = config_manager_->getVssConfig();
+    QCOMPARE(defaults.signal_paths, QStringList{"Vehicle.Speed"});
+    QCOMPARE(defaults.update_rate_hz, 10);
+    
+    QJsonObject vss;
+    vss["signals"] = QJsonArray{"Vehicle.Speed",
+                                "Vehicle.Powertrain.CombustionEngine.Speed",
+                                "Vehicle.Speed"};
+    vss["update_rate_hz"] = 20;
+    QJsonObject config;
+    config["vss"] = vss;
+    
+    QString filepath = createTestConfig(config);
+    QVERIFY(config_manager_->loadFromFile(filepath));
+    
+    auto loaded = config_manager_->getVssConfig();
+    QCOMPARE(loaded.signal_paths,
+             QStringList({"Vehicle.Speed", "Vehicle.Powertrain.CombustionEngine.Speed"}));
+    QCOMPARE(loaded.update_rate_hz, 20);
+}
+
+void TestConfigurationManager::testExpressionBands() {
+    // Default: no custom bands, speed_thresholds apply
+    QVERIFY(config_manager_->getExpressionBands().isEmpty());
+    
+    QJsonObject crawl{{"name", "crawl"}, {"max_kmh", 10.0}, {"hysteresis_kmh", 1.0}};
+    QJsonObject city{{"name", "city"}, {"max_kmh", 50.0}};
+    QJsonObject highway{{"name", "highway"}};
+    QJsonObject config;
+    config["expression_bands"] = QJsonArray{crawl, city, highway};
+    
+    QString filepath = createTestConfig(config);
+    QVERIFY(config_manager_->loadFromFile(filepath));
+    
+    auto bands = config_manager_->getExpressionBands();
+    QCOMPARE(bands.size(), 3);
+    QCOMPARE(bands[0].name, QString("crawl"));
+    QCOMPARE(bands[0].hysteresis_kmh, 1.0);
+    QCOMPARE(bands[1].max_kmh, 50.0);
+    QCOMPARE(bands[1].hysteresis_kmh, 2.0);
+    QCOMPARE(bands[2].name, QString("highway"));
+}
+
 void TestConfigurationManager::testSaveConfiguration() {
     // Set custom configuration
     ConfigurationManager::SpeedThresholds thresholds;
@@ -214,5 +269,121 @@ void TestConfigurationManager::testSaveConfiguration() {
     delete new_manager;
 }
 
+void TestConfigurationManager::testReloadEmitsChangedSections() {
+    QJsonObject thresholds{{"relaxed_max", 30.0}, {"normal_max", 70.0},
+                           {"alert_max", 110.0}, {"warning_max", 130.0}};
+    QJsonObject config;
+    config["speed_thresholds"] = thresholds;
+    config["display"] = QJsonObject{{"fullscreen", true}};
+    
+    QString filepath = createTestConfig(config);
+    QVERIFY(config_manager_->loadFromFile(filepath));
+    
+    QSignalSpy expression_spy(config_manager_, &ConfigurationManager::expressionConfigChanged);
+    QSignalSpy display_spy(config_manager_, &ConfigurationManager::displaySettingsChanged);
+    QSignalSpy logging_spy(config_manager_, &ConfigurationManager::loggingConfigChanged);
+    QSignalSpy afb_spy(config_manager_, &ConfigurationManager::afbConfigChanged);
+    QSignalSpy changed_spy(config_manager_, &ConfigurationManager::configurationChanged);
+    
+    // Same display settings in a different key order, new thresholds
+    thresholds["normal_max"] = 80.0;
+    config["speed_thresholds"] = thresholds;
+    QVERIFY(temp_file_->resize(0) && temp_file_->seek(0));
+    temp_file_->write(QJsonDocument(config).toJson());
+    temp_file_->flush();
+    
+    QVERIFY(config_manager_->reload());
+    QCOMPARE(config_manager_->getSpeedThresholds().normal_max, 80.0);
+    QVERIFY(config_manager_->getDisplaySettings().fullscreen);
+    QCOMPARE(expression_spy.count(), 1);
+    QCOMPARE(display_spy.count(), 0);
+    QCOMPARE(logging_spy.count(), 0);
+    QCOMPARE(afb_spy.count(), 0);
+    QCOMPARE(changed_spy.count(), 1);
+}
+
+void TestConfigurationManager::testReloadUnchangedFile() {
+    QJsonObject config;
+    config["smoothing"] = QJsonObject{{"window_size", 7}};
+    QString filepath = createTestConfig(config);
+    QVERIFY(config_manager_->loadFromFile(filepath));
+    
+    QSignalSpy changed_spy(config_manager_, &ConfigurationManager::configurationChanged);
+    QSignalSpy smoothing_spy(config_manager_, &ConfigurationManager::smoothingConfigChanged);
+    QVERIFY(config_manager_->reload());
+    QCOMPARE(changed_spy.count(), 0);
+    QCOMPARE(smoothing_spy.count(), 0);
+    QCOMPARE(config_manager_->getSmoothingConfig().window_size, 7);
+}
+
+void TestConfigurationManager::testReloadKeepsConfigOnError() {
+    // Nothing loaded yet
+    QVERIFY(!config_manager_->reload());
+    
+    QJsonObject config;
+    config["smoothing"] = QJsonObject{{"window_size", 7}};
+    QString filepath = createTestConfig(config);
+    QVERIFY(config_manager_->loadFromFile(filepath));
+    
+    // A half-written file must not reset everything to defaults
+    QVERIFY(temp_file_->resize(0) && temp_file_->seek(0));
+    temp_file_->write("{ \"smoothing\": { \"window_size\": ");
+    temp_file_->flush();
+    
+    QSignalSpy changed_spy(config_manager_, &ConfigurationManager::configurationChanged);
+    QVERIFY(!config_manager_->reload());
+    QCOMPARE(changed_spy.count(), 0);
+    QCOMPARE(config_manager_->getSmoothingConfig().window_size, 7);
+}
+
+void TestConfigurationManager::testSetterEmitsSectionSignal() {
+    QSignalSpy logging_spy(config_manager_, &ConfigurationManager::loggingConfigChanged);
+    QSignalSpy vss_spy(config_manager_, &ConfigurationManager::vssConfigChanged);
+    QSignalSpy changed_spy(config_manager_, &ConfigurationManager::configurationChanged);
+    
+    auto logging = config_manager_->getLoggingConfig();
+    logging.max_files = 3;
+    config_manager_->setLoggingConfig(logging);
+    QCOMPARE(logging_spy.count(), 1);
+    QCOMPARE(vss_spy.count(), 0);
+    QCOMPARE(changed_spy.count(), 1);
+}
+
+void TestConfigurationManager::testWatchReloadsFile() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString filepath = dir.filePath("config.json");
+    
+    auto write_config = [&filepath](double normal_max) {
+        QJsonObject config;
+        config["speed_thresholds"] = QJsonObject{{"relaxed_max", 30.0}, {"normal_max", normal_max},
+                                                 {"alert_max", 110.0}, {"warning_max", 130.0}};
+        config["config_reload"] = QJsonObject{{"watch", true}, {"debounce_ms", 0}};
+        // Written beside the file and renamed over it, as most editors do
+        QSaveFile file(filepath);
+        return file.open(QIODevice::WriteOnly)
+            && file.write(QJsonDocument(config).toJson()) > 0
+            && file.commit();
+    };
+    
+    QVERIFY(write_config(70.0));
+    QVERIFY(config_manager_->loadFromFile(filepath));
+    QVERIFY(config_manager_->isWatching());
+    
+    QSignalSpy expression_spy(config_manager_, &ConfigurationManager::expressionConfigChanged);
+    QVERIFY(write_config(80.0));
+    QTRY_COMPARE(config_manager_->getSpeedThresholds().normal_max, 80.0);
+    QCOMPARE(expression_spy.count(), 1);
+    
+    // The replaced file is still watched
+    QVERIFY(write_config(90.0));
+    QTRY_COMPARE(config_manager_->getSpeedThresholds().normal_max, 90.0);
+    
+    auto reload_config = config_manager_->getReloadConfig();
+    reload_config.watch = false;
+    config_manager_->setReloadConfig(reload_config);
+    QVERIFY(!config_manager_->isWatching());
+}
+
 QTEST_MAIN(TestConfigurationManager)
 #include "test_configuration_manager.moc"
@@ -0,0 +1,309 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <limits>
+#include "columnar_log.h"
+#include "data_logger.h"
+#include "log_recovery.h"
+#include "speed_log_query.h"
+
+/**
+ * @brief Unit tests for DataLogger
+ */
+class TestDataLogger : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testSynchronousLogging();
+    void testWriterThread();
+    void testWriterDropsWhenFull();
+    void testWriterRotation();
+    void testInvalidFlushInterval();
+    void testColumnarFormat();
+    void testLogDirectory();
+    void testRotationUsesNewFiles();
+    void testRetentionPrunesOnRotation();
+    void testDurableCommits();
+    void testTimeIndexSidecar();
+    void testColumnarTimeIndexFollowsBlocks();
+
+private:
+    static QStringList readLines(const QString& path);
+
+    QTemporaryDir* temp_dir_;
+    DataLogger* logger_;
+};
+
+void TestDataLogger::initTestCase() {
+    qInfo() << "Starting DataLogger tests";
+}
+
+void TestDataLogger::cleanupTestCase() {
+    qInfo() << "DataLogger tests completed";
+}
+
+void TestDataLogger::init() {
+    temp_dir_ = new QTemporaryDir();
+    QVERIFY(temp_dir_->isValid());
+    logger_ = new DataLogger(temp_dir_->path());
+}
+
+void TestDataLogger::cleanup() {
+    delete logger_;
+    logger_ = nullptr;
+    delete temp_dir_;
+    temp_dir_ = nullptr;
+}
+
+QStringList TestDataLogger::readLines(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return {};
+    }
+    QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    lines.removeAll(QString());
+    return lines;
+}
+
+void TestDataLogger::testSynchronousLogging() {
+    logger_->logSpeedData(42.5, 41.0, ExpressionState::NORMAL);
+
+    const QStringList lines = readLines(logger_->currentLogFile());
+    QCOMPARE(lines.size(), 2);
+    QCOMPARE(lines.at(0), QString("timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state"));
+    QVERIFY(lines.at(1).endsWith(",42.5,41,NORMAL"));
+}
+
+void TestDataLogger::testWriterThread() {
+    QVERIFY(logger_->startWriter(10));
+    QVERIFY(logger_->isWriterRunning());
+    QVERIFY(!logger_->startWriter(10));
+
+    for (int i = 0; i < 1000; ++i) {
+        logger_->logSpeedData(i * 0.1, i * 0.1, ExpressionState::RELAXED);
+    }
+    QTRY_COMPARE(logger_->writtenRecords(), quint64(1000));
+    QCOMPARE(logger_->queueDepth(), 0);
+
+    logger_->stopWriter();
+    QVERIFY(!logger_->isWriterRunning());
+    QCOMPARE(logger_->droppedRecords(), quint64(0));
+
+    const QStringList lines = readLines(logger_->currentLogFile());
+    QCOMPARE(lines.size(), 1001);
+    QVERIFY(lines.last().endsWith(",99.9,99.9,RELAXED"));
+
+    // Same column layout as synchronous mode
+    const QStringList fields = lines.at(1).split(',');
+    QCOMPARE(fields.size(), 4);
+    QVERIFY(QDateTime::fromString(fields.at(0), Qt::ISODate).isValid());
+}
+
+void TestDataLogger::testWriterDropsWhenFull() {
+    // The writer will not drain before stopWriter()
+    QVERIFY(logger_->startWriter(60000));
+
+    const int total = DataLogger::QUEUE_CAPACITY + 500;
+    for (int i = 0; i < total; ++i) {
+        logger_->logSpeedData(50.0, 50.0, ExpressionState::NORMAL);
+    }
+    QCOMPARE(logger_->queueDepth(), DataLogger::QUEUE_CAPACITY);
+    QCOMPARE(logger_->droppedRecords(), quint64(500));
+
+    // Stopping drains everything that was queued
+    logger_->stopWriter();
+    QCOMPARE(logger_->writtenRecords(), quint64(DataLogger::QUEUE_CAPACITY));
+    QCOMPARE(logger_->maxQueueDepth(), DataLogger::QUEUE_CAPACITY);
+    QCOMPARE(readLines(logger_->currentLogFile()).size(), DataLogger::QUEUE_CAPACITY + 1);
+}
+
+void TestDataLogger::testWriterRotation() {
+    QSignalSpy rotatedSpy(logger_, &DataLogger::logFileRotated);
+    logger_->setMaxFileSize(1024);
+    QVERIFY(logger_->startWriter(10));
+
+    for (int i = 0; i < 100; ++i) {
+        logger_->logSpeedData(120.0, 119.5, ExpressionState::WARNING);
+    }
+    QTRY_COMPARE(logger_->writtenRecords(), quint64(100));
+    logger_->stopWriter();
+
+    QTRY_VERIFY(rotatedSpy.count() >= 1);
+}
+
+void TestDataLogger::testInvalidFlushInterval() {
+    QVERIFY(!logger_->startWriter(0));
+    QVERIFY(!logger_->isWriterRunning());
+}
+
+void TestDataLogger::testColumnarFormat() {
+    const QString csv_file = logger_->currentLogFile();
+    QVERIFY(logger_->setFormat(DataLogger::Format::Columnar));
+    QVERIFY(logger_->currentLogFile().endsWith(".cslog"));
+    QVERIFY(!QFile::exists(csv_file));   // nothing was logged to it
+
+    QVERIFY(logger_->startWriter(10));
+    QVERIFY(!logger_->setFormat(DataLogger::Format::Csv));
+    for (int i = 0; i < 500; ++i) {
+        logger_->logSpeedData(i * 0.1, i * 0.1, ExpressionState::ALERT);
+    }
+    QTRY_COMPARE(logger_->writtenRecords(), quint64(500));
+
+    // The pending block is written when the file is closed
+    const QString columnar_file = logger_->currentLogFile();
+    delete logger_;
+    logger_ = nullptr;
+
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(columnar_file));
+    QCOMPARE(reader.recordCount(), quint64(500));
+    const QVector<SpeedLogRecord> records = reader.readAll();
+    QCOMPARE(records.last().raw_speed, 49.9);
+    QCOMPARE(records.last().state, quint8(ExpressionState::ALERT));
+}
+
+void TestDataLogger::testLogDirectory() {
+    const QString empty_file = logger_->currentLogFile();
+    const QString log_dir = temp_dir_->filePath("nested/logs");
+    QVERIFY(logger_->setLogDirectory(log_dir));
+    QCOMPARE(logger_->logDirectory(), log_dir);
+    QVERIFY(!QFile::exists(empty_file));   // nothing was logged to it
+    QCOMPARE(QFileInfo(logger_->currentLogFile()).absolutePath(), QFileInfo(log_dir).absoluteFilePath());
+
+    logger_->logSpeedData(42.5, 41.0, ExpressionState::NORMAL);
+    const QString first_file = logger_->currentLogFile();
+    QCOMPARE(readLines(first_file).size(), 2);
+    logger_->setRetention(LogRetention::Policy());
+
+    // Moving back keeps the logged file; retention now scans the new directory
+    QVERIFY(logger_->setLogDirectory(temp_dir_->path()));
+    QVERIFY(QFile::exists(first_file));
+    logger_->setRetention(LogRetention::Policy());
+    QCOMPARE(logger_->retainedFiles(), 0);
+
+    QVERIFY(logger_->startWriter(10));
+    QVERIFY(!logger_->setLogDirectory(log_dir));
+}
+
+void TestDataLogger::testRotationUsesNewFiles() {
+    logger_->setMaxFileSize(200);
+    for (int i = 0; i < 30; ++i) {
+        logger_->logSpeedData(80.0, 80.0, ExpressionState::ALERT);
+    }
+
+    // Rotations within the same second must not reopen the previous file
+    const QStringList files = QDir(temp_dir_->path()).entryList({"speed_log_*.csv"}, QDir::Files);
+    QVERIFY(files.size() >= 3);
+    int rows = 0;
+    for (const QString& file : files) {
+        const QStringList lines = readLines(temp_dir_->filePath(file));
+        QCOMPARE(lines.first(), QString("timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state"));
+        rows += lines.size() - 1;
+    }
+    QCOMPARE(rows, 30);
+}
+
+void TestDataLogger::testRetentionPrunesOnRotation() {
+    QSignalSpy removedSpy(logger_, &DataLogger::logFilesRemoved);
+    LogRetention::Policy policy;
+    policy.max_files = 3;
+    logger_->setRetention(policy);
+    logger_->setMaxFileSize(200);
+    QVERIFY(logger_->startWriter(10));
+
+    // Each drained batch exceeds the size limit and rotates: seven files in total
+    for (int batch = 1; batch <= 6; ++batch) {
+        for (int i = 0; i < 10; ++i) {
+            logger_->logSpeedData(80.0, 80.0, ExpressionState::ALERT);
+        }
+        QTRY_COMPARE(logger_->writtenRecords(), quint64(batch * 10));
+    }
+    logger_->stopWriter();
+    logger_->waitForRetention();
+
+    const QStringList files = QDir(temp_dir_->path()).entryList({"speed_log_*"}, QDir::Files);
+    QCOMPARE(files.size(), 3);
+    QCOMPARE(logger_->retainedFiles(), 2);
+    QTRY_VERIFY(removedSpy.count() >= 1);
+    QVERIFY(files.contains(QFileInfo(logger_->currentLogFile()).fileName()));
+}
+
+void TestDataLogger::testDurableCommits() {
+    // A commit closes after 10 records long before the one-minute interval
+    logger_->setCommitPolicy({true, 10});
+    QVERIFY(logger_->startWriter(60000));
+    for (int i = 0; i < 10; ++i) {
+        logger_->logSpeedData(50.0, 50.0, ExpressionState::NORMAL);
+    }
+    QTRY_COMPARE(logger_->writtenRecords(), quint64(10));
+    QVERIFY(logger_->commits() >= 1);
+
+    QFile file(logger_->currentLogFile());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    QVERIFY(data.contains(LogRecovery::COMMIT_PREFIX));
+    QCOMPARE(LogRecovery::validCsvBytes(data), qint64(data.size()));
+    logger_->stopWriter();
+}
+
+void TestDataLogger::testTimeIndexSidecar() {
+    logger_->setTimeIndex(1000);
+    QVERIFY(logger_->startWriter(10));
+    for (int i = 0; i < 30; ++i) {
+        logger_->logSpeedData(40.0 + i, 40.0, ExpressionState::ALERT);
+    }
+    QTRY_COMPARE(logger_->writtenRecords(), quint64(30));
+    const QString log_file = logger_->currentLogFile();
+    QVERIFY(QFile::exists(LogTimeIndex::indexPath(log_file)));
+
+    // Closing the file writes the open bucket
+    delete logger_;
+    logger_ = nullptr;
+
+    LogTimeIndex index;
+    QVERIFY(index.load(LogTimeIndex::indexPath(log_file)));
+    QVERIFY(!index.buckets().isEmpty());
+    QCOMPARE(index.indexedBytes(), QFileInfo(log_file).size());
+
+    SpeedLogQuery query(temp_dir_->path());
+    const SpeedAggregate all = query.aggregate(0, std::numeric_limits<qint64>::max());
+    QCOMPARE(all.count, quint64(30));
+    QCOMPARE(all.maxRawKmh(), 69.0);
+    QCOMPARE(all.state_counts[static_cast<int>(ExpressionState::ALERT)], quint64(30));
+    QCOMPARE(query.lastStats().rows_read, quint64(0));
+}
+
+void TestDataLogger::testColumnarTimeIndexFollowsBlocks() {
+    QVERIFY(logger_->setFormat(DataLogger::Format::Columnar));
+    logger_->setTimeIndex(1000);
+    const qint64 start_ms = 1700000000000;
+    for (int i = 0; i < 50; ++i) {
+        logger_->logSpeedDataAt(40.0, 40.0, ExpressionState::NORMAL, start_ms + i * 100);
+    }
+    const QString log_file = logger_->currentLogFile();
+
+    // Five buckets have closed, but their rows are still in the pending block
+    LogTimeIndex index;
+    QVERIFY(index.load(LogTimeIndex::indexPath(log_file)));
+    QVERIFY(index.buckets().isEmpty());
+
+    delete logger_;
+    logger_ = nullptr;
+
+    QVERIFY(index.load(LogTimeIndex::indexPath(log_file)));
+    quint64 indexed = 0;
+    for (const LogTimeIndex::Bucket& bucket : index.buckets()) {
+        indexed += bucket.stats.count;
+    }
+    QCOMPARE(indexed, quint64(50));
+    QCOMPARE(index.indexedBytes(), QFileInfo(log_file).size());
+}
+
+QTEST_MAIN(TestDataLogger)
+#include "test_data_logger.moc"
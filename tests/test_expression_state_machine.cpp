@@ -24,6 +24,16 @@ private slots:
     void testBoundaryValues();
     void testStateTransitions();
     void testSignalEmission();
+    void testCustomBands();
+    void testInvalidBandsRejected();
+    void testReplacingBandsUpdatesState();
+    void testBatchMatchesLive();
+    void testLargeTable();
+    void testDwellSuppressesStorm();
+    void testDwellKeepsRunningWhileAccelerating();
+    void testSymmetricHysteresis();
+    void testBatchWithDwellMatchesLive();
+    void testStatisticsKeptAcrossBandChanges();
 
 private:
     ExpressionStateMachine* state_machine_;
@@ -178,5 +188,203 @@ void TestExpressionStateMachine::testSignalEmission() {
     QCOMPARE(stringStateSpy.count(), 0);
 }
 
+void TestExpressionStateMachine::testCustomBands() {
+    QSignalSpy bandSpy(state_machine_, &ExpressionStateMachine::bandChanged);
+    
+    QVERIFY(state_machine_->setBands({
+        {"crawl", 10.0, 1.0},
+        {"city", 50.0, 3.0},
+        {"highway", 0.0, 0.0},
+    }));
+    QCOMPARE(state_machine_->bandTable().bandCount(), 3);
+    
+    state_machine_->updateSpeed(30.0);
+    QCOMPARE(state_machine_->currentBandName(), QString("city"));
+    QCOMPARE(state_machine_->currentBand(), 1);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::ALERT);
+    QCOMPARE(state_machine_->getStateString(), QString("alert"));
+    
+    state_machine_->updateSpeed(90.0);
+    QCOMPARE(state_machine_->currentBandName(), QString("highway"));
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::SCARED);
+    
+    // Per-edge hysteresis: 52 <= 50 + 3 while falling
+    state_machine_->updateSpeed(52.0);
+    QCOMPARE(state_machine_->currentBandName(), QString("city"));
+    state_machine_->updateSpeed(10.5);
+    QCOMPARE(state_machine_->currentBandName(), QString("crawl"));
+    QCOMPARE(state_machine_->getStateString(), QString("relaxed"));
+    
+    QCOMPARE(bandSpy.count(), 4);
+}
+
+void TestExpressionStateMachine::testInvalidBandsRejected() {
+    QVERIFY(!state_machine_->setBands({}));
+    QVERIFY(!state_machine_->setBands({{"a", 50.0, 0.0}, {"b", 40.0, 0.0}, {"c", 0.0, 0.0}}));
+    QVERIFY(!state_machine_->setBands({{"a", 10.0, 0.0}, {"a", 0.0, 0.0}}));
+    QVERIFY(!state_machine_->setBands({{"a", 10.0, -1.0}, {"b", 0.0, 0.0}}));
+    
+    // Hysteresis may not push an edge past the next one
+    QVERIFY(!state_machine_->setBands({{"a", 10.0, 15.0}, {"b", 20.0, 0.0}, {"c", 0.0, 0.0}}));
+    
+    // Previous table stays active
+    QCOMPARE(state_machine_->bandTable().bandCount(), 5);
+    state_machine_->updateSpeed(70.0);
+    QCOMPARE(state_machine_->getStateString(), QString("alert"));
+}
+
+void TestExpressionStateMachine::testReplacingBandsUpdatesState() {
+    const qint64 ms = 1000000;
+    state_machine_->updateSpeed(50.0, 0);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::NORMAL);
+    
+    // Band 1 of three maps to ALERT; the UI must hear about it right away
+    QSignalSpy stateSpy(state_machine_, &ExpressionStateMachine::stateChanged);
+    QSignalSpy stringStateSpy(state_machine_, &ExpressionStateMachine::stateStringChanged);
+    QVERIFY(state_machine_->setBands({{"crawl", 10.0, 1.0}, {"city", 60.0, 2.0}, {"fast", 0.0, 0.0}}));
+    QCOMPARE(state_machine_->currentBand(), 1);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::ALERT);
+    QCOMPARE(stateSpy.count(), 1);
+    QCOMPARE(stringStateSpy.count(), 1);
+    QCOMPARE(stringStateSpy.at(0).at(0).toString(), QString("alert"));
+    
+    // Back to the default table, with a change pending under the old one
+    state_machine_->setMinDwellMs(300);
+    state_machine_->updateSpeed(70.0, 100 * ms);
+    state_machine_->setThresholds(20.0, 60.0, 100.0, 120.0);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::NORMAL);
+    QCOMPARE(stateSpy.count(), 2);
+    
+    // 350 ms after the old pending change, but only just seen by the new table
+    state_machine_->updateSpeed(70.0, 450 * ms);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::NORMAL);
+    state_machine_->updateSpeed(70.0, 800 * ms);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::ALERT);
+}
+
+void TestExpressionStateMachine::testBatchMatchesLive() {
+    const QVector<double> speeds = {0.0, 15.0, 21.0, 30.0, 22.5, 21.0, 59.0, 61.0,
+                                    100.0, 101.5, 99.0, 130.0, 119.0, 121.0, 5.0};
+    const QVector<int> batch = state_machine_->classify(speeds);
+    QCOMPARE(batch.size(), speeds.size());
+    
+    for (int i = 0; i < speeds.size(); ++i) {
+        state_machine_->updateSpeed(speeds[i]);
+        QCOMPARE(state_machine_->currentBand(), batch[i]);
+    }
+}
+
+void TestExpressionStateMachine::testLargeTable() {
+    // 40 bands of 5 km/h exercises the binary search path
+    QVector<SpeedBand> bands;
+    for (int i = 0; i < 40; ++i) {
+        bands.append({QString("band%1").arg(i), (i + 1) * 5.0, 1.0});
+    }
+    QVERIFY(state_machine_->setBands(bands));
+    
+    const SpeedBandTable& table = state_machine_->bandTable();
+    QCOMPARE(table.classify(0.0, -1.0), 0);
+    QCOMPARE(table.classify(5.0, 0.0), 0);
+    QCOMPARE(table.classify(5.1, 0.0), 1);
+    QCOMPARE(table.classify(76.0, 80.0), 14);
+    QCOMPARE(table.classify(500.0, 0.0), 39);
+    QCOMPARE(table.indexOf("band7"), 7);
+}
+
+void TestExpressionStateMachine::testDwellSuppressesStorm() {
+    const qint64 ms = 1000000;
+    QSignalSpy stringStateSpy(state_machine_, &ExpressionStateMachine::stateStringChanged);
+    
+    state_machine_->updateSpeed(50.0, 0);
+    QCOMPARE(state_machine_->getStateString(), QString("normal"));
+    state_machine_->setMinDwellMs(300);
+    
+    // Noise around the 60 km/h edge at 10 Hz never lasts 300 ms
+    qint64 t = 0;
+    for (int i = 0; i < 20; ++i) {
+        t += 100 * ms;
+        state_machine_->updateSpeed(i % 2 == 0 ? 61.0 : 59.0, t);
+        QCOMPARE(state_machine_->getStateString(), QString("normal"));
+    }
+    QCOMPARE(state_machine_->transitionStatistics().suppressed_by_dwell, quint64(10));
+    
+    // A sustained change goes through once the dwell time has passed
+    for (int i = 0; i < 4; ++i) {
+        t += 100 * ms;
+        state_machine_->updateSpeed(70.0, t);
+    }
+    QCOMPARE(state_machine_->getStateString(), QString("alert"));
+    QCOMPARE(stringStateSpy.count(), 2);
+    QCOMPARE(state_machine_->transitionStatistics().transitions, quint64(2));
+}
+
+void TestExpressionStateMachine::testDwellKeepsRunningWhileAccelerating() {
+    const qint64 ms = 1000000;
+    state_machine_->setMinDwellMs(200);
+    
+    state_machine_->updateSpeed(10.0, 0);
+    state_machine_->updateSpeed(40.0, 100 * ms);    // normal pending
+    state_machine_->updateSpeed(80.0, 200 * ms);    // alert pending, same direction
+    QCOMPARE(state_machine_->getStateString(), QString("relaxed"));
+    state_machine_->updateSpeed(85.0, 300 * ms);
+    QCOMPARE(state_machine_->getStateString(), QString("alert"));
+}
+
+void TestExpressionStateMachine::testSymmetricHysteresis() {
+    state_machine_->setHysteresisMode(HysteresisMode::Symmetric);
+    
+    state_machine_->updateSpeed(50.0);
+    QCOMPARE(state_machine_->getStateString(), QString("normal"));
+    
+    // Rising needs edge + 2 as well
+    state_machine_->updateSpeed(61.5);
+    QCOMPARE(state_machine_->getStateString(), QString("normal"));
+    state_machine_->updateSpeed(62.5);
+    QCOMPARE(state_machine_->getStateString(), QString("alert"));
+    
+    // Falling needs edge - 2, regardless of sample-to-sample direction
+    state_machine_->updateSpeed(58.5);
+    state_machine_->updateSpeed(59.0);
+    QCOMPARE(state_machine_->getStateString(), QString("alert"));
+    state_machine_->updateSpeed(57.5);
+    QCOMPARE(state_machine_->getStateString(), QString("normal"));
+    
+    QCOMPARE(state_machine_->transitionStatistics().held_by_hysteresis, quint64(3));
+}
+
+void TestExpressionStateMachine::testBatchWithDwellMatchesLive() {
+    const qint64 ms = 1000000;
+    state_machine_->setMinDwellMs(150);
+    state_machine_->setHysteresisMode(HysteresisMode::Symmetric);
+    
+    QVector<double> speeds;
+    QVector<qint64> timestamps;
+    for (int i = 0; i < 200; ++i) {
+        speeds.append(60.0 + 25.0 * qSin(i * 0.07) + (i % 3 - 1) * 3.0);
+        timestamps.append(i * 50 * ms);
+    }
+    
+    const QVector<int> batch = state_machine_->classify(speeds, timestamps);
+    for (int i = 0; i < speeds.size(); ++i) {
+        state_machine_->updateSpeed(speeds[i], timestamps[i]);
+        QCOMPARE(state_machine_->currentBand(), batch[i]);
+    }
+}
+
+void TestExpressionStateMachine::testStatisticsKeptAcrossBandChanges() {
+    const qint64 ms = 1000000;
+    state_machine_->updateSpeed(50.0, 0);
+    state_machine_->setMinDwellMs(300);
+    state_machine_->updateSpeed(61.0, 100 * ms);
+    state_machine_->updateSpeed(59.0, 200 * ms);   // pending change dropped
+    const BandTracker::Statistics before = state_machine_->transitionStatistics();
+    QCOMPARE(before.suppressed_by_dwell, quint64(1));
+    
+    // A reloaded table restarts the tracker but not its counters
+    state_machine_->setThresholds(25.0, 65.0, 105.0, 125.0);
+    QCOMPARE(state_machine_->transitionStatistics().transitions, before.transitions);
+    QCOMPARE(state_machine_->transitionStatistics().suppressed_by_dwell, quint64(1));
+}
+
 QTEST_MAIN(TestExpressionStateMachine)
 #include "test_expression_state_machine.moc"
@@ -0,0 +1,94 @@
+#include <QtTest/QtTest>
+#include "diagnostics/latency_histogram.h"
+#include "diagnostics/latency_tracker.h"
+
+/**
+ * @brief Unit tests for LatencyHistogram and LatencyTracker
+ */
+class TestLatencyHistogram : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Test cases
+    void testEmptyHistogram();
+    void testBucketBoundaries();
+    void testPercentiles();
+    void testClampAndReset();
+    void testTrackerSummary();
+};
+
+void TestLatencyHistogram::initTestCase() {
+    qInfo() << "Starting LatencyHistogram tests";
+}
+
+void TestLatencyHistogram::cleanupTestCase() {
+    qInfo() << "LatencyHistogram tests completed";
+}
+
+void TestLatencyHistogram::testEmptyHistogram() {
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.minNs(), qint64(0));
+    QCOMPARE(histogram.maxNs(), qint64(0));
+    QCOMPARE(histogram.meanNs(), 0.0);
+    QCOMPARE(histogram.percentileNs(99.0), qint64(0));
+}
+
+void TestLatencyHistogram::testBucketBoundaries() {
+    // Every bucket's upper bound maps to itself, the next value to the next bucket
+    for (int i = 0; i < LatencyHistogram::BUCKET_COUNT - 1; ++i) {
+        const auto upper = LatencyHistogram::bucketUpperBound(i);
+        QCOMPARE(LatencyHistogram::bucketIndex(upper), i);
+        QCOMPARE(LatencyHistogram::bucketIndex(upper + 1), i + 1);
+    }
+}
+
+void TestLatencyHistogram::testPercentiles() {
+    LatencyHistogram histogram;
+    for (int i = 1; i <= 1000; ++i) {
+        histogram.record(i * 1000);   // 1 us .. 1 ms
+    }
+
+    QCOMPARE(histogram.count(), quint64(1000));
+    QCOMPARE(histogram.minNs(), qint64(1000));
+    QCOMPARE(histogram.maxNs(), qint64(1000000));
+    QCOMPARE(histogram.meanNs(), 500500.0);
+
+    // Bucket resolution is ~6%
+    const double p50 = static_cast<double>(histogram.percentileNs(50.0));
+    QVERIFY(p50 >= 500000.0 && p50 <= 500000.0 * 1.07);
+    const double p99 = static_cast<double>(histogram.percentileNs(99.0));
+    QVERIFY(p99 >= 990000.0 && p99 <= 1000000.0);
+}
+
+void TestLatencyHistogram::testClampAndReset() {
+    LatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(std::numeric_limits<qint64>::max());
+    QCOMPARE(histogram.count(), quint64(2));
+    QCOMPARE(histogram.minNs(), qint64(0));
+
+    histogram.reset();
+    QCOMPARE(histogram.count(), quint64(0));
+    QCOMPARE(histogram.maxNs(), qint64(0));
+}
+
+void TestLatencyHistogram::testTrackerSummary() {
+    LatencyTracker tracker;
+    tracker.record(LatencyTracker::Stage::Decode, 1000, 3000);
+    tracker.record(LatencyTracker::Stage::Decode, 0, 3000);   // unstamped, ignored
+
+    const QVariantMap summary = tracker.summary();
+    QCOMPARE(summary.size(), LatencyTracker::STAGE_COUNT);
+
+    const QVariantMap decode = summary["decode"].toMap();
+    QCOMPARE(decode["count"].toULongLong(), qulonglong(1));
+    QCOMPARE(decode["max_us"].toDouble(), 2.0);
+    QCOMPARE(summary["frame_swapped"].toMap()["count"].toULongLong(), qulonglong(0));
+}
+
+QTEST_MAIN(TestLatencyHistogram)
+#include "test_latency_histogram.moc"
@@ -0,0 +1,210 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "columnar_log.h"
+#include "common/crc32.h"
+#include "log_recovery.h"
+
+/**
+ * @brief Unit tests for LogRecovery and columnar block checksums
+ */
+class TestLogRecovery : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testCrc32();
+    void testCommittedCsvIsIntact();
+    void testTornCommitIsDropped();
+    void testCorruptCommitIsDropped();
+    void testCsvWithoutMarkers();
+    void testMixedCommitModes();
+    void testRecoverCsvFile();
+    void testRecoverColumnarFile();
+    void testColumnarChecksumMismatch();
+
+private:
+    static QByteArray rows(int first, int count);
+    QString writeFile(const QString& name, const QByteArray& data);
+    void writeColumnar(const QString& path, int records, int block_capacity);
+
+    QTemporaryDir* temp_dir_;
+};
+
+static const QByteArray HEADER("timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state\n");
+
+void TestLogRecovery::init() {
+    temp_dir_ = new QTemporaryDir();
+    QVERIFY(temp_dir_->isValid());
+}
+
+void TestLogRecovery::cleanup() {
+    delete temp_dir_;
+    temp_dir_ = nullptr;
+}
+
+QByteArray TestLogRecovery::rows(int first, int count) {
+    QByteArray text;
+    for (int i = first; i < first + count; ++i) {
+        text += "2024-01-01T00:00:" + QByteArray::number(10 + i % 50) + ",50." +
+                QByteArray::number(i % 10) + ",50,NORMAL\n";
+    }
+    return text;
+}
+
+QString TestLogRecovery::writeFile(const QString& name, const QByteArray& data) {
+    const QString path = temp_dir_->filePath(name);
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(data);
+    }
+    return path;
+}
+
+void TestLogRecovery::writeColumnar(const QString& path, int records, int block_capacity) {
+    ColumnarLogWriter writer(block_capacity);
+    QVERIFY(writer.open(path));
+    for (int i = 0; i < records; ++i) {
+        SpeedLogRecord record;
+        record.wall_ms = 1700000000000 + i * 100;
+        record.raw_speed = 30.0 + i * 0.1;
+        record.smoothed_speed = 30.0;
+        writer.append(record);
+    }
+}
+
+void TestLogRecovery::testCrc32() {
+    QCOMPARE(Crc32::compute("123456789", 9), quint32(0xcbf43926));
+    QCOMPARE(Crc32::update(Crc32::compute("1234", 4), "56789", 5), quint32(0xcbf43926));
+}
+
+void TestLogRecovery::testCommittedCsvIsIntact() {
+    const QByteArray first = rows(0, 5);
+    const QByteArray second = rows(5, 3);
+    const QByteArray data = HEADER + first + LogRecovery::commitMarker(5, first)
+        + second + LogRecovery::commitMarker(3, second);
+
+    QCOMPARE(LogRecovery::validCsvBytes(data), qint64(data.size()));
+    QVERIFY(LogRecovery::commitMarker(5, first).startsWith(LogRecovery::COMMIT_PREFIX));
+}
+
+void TestLogRecovery::testTornCommitIsDropped() {
+    const QByteArray first = rows(0, 5);
+    const QByteArray committed = HEADER + first + LogRecovery::commitMarker(5, first);
+    const QByteArray second = rows(5, 3);
+
+    // Power lost inside the second commit: complete rows without a marker
+    // are kept; a half-written line and zero fill from the filesystem are not
+    QCOMPARE(LogRecovery::validCsvBytes(committed + second), qint64(committed.size() + second.size()));
+    QCOMPARE(LogRecovery::validCsvBytes(committed + second.left(20)), qint64(committed.size()));
+    QCOMPARE(LogRecovery::validCsvBytes(committed + QByteArray(512, '\0')),
+             qint64(committed.size()));
+}
+
+void TestLogRecovery::testCorruptCommitIsDropped() {
+    const QByteArray first = rows(0, 5);
+    const QByteArray second = rows(5, 3);
+    const QByteArray committed = HEADER + first + LogRecovery::commitMarker(5, first);
+    QByteArray damaged = second;
+    damaged[3] = 'X';
+
+    QCOMPARE(LogRecovery::validCsvBytes(committed + damaged + LogRecovery::commitMarker(3, second)),
+             qint64(committed.size()));
+}
+
+void TestLogRecovery::testCsvWithoutMarkers() {
+    const QByteArray complete = HEADER + rows(0, 4);
+    QCOMPARE(LogRecovery::validCsvBytes(complete), qint64(complete.size()));
+    QCOMPARE(LogRecovery::validCsvBytes(complete + "2024-01-01T00:0"), qint64(complete.size()));
+    QCOMPARE(LogRecovery::validCsvBytes(QByteArray("timestamp,raw")), qint64(0));
+}
+
+void TestLogRecovery::testMixedCommitModes() {
+    const QByteArray buffered = rows(0, 4);
+    const QByteArray first = rows(4, 5);
+    const QByteArray later = rows(9, 3);
+
+    // Buffered rows before and after a durable commit all survive
+    const QByteArray mixed = HEADER + buffered + first + LogRecovery::commitMarker(5, first) + later;
+    QCOMPARE(LogRecovery::validCsvBytes(mixed), qint64(mixed.size()));
+
+    // A damaged commit goes, the buffered rows before it stay
+    QByteArray damaged = first;
+    damaged[3] = 'X';
+    QCOMPARE(LogRecovery::validCsvBytes(HEADER + buffered + damaged + LogRecovery::commitMarker(5, first)),
+             qint64(HEADER.size() + buffered.size()));
+
+    // A marker claiming more rows than precede it is not trusted
+    QCOMPARE(LogRecovery::validCsvBytes(HEADER + first + LogRecovery::commitMarker(6, first)),
+             qint64(HEADER.size()));
+}
+
+void TestLogRecovery::testRecoverCsvFile() {
+    const QByteArray first = rows(0, 5);
+    const QByteArray committed = HEADER + first + LogRecovery::commitMarker(5, first);
+
+    const QString clean = writeFile("speed_log_clean.csv", committed);
+    LogRecovery::Result result = LogRecovery::recoverFile(clean);
+    QVERIFY(result.ok);
+    QVERIFY(!result.truncated());
+
+    const QString torn = writeFile("speed_log_torn.csv", committed + rows(5, 2).left(30));
+    result = LogRecovery::recoverFile(torn);
+    QVERIFY(result.ok);
+    QVERIFY(result.truncated());
+    QCOMPARE(QFileInfo(torn).size(), qint64(committed.size()));
+}
+
+void TestLogRecovery::testRecoverColumnarFile() {
+    const QString path = temp_dir_->filePath("speed_log_torn.cslog");
+    writeColumnar(path, 250, 100);
+    const qint64 intact = QFileInfo(path).size();
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write(QByteArray(100, '\0'));
+    }
+
+    const LogRecovery::Result result = LogRecovery::recoverFile(path);
+    QVERIFY(result.ok);
+    QVERIFY(result.truncated());
+    QCOMPARE(result.recovered_bytes, intact);
+
+    // Appending after recovery keeps every block reachable
+    writeColumnar(path, 10, 100);
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(path));
+    QVERIFY(!reader.truncated());
+    QCOMPARE(reader.recordCount(), quint64(260));
+}
+
+void TestLogRecovery::testColumnarChecksumMismatch() {
+    const QString path = temp_dir_->filePath("speed_log_flip.cslog");
+    writeColumnar(path, 300, 100);
+
+    ColumnarLogReader reader;
+    QVERIFY(reader.open(path));
+    const qint64 last_block = reader.blocks().last().offset;
+    reader.close();
+
+    // Flip one payload byte of the last block
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        file.seek(last_block + ColumnarLog::BLOCK_HEADER_SIZE + 3);
+        char byte = 0;
+        file.getChar(&byte);
+        file.seek(last_block + ColumnarLog::BLOCK_HEADER_SIZE + 3);
+        file.putChar(static_cast<char>(byte ^ 0x5a));
+    }
+
+    QVERIFY(reader.open(path));
+    QVERIFY(reader.truncated());
+    QCOMPARE(reader.blocks().size(), 2);
+    QCOMPARE(reader.validBytes(), last_block);
+}
+
+QTEST_MAIN(TestLogRecovery)
+#include "test_log_recovery.moc"
@@ -0,0 +1,154 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "log_retention.h"
+
+/**
+ * @brief Unit tests for LogRetention
+ */
+class TestLogRetention : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testScanIndexesMatchingFiles();
+    void testPruneByCount();
+    void testPruneByTotalBytes();
+    void testPruneByAge();
+    void testNoLimits();
+    void testAddFileKeepsIndexWithoutRescan();
+
+private:
+    QString createLog(const QString& name, int bytes, qint64 modified_ms);
+
+    QTemporaryDir* temp_dir_;
+    LogRetention* retention_;
+    qint64 now_ms_;
+};
+
+void TestLogRetention::init() {
+    temp_dir_ = new QTemporaryDir();
+    QVERIFY(temp_dir_->isValid());
+    retention_ = new LogRetention(temp_dir_->path(), {"speed_log_*.csv", "speed_log_*.cslog"});
+    now_ms_ = QDateTime::currentMSecsSinceEpoch();
+}
+
+void TestLogRetention::cleanup() {
+    delete retention_;
+    retention_ = nullptr;
+    delete temp_dir_;
+    temp_dir_ = nullptr;
+}
+
+QString TestLogRetention::createLog(const QString& name, int bytes, qint64 modified_ms) {
+    const QString path = temp_dir_->filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(QByteArray(bytes, 'x'));
+    file.flush();
+    file.setFileTime(QDateTime::fromMSecsSinceEpoch(modified_ms), QFileDevice::FileModificationTime);
+    file.close();
+    return path;
+}
+
+void TestLogRetention::testScanIndexesMatchingFiles() {
+    const QString oldest = createLog("speed_log_20240101_000000.csv", 100, now_ms_ - 3000);
+    createLog("speed_log_20240101_010000.cslog", 200, now_ms_ - 2000);
+    const QString active = createLog("speed_log_20240101_020000.csv", 50, now_ms_ - 1000);
+    createLog("notes.txt", 1000, now_ms_);
+
+    QCOMPARE(retention_->scan(active), 2);
+    QCOMPARE(retention_->fileCount(), 2);
+    QCOMPARE(retention_->totalBytes(), qint64(300));
+    QCOMPARE(retention_->entries().first().path, QFileInfo(oldest).absoluteFilePath());
+}
+
+void TestLogRetention::testPruneByCount() {
+    QStringList paths;
+    for (int i = 0; i < 5; ++i) {
+        paths.append(createLog(QString("speed_log_2024010%1_000000.csv").arg(i), 10,
+                               now_ms_ - (5 - i) * 1000));
+    }
+    retention_->scan();
+
+    LogRetention::Policy policy;
+    policy.max_files = 3;   // two closed files plus the active one
+    retention_->setPolicy(policy);
+
+    const QStringList removed = retention_->prune(now_ms_, 0);
+    QCOMPARE(removed.size(), 3);
+    QCOMPARE(removed.first(), QFileInfo(paths[0]).absoluteFilePath());
+    QVERIFY(!QFile::exists(paths[0]));
+    QVERIFY(!QFile::exists(paths[2]));
+    QVERIFY(QFile::exists(paths[3]));
+    QCOMPARE(retention_->fileCount(), 2);
+    QCOMPARE(retention_->totalBytes(), qint64(20));
+}
+
+void TestLogRetention::testPruneByTotalBytes() {
+    for (int i = 0; i < 4; ++i) {
+        createLog(QString("speed_log_2024010%1_000000.csv").arg(i), 1000, now_ms_ - (4 - i) * 1000);
+    }
+    retention_->scan();
+
+    LogRetention::Policy policy;
+    policy.max_total_bytes = 2500;
+    retention_->setPolicy(policy);
+
+    // 4000 closed + 500 active: two files have to go
+    QCOMPARE(retention_->selectExpired(now_ms_, 500).size(), 2);
+    QCOMPARE(retention_->prune(now_ms_, 500).size(), 2);
+    QCOMPARE(retention_->totalBytes(), qint64(2000));
+}
+
+void TestLogRetention::testPruneByAge() {
+    const qint64 day_ms = 24 * 3600 * 1000LL;
+    createLog("speed_log_20240101_000000.csv", 10, now_ms_ - 10 * day_ms);
+    createLog("speed_log_20240102_000000.csv", 10, now_ms_ - 8 * day_ms);
+    createLog("speed_log_20240103_000000.csv", 10, now_ms_ - 1 * day_ms);
+    retention_->scan();
+
+    LogRetention::Policy policy;
+    policy.max_age_ms = 7 * day_ms;
+    retention_->setPolicy(policy);
+
+    QCOMPARE(retention_->prune(now_ms_, 0).size(), 2);
+    QCOMPARE(retention_->fileCount(), 1);
+}
+
+void TestLogRetention::testNoLimits() {
+    for (int i = 0; i < 3; ++i) {
+        createLog(QString("speed_log_2024010%1_000000.csv").arg(i), 10, now_ms_ - i * 1000);
+    }
+    retention_->scan();
+    QVERIFY(retention_->prune(now_ms_, 1 << 30).isEmpty());
+    QCOMPARE(retention_->fileCount(), 3);
+}
+
+void TestLogRetention::testAddFileKeepsIndexWithoutRescan() {
+    LogRetention::Policy policy;
+    policy.max_files = 2;
+    retention_->setPolicy(policy);
+    retention_->scan();
+
+    const QString first = createLog("speed_log_20240101_000000.csv", 10, now_ms_ - 2000);
+    const QString second = createLog("speed_log_20240101_010000.csv", 10, now_ms_ - 1000);
+    retention_->addFile(first, 10, now_ms_ - 2000);
+    retention_->addFile(second, 10, now_ms_ - 1000);
+    retention_->addFile(second, 15, now_ms_);   // reopened, not a new entry
+    QCOMPARE(retention_->fileCount(), 2);
+    QCOMPARE(retention_->totalBytes(), qint64(25));
+
+    // Files the index does not know about are left alone
+    createLog("speed_log_20231231_000000.csv", 10, now_ms_ - 5000);
+    const QStringList removed = retention_->prune(now_ms_, 0);
+    QCOMPARE(removed, QStringList{QFileInfo(first).absoluteFilePath()});
+    QCOMPARE(QDir(temp_dir_->path()).entryList({"speed_log_*"}, QDir::Files).size(), 2);
+}
+
+QTEST_MAIN(TestLogRetention)
+#include "test_log_retention.moc"
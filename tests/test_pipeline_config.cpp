@@ -0,0 +1,108 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include "configuration_manager.h"
+#include "expression_state_machine.h"
+#include "pipeline_config.h"
+
+/**
+ * @brief Unit tests for PipelineConfig
+ */
+class TestPipelineConfig : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testSpeedFilterNames();
+    void testCustomBands();
+    void testReloadWithCustomBandsKeepsState();
+    void testInvalidBandsFallBackToThresholds();
+
+private:
+    static QVector<ConfigurationManager::ExpressionBandConfig> customBands();
+
+    ConfigurationManager* config_manager_;
+    ExpressionStateMachine* state_machine_;
+};
+
+void TestPipelineConfig::init() {
+    config_manager_ = new ConfigurationManager();
+    state_machine_ = new ExpressionStateMachine();
+}
+
+void TestPipelineConfig::cleanup() {
+    delete state_machine_;
+    state_machine_ = nullptr;
+    delete config_manager_;
+    config_manager_ = nullptr;
+}
+
+QVector<ConfigurationManager::ExpressionBandConfig> TestPipelineConfig::customBands() {
+    ConfigurationManager::ExpressionBandConfig crawl;
+    crawl.name = "crawl";
+    crawl.max_kmh = 10.0;
+    ConfigurationManager::ExpressionBandConfig city;
+    city.name = "city";
+    city.max_kmh = 60.0;
+    ConfigurationManager::ExpressionBandConfig fast;
+    fast.name = "fast";
+    return {crawl, city, fast};
+}
+
+void TestPipelineConfig::testSpeedFilterNames() {
+    ConfigurationManager::SmoothingConfig smoothing;
+    QVERIFY(std::holds_alternative<MovingAverageFilter>(PipelineConfig::makeSpeedFilter(smoothing)));
+    smoothing.filter = "ema";
+    QVERIFY(std::holds_alternative<EmaFilter>(PipelineConfig::makeSpeedFilter(smoothing)));
+    smoothing.filter = "median";
+    QVERIFY(std::holds_alternative<MedianFilter>(PipelineConfig::makeSpeedFilter(smoothing)));
+    smoothing.filter = "one_euro";
+    QVERIFY(std::holds_alternative<OneEuroFilter>(PipelineConfig::makeSpeedFilter(smoothing)));
+    smoothing.filter = "kalman";
+    QVERIFY(std::holds_alternative<KalmanFilter>(PipelineConfig::makeSpeedFilter(smoothing)));
+    smoothing.filter = "unknown";
+    QVERIFY(std::holds_alternative<MovingAverageFilter>(PipelineConfig::makeSpeedFilter(smoothing)));
+}
+
+void TestPipelineConfig::testCustomBands() {
+    config_manager_->setExpressionBands(customBands());
+    PipelineConfig::applyExpression(*config_manager_, *state_machine_);
+    QCOMPARE(state_machine_->bandTable().bandCount(), 3);
+
+    state_machine_->updateSpeed(30.0);
+    QCOMPARE(state_machine_->currentBandName(), QString("city"));
+}
+
+void TestPipelineConfig::testReloadWithCustomBandsKeepsState() {
+    config_manager_->setExpressionBands(customBands());
+    PipelineConfig::applyExpression(*config_manager_, *state_machine_);
+    state_machine_->updateSpeed(30.0);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::ALERT);
+
+    // A reload must not pass through the default table, where band 1 is NORMAL
+    QSignalSpy stateSpy(state_machine_, &ExpressionStateMachine::stateChanged);
+    QSignalSpy stringStateSpy(state_machine_, &ExpressionStateMachine::stateStringChanged);
+    PipelineConfig::applyExpression(*config_manager_, *state_machine_);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::ALERT);
+    QCOMPARE(stateSpy.count(), 0);
+    QCOMPARE(stringStateSpy.count(), 0);
+}
+
+void TestPipelineConfig::testInvalidBandsFallBackToThresholds() {
+    QVector<ConfigurationManager::ExpressionBandConfig> bands = customBands();
+    bands[1].max_kmh = 5.0;   // Below the previous edge
+    config_manager_->setExpressionBands(bands);
+    ConfigurationManager::SpeedThresholds thresholds;
+    thresholds.relaxed_max = 30.0;
+    config_manager_->setSpeedThresholds(thresholds);
+
+    PipelineConfig::applyExpression(*config_manager_, *state_machine_);
+    QCOMPARE(state_machine_->bandTable().bandCount(), 5);
+    state_machine_->updateSpeed(25.0);
+    QCOMPARE(state_machine_->getCurrentState(), ExpressionState::RELAXED);
+}
+
+QTEST_MAIN(TestPipelineConfig)
+#include "test_pipeline_config.moc"
@@ -0,0 +1,124 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QThread>
+#include "sample_channel.h"
+
+/**
+ * @brief Unit tests for SampleChannel
+ */
+class TestSampleChannel : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testEmptyChannel();
+    void testPushAndConsume();
+    void testSingleWakeupPerBurst();
+    void testDropWhenFull();
+    void testCrossThreadOrdering();
+
+private:
+    SampleChannel* channel_;
+};
+
+void TestSampleChannel::initTestCase() {
+    qInfo() << "Starting SampleChannel tests";
+}
+
+void TestSampleChannel::cleanupTestCase() {
+    qInfo() << "SampleChannel tests completed";
+}
+
+void TestSampleChannel::init() {
+    channel_ = new SampleChannel();
+}
+
+void TestSampleChannel::cleanup() {
+    delete channel_;
+    channel_ = nullptr;
+}
+
+void TestSampleChannel::testEmptyChannel() {
+    QCOMPARE(channel_->depth(), 0);
+    QCOMPARE(channel_->pushedCount(), quint64(0));
+    QCOMPARE(channel_->droppedCount(), quint64(0));
+    QCOMPARE(channel_->consume([](const VehicleSample&) {}), 0);
+}
+
+void TestSampleChannel::testPushAndConsume() {
+    QVERIFY(channel_->push({0, 42.0, 1000, 0}));
+    QVERIFY(channel_->push({0, 43.0, 2000, 0}));
+    QCOMPARE(channel_->depth(), 2);
+
+    QVector<double> values;
+    QCOMPARE(channel_->consume([&values](const VehicleSample& sample) {
+        values.append(sample.value);
+    }), 2);
+
+    QCOMPARE(values, QVector<double>({42.0, 43.0}));
+    QCOMPARE(channel_->depth(), 0);
+    QCOMPARE(channel_->highWaterMark(), 2);
+}
+
+void TestSampleChannel::testSingleWakeupPerBurst() {
+    QSignalSpy spy(channel_, &SampleChannel::samplesAvailable);
+
+    for (int i = 0; i < 10; ++i) {
+        channel_->push({0, static_cast<double>(i), i, 0});
+    }
+    QCOMPARE(spy.count(), 1);
+
+    channel_->consume([](const VehicleSample&) {});
+    channel_->push({0, 1.0, 0, 0});
+    QCOMPARE(spy.count(), 2);
+}
+
+void TestSampleChannel::testDropWhenFull() {
+    const int capacity = static_cast<int>(SampleChannel::CAPACITY);
+    for (int i = 0; i < capacity; ++i) {
+        QVERIFY(channel_->push({0, static_cast<double>(i), i, 0}));
+    }
+    QVERIFY(!channel_->push({0, -1.0, 0, 0}));
+
+    QCOMPARE(channel_->depth(), capacity);
+    QCOMPARE(channel_->pushedCount(), quint64(capacity));
+    QCOMPARE(channel_->droppedCount(), quint64(1));
+}
+
+void TestSampleChannel::testCrossThreadOrdering() {
+    constexpr int SAMPLE_COUNT = 100000;
+
+    QThread* producer = QThread::create([this]() {
+        for (int i = 0; i < SAMPLE_COUNT; ++i) {
+            // Spin until the consumer makes room; nothing may be lost here
+            while (!channel_->push({0, static_cast<double>(i), i, 0})) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    });
+
+    int received = 0;
+    bool ordered = true;
+    connect(channel_, &SampleChannel::samplesAvailable, this, [&]() {
+        channel_->consume([&](const VehicleSample& sample) {
+            ordered = ordered && sample.received_ns == received;
+            ++received;
+        });
+    }, Qt::QueuedConnection);
+
+    producer->start();
+    QTRY_COMPARE_WITH_TIMEOUT(received, SAMPLE_COUNT, 10000);
+    producer->wait();
+    delete producer;
+
+    QVERIFY(ordered);
+    QCOMPARE(channel_->pushedCount(), quint64(SAMPLE_COUNT));
+}
+
+QTEST_MAIN(TestSampleChannel)
+#include "test_sample_channel.moc"
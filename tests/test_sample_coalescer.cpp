@@ -0,0 +1,122 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include "sample_coalescer.h"
+
+/**
+ * @brief Unit tests for SampleCoalescer
+ */
+class TestSampleCoalescer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testPassThrough();
+    void testLeadingEdgeDelivery();
+    void testBurstCoalescing();
+    void testSignalsCoalescedIndependently();
+    void testInvalidRate();
+
+private:
+    static VehicleSample sample(int signal_id, double value);
+
+    SampleCoalescer* coalescer_;
+};
+
+void TestSampleCoalescer::initTestCase() {
+    qRegisterMetaType<VehicleSample>();
+    qInfo() << "Starting SampleCoalescer tests";
+}
+
+void TestSampleCoalescer::cleanupTestCase() {
+    qInfo() << "SampleCoalescer tests completed";
+}
+
+void TestSampleCoalescer::init() {
+    coalescer_ = new SampleCoalescer(10);
+}
+
+void TestSampleCoalescer::cleanup() {
+    delete coalescer_;
+    coalescer_ = nullptr;
+}
+
+VehicleSample TestSampleCoalescer::sample(int signal_id, double value) {
+    VehicleSample result;
+    result.signal_id = signal_id;
+    result.value = value;
+    return result;
+}
+
+void TestSampleCoalescer::testPassThrough() {
+    coalescer_->setUpdateRate(0);
+    QSignalSpy spy(coalescer_, &SampleCoalescer::sampleReady);
+
+    for (int i = 0; i < 5; ++i) {
+        coalescer_->submit(sample(0, i));
+    }
+
+    QCOMPARE(spy.count(), 5);
+    QCOMPARE(coalescer_->coalescedCount(), quint64(0));
+}
+
+void TestSampleCoalescer::testLeadingEdgeDelivery() {
+    QSignalSpy spy(coalescer_, &SampleCoalescer::sampleReady);
+
+    // First sample after idle goes straight through
+    coalescer_->submit(sample(0, 42.0));
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.takeFirst().at(0).value<VehicleSample>().value, 42.0);
+}
+
+void TestSampleCoalescer::testBurstCoalescing() {
+    QSignalSpy spy(coalescer_, &SampleCoalescer::sampleReady);
+
+    for (int i = 0; i < 10; ++i) {
+        coalescer_->submit(sample(0, i));
+    }
+
+    // Leading edge delivered, remaining nine collapse into one pending value
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(coalescer_->pendingCount(), 1);
+    QCOMPARE(coalescer_->coalescedCount(), quint64(8));
+
+    // Next tick delivers only the latest value
+    QVERIFY(spy.wait(500));
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.at(1).at(0).value<VehicleSample>().value, 9.0);
+    QCOMPARE(coalescer_->submittedCount(), quint64(10));
+    QCOMPARE(coalescer_->deliveredCount(), quint64(2));
+}
+
+void TestSampleCoalescer::testSignalsCoalescedIndependently() {
+    QSignalSpy spy(coalescer_, &SampleCoalescer::sampleReady);
+
+    coalescer_->submit(sample(0, 1.0));   // leading edge
+    coalescer_->submit(sample(1, 10.0));
+    coalescer_->submit(sample(0, 2.0));
+    coalescer_->submit(sample(1, 20.0));
+    QCOMPARE(coalescer_->pendingCount(), 2);
+
+    // Pending signals are delivered in order of first arrival
+    coalescer_->flush();
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(1).at(0).value<VehicleSample>().value, 20.0);
+    QCOMPARE(spy.at(2).at(0).value<VehicleSample>().value, 2.0);
+    QCOMPARE(coalescer_->pendingCount(), 0);
+}
+
+void TestSampleCoalescer::testInvalidRate() {
+    coalescer_->setUpdateRate(-1);
+    QCOMPARE(coalescer_->updateRate(), 10);
+
+    coalescer_->setUpdateRate(5000);
+    QCOMPARE(coalescer_->updateRate(), 10);
+}
+
+QTEST_MAIN(TestSampleCoalescer)
+#include "test_sample_coalescer.moc"
@@ -0,0 +1,125 @@
+#include <QtTest/QtTest>
+#include "speed_extrapolator.h"
+
+/**
+ * @brief Unit tests for SpeedExtrapolator
+ */
+class TestSpeedExtrapolator : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Test cases
+    void testNoData();
+    void testConstantSpeed();
+    void testTracksAcceleration();
+    void testErrorIsBounded();
+    void testStaleFallback();
+    void testOutOfOrderIgnored();
+
+private:
+    static constexpr qint64 MS = 1000000;
+
+    // Feed a constant-acceleration ramp at 10 Hz, returns the last timestamp
+    static qint64 feedRamp(SpeedExtrapolator& extrapolator, double start_kmh,
+                           double accel_kmh_s, int samples);
+};
+
+void TestSpeedExtrapolator::initTestCase() {
+    qInfo() << "Starting SpeedExtrapolator tests";
+}
+
+void TestSpeedExtrapolator::cleanupTestCase() {
+    qInfo() << "SpeedExtrapolator tests completed";
+}
+
+qint64 TestSpeedExtrapolator::feedRamp(SpeedExtrapolator& extrapolator, double start_kmh,
+                                       double accel_kmh_s, int samples) {
+    qint64 timestamp_ns = 0;
+    for (int i = 0; i < samples; ++i) {
+        timestamp_ns = (i + 1) * 100 * MS;
+        extrapolator.addSample(start_kmh + accel_kmh_s * i * 0.1, timestamp_ns);
+    }
+    return timestamp_ns;
+}
+
+void TestSpeedExtrapolator::testNoData() {
+    SpeedExtrapolator extrapolator;
+    QVERIFY(!extrapolator.hasData());
+    QVERIFY(extrapolator.isStale(100 * MS));
+    QCOMPARE(extrapolator.speedAt(100 * MS), 0.0);
+}
+
+void TestSpeedExtrapolator::testConstantSpeed() {
+    SpeedExtrapolator extrapolator;
+    const qint64 last = feedRamp(extrapolator, 50.0, 0.0, 20);
+
+    for (qint64 offset = 0; offset <= 100 * MS; offset += 16 * MS) {
+        QVERIFY(qAbs(extrapolator.speedAt(last + offset) - 50.0) < 1e-6);
+    }
+}
+
+void TestSpeedExtrapolator::testTracksAcceleration() {
+    SpeedExtrapolator extrapolator;
+    const qint64 last = feedRamp(extrapolator, 20.0, 10.0, 30);
+    const double last_speed = 20.0 + 10.0 * 29 * 0.1;
+
+    // Converged on the ramp: the next frames lead the last sample
+    QVERIFY(qAbs(extrapolator.estimatedAcceleration() - 10.0) < 0.5);
+    const double predicted = extrapolator.speedAt(last + 50 * MS);
+    QVERIFY(qAbs(predicted - (last_speed + 0.5)) < 0.2);
+
+    // Frames in between move monotonically
+    double previous = extrapolator.speedAt(last);
+    for (qint64 offset = 16 * MS; offset <= 96 * MS; offset += 16 * MS) {
+        const double speed = extrapolator.speedAt(last + offset);
+        QVERIFY(speed > previous);
+        previous = speed;
+    }
+}
+
+void TestSpeedExtrapolator::testErrorIsBounded() {
+    SpeedExtrapolator::Settings settings;
+    settings.max_lead_s = 0.2;
+    settings.stale_after_s = 0.5;
+    settings.max_acceleration_kmh_s = 20.0;
+    SpeedExtrapolator extrapolator(settings);
+    QCOMPARE(extrapolator.maxError(), 4.0);
+
+    // Far harder than the clamp allows
+    const qint64 last = feedRamp(extrapolator, 0.0, 200.0, 10);
+    const double base = extrapolator.estimatedSpeed();
+    for (qint64 offset = 0; offset < 500 * MS; offset += 10 * MS) {
+        QVERIFY(qAbs(extrapolator.speedAt(last + offset) - base) <= 4.0 + 1e-9);
+    }
+}
+
+void TestSpeedExtrapolator::testStaleFallback() {
+    SpeedExtrapolator extrapolator;
+    const qint64 last = feedRamp(extrapolator, 20.0, 10.0, 30);
+    const double base = extrapolator.estimatedSpeed();
+
+    // Projection fades out between max_lead and stale_after, then holds
+    QVERIFY(!extrapolator.isStale(last + 400 * MS));
+    QVERIFY(qAbs(extrapolator.speedAt(last + 490 * MS) - base) < 0.1);
+    QVERIFY(extrapolator.isStale(last + 500 * MS));
+    QCOMPARE(extrapolator.speedAt(last + 5000 * MS), base);
+
+    // After a stall the old trend is dropped
+    extrapolator.addSample(80.0, last + 5000 * MS);
+    QCOMPARE(extrapolator.estimatedSpeed(), 80.0);
+    QCOMPARE(extrapolator.estimatedAcceleration(), 0.0);
+}
+
+void TestSpeedExtrapolator::testOutOfOrderIgnored() {
+    SpeedExtrapolator extrapolator;
+    extrapolator.addSample(40.0, 200 * MS);
+    extrapolator.addSample(90.0, 100 * MS);
+    QCOMPARE(extrapolator.lastSampleNs(), 200 * MS);
+    QCOMPARE(extrapolator.estimatedSpeed(), 40.0);
+}
+
+QTEST_MAIN(TestSpeedExtrapolator)
+#include "test_speed_extrapolator.moc"
@@ -0,0 +1,143 @@
+#include <QtTest/QtTest>
+#include "speed_filters.h"
+
+/**
+ * @brief Unit tests for the SpeedMonitor filter policies
+ */
+class TestSpeedFilters : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Test cases
+    void testConvergesToConstant_data();
+    void testConvergesToConstant();
+    void testMedianRejectsSpike();
+    void testEmaUsesElapsedTime();
+    void testKalmanTracksRamp();
+    void testOneEuroFollowsFastChange();
+
+private:
+    template <typename Filter>
+    static double feedConstant(Filter filter, double value, int count);
+};
+
+void TestSpeedFilters::initTestCase() {
+    qInfo() << "Starting SpeedFilter tests";
+}
+
+void TestSpeedFilters::cleanupTestCase() {
+    qInfo() << "SpeedFilter tests completed";
+}
+
+template <typename Filter>
+double TestSpeedFilters::feedConstant(Filter filter, double value, int count) {
+    double result = 0.0;
+    for (int i = 0; i < count; ++i) {
+        result = filter.update(value, 0.1);
+    }
+    return result;
+}
+
+void TestSpeedFilters::testConvergesToConstant_data() {
+    QTest::addColumn<int>("policy");
+    QTest::newRow(MovingAverageFilter::NAME) << 0;
+    QTest::newRow(EmaFilter::NAME) << 1;
+    QTest::newRow(MedianFilter::NAME) << 2;
+    QTest::newRow(OneEuroFilter::NAME) << 3;
+    QTest::newRow(KalmanFilter::NAME) << 4;
+}
+
+void TestSpeedFilters::testConvergesToConstant() {
+    QFETCH(int, policy);
+
+    SpeedFilter filter;
+    switch (policy) {
+        case 0: filter = MovingAverageFilter(); break;
+        case 1: filter = EmaFilter(); break;
+        case 2: filter = MedianFilter(); break;
+        case 3: filter = OneEuroFilter(); break;
+        default: filter = KalmanFilter(); break;
+    }
+
+    // First sample is passed through, then a constant input stays constant
+    double result = std::visit([](auto& f) { return f.update(42.0, 0.1); }, filter);
+    QCOMPARE(result, 42.0);
+    for (int i = 0; i < 50; ++i) {
+        result = std::visit([](auto& f) { return f.update(42.0, 0.1); }, filter);
+    }
+    QVERIFY(qAbs(result - 42.0) < 1e-9);
+
+    // reset() forgets history
+    std::visit([](auto& f) { f.reset(); }, filter);
+    result = std::visit([](auto& f) { return f.update(7.0, 0.1); }, filter);
+    QCOMPARE(result, 7.0);
+}
+
+void TestSpeedFilters::testMedianRejectsSpike() {
+    MedianFilter filter(5);
+    double result = 0.0;
+    for (double value : {50.0, 51.0, 250.0, 50.0, 49.0}) {
+        result = filter.update(value, 0.1);
+    }
+    QCOMPARE(result, 50.0);
+}
+
+void TestSpeedFilters::testEmaUsesElapsedTime() {
+    EmaFilter slow(1.0);
+    EmaFilter burst(1.0);
+    slow.update(0.0, 0.1);
+    burst.update(0.0, 0.1);
+
+    // One second of data vs. ten frames arriving within 5 ms
+    double slow_result = 0.0;
+    double burst_result = 0.0;
+    for (int i = 0; i < 10; ++i) {
+        slow_result = slow.update(100.0, 0.1);
+        burst_result = burst.update(100.0, 0.0005);
+    }
+    QVERIFY(qAbs(slow_result - 100.0 * (1.0 - std::exp(-1.0))) < 1e-9);
+    QVERIFY(burst_result < 1.0);
+}
+
+void TestSpeedFilters::testKalmanTracksRamp() {
+    KalmanFilter kalman;
+    MovingAverageFilter average(5);
+
+    // Braking at 20 km/h per second, sampled at 10 Hz
+    double kalman_result = 0.0;
+    double average_result = 0.0;
+    double speed = 100.0;
+    for (int i = 0; i < 40; ++i) {
+        kalman_result = kalman.update(speed, 0.1);
+        average_result = average.update(speed, 0.1);
+        speed -= 2.0;
+    }
+    const double truth = speed + 2.0;
+
+    // The moving average lags by two samples (4 km/h); Kalman has no steady-state lag
+    QVERIFY(qAbs(average_result - truth) > 3.9);
+    QVERIFY(qAbs(kalman_result - truth) < 0.5);
+    QVERIFY(qAbs(kalman.acceleration() + 20.0) < 1.0);
+}
+
+void TestSpeedFilters::testOneEuroFollowsFastChange() {
+    OneEuroFilter one_euro;
+    EmaFilter ema(0.3);
+    one_euro.update(0.0, 0.1);
+    ema.update(0.0, 0.1);
+
+    // A fast change raises the one-euro cutoff, so it reacts faster than a fixed EMA
+    double one_euro_result = 0.0;
+    double ema_result = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        one_euro_result = one_euro.update(60.0, 0.1);
+        ema_result = ema.update(60.0, 0.1);
+    }
+    QVERIFY(one_euro_result > ema_result);
+}
+
+QTEST_MAIN(TestSpeedFilters)
+#include "test_speed_filters.moc"
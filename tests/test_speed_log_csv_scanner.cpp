@@ -0,0 +1,266 @@
+#include <QtTest/QtTest>
+#include <cstring>
+#include <random>
+#include "speed_log_csv_scanner.h"
+
+/**
+ * @brief Unit tests for SpeedLogCsvScanner
+ *
+ * SpeedLogCsvParser is the reference: every row must parse to the same
+ * record (bit for bit) or be rejected by both, on the AVX2 and the scalar
+ * delimiter search alike.
+ */
+class TestSpeedLogCsvScanner : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    // Test cases
+    void testStateFromName();
+    void testFormatterRows();
+    void testUnusualRowsMatchParser();
+    void testRowOffsets();
+    void testIncompleteLastRow();
+    void testRowsAcrossWindows();
+    void testOverlongRow();
+    void testScalarMatchesSimd();
+
+private:
+    struct ScannedRow {
+        SpeedLogRecord record;
+        qint64 offset;
+        qint64 end;
+    };
+
+    static QVector<ScannedRow> scanAll(SpeedLogCsvScanner& scanner, const QByteArray& data,
+                                       qint64* consumed = nullptr);
+    static bool sameRecord(const SpeedLogRecord& a, const SpeedLogRecord& b);
+    QByteArray makeLog(int count, bool with_milliseconds, quint32 seed) const;
+
+    qint64 start_ms_;
+};
+
+void TestSpeedLogCsvScanner::init() {
+    start_ms_ = QDateTime(QDate(2024, 3, 5), QTime(14, 0)).toMSecsSinceEpoch();
+}
+
+QVector<TestSpeedLogCsvScanner::ScannedRow> TestSpeedLogCsvScanner::scanAll(
+    SpeedLogCsvScanner& scanner, const QByteArray& data, qint64* consumed) {
+    QVector<ScannedRow> rows;
+    const qint64 used = scanner.scan(data.constData(), data.size(),
+                                     [&rows](const SpeedLogRecord& record, qint64 offset, qint64 end) {
+        rows.append({record, offset, end});
+    });
+    if (consumed) {
+        *consumed = used;
+    }
+    return rows;
+}
+
+bool TestSpeedLogCsvScanner::sameRecord(const SpeedLogRecord& a, const SpeedLogRecord& b) {
+    // Bitwise, so a rounding difference in the last place fails
+    return a.wall_ms == b.wall_ms && a.state == b.state
+        && std::memcmp(&a.raw_speed, &b.raw_speed, sizeof(double)) == 0
+        && std::memcmp(&a.smoothed_speed, &b.smoothed_speed, sizeof(double)) == 0;
+}
+
+QByteArray TestSpeedLogCsvScanner::makeLog(int count, bool with_milliseconds, quint32 seed) const {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> speed(0.0, 250.0);
+    SpeedLogCsvFormatter formatter(with_milliseconds);
+    QByteArray log(SpeedLogCsvFormatter::HEADER);
+    for (int i = 0; i < count; ++i) {
+        SpeedLogRecord record;
+        record.wall_ms = start_ms_ + i * 100;
+        record.raw_speed = speed(random);
+        record.smoothed_speed = (i % 7 == 0) ? 0.0 : speed(random);
+        record.state = static_cast<quint8>(i % 5);
+        formatter.appendRow(log, record);
+        if (i % 1000 == 999) {
+            log += "#commit,1000,0badc0de\n";
+        }
+    }
+    return log;
+}
+
+void TestSpeedLogCsvScanner::testStateFromName() {
+    for (int state = 0; state < 5; ++state) {
+        const char* name = SpeedLogCsvFormatter::stateName(static_cast<quint8>(state));
+        QCOMPARE(SpeedLogCsvParser::stateFromName(name, static_cast<int>(std::strlen(name))), state);
+    }
+    QCOMPARE(SpeedLogCsvParser::stateFromName("RELAXEX", 7), -1);
+    QCOMPARE(SpeedLogCsvParser::stateFromName("ALERTS", 6), -1);
+    QCOMPARE(SpeedLogCsvParser::stateFromName("normal", 6), -1);
+    QCOMPARE(SpeedLogCsvParser::stateFromName("UNKNOWN", 7), -1);
+    QCOMPARE(SpeedLogCsvParser::stateFromName("", 0), -1);
+}
+
+void TestSpeedLogCsvScanner::testFormatterRows() {
+    for (const bool with_milliseconds : {true, false}) {
+        const QByteArray log = makeLog(5000, with_milliseconds, 7);
+        SpeedLogCsvScanner scanner;
+        const QVector<ScannedRow> rows = scanAll(scanner, log);
+        QCOMPARE(rows.size(), 5000);
+        QCOMPARE(scanner.stats().records, quint64(5000));
+        QCOMPARE(scanner.stats().ignored, quint64(6));   // header + 5 commit markers
+        QCOMPARE(scanner.stats().malformed, quint64(0));
+        QCOMPARE(scanner.stats().slow_rows, quint64(0));
+
+        for (const ScannedRow& row : rows) {
+            SpeedLogRecord expected;
+            QVERIFY(SpeedLogCsvParser::parseRow(log.constData() + row.offset,
+                                                static_cast<int>(row.end - row.offset - 1), &expected));
+            QVERIFY(sameRecord(row.record, expected));
+        }
+        const qint64 last_ms = start_ms_ + 4999 * 100;
+        QCOMPARE(rows.last().record.wall_ms, with_milliseconds ? last_ms : last_ms / 1000 * 1000);
+    }
+}
+
+void TestSpeedLogCsvScanner::testUnusualRowsMatchParser() {
+    const QList<QByteArray> lines = {
+        "2024-03-05T14:00:00.250,87.5,86.25,WARNING",
+        "2024-03-05T14:00:01,1e+06,0,SCARED",          // exponent
+        "2024-03-05T14:00:02, 12.5,12,NORMAL",          // whitespace
+        "2024-03-05T14:00:03,-0,-1.5,RELAXED",
+        "2024-03-05T14:00:04,007.5,7,NORMAL",           // leading zeros
+        "2024-03-05T14:00:05,5.,.5,NORMAL",
+        "2024-03-05T14:00:06,123.45678901234567,1,ALERT",   // more than 15 digits
+        "2024-03-05T14:00:07.5,1,2,ALERT",              // short milliseconds
+        "2024-03-05T14:00:08Z,1,2,ALERT",               // zone suffix
+        "2024-03-05T14:00:09,1,2,ALERT\r",              // CRLF
+        "2024-03-05T14:00:60,1,2,ALERT",
+        "2024-02-30T14:00:00,1,2,ALERT",
+        "2024-03-05 14:00:00,1,2,ALERT",
+        "2024-03-05T14:00:10,1,2,FAST",
+        "2024-03-05T14:00:11,1,2",
+        "2024-03-05T14:00:12,1,2,ALERT,extra",
+        "2024-03-05T14:00:13,,2,ALERT",
+        "2024-03-05T14:00:14,abc,2,ALERT",
+        "timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state",
+        "#commit,10,0badc0de",
+        "",
+        "garbage",
+    };
+
+    QByteArray log;
+    for (const QByteArray& line : lines) {
+        log += line + '\n';
+    }
+    SpeedLogCsvScanner scanner;
+    const QVector<ScannedRow> rows = scanAll(scanner, log);
+
+    int next = 0;
+    int offset = 0;
+    int records = 0;
+    for (const QByteArray& line : lines) {
+        SpeedLogRecord expected;
+        if (SpeedLogCsvParser::parseRow(line.constData(), line.size(), &expected)) {
+            QVERIFY2(next < rows.size(), line.constData());
+            QCOMPARE(rows[next].offset, qint64(offset));
+            QVERIFY2(sameRecord(rows[next].record, expected), line.constData());
+            ++next;
+            ++records;
+        }
+        offset += line.size() + 1;
+    }
+    QCOMPARE(rows.size(), next);
+    QCOMPARE(scanner.stats().records, quint64(records));
+    QCOMPARE(scanner.stats().ignored, quint64(3));
+    QCOMPARE(scanner.stats().malformed, quint64(lines.size() - 3 - records));
+}
+
+void TestSpeedLogCsvScanner::testRowOffsets() {
+    const QByteArray log = makeLog(100, true, 3);
+    SpeedLogCsvScanner scanner;
+    const QVector<ScannedRow> rows = scanAll(scanner, log);
+    QCOMPARE(rows.size(), 100);
+
+    qint64 offset = std::strlen(SpeedLogCsvFormatter::HEADER);
+    for (const ScannedRow& row : rows) {
+        QCOMPARE(row.offset, offset);
+        QCOMPARE(log.at(static_cast<int>(row.end - 1)), '\n');
+        offset = row.end;
+    }
+    QCOMPARE(offset, qint64(log.size()));
+}
+
+void TestSpeedLogCsvScanner::testIncompleteLastRow() {
+    QByteArray log = makeLog(10, true, 5);
+    const int complete = log.size();
+    log += "2024-03-05T14:00:59.900,12.5";
+
+    SpeedLogCsvScanner scanner;
+    qint64 consumed = 0;
+    QCOMPARE(scanAll(scanner, log, &consumed).size(), 10);
+    QCOMPARE(consumed, qint64(complete));
+    QCOMPARE(scanner.stats().malformed, quint64(0));
+
+    // The rest of the row arrives later
+    log += ",12,NORMAL\n";
+    const QByteArray tail = log.mid(complete);
+    const QVector<ScannedRow> rows = scanAll(scanner, tail, &consumed);
+    QCOMPARE(rows.size(), 1);
+    QCOMPARE(consumed, qint64(tail.size()));
+    QCOMPARE(rows[0].record.raw_speed, 12.5);
+    QCOMPARE(rows[0].record.state, quint8(1));
+}
+
+void TestSpeedLogCsvScanner::testRowsAcrossWindows() {
+    const QByteArray log = makeLog(20000, true, 11);
+    QVERIFY(log.size() > 10 * SpeedLogCsvScanner::WINDOW_BYTES);
+
+    SpeedLogCsvScanner scanner;
+    qint64 consumed = 0;
+    const QVector<ScannedRow> rows = scanAll(scanner, log, &consumed);
+    QCOMPARE(rows.size(), 20000);
+    QCOMPARE(consumed, qint64(log.size()));
+    QCOMPARE(scanner.stats().malformed, quint64(0));
+    for (int i = 0; i < rows.size(); ++i) {
+        QCOMPARE(rows[i].record.wall_ms, start_ms_ + i * 100);
+    }
+}
+
+void TestSpeedLogCsvScanner::testOverlongRow() {
+    QByteArray log(SpeedLogCsvScanner::WINDOW_BYTES + 100, 'x');
+    log += '\n';
+    log += makeLog(50, true, 13);
+
+    SpeedLogCsvScanner scanner;
+    qint64 consumed = 0;
+    QCOMPARE(scanAll(scanner, log, &consumed).size(), 50);
+    QCOMPARE(consumed, qint64(log.size()));
+    QCOMPARE(scanner.stats().malformed, quint64(1));
+}
+
+void TestSpeedLogCsvScanner::testScalarMatchesSimd() {
+    if (!SpeedLogCsvScanner::hasAvx2()) {
+        QSKIP("No AVX2 on this CPU");
+    }
+    // Odd lengths put rows and the window end at every alignment
+    QByteArray log = makeLog(3000, true, 17);
+    log += "2024-03-05T15:00:00,1e3,2,ALERT\nbroken,row\n";
+
+    SpeedLogCsvScanner simd(true);
+    SpeedLogCsvScanner scalar(false);
+    QVERIFY(simd.usesAvx2());
+    QVERIFY(!scalar.usesAvx2());
+    for (int trim = 0; trim < 70; trim += 3) {
+        const QByteArray data = log.mid(trim);
+        qint64 simd_consumed = 0;
+        qint64 scalar_consumed = 0;
+        const QVector<ScannedRow> simd_rows = scanAll(simd, data, &simd_consumed);
+        const QVector<ScannedRow> scalar_rows = scanAll(scalar, data, &scalar_consumed);
+        QCOMPARE(simd_consumed, scalar_consumed);
+        QCOMPARE(simd_rows.size(), scalar_rows.size());
+        for (int i = 0; i < simd_rows.size(); ++i) {
+            QCOMPARE(simd_rows[i].offset, scalar_rows[i].offset);
+            QVERIFY(sameRecord(simd_rows[i].record, scalar_rows[i].record));
+        }
+    }
+    QCOMPARE(simd.stats().malformed, scalar.stats().malformed);
+}
+
+QTEST_MAIN(TestSpeedLogCsvScanner)
+#include "test_speed_log_csv_scanner.moc"
@@ -0,0 +1,305 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "columnar_log.h"
+#include "log_time_index.h"
+#include "speed_log_query.h"
+
+/**
+ * @brief Unit tests for LogTimeIndex and SpeedLogQuery
+ */
+class TestSpeedLogQuery : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testCsvParserRoundTrip();
+    void testIndexBuckets();
+    void testAggregateFromIndexOnly();
+    void testAggregatePartialBuckets();
+    void testRecordsSeekToRange();
+    void testBuildsMissingIndex();
+    void testReadsUnindexedTail();
+    void testClampsIndexOfTruncatedLog();
+    void testColumnarLog();
+    void testAcrossFiles();
+
+private:
+    static QVector<SpeedLogRecord> makeRecords(qint64 start_ms, int count);
+    static SpeedAggregate bruteForce(const QVector<SpeedLogRecord>& records, qint64 from_ms, qint64 to_ms);
+    static void compareAggregates(const SpeedAggregate& actual, const SpeedAggregate& expected);
+
+    /**
+     * @brief Write a CSV log with millisecond timestamps
+     * @param indexed_records Records covered by the sidecar, -1 for all, 0 for no sidecar
+     */
+    QString writeCsvLog(const QString& name, const QVector<SpeedLogRecord>& records,
+                        int indexed_records = -1);
+
+    QTemporaryDir* temp_dir_;
+    qint64 start_ms_;
+};
+
+void TestSpeedLogQuery::init() {
+    temp_dir_ = new QTemporaryDir();
+    QVERIFY(temp_dir_->isValid());
+    start_ms_ = QDateTime(QDate(2024, 3, 5), QTime(14, 0)).toMSecsSinceEpoch();
+}
+
+void TestSpeedLogQuery::cleanup() {
+    delete temp_dir_;
+    temp_dir_ = nullptr;
+}
+
+QVector<SpeedLogRecord> TestSpeedLogQuery::makeRecords(qint64 start_ms, int count) {
+    // 10 Hz; speeds on exact binary fractions so CSV text round-trips
+    QVector<SpeedLogRecord> records;
+    for (int i = 0; i < count; ++i) {
+        SpeedLogRecord record;
+        record.wall_ms = start_ms + i * 100;
+        record.raw_speed = 40.0 + (i % 50) * 0.5;
+        record.smoothed_speed = 40.0 + (i % 40) * 0.25;
+        record.state = static_cast<quint8>((i / 100) % 5);
+        records.append(record);
+    }
+    return records;
+}
+
+SpeedAggregate TestSpeedLogQuery::bruteForce(const QVector<SpeedLogRecord>& records, qint64 from_ms,
+                                             qint64 to_ms) {
+    SpeedAggregate aggregate;
+    for (const SpeedLogRecord& record : records) {
+        if (record.wall_ms >= from_ms && record.wall_ms < to_ms) {
+            aggregate.add(record);
+        }
+    }
+    return aggregate;
+}
+
+void TestSpeedLogQuery::compareAggregates(const SpeedAggregate& actual, const SpeedAggregate& expected) {
+    QCOMPARE(actual.count, expected.count);
+    QCOMPARE(actual.first_ms, expected.first_ms);
+    QCOMPARE(actual.last_ms, expected.last_ms);
+    QCOMPARE(actual.min_raw, expected.min_raw);
+    QCOMPARE(actual.max_raw, expected.max_raw);
+    QCOMPARE(actual.min_smoothed, expected.min_smoothed);
+    QCOMPARE(actual.max_smoothed, expected.max_smoothed);
+    QCOMPARE(actual.sum_raw, expected.sum_raw);
+    QCOMPARE(actual.sum_smoothed, expected.sum_smoothed);
+    QVERIFY(actual.state_counts == expected.state_counts);
+}
+
+QString TestSpeedLogQuery::writeCsvLog(const QString& name, const QVector<SpeedLogRecord>& records,
+                                       int indexed_records) {
+    const QString path = temp_dir_->filePath(name);
+    if (indexed_records < 0) {
+        indexed_records = records.size();
+    }
+
+    QByteArray data(SpeedLogCsvFormatter::HEADER);
+    SpeedLogCsvFormatter formatter(true);
+    LogTimeIndexWriter index(LogTimeIndex::DEFAULT_BUCKET_MS);
+    if (indexed_records > 0 && !index.open(LogTimeIndex::indexPath(path))) {
+        return QString();
+    }
+    for (int i = 0; i < records.size(); ++i) {
+        const qint64 offset = data.size();
+        formatter.appendRow(data, records[i]);
+        if (i < indexed_records) {
+            index.add(records[i], offset, data.size());
+        }
+    }
+    index.close();
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return QString();
+    }
+    file.write(data);
+    return path;
+}
+
+void TestSpeedLogQuery::testCsvParserRoundTrip() {
+    SpeedLogRecord record;
+    record.wall_ms = start_ms_ + 123;
+    record.raw_speed = 87.5;
+    record.smoothed_speed = 86.25;
+    record.state = 3;
+
+    QByteArray row;
+    SpeedLogCsvFormatter(true).appendRow(row, record);
+    SpeedLogRecord parsed;
+    QVERIFY(SpeedLogCsvParser::parseRow(row.constData(), row.size() - 1, &parsed));
+    QCOMPARE(parsed.wall_ms, record.wall_ms);
+    QCOMPARE(parsed.raw_speed, record.raw_speed);
+    QCOMPARE(parsed.smoothed_speed, record.smoothed_speed);
+    QCOMPARE(parsed.state, record.state);
+
+    const QByteArray header(SpeedLogCsvFormatter::HEADER);
+    QVERIFY(!SpeedLogCsvParser::parseRow(header.constData(), header.size() - 1, &parsed));
+    QVERIFY(!SpeedLogCsvParser::parseRow("#commit,10,0badc0de", 19, &parsed));
+    QVERIFY(!SpeedLogCsvParser::parseRow("2024-03-05T14:00:00,1,2,FAST", 28, &parsed));
+    QCOMPARE(SpeedLogCsvParser::stateFromName("SCARED", 6), 4);
+}
+
+void TestSpeedLogQuery::testIndexBuckets() {
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 600);   // one minute
+    const QString path = writeCsvLog("speed_log_20240305_140000.csv", records);
+
+    LogTimeIndex index;
+    QVERIFY(index.load(LogTimeIndex::indexPath(path)));
+    QCOMPARE(index.bucketMs(), LogTimeIndex::DEFAULT_BUCKET_MS);
+    QCOMPARE(index.buckets().size(), 6);
+    QCOMPARE(index.buckets().first().offset, qint64(qstrlen(SpeedLogCsvFormatter::HEADER)));
+    for (int i = 1; i < index.buckets().size(); ++i) {
+        QCOMPARE(index.buckets()[i].offset, index.buckets()[i - 1].end_offset);
+        QCOMPARE(index.buckets()[i].stats.count, quint64(100));
+    }
+    QCOMPARE(index.indexedBytes(), QFileInfo(path).size());
+    compareAggregates(index.buckets()[2].stats,
+                      bruteForce(records, start_ms_ + 20000, start_ms_ + 30000));
+}
+
+void TestSpeedLogQuery::testAggregateFromIndexOnly() {
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 600);
+    writeCsvLog("speed_log_20240305_140000.csv", records);
+
+    SpeedLogQuery query(temp_dir_->path());
+    const qint64 from = start_ms_ + 10000;
+    const qint64 to = start_ms_ + 40000;
+    const SpeedAggregate result = query.aggregate(from, to);
+
+    compareAggregates(result, bruteForce(records, from, to));
+    QCOMPARE(query.lastStats().index_buckets, 3);
+    QCOMPARE(query.lastStats().rows_read, quint64(0));
+    QCOMPARE(query.lastStats().files, 1);
+}
+
+void TestSpeedLogQuery::testAggregatePartialBuckets() {
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 600);
+    writeCsvLog("speed_log_20240305_140000.csv", records);
+
+    SpeedLogQuery query(temp_dir_->path());
+    const qint64 from = start_ms_ + 15050;
+    const qint64 to = start_ms_ + 42300;
+    const SpeedAggregate result = query.aggregate(from, to);
+
+    compareAggregates(result, bruteForce(records, from, to));
+    QCOMPARE(query.lastStats().index_buckets, 2);
+    QCOMPARE(query.lastStats().rows_read, quint64(200));   // the two edge buckets only
+    QCOMPARE(result.maxRawKmh(), 64.5);
+}
+
+void TestSpeedLogQuery::testRecordsSeekToRange() {
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 600);
+    writeCsvLog("speed_log_20240305_140000.csv", records);
+
+    SpeedLogQuery query(temp_dir_->path());
+    const QVector<SpeedLogRecord> result = query.records(start_ms_ + 25000, start_ms_ + 35000);
+    QCOMPARE(result.size(), 100);
+    QCOMPARE(result.first().wall_ms, start_ms_ + 25000);
+    QCOMPARE(result.last().wall_ms, start_ms_ + 34900);
+    QCOMPARE(query.lastStats().rows_read, quint64(200));
+}
+
+void TestSpeedLogQuery::testBuildsMissingIndex() {
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 300);
+    const QString path = writeCsvLog("speed_log_20240305_140000.csv", records, 0);
+    QVERIFY(!QFile::exists(LogTimeIndex::indexPath(path)));
+
+    SpeedLogQuery query(temp_dir_->path());
+    query.setBuildMissingIndexes(false);
+    compareAggregates(query.aggregate(start_ms_, start_ms_ + 30000),
+                      bruteForce(records, start_ms_, start_ms_ + 30000));
+    QCOMPARE(query.lastStats().rows_read, quint64(300));
+    QVERIFY(!QFile::exists(LogTimeIndex::indexPath(path)));
+
+    query.setBuildMissingIndexes(true);
+    query.aggregate(start_ms_, start_ms_ + 30000);
+    QCOMPARE(query.lastStats().indexes_built, 1);
+    QVERIFY(QFile::exists(LogTimeIndex::indexPath(path)));
+
+    const SpeedAggregate result = query.aggregate(start_ms_, start_ms_ + 30000);
+    compareAggregates(result, bruteForce(records, start_ms_, start_ms_ + 30000));
+    QCOMPARE(query.lastStats().indexes_built, 0);
+    QCOMPARE(query.lastStats().rows_read, quint64(0));
+}
+
+void TestSpeedLogQuery::testReadsUnindexedTail() {
+    // Rows appended after the index was written, like an active log
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 400);
+    const QString path = writeCsvLog("speed_log_20240305_140000.csv", records, 250);
+
+    LogTimeIndex index;
+    QVERIFY(index.load(LogTimeIndex::indexPath(path)));
+    QCOMPARE(index.buckets().size(), 3);
+
+    SpeedLogQuery query(temp_dir_->path());
+    const SpeedAggregate result = query.aggregate(start_ms_, start_ms_ + 3600000);
+    compareAggregates(result, bruteForce(records, start_ms_, start_ms_ + 3600000));
+    QCOMPARE(query.lastStats().index_buckets, 3);
+    QCOMPARE(query.lastStats().rows_read, quint64(150));
+}
+
+void TestSpeedLogQuery::testClampsIndexOfTruncatedLog() {
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 300);
+    const QString path = writeCsvLog("speed_log_20240305_140000.csv", records);
+
+    // Recovery cut the log inside the last bucket
+    LogTimeIndex index;
+    QVERIFY(index.load(LogTimeIndex::indexPath(path)));
+    QFile file(path);
+    QVERIFY(file.resize(index.buckets()[2].offset + 100));
+
+    SpeedLogQuery query(temp_dir_->path());
+    const SpeedAggregate result = query.aggregate(start_ms_, start_ms_ + 30000);
+    QCOMPARE(query.lastStats().index_buckets, 2);
+    QVERIFY(result.count > 200 && result.count < 300);
+}
+
+void TestSpeedLogQuery::testColumnarLog() {
+    const QVector<SpeedLogRecord> records = makeRecords(start_ms_, 1000);
+    const QString path = temp_dir_->filePath(
+        QString("speed_log_20240305_140000.%1").arg(ColumnarLog::FILE_SUFFIX));
+    {
+        ColumnarLogWriter writer(256);
+        QVERIFY(writer.open(path));
+        for (const SpeedLogRecord& record : records) {
+            QVERIFY(writer.append(record));
+        }
+    }
+
+    SpeedLogQuery query(temp_dir_->path());
+    const qint64 from = start_ms_ + 12345;
+    const qint64 to = start_ms_ + 77777;
+    compareAggregates(query.aggregate(from, to), bruteForce(records, from, to));
+    QCOMPARE(query.lastStats().indexes_built, 1);
+    QCOMPARE(query.lastStats().index_buckets, 5);
+
+    const QVector<SpeedLogRecord> rows = query.records(from, to);
+    QCOMPARE(rows.size(), static_cast<int>(bruteForce(records, from, to).count));
+    QCOMPARE(rows.first().wall_ms, start_ms_ + 12400);
+}
+
+void TestSpeedLogQuery::testAcrossFiles() {
+    const QVector<SpeedLogRecord> first = makeRecords(start_ms_, 300);
+    const QVector<SpeedLogRecord> second = makeRecords(start_ms_ + 30000, 300);
+    writeCsvLog("speed_log_20240305_140000.csv", first);
+    writeCsvLog("speed_log_20240305_140030.csv", second);
+    writeCsvLog("speed_log_20240305_150000.csv", makeRecords(start_ms_ + 3600000, 100));
+
+    SpeedLogQuery query(temp_dir_->path());
+    QCOMPARE(query.logFiles().size(), 3);
+
+    const qint64 from = start_ms_ + 20000;
+    const qint64 to = start_ms_ + 40000;
+    const SpeedAggregate result = query.aggregate(from, to);
+    compareAggregates(result, bruteForce(first + second, from, to));
+    QCOMPARE(query.lastStats().files, 2);
+    QCOMPARE(query.lastStats().rows_read, quint64(0));
+}
+
+QTEST_MAIN(TestSpeedLogQuery)
+#include "test_speed_log_query.moc"
@@ -0,0 +1,202 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include "speed_monitor.h"
+
+/**
+ * @brief Unit tests for SpeedMonitor
+ */
+class TestSpeedMonitor : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testMovingAverage();
+    void testShrinkWindow();
+    void testAbnormalSpeedIgnored();
+    void testReset();
+    void testRunningSumPrecision();
+    void testFilterSelection();
+    void testBurstIsTimeWeighted();
+    void testHorizonDropsOldSamples();
+    void testGapStatistics();
+
+private:
+    SpeedMonitor* monitor_;
+};
+
+void TestSpeedMonitor::initTestCase() {
+    qInfo() << "Starting SpeedMonitor tests";
+}
+
+void TestSpeedMonitor::cleanupTestCase() {
+    qInfo() << "SpeedMonitor tests completed";
+}
+
+void TestSpeedMonitor::init() {
+    monitor_ = new SpeedMonitor(3);
+}
+
+void TestSpeedMonitor::cleanup() {
+    delete monitor_;
+    monitor_ = nullptr;
+}
+
+void TestSpeedMonitor::testMovingAverage() {
+    QSignalSpy spy(monitor_, &SpeedMonitor::smoothedSpeedUpdated);
+
+    monitor_->onRawSpeedUpdate(10.0);
+    QCOMPARE(monitor_->smoothedSpeed(), 10.0);
+    monitor_->onRawSpeedUpdate(20.0);
+    QCOMPARE(monitor_->smoothedSpeed(), 15.0);
+    monitor_->onRawSpeedUpdate(30.0);
+    QCOMPARE(monitor_->smoothedSpeed(), 20.0);
+
+    // Window full: 10 drops out
+    monitor_->onRawSpeedUpdate(40.0);
+    QCOMPARE(monitor_->smoothedSpeed(), 30.0);
+    QCOMPARE(spy.count(), 4);
+}
+
+void TestSpeedMonitor::testShrinkWindow() {
+    monitor_->setWindowSize(5);
+    for (double speed : {10.0, 20.0, 30.0, 40.0, 50.0}) {
+        monitor_->onRawSpeedUpdate(speed);
+    }
+
+    // Shrinking keeps the newest samples
+    monitor_->setWindowSize(2);
+    monitor_->onRawSpeedUpdate(60.0);
+    QCOMPARE(monitor_->smoothedSpeed(), 55.0);
+
+    // Out-of-range sizes are rejected
+    monitor_->setWindowSize(0);
+    monitor_->setWindowSize(SpeedMonitor::MAX_WINDOW_SIZE + 1);
+    QCOMPARE(monitor_->windowSize(), 2);
+}
+
+void TestSpeedMonitor::testAbnormalSpeedIgnored() {
+    QSignalSpy abnormalSpy(monitor_, &SpeedMonitor::abnormalSpeedDetected);
+
+    monitor_->onRawSpeedUpdate(50.0);
+    monitor_->onRawSpeedUpdate(-1.0);
+    monitor_->onRawSpeedUpdate(301.0);
+
+    QCOMPARE(abnormalSpy.count(), 2);
+    QCOMPARE(monitor_->smoothedSpeed(), 50.0);
+}
+
+void TestSpeedMonitor::testReset() {
+    monitor_->onRawSpeedUpdate(100.0);
+    monitor_->reset();
+    QCOMPARE(monitor_->smoothedSpeed(), 0.0);
+
+    monitor_->onRawSpeedUpdate(10.0);
+    QCOMPARE(monitor_->smoothedSpeed(), 10.0);
+}
+
+void TestSpeedMonitor::testRunningSumPrecision() {
+    RunningWindow<SpeedMonitor::MAX_WINDOW_SIZE> window(7);
+
+    // Large values followed by small ones would leave residue in a naive running sum
+    for (int i = 0; i < 100000; ++i) {
+        window.push(i % 2 == 0 ? 299.99 : 0.01);
+    }
+    for (int i = 0; i < 7; ++i) {
+        window.push(0.1);
+    }
+
+    QCOMPARE(window.size(), std::size_t(7));
+    QVERIFY(qAbs(window.mean() - 0.1) < 1e-12);
+}
+
+void TestSpeedMonitor::testFilterSelection() {
+    QCOMPARE(monitor_->filterName(), QString("moving_average"));
+
+    monitor_->onRawSpeedUpdate(10.0);
+    monitor_->setFilter(MedianFilter());
+    QCOMPARE(monitor_->filterName(), QString("median"));
+
+    // New policy starts fresh and uses the monitor's window size (3)
+    for (double speed : {20.0, 200.0, 30.0, 40.0}) {
+        monitor_->onRawSpeedUpdate(speed);
+    }
+    QCOMPARE(monitor_->smoothedSpeed(), 40.0);
+
+    monitor_->setFilter(KalmanFilter());
+    monitor_->onRawSpeedUpdate(55.0);
+    QCOMPARE(monitor_->smoothedSpeed(), 55.0);
+}
+
+void TestSpeedMonitor::testBurstIsTimeWeighted() {
+    const qint64 ms = 1000000;
+    monitor_->setWindowSize(10);
+
+    // Half a second at 50 km/h, 10 Hz
+    for (int i = 0; i < 5; ++i) {
+        monitor_->onSpeedSample(50.0, (i + 1) * 100 * ms);
+    }
+
+    // Five frames at 100 km/h delivered within 4 ms after the next tick
+    for (int i = 0; i < 5; ++i) {
+        monitor_->onSpeedSample(100.0, 600 * ms + i * ms);
+    }
+
+    // Equal weights would give 75; the burst only counts for ~104 ms
+    const double expected = (50.0 * 0.5 + 100.0 * 0.104) / 0.604;
+    QVERIFY(qAbs(monitor_->smoothedSpeed() - expected) < 0.01);
+}
+
+void TestSpeedMonitor::testHorizonDropsOldSamples() {
+    const qint64 ms = 1000000;
+    monitor_->setWindowSize(10);
+    monitor_->setHorizonMs(1000);
+    QCOMPARE(monitor_->horizonMs(), 1000);
+
+    monitor_->onSpeedSample(20.0, 100 * ms);
+    monitor_->onSpeedSample(20.0, 200 * ms);
+    monitor_->onSpeedSample(80.0, 1700 * ms);
+    QCOMPARE(monitor_->smoothedSpeed(), 80.0);
+
+    // Within the horizon samples are still averaged
+    monitor_->onSpeedSample(60.0, 1800 * ms);
+    QCOMPARE(monitor_->smoothedSpeed(), 70.0);
+
+    // Negative horizons are rejected
+    monitor_->setHorizonMs(-1);
+    QCOMPARE(monitor_->horizonMs(), 1000);
+}
+
+void TestSpeedMonitor::testGapStatistics() {
+    const qint64 ms = 1000000;
+    QSignalSpy stallSpy(monitor_, &SpeedMonitor::transportStallDetected);
+
+    monitor_->onSpeedSample(10.0, 100 * ms);
+    monitor_->onSpeedSample(10.0, 200 * ms);
+    monitor_->onSpeedSample(10.0, 300 * ms);
+    monitor_->onSpeedSample(10.0, 300 * ms + ms / 2);   // burst
+    monitor_->onSpeedSample(10.0, 1100 * ms);           // stall
+    monitor_->onSpeedSample(10.0, 1000 * ms);           // out of order
+
+    const auto gaps = monitor_->gapStatistics();
+    QCOMPARE(gaps.intervals, quint64(4));
+    QCOMPARE(gaps.burst_samples, quint64(1));
+    QCOMPARE(gaps.stalls, quint64(1));
+    QCOMPARE(gaps.out_of_order, quint64(1));
+    QCOMPARE(gaps.max_gap_ms, 799.5);
+    QCOMPARE(gaps.mean_gap_ms, 250.0);
+    QCOMPARE(stallSpy.count(), 1);
+    QCOMPARE(stallSpy.takeFirst().at(0).toDouble(), 799.5);
+
+    QCOMPARE(monitor_->gapSummary()["stalls"].toULongLong(), quint64(1));
+
+    monitor_->reset();
+    QCOMPARE(monitor_->gapStatistics().intervals, quint64(0));
+}
+
+QTEST_MAIN(TestSpeedMonitor)
+#include "test_speed_monitor.moc"
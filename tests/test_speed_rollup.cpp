@@ -0,0 +1,315 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "speed_rollup.h"
+
+/**
+ * @brief Unit tests for SpeedRollup
+ */
+class TestSpeedRollup : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    // Test cases
+    void testSecondBuckets();
+    void testDwellTimeSplitAtBoundary();
+    void testLongGapNotCounted();
+    void testGapSpansEmptyBucket();
+    void testTiersAgree();
+    void testRingCapacity();
+    void testRecentAndRange();
+    void testPersistAndReload();
+    void testReopensSavedBucket();
+    void testIgnoresTornEntry();
+    void testCompactsFile();
+
+private:
+    static SpeedLogRecord makeRecord(qint64 wall_ms, double speed, quint8 state);
+
+    /**
+     * @brief Add count samples step_ms apart; speed = index % 100, state = (index / 50) % 5
+     * @return Time of the sample after the last one
+     */
+    static qint64 feed(SpeedRollup& rollup, qint64 start_ms, int count, qint64 step_ms);
+
+    QTemporaryDir* temp_dir_;
+    qint64 start_ms_;
+};
+
+void TestSpeedRollup::init() {
+    temp_dir_ = new QTemporaryDir();
+    QVERIFY(temp_dir_->isValid());
+    start_ms_ = QDateTime(QDate(2024, 3, 5), QTime(14, 0), Qt::UTC).toMSecsSinceEpoch();
+}
+
+void TestSpeedRollup::cleanup() {
+    delete temp_dir_;
+    temp_dir_ = nullptr;
+}
+
+SpeedLogRecord TestSpeedRollup::makeRecord(qint64 wall_ms, double speed, quint8 state) {
+    SpeedLogRecord record;
+    record.wall_ms = wall_ms;
+    record.raw_speed = speed;
+    record.smoothed_speed = speed;
+    record.state = state;
+    return record;
+}
+
+qint64 TestSpeedRollup::feed(SpeedRollup& rollup, qint64 start_ms, int count, qint64 step_ms) {
+    for (int i = 0; i < count; ++i) {
+        rollup.add(makeRecord(start_ms + i * step_ms, i % 100, static_cast<quint8>((i / 50) % 5)));
+    }
+    return start_ms + count * step_ms;
+}
+
+void TestSpeedRollup::testSecondBuckets() {
+    SpeedRollup rollup;
+    QVERIFY(rollup.current(SpeedRollup::Tier::Second) == nullptr);
+
+    // 10 Hz for 2.5 s
+    for (int i = 0; i < 25; ++i) {
+        rollup.add(makeRecord(start_ms_ + i * 100, 10.0 + i, 1));
+    }
+
+    QCOMPARE(rollup.closedCount(SpeedRollup::Tier::Second), 2);
+    QCOMPARE(rollup.closedCount(SpeedRollup::Tier::Minute), 0);
+
+    const QVector<RollupBucket> seconds = rollup.recent(SpeedRollup::Tier::Second, 10);
+    QCOMPARE(seconds.size(), 3);
+    QCOMPARE(seconds[0].start_ms, start_ms_);
+    QCOMPARE(seconds[1].start_ms, start_ms_ + 1000);
+    QCOMPARE(seconds[0].speed.count, quint64(10));
+    QCOMPARE(seconds[0].speed.minRawKmh(), 10.0);
+    QCOMPARE(seconds[0].speed.maxRawKmh(), 19.0);
+    QCOMPARE(seconds[0].speed.meanRawKmh(), 14.5);
+    QCOMPARE(seconds[2].speed.count, quint64(5));
+
+    const RollupBucket* current = rollup.current(SpeedRollup::Tier::Second);
+    QVERIFY(current != nullptr);
+    QCOMPARE(current->start_ms, start_ms_ + 2000);
+}
+
+void TestSpeedRollup::testDwellTimeSplitAtBoundary() {
+    SpeedRollup rollup;
+    rollup.add(makeRecord(start_ms_ + 600, 30.0, 0));
+    rollup.add(makeRecord(start_ms_ + 900, 30.0, 2));
+    rollup.add(makeRecord(start_ms_ + 1300, 30.0, 2));
+
+    const QVector<RollupBucket> seconds = rollup.recent(SpeedRollup::Tier::Second, 2);
+    QCOMPARE(seconds.size(), 2);
+    // 600..900 RELAXED, 900..1000 ALERT in the first second, 1000..1300 ALERT in the next
+    QCOMPARE(seconds[0].state_ms[0], qint64(300));
+    QCOMPARE(seconds[0].state_ms[2], qint64(100));
+    QCOMPARE(seconds[1].state_ms[0], qint64(0));
+    QCOMPARE(seconds[1].state_ms[2], qint64(300));
+
+    // The minute holds all of it
+    const RollupBucket* minute = rollup.current(SpeedRollup::Tier::Minute);
+    QVERIFY(minute != nullptr);
+    QCOMPARE(minute->state_ms[0], qint64(300));
+    QCOMPARE(minute->state_ms[2], qint64(400));
+    QCOMPARE(minute->speed.state_counts[2], quint64(2));
+}
+
+void TestSpeedRollup::testLongGapNotCounted() {
+    SpeedRollup rollup;
+    rollup.setMaxGapMs(1000);
+    rollup.add(makeRecord(start_ms_, 30.0, 1));
+    rollup.add(makeRecord(start_ms_ + 500, 30.0, 1));
+    rollup.add(makeRecord(start_ms_ + 10500, 30.0, 1));   // Stall
+    rollup.add(makeRecord(start_ms_ + 10600, 30.0, 1));
+
+    const RollupBucket* minute = rollup.current(SpeedRollup::Tier::Minute);
+    QVERIFY(minute != nullptr);
+    QCOMPARE(minute->state_ms[1], qint64(600));
+    QCOMPARE(minute->speed.count, quint64(4));
+}
+
+void TestSpeedRollup::testGapSpansEmptyBucket() {
+    SpeedRollup rollup;
+    rollup.add(makeRecord(start_ms_ + 900, 30.0, 1));
+    rollup.add(makeRecord(start_ms_ + 2100, 30.0, 1));   // Within the 2 s maximum gap
+
+    // The second without a sample still gets its dwell time
+    const QVector<RollupBucket> seconds = rollup.recent(SpeedRollup::Tier::Second, 3);
+    QCOMPARE(seconds.size(), 3);
+    QCOMPARE(seconds[0].state_ms[1], qint64(100));
+    QCOMPARE(seconds[1].start_ms, start_ms_ + 1000);
+    QCOMPARE(seconds[1].state_ms[1], qint64(1000));
+    QVERIFY(seconds[1].isEmpty());
+    QCOMPARE(seconds[2].state_ms[1], qint64(100));
+
+    const RollupBucket* minute = rollup.current(SpeedRollup::Tier::Minute);
+    QVERIFY(minute != nullptr);
+    QCOMPARE(minute->state_ms[1], qint64(1200));
+}
+
+void TestSpeedRollup::testTiersAgree() {
+    SpeedRollup rollup;
+    const qint64 end_ms = feed(rollup, start_ms_, 3 * 60 * 10, 100);   // 3 min at 10 Hz
+    rollup.add(makeRecord(end_ms, 0.0, 0));                         // Closes the last minute
+
+    const QVector<RollupBucket> minutes = rollup.buckets(SpeedRollup::Tier::Minute, start_ms_, end_ms);
+    QCOMPARE(minutes.size(), 3);
+    const QVector<RollupBucket> seconds = rollup.buckets(SpeedRollup::Tier::Second, start_ms_, end_ms);
+    QCOMPARE(seconds.size(), 180);
+
+    for (int m = 0; m < 3; ++m) {
+        SpeedAggregate merged;
+        std::array<qint64, SpeedAggregate::STATE_SLOTS> state_ms{};
+        for (int s = m * 60; s < (m + 1) * 60; ++s) {
+            merged.merge(seconds[s].speed);
+            for (int i = 0; i < SpeedAggregate::STATE_SLOTS; ++i) {
+                state_ms[i] += seconds[s].state_ms[i];
+            }
+        }
+        QCOMPARE(minutes[m].speed.count, merged.count);
+        QCOMPARE(minutes[m].speed.sum_raw, merged.sum_raw);
+        QCOMPARE(minutes[m].speed.min_smoothed, merged.min_smoothed);
+        QCOMPARE(minutes[m].speed.max_smoothed, merged.max_smoothed);
+        QVERIFY(minutes[m].state_ms == state_ms);
+
+        qint64 total_ms = 0;
+        for (qint64 ms : minutes[m].state_ms) {
+            total_ms += ms;
+        }
+        QCOMPARE(total_ms, qint64(60000));
+    }
+
+    const RollupBucket* hour = rollup.current(SpeedRollup::Tier::Hour);
+    QVERIFY(hour != nullptr);
+    QCOMPARE(hour->speed.count, quint64(3 * 60 * 10 + 1));
+}
+
+void TestSpeedRollup::testRingCapacity() {
+    SpeedRollup rollup;
+    const int capacity = SpeedRollup::tierCapacity(SpeedRollup::Tier::Second);
+    feed(rollup, start_ms_, capacity + 100, 1000);
+
+    QCOMPARE(rollup.closedCount(SpeedRollup::Tier::Second), capacity);
+    const QVector<RollupBucket> seconds = rollup.recent(SpeedRollup::Tier::Second, capacity + 1);
+    QCOMPARE(seconds.size(), capacity + 1);
+    QCOMPARE(seconds.first().start_ms, start_ms_ + 99 * 1000);
+    QCOMPARE(seconds.last().start_ms, start_ms_ + (capacity + 99) * 1000);
+}
+
+void TestSpeedRollup::testRecentAndRange() {
+    SpeedRollup rollup;
+    feed(rollup, start_ms_, 10 * 60, 1000);   // 10 min at 1 Hz
+
+    QCOMPARE(rollup.recent(SpeedRollup::Tier::Minute, 0).size(), 0);
+    const QVector<RollupBucket> last = rollup.recent(SpeedRollup::Tier::Minute, 3);
+    QCOMPARE(last.size(), 3);
+    QCOMPARE(last[0].start_ms, start_ms_ + 7 * 60000);
+    QCOMPARE(last[2].start_ms, start_ms_ + 9 * 60000);
+
+    const QVector<RollupBucket> range = rollup.buckets(SpeedRollup::Tier::Minute,
+                                                       start_ms_ + 2 * 60000, start_ms_ + 5 * 60000);
+    QCOMPARE(range.size(), 3);
+    QCOMPARE(range[0].start_ms, start_ms_ + 2 * 60000);
+    QCOMPARE(range[0].speed.count, quint64(60));
+}
+
+void TestSpeedRollup::testPersistAndReload() {
+    const QString dir = temp_dir_->path();
+    {
+        SpeedRollup rollup;
+        QVERIFY(rollup.open(dir));
+        feed(rollup, start_ms_, 150, 1000);   // 2.5 min at 1 Hz
+
+        // Two closed minutes have been written; the seconds went with them
+        QFileInfo minutes(SpeedRollup::tierPath(dir, SpeedRollup::Tier::Minute));
+        QCOMPARE(minutes.size(), qint64(SpeedRollup::HEADER_SIZE + 2 * SpeedRollup::ENTRY_SIZE));
+        QFileInfo seconds(SpeedRollup::tierPath(dir, SpeedRollup::Tier::Second));
+        QCOMPARE(seconds.size(), qint64(SpeedRollup::HEADER_SIZE + 120 * SpeedRollup::ENTRY_SIZE));
+    }
+
+    SpeedRollup reloaded;
+    QVERIFY(reloaded.open(dir));
+    QCOMPARE(reloaded.closedCount(SpeedRollup::Tier::Second), 150);
+    QCOMPARE(reloaded.closedCount(SpeedRollup::Tier::Minute), 3);
+    QCOMPARE(reloaded.closedCount(SpeedRollup::Tier::Hour), 1);
+    QVERIFY(reloaded.current(SpeedRollup::Tier::Minute) == nullptr);
+
+    const QVector<RollupBucket> minutes = reloaded.recent(SpeedRollup::Tier::Minute, 3);
+    QCOMPARE(minutes[0].start_ms, start_ms_);
+    QCOMPARE(minutes[0].speed.count, quint64(60));
+    QCOMPARE(minutes[2].speed.count, quint64(30));
+    QCOMPARE(minutes[1].speed.maxRawKmh(), 99.0);
+    QCOMPARE(minutes[1].state_ms[1] + minutes[1].state_ms[2], qint64(60000));
+    QCOMPARE(reloaded.recent(SpeedRollup::Tier::Hour, 1)[0].speed.count, quint64(150));
+}
+
+void TestSpeedRollup::testReopensSavedBucket() {
+    const QString dir = temp_dir_->path();
+    {
+        SpeedRollup rollup;
+        QVERIFY(rollup.open(dir));
+        feed(rollup, start_ms_, 90, 1000);
+    }
+
+    // Restart within the same minute and hour
+    SpeedRollup rollup;
+    QVERIFY(rollup.open(dir));
+    rollup.add(makeRecord(start_ms_ + 100 * 1000, 50.0, 0));
+    QCOMPARE(rollup.closedCount(SpeedRollup::Tier::Minute), 1);
+    QCOMPARE(rollup.current(SpeedRollup::Tier::Minute)->speed.count, quint64(31));
+    QCOMPARE(rollup.current(SpeedRollup::Tier::Hour)->speed.count, quint64(91));
+    rollup.close();
+
+    // The file holds the bucket twice; the later copy wins
+    SpeedRollup reloaded;
+    QVERIFY(reloaded.open(dir));
+    const QVector<RollupBucket> hours = reloaded.recent(SpeedRollup::Tier::Hour, 5);
+    QCOMPARE(hours.size(), 1);
+    QCOMPARE(hours[0].speed.count, quint64(91));
+}
+
+void TestSpeedRollup::testIgnoresTornEntry() {
+    const QString dir = temp_dir_->path();
+    const QString path = SpeedRollup::tierPath(dir, SpeedRollup::Tier::Second);
+    {
+        SpeedRollup rollup;
+        QVERIFY(rollup.open(dir));
+        feed(rollup, start_ms_, 70, 1000);
+        QVERIFY(rollup.flush());
+    }
+    const qint64 size = QFileInfo(path).size();
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::Append));
+    file.write(QByteArray(40, '\x7f'));
+    file.close();
+
+    SpeedRollup rollup;
+    QVERIFY(rollup.open(dir));
+    QCOMPARE(rollup.closedCount(SpeedRollup::Tier::Second), 70);
+    rollup.close();
+    QCOMPARE(QFileInfo(path).size(), size);
+}
+
+void TestSpeedRollup::testCompactsFile() {
+    const QString dir = temp_dir_->path();
+    const QString path = SpeedRollup::tierPath(dir, SpeedRollup::Tier::Second);
+    const int capacity = SpeedRollup::tierCapacity(SpeedRollup::Tier::Second);
+
+    SpeedRollup rollup;
+    QVERIFY(rollup.open(dir));
+    feed(rollup, start_ms_, 2 * capacity + 300, 1000);
+    QVERIFY(rollup.flush());
+
+    const qint64 max_size = SpeedRollup::HEADER_SIZE + qint64(2) * capacity * SpeedRollup::ENTRY_SIZE;
+    QVERIFY(QFileInfo(path).size() < max_size);
+    rollup.close();
+
+    SpeedRollup reloaded;
+    QVERIFY(reloaded.open(dir));
+    QCOMPARE(reloaded.closedCount(SpeedRollup::Tier::Second), capacity);
+    QCOMPARE(reloaded.recent(SpeedRollup::Tier::Second, 1)[0].start_ms,
+             start_ms_ + (2 * capacity + 299) * qint64(1000));
+}
+
+QTEST_MAIN(TestSpeedRollup)
+#include "test_speed_rollup.moc"
@@ -0,0 +1,82 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include "speed_trace.h"
+
+/**
+ * @brief Unit tests for SpeedTrace (AFB stand-in replay input)
+ */
+class TestSpeedTrace : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Test cases
+    void testLoadDataLoggerCsv();
+    void testMissingFile();
+    void testSyntheticTrace();
+
+private:
+    static QString writeFile(const QTemporaryDir& dir, const QByteArray& contents);
+};
+
+void TestSpeedTrace::initTestCase() {
+    qInfo() << "Starting SpeedTrace tests";
+}
+
+void TestSpeedTrace::cleanupTestCase() {
+    qInfo() << "SpeedTrace tests completed";
+}
+
+QString TestSpeedTrace::writeFile(const QTemporaryDir& dir, const QByteArray& contents) {
+    const QString path = dir.filePath("speed_log_test.csv");
+    QFile file(path);
+    file.open(QIODevice::WriteOnly);
+    file.write(contents);
+    return path;
+}
+
+void TestSpeedTrace::testLoadDataLoggerCsv() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = writeFile(dir,
+        "timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state\n"
+        "2024-01-01T10:00:00,10,10,RELAXED\n"
+        "2024-01-01T10:00:00,12,11,RELAXED\n"
+        "2024-01-01T10:00:00,14,12,RELAXED\n"
+        "2024-01-01T10:00:00,16,13,RELAXED\n"
+        "garbage line\n"
+        "2024-01-01T10:00:01,30,20,NORMAL\n");
+
+    SpeedTrace trace;
+    QVERIFY(trace.loadCsv(path));
+    QCOMPARE(trace.size(), 5);
+
+    // Rows within the same second are spread over that second
+    QCOMPARE(trace.points()[0].offset_ms, qint64(0));
+    QCOMPARE(trace.points()[1].offset_ms, qint64(250));
+    QCOMPARE(trace.points()[3].offset_ms, qint64(750));
+    QCOMPARE(trace.points()[3].speed, 16.0);
+    QCOMPARE(trace.points()[4].offset_ms, qint64(1000));
+    QCOMPARE(trace.points()[4].speed, 30.0);
+}
+
+void TestSpeedTrace::testMissingFile() {
+    SpeedTrace trace;
+    QVERIFY(!trace.loadCsv("/nonexistent/speed_log.csv"));
+    QVERIFY(trace.isEmpty());
+}
+
+void TestSpeedTrace::testSyntheticTrace() {
+    const SpeedTrace trace = SpeedTrace::synthetic(10000, 10);
+    QCOMPARE(trace.size(), 100);
+    QCOMPARE(trace.durationMs(), qint64(10000));
+
+    for (const TracePoint& point : trace.points()) {
+        QVERIFY(point.speed >= 0.0 && point.speed <= 121.0);
+    }
+}
+
+QTEST_MAIN(TestSpeedTrace)
+#include "test_speed_trace.moc"
@@ -1,12 +1,29 @@
 #include <QtTest/QtTest>
 #include <QSignalSpy>
 #include "vehicle_data_manager.h"
+#include "afb_event_parser.h"
+#include "afb_stand_in_server.h"
+#include "vehicle_data_source.h"
+
+/**
+ * @brief Data source driven directly by the test
+ */
+class FakeDataSource : public VehicleDataSource {
+    Q_OBJECT
+
+public:
+    bool start() override { running = true; return true; }
+    void stop() override { running = false; }
+    QString description() const override { return "fake"; }
+
+    bool running = false;
+};
 
 /**
  * @brief Unit tests for VehicleDataManager
  * 
- * Note: These tests focus on logic without requiring a real AFB server.
- * WebSocket communication is tested with signal/slot behavior.
+ * Note: Most tests focus on logic without requiring a real AFB server.
+ * The StandIn tests run against AfbStandInServer on a local port.
  */
 class TestVehicleDataManager : public QObject {
     Q_OBJECT
@@ -24,12 +41,21 @@ private slots:
     void testSpeedDataValidation();
     void testInvalidSpeedData();
     void testSignalEmission();
+    void testSignalRegistration();
+    void testSignalRegistryLookup();
+    void testStandInEventDelivery();
+    void testStandInBinaryFrames();
+    void testStandInBinaryFallback();
+    void testStandInAcceleratedReplay();
+    void testReconnectAfterServerDrop();
+    void testAlternativeDataSource();
 
 private:
     VehicleDataManager* data_manager_;
 };
 
 void TestVehicleDataManager::initTestCase() {
+    qRegisterMetaType<VehicleSample>();
     qInfo() << "Starting VehicleDataManager tests";
 }
 
@@ -106,5 +132,188 @@ void TestVehicleDataManager::testSignalEmission() {
     QVERIFY(errorSpy.isValid());
 }
 
+void TestVehicleDataManager::testSignalRegistration() {
+    // Vehicle.Speed is always registered
+    const int speed_id = data_manager_->signalId("Vehicle.Speed");
+    QVERIFY(speed_id != SignalRegistry::INVALID_ID);
+    
+    data_manager_->setSignals({"Vehicle.Speed",
+                               "Vehicle.Powertrain.CombustionEngine.Speed",
+                               "Vehicle.CurrentLocation.Latitude"});
+    
+    QCOMPARE(data_manager_->signalRegistry().size(), 3);
+    QCOMPARE(data_manager_->signalId("Vehicle.Speed"), speed_id);
+    
+    const int rpm_id = data_manager_->signalId("Vehicle.Powertrain.CombustionEngine.Speed");
+    QVERIFY(rpm_id != SignalRegistry::INVALID_ID);
+    QVERIFY(rpm_id != speed_id);
+    QCOMPARE(data_manager_->signalRegistry().path(rpm_id),
+             QString("Vehicle.Powertrain.CombustionEngine.Speed"));
+    
+    // No value received yet
+    QVERIFY(data_manager_->latestValue(rpm_id) != nullptr);
+    QVERIFY(!data_manager_->latestValue(rpm_id)->valid);
+    QVERIFY(data_manager_->latestValue(42) == nullptr);
+}
+
+void TestVehicleDataManager::testSignalRegistryLookup() {
+    SignalRegistry registry;
+    
+    // Enough signals to force several rehashes
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(registry.intern(QString("Vehicle.Test.Signal%1").arg(i)), i);
+    }
+    
+    for (int i = 0; i < 100; ++i) {
+        const QByteArray frame = QString(R"({"event":"vss/Vehicle.Test.Signal%1","data":%1})")
+            .arg(i).toUtf8();
+        AfbEvent event;
+        QCOMPARE(AfbEventParser::parse(frame.constData(), static_cast<std::size_t>(frame.size()),
+                                       event),
+                 AfbEventParser::Result::Event);
+        QCOMPARE(registry.find(event), i);
+    }
+    
+    QCOMPARE(registry.findPath("Vehicle.Test.Signal100"), SignalRegistry::INVALID_ID);
+}
+
+void TestVehicleDataManager::testStandInEventDelivery() {
+    AfbStandInServer server;
+    QVERIFY(server.listen());
+    QSignalSpy subscribedSpy(&server, &AfbStandInServer::clientSubscribed);
+    QSignalSpy speedSpy(data_manager_, &VehicleDataManager::speedUpdated);
+    
+    data_manager_->initialize(server.url().toString(), "");
+    QTRY_COMPARE_WITH_TIMEOUT(subscribedSpy.count(), 1, 5000);
+    QCOMPARE(subscribedSpy.at(0).at(0).toString(), QString("Vehicle.Speed"));
+    QCOMPARE(subscribedSpy.at(0).at(1).toBool(), false);
+    
+    server.publish("Vehicle.Speed", 42.5, 1700000000000);
+    QTRY_COMPARE_WITH_TIMEOUT(speedSpy.count(), 1, 5000);
+    QCOMPARE(speedSpy.at(0).at(0).toDouble(), 42.5);
+    QCOMPARE(data_manager_->getCurrentSpeed(), 42.5);
+    QVERIFY(data_manager_->isDataValid());
+    
+    const SignalSlot* slot = data_manager_->latestValue(data_manager_->signalId("Vehicle.Speed"));
+    QCOMPARE(slot->timestamp_ms, qint64(1700000000000));
+}
+
+void TestVehicleDataManager::testStandInBinaryFrames() {
+    AfbStandInServer server;
+    QVERIFY(server.listen());
+    QSignalSpy subscribedSpy(&server, &AfbStandInServer::clientSubscribed);
+    QSignalSpy speedSpy(data_manager_, &VehicleDataManager::speedUpdated);
+    
+    data_manager_->setPreferBinaryFrames(true);
+    data_manager_->initialize(server.url().toString(), "");
+    QTRY_COMPARE_WITH_TIMEOUT(subscribedSpy.count(), 1, 5000);
+    QCOMPARE(subscribedSpy.at(0).at(1).toBool(), true);
+    
+    server.publish("Vehicle.Speed", 88.0, 0);
+    QTRY_COMPARE_WITH_TIMEOUT(speedSpy.count(), 1, 5000);
+    QCOMPARE(speedSpy.at(0).at(0).toDouble(), 88.0);
+    QVERIFY(data_manager_->binaryFramesActive());
+}
+
+void TestVehicleDataManager::testStandInBinaryFallback() {
+    AfbStandInServer server;
+    AfbStandInServer::Options options;
+    options.binary_frames = false;
+    server.setOptions(options);
+    QVERIFY(server.listen());
+    QSignalSpy subscribedSpy(&server, &AfbStandInServer::clientSubscribed);
+    QSignalSpy speedSpy(data_manager_, &VehicleDataManager::speedUpdated);
+    
+    // CBOR request is rejected, manager resubscribes for JSON text frames
+    data_manager_->setPreferBinaryFrames(true);
+    data_manager_->initialize(server.url().toString(), "");
+    QTRY_COMPARE_WITH_TIMEOUT(subscribedSpy.count(), 1, 5000);
+    QCOMPARE(subscribedSpy.at(0).at(1).toBool(), false);
+    QVERIFY(!data_manager_->binaryFramesActive());
+    
+    server.publish("Vehicle.Speed", 30.0, 0);
+    QTRY_COMPARE_WITH_TIMEOUT(speedSpy.count(), 1, 5000);
+}
+
+void TestVehicleDataManager::testStandInAcceleratedReplay() {
+    AfbStandInServer server;
+    AfbStandInServer::Options options;
+    options.speed_factor = 1000.0;
+    options.burst_size = 8;
+    options.jitter_ms = 2;
+    options.loop = false;
+    server.setOptions(options);
+    
+    // 60 s at 10 Hz replays in about 60 ms
+    const SpeedTrace trace = SpeedTrace::synthetic(60000, 10);
+    server.setTrace(trace);
+    QVERIFY(server.listen());
+    
+    QSignalSpy subscribedSpy(&server, &AfbStandInServer::clientSubscribed);
+    QSignalSpy finishedSpy(&server, &AfbStandInServer::replayFinished);
+    QSignalSpy speedSpy(data_manager_, &VehicleDataManager::speedUpdated);
+    
+    data_manager_->initialize(server.url().toString(), "");
+    QTRY_COMPARE_WITH_TIMEOUT(subscribedSpy.count(), 1, 5000);
+    
+    server.startReplay();
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 5000);
+    QCOMPARE(server.eventsSent(), quint64(trace.size()));
+    
+    // Every event arrives, in trace order
+    QTRY_COMPARE_WITH_TIMEOUT(speedSpy.count(), trace.size(), 5000);
+    for (int i = 0; i < trace.size(); ++i) {
+        QCOMPARE(speedSpy.at(i).at(0).toDouble(), trace.points()[i].speed);
+    }
+}
+
+void TestVehicleDataManager::testReconnectAfterServerDrop() {
+    AfbStandInServer server;
+    QVERIFY(server.listen());
+    QSignalSpy subscribedSpy(&server, &AfbStandInServer::clientSubscribed);
+    QSignalSpy connectedSpy(data_manager_, &VehicleDataManager::connectionEstablished);
+    QSignalSpy lostSpy(data_manager_, &VehicleDataManager::connectionLost);
+    
+    data_manager_->initialize(server.url().toString(), "");
+    QTRY_COMPARE_WITH_TIMEOUT(subscribedSpy.count(), 1, 5000);
+    
+    server.disconnectClients();
+    QTRY_COMPARE_WITH_TIMEOUT(lostSpy.count(), 1, 5000);
+    QVERIFY(!data_manager_->isDataValid());
+    
+    // First retry fires after 1 s and resubscribes on its own
+    QTRY_COMPARE_WITH_TIMEOUT(connectedSpy.count(), 2, 5000);
+    QTRY_COMPARE_WITH_TIMEOUT(subscribedSpy.count(), 2, 5000);
+    QCOMPARE(server.disconnectsInjected(), quint64(1));
+}
+
+void TestVehicleDataManager::testAlternativeDataSource() {
+    auto* source = new FakeDataSource();
+    data_manager_->setDataSource(source);
+    QCOMPARE(data_manager_->dataSource(), source);
+    QCOMPARE(source->parent(), data_manager_);
+    
+    QSignalSpy connectedSpy(data_manager_, &VehicleDataManager::connectionEstablished);
+    QSignalSpy speedSpy(data_manager_, &VehicleDataManager::speedUpdated);
+    QSignalSpy sampleSpy(data_manager_, &VehicleDataManager::sampleReceived);
+    
+    QVERIFY(data_manager_->initialize(QString(), QString()));
+    QVERIFY(source->running);
+    QCOMPARE(connectedSpy.count(), 1);
+    
+    // Decoded values take the same validation and delivery path as AFB events
+    emit source->speedDecoded(55.5, 1000, 1700000000000);
+    emit source->speedDecoded(500.0, 2000, 0);
+    QCOMPARE(speedSpy.count(), 1);
+    QCOMPARE(speedSpy.at(0).at(0).toDouble(), 55.5);
+    QCOMPARE(sampleSpy.at(0).at(0).value<VehicleSample>().received_ns, qint64(1000));
+    
+    const SignalSlot* slot = data_manager_->latestValue(data_manager_->signalId("Vehicle.Speed"));
+    QCOMPARE(slot->timestamp_ms, qint64(1700000000000));
+    
+    data_manager_->shutdown();
+    QVERIFY(!source->running);
+}
+
 QTEST_MAIN(TestVehicleDataManager)
 #include "test_vehicle_data_manager.moc"
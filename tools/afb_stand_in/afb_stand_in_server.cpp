@@ -0,0 +1,303 @@
+#include "afb_stand_in_server.h"
+#include <QCborMap>
+#include <QCborValue>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QWebSocket>
+#include <QWebSocketServer>
+#include <QDebug>
+
+namespace {
+
+QString replyFrame(const QString& status, const QString& response) {
+    QJsonObject request;
+    request["status"] = status;
+    
+    QJsonObject reply;
+    reply["jtype"] = "afb-reply";
+    reply["request"] = request;
+    if (!response.isEmpty()) {
+        reply["response"] = response;
+    }
+    return QString::fromUtf8(QJsonDocument(reply).toJson(QJsonDocument::Compact));
+}
+
+}  // namespace
+
+AfbStandInServer::AfbStandInServer(QObject* parent)
+    : QObject(parent)
+    , server_(new QWebSocketServer("carspeedboy-afb-stand-in",
+                                   QWebSocketServer::NonSecureMode, this))
+{
+    replay_timer_.setTimerType(Qt::PreciseTimer);
+    replay_timer_.setInterval(1);
+    
+    connect(server_, &QWebSocketServer::newConnection,
+            this, &AfbStandInServer::onNewConnection);
+    connect(&replay_timer_, &QTimer::timeout,
+            this, &AfbStandInServer::onReplayTick);
+}
+
+AfbStandInServer::~AfbStandInServer() {
+    close();
+}
+
+bool AfbStandInServer::listen(const QHostAddress& address, quint16 port) {
+    if (!server_->listen(address, port)) {
+        qWarning() << "Stand-in cannot listen on port" << port << ":" << server_->errorString();
+        return false;
+    }
+    qInfo() << "AFB stand-in listening on" << url().toString();
+    return true;
+}
+
+void AfbStandInServer::close() {
+    stopReplay();
+    
+    const auto sockets = clients_.keys();
+    clients_.clear();
+    for (QWebSocket* socket : sockets) {
+        socket->disconnect(this);
+        socket->abort();
+        socket->deleteLater();
+    }
+    server_->close();
+}
+
+quint16 AfbStandInServer::port() const {
+    return server_->serverPort();
+}
+
+QUrl AfbStandInServer::url() const {
+    QUrl result;
+    result.setScheme("ws");
+    result.setHost(server_->serverAddress().toString());
+    result.setPort(server_->serverPort());
+    result.setPath("/api");
+    return result;
+}
+
+void AfbStandInServer::setOptions(const Options& options) {
+    options_ = options;
+    options_.speed_factor = qBound(MIN_SPEED_FACTOR, options.speed_factor, MAX_SPEED_FACTOR);
+    options_.jitter_ms = qMax(0, options.jitter_ms);
+    options_.burst_size = qMax(1, options.burst_size);
+    options_.disconnect_every = qMax(0, options.disconnect_every);
+    random_.seed(options_.seed);
+}
+
+void AfbStandInServer::setTrace(const SpeedTrace& trace) {
+    trace_ = trace;
+}
+
+void AfbStandInServer::startReplay() {
+    if (trace_.isEmpty()) {
+        qWarning() << "Stand-in has no trace to replay";
+        return;
+    }
+    
+    cursor_ = 0;
+    loop_offset_ms_ = 0;
+    next_due_ms_ = 0;
+    burst_.clear();
+    replay_epoch_ms_ = QDateTime::currentMSecsSinceEpoch();
+    replay_clock_.start();
+    scheduleNextEvent();
+    replay_timer_.start();
+    
+    qInfo() << "Replaying" << trace_.size() << "samples at" << options_.speed_factor << "x";
+}
+
+void AfbStandInServer::stopReplay() {
+    replay_timer_.stop();
+    burst_.clear();
+}
+
+void AfbStandInServer::publish(const QString& path, double value, qint64 timestamp_ms) {
+    QString text_frame;
+    QByteArray binary_frame;
+    
+    for (auto it = clients_.begin(); it != clients_.end(); ++it) {
+        if (!it->paths.contains(path)) {
+            continue;
+        }
+        
+        // Encode lazily, once per format
+        if (it->binary_frames) {
+            if (binary_frame.isEmpty()) {
+                QCborMap data;
+                data[QStringLiteral("value")] = value;
+                if (path == SPEED_PATH) {
+                    data[QStringLiteral("unit")] = QStringLiteral("km/h");
+                }
+                data[QStringLiteral("timestamp")] = timestamp_ms;
+                
+                QCborMap event;
+                event[QStringLiteral("jtype")] = QStringLiteral("afb-event");
+                event[QStringLiteral("event")] = QStringLiteral("vss/") + path;
+                event[QStringLiteral("data")] = data;
+                binary_frame = QCborValue(event).toCbor();
+            }
+            it.key()->sendBinaryMessage(binary_frame);
+        } else {
+            if (text_frame.isEmpty()) {
+                QJsonObject data;
+                data["value"] = value;
+                if (path == SPEED_PATH) {
+                    data["unit"] = "km/h";
+                }
+                data["timestamp"] = timestamp_ms;
+                
+                QJsonObject event;
+                event["jtype"] = "afb-event";
+                event["event"] = "vss/" + path;
+                event["data"] = data;
+                text_frame = QString::fromUtf8(QJsonDocument(event).toJson(QJsonDocument::Compact));
+            }
+            it.key()->sendTextMessage(text_frame);
+        }
+        ++frames_sent_;
+    }
+    
+    ++events_sent_;
+    if (options_.disconnect_every > 0 &&
+        events_sent_ % static_cast<quint64>(options_.disconnect_every) == 0) {
+        disconnectClients();
+    }
+}
+
+void AfbStandInServer::disconnectClients() {
+    if (clients_.isEmpty()) {
+        return;
+    }
+    
+    ++disconnects_injected_;
+    qInfo() << "Stand-in dropping" << clients_.size() << "client(s)";
+    
+    // close() may report the disconnect synchronously, so iterate a copy
+    const auto sockets = clients_.keys();
+    for (QWebSocket* socket : sockets) {
+        socket->close(QWebSocketProtocol::CloseCodeGoingAway, "stand-in disconnect");
+    }
+}
+
+void AfbStandInServer::onNewConnection() {
+    while (server_->hasPendingConnections()) {
+        QWebSocket* socket = server_->nextPendingConnection();
+        clients_.insert(socket, Client());
+        
+        connect(socket, &QWebSocket::textMessageReceived,
+                this, &AfbStandInServer::onTextMessageReceived);
+        connect(socket, &QWebSocket::disconnected,
+                this, &AfbStandInServer::onClientDisconnected);
+        
+        qInfo() << "Stand-in client connected from" << socket->peerAddress().toString();
+        emit clientConnected();
+    }
+}
+
+void AfbStandInServer::onTextMessageReceived(const QString& message) {
+    auto* socket = qobject_cast<QWebSocket*>(sender());
+    if (socket && clients_.contains(socket)) {
+        handleRequest(socket, message);
+    }
+}
+
+void AfbStandInServer::onClientDisconnected() {
+    auto* socket = qobject_cast<QWebSocket*>(sender());
+    if (!socket) {
+        return;
+    }
+    clients_.remove(socket);
+    socket->deleteLater();
+}
+
+void AfbStandInServer::onReplayTick() {
+    const qint64 now_ms = replay_clock_.elapsed();
+    
+    while (replay_timer_.isActive() && next_due_ms_ <= now_ms) {
+        TracePoint point = trace_.points()[cursor_];
+        point.offset_ms += loop_offset_ms_;
+        burst_.append(point);
+        
+        if (++cursor_ >= trace_.size()) {
+            if (!options_.loop) {
+                flushBurst();
+                stopReplay();
+                qInfo() << "Replay finished -" << events_sent_ << "events sent";
+                emit replayFinished();
+                return;
+            }
+            cursor_ = 0;
+            loop_offset_ms_ += trace_.durationMs();
+        }
+        scheduleNextEvent();
+        
+        if (burst_.size() >= options_.burst_size) {
+            flushBurst();
+        }
+    }
+}
+
+void AfbStandInServer::scheduleNextEvent() {
+    const qint64 trace_ms = loop_offset_ms_ + trace_.points()[cursor_].offset_ms;
+    qint64 due_ms = static_cast<qint64>(static_cast<double>(trace_ms) / options_.speed_factor);
+    if (options_.jitter_ms > 0) {
+        due_ms += random_.bounded(options_.jitter_ms + 1);
+    }
+    
+    // Jitter delays events but never reorders them
+    next_due_ms_ = qMax(next_due_ms_, due_ms);
+}
+
+void AfbStandInServer::flushBurst() {
+    const QVector<TracePoint> burst = burst_;
+    burst_.clear();
+    for (const TracePoint& point : burst) {
+        publish(SPEED_PATH, point.speed, replay_epoch_ms_ + point.offset_ms);
+    }
+}
+
+void AfbStandInServer::handleRequest(QWebSocket* socket, const QString& message) {
+    const QJsonDocument doc = QJsonDocument::fromJson(message.toUtf8());
+    if (!doc.isObject()) {
+        qWarning() << "Stand-in received invalid JSON request";
+        socket->sendTextMessage(replyFrame("invalid-request", QString()));
+        return;
+    }
+    
+    const QJsonObject request = doc.object();
+    const QString api = request["api"].toString();
+    const QString verb = request["verb"].toString();
+    const QJsonObject args = request["args"].toObject();
+    
+    if (api != "vss") {
+        socket->sendTextMessage(replyFrame("unknown-api", QString()));
+        return;
+    }
+    if (verb != "subscribe") {
+        socket->sendTextMessage(replyFrame("unknown-verb", QString()));
+        return;
+    }
+    
+    const QString path = args["path"].toString();
+    if (path.isEmpty()) {
+        socket->sendTextMessage(replyFrame("invalid-request", QString()));
+        return;
+    }
+    
+    const bool wants_cbor = args["format"].toString() == "cbor";
+    if (wants_cbor && !options_.binary_frames) {
+        // Behave like a binding that predates binary frames
+        socket->sendTextMessage(replyFrame("invalid-args", QString()));
+        return;
+    }
+    
+    Client& client = clients_[socket];
+    client.paths.insert(path);
+    client.binary_frames = wants_cbor;
+    socket->sendTextMessage(replyFrame("success", "subscribed"));
+    
+    emit clientSubscribed(path, wants_cbor);
+}
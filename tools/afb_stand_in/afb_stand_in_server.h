@@ -0,0 +1,148 @@
+#pragma once
+
+#include "speed_trace.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHostAddress>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QTimer>
+#include <QUrl>
+
+class QWebSocket;
+class QWebSocketServer;
+
+/**
+ * @brief Local stand-in for the AGL AFB binder and its VSS binding
+ *
+ * Speaks the subset of the AFB WebSocket protocol VehicleDataManager uses:
+ * {"api":"vss","verb":"subscribe","args":{"path":..,"format":..}} requests
+ * are answered with an afb-reply, and subscribed clients receive
+ * afb-event frames (JSON text, or CBOR binary when "format":"cbor" was
+ * requested). A SpeedTrace is replayed as Vehicle.Speed events at 1x to
+ * 1000x, optionally with jitter, bursts and forced disconnects, to exercise
+ * the ingestion path far beyond real vehicle rates.
+ */
+class AfbStandInServer : public QObject {
+    Q_OBJECT
+
+public:
+    struct Options {
+        double speed_factor = 1.0;     ///< Replay speed multiplier (1-1000)
+        int jitter_ms = 0;             ///< Max random delay added per event
+        int burst_size = 1;            ///< Events held back and sent together
+        int disconnect_every = 0;      ///< Drop all clients every N events (0 = never)
+        bool loop = true;              ///< Restart the trace when it ends
+        bool binary_frames = true;     ///< Accept "format":"cbor" subscriptions
+        quint32 seed = 1;              ///< Jitter random seed (reproducible runs)
+    };
+
+    static constexpr double MIN_SPEED_FACTOR = 1.0;
+    static constexpr double MAX_SPEED_FACTOR = 1000.0;
+
+    explicit AfbStandInServer(QObject* parent = nullptr);
+    ~AfbStandInServer();
+
+    /**
+     * @brief Start accepting connections
+     * @param address Listen address
+     * @param port Port, 0 picks a free one
+     * @return true on success
+     */
+    bool listen(const QHostAddress& address = QHostAddress::LocalHost, quint16 port = 0);
+
+    /**
+     * @brief Stop replay, drop all clients and stop listening
+     */
+    void close();
+
+    quint16 port() const;
+
+    /**
+     * @brief WebSocket URL clients should connect to (ws://host:port/api)
+     */
+    QUrl url() const;
+
+    /**
+     * @brief Set replay options (out-of-range values are clamped)
+     */
+    void setOptions(const Options& options);
+    const Options& options() const { return options_; }
+
+    /**
+     * @brief Set the trace replayed by startReplay()
+     */
+    void setTrace(const SpeedTrace& trace);
+
+    /**
+     * @brief Start replaying the trace from the beginning
+     */
+    void startReplay();
+
+    /**
+     * @brief Stop replaying (pending burst events are discarded)
+     */
+    void stopReplay();
+
+    bool isReplaying() const { return replay_timer_.isActive(); }
+
+    /**
+     * @brief Send one event to all clients subscribed to a path
+     * @param path VSS path, e.g. "Vehicle.Speed"
+     * @param value Signal value
+     * @param timestamp_ms Source timestamp (ms since epoch)
+     */
+    void publish(const QString& path, double value, qint64 timestamp_ms);
+
+    /**
+     * @brief Close every client connection (clients are expected to reconnect)
+     */
+    void disconnectClients();
+
+    int clientCount() const { return clients_.size(); }
+    quint64 eventsSent() const { return events_sent_; }
+    quint64 framesSent() const { return frames_sent_; }
+    quint64 disconnectsInjected() const { return disconnects_injected_; }
+
+signals:
+    void clientConnected();
+    void clientSubscribed(const QString& path, bool binary_frames);
+    void replayFinished();
+
+private slots:
+    void onNewConnection();
+    void onTextMessageReceived(const QString& message);
+    void onClientDisconnected();
+    void onReplayTick();
+
+private:
+    struct Client {
+        QSet<QString> paths;          ///< Subscribed VSS paths
+        bool binary_frames = false;   ///< Client asked for CBOR frames
+    };
+
+    void handleRequest(QWebSocket* socket, const QString& message);
+    void scheduleNextEvent();
+    void flushBurst();
+
+    QWebSocketServer* server_;
+    QHash<QWebSocket*, Client> clients_;
+    Options options_;
+    SpeedTrace trace_;
+
+    QTimer replay_timer_;             ///< Polls the replay clock while replaying
+    QElapsedTimer replay_clock_;      ///< Wall time since startReplay()
+    qint64 replay_epoch_ms_ = 0;      ///< Source timestamp of trace offset 0
+    int cursor_ = 0;                  ///< Next trace point
+    qint64 loop_offset_ms_ = 0;       ///< Trace time consumed by earlier loops
+    qint64 next_due_ms_ = 0;          ///< Wall time the cursor's event is due
+    QVector<TracePoint> burst_;       ///< Due events held back for a burst
+    QRandomGenerator random_;
+
+    quint64 events_sent_ = 0;
+    quint64 frames_sent_ = 0;
+    quint64 disconnects_injected_ = 0;
+
+    static constexpr const char* SPEED_PATH = "Vehicle.Speed";
+};
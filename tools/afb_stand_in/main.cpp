@@ -0,0 +1,64 @@
+#include "afb_stand_in_server.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("carspeedboy-afb-stand-in");
+    QCoreApplication::setApplicationVersion("1.0.0");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Local AFB/VSS stand-in: replays DataLogger speed traces over the AFB WebSocket protocol");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    
+    QCommandLineOption port_option({"p", "port"}, "Listen port (default 1234).", "port", "1234");
+    QCommandLineOption trace_option({"t", "trace"},
+        "DataLogger CSV to replay (default: synthetic drive cycle).", "file");
+    QCommandLineOption speed_option({"s", "speed"}, "Replay speed factor, 1-1000 (default 1).",
+        "factor", "1");
+    QCommandLineOption jitter_option("jitter-ms", "Max random delay per event in ms.", "ms", "0");
+    QCommandLineOption burst_option("burst", "Send events in bursts of N.", "n", "1");
+    QCommandLineOption disconnect_option("disconnect-every",
+        "Drop all clients every N events (0 = never).", "n", "0");
+    QCommandLineOption once_option("once", "Stop after one pass over the trace.");
+    QCommandLineOption text_only_option("text-only", "Reject CBOR (binary frame) subscriptions.");
+    parser.addOptions({port_option, trace_option, speed_option, jitter_option, burst_option,
+                       disconnect_option, once_option, text_only_option});
+    parser.process(app);
+    
+    SpeedTrace trace;
+    if (parser.isSet(trace_option)) {
+        if (!trace.loadCsv(parser.value(trace_option))) {
+            return 1;
+        }
+    } else {
+        trace = SpeedTrace::synthetic();
+    }
+    
+    AfbStandInServer::Options options;
+    options.speed_factor = parser.value(speed_option).toDouble();
+    options.jitter_ms = parser.value(jitter_option).toInt();
+    options.burst_size = parser.value(burst_option).toInt();
+    options.disconnect_every = parser.value(disconnect_option).toInt();
+    options.loop = !parser.isSet(once_option);
+    options.binary_frames = !parser.isSet(text_only_option);
+    
+    AfbStandInServer server;
+    server.setOptions(options);
+    server.setTrace(trace);
+    
+    if (!server.listen(QHostAddress::Any, static_cast<quint16>(parser.value(port_option).toUInt()))) {
+        return 1;
+    }
+    
+    QObject::connect(&server, &AfbStandInServer::replayFinished, &app, &QCoreApplication::quit);
+    server.startReplay();
+    
+    const int result = app.exec();
+    qInfo() << "Events sent:" << server.eventsSent() << "frames:" << server.framesSent()
+            << "disconnects:" << server.disconnectsInjected();
+    return result;
+}
@@ -0,0 +1,117 @@
+#include "speed_trace.h"
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+#include <QtMath>
+
+namespace {
+constexpr qint64 DEFAULT_PERIOD_MS = 100;
+}
+
+bool SpeedTrace::loadCsv(const QString& file_path) {
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Cannot open trace:" << file_path;
+        return false;
+    }
+    
+    // Collect (wall clock, speed) rows first; offsets are assigned afterwards
+    QVector<qint64> times;
+    QVector<double> speeds;
+    QTextStream in(&file);
+    int line_number = 0;
+    
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++line_number;
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith("timestamp,")) {
+            continue;
+        }
+        
+        const QStringList fields = line.split(',');
+        if (fields.size() < 2) {
+            qWarning() << "Skipping malformed trace line" << line_number;
+            continue;
+        }
+        
+        const QDateTime time = QDateTime::fromString(fields[0], Qt::ISODateWithMs);
+        bool ok = false;
+        const double speed = fields[1].toDouble(&ok);
+        if (!time.isValid() || !ok) {
+            qWarning() << "Skipping malformed trace line" << line_number;
+            continue;
+        }
+        
+        times.append(time.toMSecsSinceEpoch());
+        speeds.append(speed);
+    }
+    
+    points_.clear();
+    if (times.isEmpty()) {
+        qWarning() << "Trace contains no samples:" << file_path;
+        return false;
+    }
+    
+    // Spread rows that share a timestamp across the interval to the next one
+    const qint64 origin = times.first();
+    int group_start = 0;
+    while (group_start < times.size()) {
+        int group_end = group_start;
+        while (group_end < times.size() && times[group_end] == times[group_start]) {
+            ++group_end;
+        }
+        
+        const qint64 begin = times[group_start] - origin;
+        const qint64 span = group_end < times.size()
+            ? times[group_end] - times[group_start]
+            : qMax<qint64>(1000, DEFAULT_PERIOD_MS * (group_end - group_start));
+        const int count = group_end - group_start;
+        
+        for (int i = 0; i < count; ++i) {
+            append(begin + span * i / count, speeds[group_start + i]);
+        }
+        group_start = group_end;
+    }
+    
+    qInfo() << "Loaded trace" << file_path << "-" << points_.size() << "samples,"
+            << durationMs() << "ms";
+    return true;
+}
+
+SpeedTrace SpeedTrace::synthetic(qint64 duration_ms, int rate_hz) {
+    SpeedTrace trace;
+    const qint64 period_ms = rate_hz > 0 ? 1000 / rate_hz : DEFAULT_PERIOD_MS;
+    
+    for (qint64 t = 0; t < duration_ms; t += period_ms) {
+        // Accelerate to 120 km/h, cruise, brake to standstill, plus a little sensor noise
+        const double phase = static_cast<double>(t) / static_cast<double>(duration_ms);
+        double speed;
+        if (phase < 0.3) {
+            speed = 120.0 * phase / 0.3;
+        } else if (phase < 0.7) {
+            speed = 120.0;
+        } else {
+            speed = 120.0 * (1.0 - phase) / 0.3;
+        }
+        speed += 0.5 * qSin(static_cast<double>(t) / 37.0);
+        trace.append(t, qMax(0.0, speed));
+    }
+    return trace;
+}
+
+void SpeedTrace::append(qint64 offset_ms, double speed) {
+    TracePoint point;
+    point.offset_ms = offset_ms;
+    point.speed = speed;
+    points_.append(point);
+}
+
+qint64 SpeedTrace::durationMs() const {
+    if (points_.isEmpty()) {
+        return 0;
+    }
+    const qint64 last = points_.last().offset_ms;
+    const qint64 period = points_.size() > 1 ? last / (points_.size() - 1) : DEFAULT_PERIOD_MS;
+    return last + qMax<qint64>(1, period);
+}
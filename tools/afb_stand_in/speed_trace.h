@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief One recorded speed sample
+ */
+struct TracePoint {
+    qint64 offset_ms = 0;   ///< Time since the start of the trace
+    double speed = 0.0;     ///< Speed in km/h
+};
+
+/**
+ * @brief Speed trace replayed by the AFB stand-in
+ *
+ * Loaded from CSV files written by DataLogger
+ * (timestamp,raw_speed_kmh,smoothed_speed_kmh,expression_state). The raw
+ * speed column is replayed. DataLogger timestamps have one-second
+ * resolution, so rows sharing a timestamp are spread evenly up to the next
+ * distinct timestamp.
+ */
+class SpeedTrace {
+public:
+    /**
+     * @brief Load a DataLogger CSV file
+     * @param file_path Path to the CSV file
+     * @return true if at least one sample was loaded
+     */
+    bool loadCsv(const QString& file_path);
+
+    /**
+     * @brief Build a synthetic accelerate/cruise/brake cycle
+     * @param duration_ms Length of the cycle
+     * @param rate_hz Sample rate
+     * @return Generated trace
+     */
+    static SpeedTrace synthetic(qint64 duration_ms = 60000, int rate_hz = 10);
+
+    /**
+     * @brief Append a sample (offsets must not decrease)
+     */
+    void append(qint64 offset_ms, double speed);
+
+    const QVector<TracePoint>& points() const { return points_; }
+    int size() const { return points_.size(); }
+    bool isEmpty() const { return points_.isEmpty(); }
+
+    /**
+     * @brief Trace length including one average sample period
+     */
+    qint64 durationMs() const;
+
+private:
+    QVector<TracePoint> points_;
+};
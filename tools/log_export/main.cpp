@@ -0,0 +1,134 @@
+#include "business_logic/columnar_log.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QTextStream>
+#include <limits>
+
+namespace {
+
+constexpr int WRITE_CHUNK_BYTES = 1 << 20;
+
+bool parseTime(const QString& text, qint64* ms) {
+    const QDateTime time = QDateTime::fromString(text, Qt::ISODateWithMs);
+    if (!time.isValid()) {
+        qCritical() << "Invalid ISO 8601 time:" << text;
+        return false;
+    }
+    *ms = time.toMSecsSinceEpoch();
+    return true;
+}
+
+void printInfo(const QString& path, const ColumnarLogReader& reader) {
+    const auto& blocks = reader.blocks();
+    QTextStream out(stdout);
+    out << path << ": " << reader.recordCount() << " records, " << blocks.size() << " blocks, "
+        << reader.fileSize() << " bytes";
+    if (reader.recordCount() > 0) {
+        out << " (" << QString::number(double(reader.fileSize()) / reader.recordCount(), 'f', 2)
+            << " bytes/record)";
+    }
+    out << (reader.truncated() ? ", truncated tail" : "") << "\n";
+    if (!blocks.isEmpty()) {
+        out << "  from " << QDateTime::fromMSecsSinceEpoch(blocks.first().first_ms).toString(Qt::ISODateWithMs)
+            << " to " << QDateTime::fromMSecsSinceEpoch(blocks.last().last_ms).toString(Qt::ISODateWithMs)
+            << "\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("carspeedboy-log-export");
+    QCoreApplication::setApplicationVersion("1.0.0");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Export columnar DataLogger logs (.cslog) to the speed_log CSV schema");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("files", "Columnar log files, exported in the given order.",
+                                 "files...");
+    
+    QCommandLineOption output_option({"o", "output"}, "CSV file to write (default: stdout).",
+        "file");
+    QCommandLineOption from_option("from", "Only records at or after this ISO 8601 time.", "time");
+    QCommandLineOption to_option("to", "Only records before this ISO 8601 time.", "time");
+    QCommandLineOption millis_option("millis",
+        "Write timestamps with milliseconds (the stored resolution).");
+    QCommandLineOption info_option("info", "Print block index summaries instead of exporting.");
+    parser.addOptions({output_option, from_option, to_option, millis_option, info_option});
+    parser.process(app);
+    
+    const QStringList files = parser.positionalArguments();
+    if (files.isEmpty()) {
+        parser.showHelp(1);
+    }
+    
+    qint64 from_ms = std::numeric_limits<qint64>::min();
+    qint64 to_ms = std::numeric_limits<qint64>::max();
+    if ((parser.isSet(from_option) && !parseTime(parser.value(from_option), &from_ms))
+        || (parser.isSet(to_option) && !parseTime(parser.value(to_option), &to_ms))) {
+        return 1;
+    }
+    
+    ColumnarLogReader reader;
+    if (parser.isSet(info_option)) {
+        for (const QString& path : files) {
+            QString error;
+            if (!reader.open(path, &error)) {
+                qCritical() << "Cannot read" << path << ":" << error;
+                return 1;
+            }
+            printInfo(path, reader);
+        }
+        return 0;
+    }
+    
+    QFile output;
+    bool opened = false;
+    if (parser.isSet(output_option)) {
+        output.setFileName(parser.value(output_option));
+        opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    } else {
+        opened = output.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!opened) {
+        qCritical() << "Cannot open output:" << output.errorString();
+        return 1;
+    }
+    
+    SpeedLogCsvFormatter formatter(parser.isSet(millis_option));
+    QByteArray chunk(SpeedLogCsvFormatter::HEADER);
+    chunk.reserve(WRITE_CHUNK_BYTES + 256);
+    quint64 exported = 0;
+    bool ok = true;
+    
+    for (const QString& path : files) {
+        QString error;
+        if (!reader.open(path, &error)) {
+            qCritical() << "Cannot read" << path << ":" << error;
+            return 1;
+        }
+        reader.forEachInRange(from_ms, to_ms, [&](const SpeedLogRecord& record) {
+            formatter.appendRow(chunk, record);
+            ++exported;
+            if (chunk.size() >= WRITE_CHUNK_BYTES) {
+                ok = output.write(chunk) == chunk.size() && ok;
+                chunk.truncate(0);
+            }
+        });
+    }
+    ok = output.write(chunk) == chunk.size() && ok;
+    output.close();
+    
+    if (!ok) {
+        qCritical() << "Failed to write output:" << output.errorString();
+        return 1;
+    }
+    qInfo() << "Exported" << exported << "records from" << files.size() << "file(s)";
+    return 0;
+}
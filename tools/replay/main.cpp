@@ -0,0 +1,318 @@
+#include "replay_pipeline.h"
+#include "work_stealing_pool.h"
+#include "business_logic/data_logger.h"
+#include "data_acquisition/configuration_manager.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QTextStream>
+#include <QThread>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Results of a run (or of one worker)
+ */
+struct Totals {
+    ReplayPipeline::Report report;
+    int files = 0;
+    int failed = 0;                ///< Files that could not be opened
+    qint64 bytes = 0;
+    quint64 skipped = 0;
+};
+
+const char* const ALERT_LEVEL_NAMES[ReplayPipeline::ALERT_LEVEL_COUNT] = {
+    "none", "info", "warning", "critical"
+};
+
+QString formatDuration(qint64 ms) {
+    const qint64 seconds = ms / 1000;
+    return QString("%1h %2m %3s")
+        .arg(seconds / 3600)
+        .arg((seconds / 60) % 60, 2, 10, QChar('0'))
+        .arg(seconds % 60, 2, 10, QChar('0'));
+}
+
+/**
+ * @brief Recordings under a directory tree, in directory order
+ */
+template <typename Visitor>
+void walkTree(const QString& root, Visitor&& visit) {
+    if (!QFileInfo(root).isDir()) {
+        visit(root);
+        return;
+    }
+    QDirIterator it(root,
+                    {"speed_log_*.csv", QString("speed_log_*.%1").arg(ColumnarLog::FILE_SUFFIX),
+                     "*.afb", "*.jsonl"},
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        visit(it.next());
+    }
+}
+
+/**
+ * @brief Replay one recording through pipeline
+ * @return false if it cannot be opened
+ */
+bool replayFile(const QString& path, ReplayReader& reader, ReplayPipeline& pipeline,
+                std::vector<ReplaySample>& batch) {
+    if (!reader.open(path)) {
+        return false;
+    }
+    QElapsedTimer read_timer;
+    for (;;) {
+        read_timer.start();
+        const int count = reader.read(batch.data(), static_cast<int>(batch.size()));
+        pipeline.addStageTime(ReplayPipeline::Stage::Read, read_timer.nsecsElapsed());
+        if (count == 0) {
+            return true;
+        }
+        pipeline.process(batch.data(), count);
+    }
+}
+
+void printReport(const Totals& totals, qint64 elapsed_ns) {
+    const ReplayPipeline::Report& report = totals.report;
+    QTextStream out(stdout);
+    const double elapsed_s = elapsed_ns / 1e9;
+    const qint64 recorded_ms = report.recorded_ms;
+
+    out << "Replayed " << report.samples << " samples from " << totals.files << " file(s), "
+        << totals.bytes << " bytes";
+    if (totals.skipped > 0) {
+        out << " (" << totals.skipped << " rows skipped)";
+    }
+    if (totals.failed > 0) {
+        out << ", " << totals.failed << " file(s) unreadable";
+    }
+    out << "\n";
+    if (report.samples > 0) {
+        out << "  recorded " << QDateTime::fromMSecsSinceEpoch(report.first_ms).toString(Qt::ISODate)
+            << " to " << QDateTime::fromMSecsSinceEpoch(report.last_ms).toString(Qt::ISODate)
+            << ", " << formatDuration(recorded_ms) << " of samples\n";
+    }
+    out << "  elapsed " << QString::number(elapsed_s, 'f', 3) << " s, "
+        << QString::number(elapsed_s > 0 ? report.samples / elapsed_s : 0.0, 'f', 0) << " samples/s";
+    if (elapsed_s > 0 && recorded_ms > 0) {
+        out << ", " << QString::number(recorded_ms / 1000.0 / elapsed_s, 'f', 0) << "x real time";
+    }
+    out << "\n";
+
+    out << "Stage time (total CPU ms, ns/sample):\n";
+    for (int i = 0; i < ReplayPipeline::STAGE_COUNT; ++i) {
+        const qint64 ns = report.stage_ns[i];
+        out << "  " << QString(ReplayPipeline::stageName(static_cast<ReplayPipeline::Stage>(i)))
+                           .leftJustified(14)
+            << QString::number(ns / 1e6, 'f', 1).rightJustified(10)
+            << QString::number(report.samples ? double(ns) / report.samples : 0.0, 'f', 1)
+                   .rightJustified(10)
+            << "\n";
+    }
+
+    out << "Time in state:\n";
+    qint64 total_state_ms = 0;
+    for (qint64 ms : report.state_ms) {
+        total_state_ms += ms;
+    }
+    for (int i = 0; i < ReplayPipeline::STATE_COUNT; ++i) {
+        out << "  " << QString(SpeedLogCsvFormatter::stateName(static_cast<quint8>(i))).leftJustified(14)
+            << formatDuration(report.state_ms[i]).rightJustified(14)
+            << QString::number(total_state_ms ? 100.0 * report.state_ms[i] / total_state_ms : 0.0,
+                               'f', 1).rightJustified(8)
+            << " %\n";
+    }
+
+    out << "Transitions: " << report.transitions << " (" << report.smoothed
+        << " smoothed samples, " << report.stalls << " stalls)\n";
+    for (int from = 0; from < ReplayPipeline::STATE_COUNT; ++from) {
+        for (int to = 0; to < ReplayPipeline::STATE_COUNT; ++to) {
+            if (report.transition_counts[from][to] > 0) {
+                out << "  " << SpeedLogCsvFormatter::stateName(static_cast<quint8>(from)) << " -> "
+                    << SpeedLogCsvFormatter::stateName(static_cast<quint8>(to)) << ": "
+                    << report.transition_counts[from][to] << "\n";
+            }
+        }
+    }
+
+    out << "Alerts:";
+    for (int i = 1; i < ReplayPipeline::ALERT_LEVEL_COUNT; ++i) {
+        out << " " << ALERT_LEVEL_NAMES[i] << "=" << report.alerts[i];
+    }
+    out << "\n";
+
+    out << "Raw speed histogram (km/h, samples):\n";
+    for (int i = 0; i < ReplayPipeline::SPEED_BINS; ++i) {
+        if (report.speed_histogram[i] == 0) {
+            continue;
+        }
+        const int low = i * ReplayPipeline::SPEED_BIN_KMH;
+        const QString range = i + 1 < ReplayPipeline::SPEED_BINS
+            ? QString("%1-%2").arg(low).arg(low + ReplayPipeline::SPEED_BIN_KMH)
+            : QString("%1+").arg(low);
+        out << "  " << range.leftJustified(10) << QString::number(report.speed_histogram[i]).rightJustified(14)
+            << QString::number(100.0 * report.speed_histogram[i] / report.samples, 'f', 1).rightJustified(8)
+            << " %\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("carspeedboy-replay");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Replay recorded speed data through SpeedMonitor, ExpressionStateMachine and AlertManager "
+        "as fast as possible, on the recording's clock.\n"
+        "By default the paths are one continuous recording. With --jobs every file is analysed on "
+        "its own, directories are searched recursively and the results are merged.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("paths",
+        "DataLogger logs (.csv, .cslog), AFB captures (one JSON frame per line) or directories "
+        "of them; replayed in the given order.", "paths...");
+
+    QCommandLineOption config_option({"c", "config"},
+        "config.json whose smoothing and expression settings to use (default: built-in).", "file");
+    QCommandLineOption log_dir_option("log-dir",
+        "Also run DataLogger, writing to this directory.", "dir");
+    QCommandLineOption log_format_option("log-format",
+        "DataLogger format with --log-dir: csv or columnar (default columnar).", "format",
+        "columnar");
+    QCommandLineOption event_option("event", "AFB event carrying the speed.", "name",
+        ReplayReader::DEFAULT_EVENT);
+    QCommandLineOption read_size_option("read-size", "Samples read per batch (default 4096).", "n",
+        "4096");
+    QCommandLineOption jobs_option({"j", "jobs"},
+        "Analyse files independently on n threads (0 = one per core).", "n");
+    QCommandLineOption verbose_option({"v", "verbose"}, "Keep component info output.");
+    parser.addOptions({config_option, log_dir_option, log_format_option, event_option,
+                       read_size_option, jobs_option, verbose_option});
+    parser.process(app);
+
+    const QStringList paths = parser.positionalArguments();
+    if (paths.isEmpty()) {
+        parser.showHelp(1);
+    }
+    const bool parallel = parser.isSet(jobs_option);
+    if (parallel && parser.isSet(log_dir_option)) {
+        qCritical() << "--log-dir cannot be combined with --jobs";
+        return 1;
+    }
+
+    // Per-sample logging would dominate the run
+    if (!parser.isSet(verbose_option)) {
+        QLoggingCategory::setFilterRules("*.debug=false\n*.info=false");
+    }
+
+    ConfigurationManager config;
+    if (parser.isSet(config_option) && !config.loadFromFile(parser.value(config_option))) {
+        qCritical() << "Cannot load config:" << parser.value(config_option);
+        return 1;
+    }
+
+    const int read_size = qMax(1, parser.value(read_size_option).toInt());
+    const QString event = parser.value(event_option);
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    if (parallel) {
+        int jobs = parser.value(jobs_option).toInt();
+        if (jobs <= 0) {
+            jobs = QThread::idealThreadCount();
+        }
+
+        // Workers keep running totals and a fresh pipeline per file, so memory
+        // does not grow with the number of files
+        std::vector<Totals> worker_totals(static_cast<std::size_t>(jobs));
+        unsigned long long stolen = 0;
+        {
+            WorkStealingPool pool(jobs, 4 * jobs);
+            for (const QString& root : paths) {
+                walkTree(root, [&](const QString& path) {
+                    pool.submit([&config, &worker_totals, &event, read_size, path](int worker) {
+                        Totals& totals = worker_totals[static_cast<std::size_t>(worker)];
+                        ReplayReader reader(event);
+                        ReplayPipeline pipeline(config);
+                        std::vector<ReplaySample> batch(static_cast<std::size_t>(read_size));
+                        ++totals.files;
+                        if (!replayFile(path, reader, pipeline, batch)) {
+                            ++totals.failed;
+                            return;
+                        }
+                        totals.report.merge(pipeline.report());
+                        totals.bytes += reader.bytesRead();
+                        totals.skipped += reader.rowsSkipped();
+                    });
+                });
+            }
+            pool.wait();
+            stolen = pool.stolenCount();
+        }
+
+        Totals totals;
+        for (const Totals& worker : worker_totals) {
+            totals.report.merge(worker.report);
+            totals.files += worker.files;
+            totals.failed += worker.failed;
+            totals.bytes += worker.bytes;
+            totals.skipped += worker.skipped;
+        }
+        if (totals.files == 0) {
+            qCritical() << "No recordings found";
+            return 1;
+        }
+        printReport(totals, elapsed.nsecsElapsed());
+        QTextStream(stdout) << "Workers: " << jobs << ", tasks stolen: " << stolen << "\n";
+        return 0;
+    }
+
+    QStringList files;
+    for (const QString& path : paths) {
+        files.append(ReplayReader::expandPath(path));
+    }
+
+    ReplayPipeline pipeline(config);
+    std::unique_ptr<DataLogger> data_logger;
+    if (parser.isSet(log_dir_option)) {
+        // No writer thread: at replay speed its queue would drop records
+        data_logger = std::make_unique<DataLogger>(parser.value(log_dir_option));
+        const QString format = parser.value(log_format_option);
+        if (format == "csv") {
+            data_logger->setFormat(DataLogger::Format::Csv);
+        } else if (format == "columnar") {
+            data_logger->setFormat(DataLogger::Format::Columnar);
+        } else {
+            qCritical() << "Unknown log format:" << format;
+            return 1;
+        }
+        pipeline.setDataLogger(data_logger.get());
+    }
+
+    std::vector<ReplaySample> batch(static_cast<std::size_t>(read_size));
+    ReplayReader reader(event);
+    for (const QString& path : files) {
+        if (!replayFile(path, reader, pipeline, batch)) {
+            return 1;
+        }
+    }
+    data_logger.reset();
+
+    Totals totals;
+    totals.report = pipeline.report();
+    totals.files = files.size();
+    totals.bytes = reader.bytesRead();
+    totals.skipped = reader.rowsSkipped();
+    printReport(totals, elapsed.nsecsElapsed());
+    return 0;
+}
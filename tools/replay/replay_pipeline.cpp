@@ -0,0 +1,130 @@
+#include "replay_pipeline.h"
+#include "business_logic/data_logger.h"
+#include "business_logic/pipeline_config.h"
+#include "data_acquisition/configuration_manager.h"
+
+namespace {
+
+constexpr qint64 NS_PER_MS = 1000000;
+
+} // namespace
+
+const char* ReplayPipeline::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::Read: return "read";
+        case Stage::Smoothing: return "smoothing";
+        case Stage::StateMachine: return "state_machine";
+        case Stage::Alerts: return "alerts";
+        case Stage::Logging: return "logging";
+    }
+    return "unknown";
+}
+
+void ReplayPipeline::Report::merge(const Report& other) {
+    if (other.samples == 0) {
+        return;
+    }
+    first_ms = samples == 0 ? other.first_ms : qMin(first_ms, other.first_ms);
+    last_ms = samples == 0 ? other.last_ms : qMax(last_ms, other.last_ms);
+    samples += other.samples;
+    smoothed += other.smoothed;
+    transitions += other.transitions;
+    stalls += other.stalls;
+    recorded_ms += other.recorded_ms;
+    for (int from = 0; from < STATE_COUNT; ++from) {
+        state_ms[from] += other.state_ms[from];
+        for (int to = 0; to < STATE_COUNT; ++to) {
+            transition_counts[from][to] += other.transition_counts[from][to];
+        }
+    }
+    for (int i = 0; i < SPEED_BINS; ++i) {
+        speed_histogram[i] += other.speed_histogram[i];
+    }
+    for (int i = 0; i < ALERT_LEVEL_COUNT; ++i) {
+        alerts[i] += other.alerts[i];
+    }
+    for (int i = 0; i < STAGE_COUNT; ++i) {
+        stage_ns[i] += other.stage_ns[i];
+    }
+}
+
+ReplayPipeline::ReplayPipeline(const ConfigurationManager& config) {
+    PipelineConfig::applySmoothing(config, speed_monitor_);
+    PipelineConfig::applyExpression(config, state_machine_);
+
+    QObject::connect(&speed_monitor_, &SpeedMonitor::smoothedSpeedUpdated, [this](double speed) {
+        smoothed_ready_ = true;
+        smoothed_speed_ = speed;
+    });
+    QObject::connect(&alert_manager_, &AlertManager::alertTriggered,
+                     [this](AlertManager::AlertLevel level, const QString&) {
+        const int index = static_cast<int>(level);
+        if (index >= 0 && index < ALERT_LEVEL_COUNT) {
+            ++report_.alerts[index];
+        }
+    });
+    timer_.start();
+}
+
+void ReplayPipeline::process(const ReplaySample* samples, int count) {
+    auto& stage_ns = report_.stage_ns;
+    qint64 now_ns = timer_.nsecsElapsed();
+
+    for (int i = 0; i < count; ++i) {
+        const ReplaySample& sample = samples[i];
+        const qint64 sample_ns = sample.time_ms * NS_PER_MS;
+        const ExpressionState old_state = state_machine_.getCurrentState();
+
+        // Time in state runs on the recording's clock
+        if (report_.samples == 0) {
+            report_.first_ms = report_.last_ms = sample.time_ms;
+        } else {
+            const qint64 gap_ms = sample.time_ms - last_ms_;
+            if (gap_ms > 0 && gap_ms <= MAX_DWELL_GAP_MS) {
+                report_.state_ms[static_cast<int>(old_state) % STATE_COUNT] += gap_ms;
+                report_.recorded_ms += gap_ms;
+            }
+        }
+        last_ms_ = sample.time_ms;
+        report_.first_ms = qMin(report_.first_ms, sample.time_ms);
+        report_.last_ms = qMax(report_.last_ms, sample.time_ms);
+        ++report_.samples;
+        // Clamped as a double; the cast is undefined for speeds beyond int
+        const double bin = qBound(0.0, sample.speed / SPEED_BIN_KMH, SPEED_BINS - 1.0);
+        ++report_.speed_histogram[static_cast<int>(bin)];
+
+        smoothed_ready_ = false;
+        speed_monitor_.onSpeedSample(sample.speed, sample_ns);
+        qint64 stage_end_ns = timer_.nsecsElapsed();
+        stage_ns[static_cast<int>(Stage::Smoothing)] += stage_end_ns - now_ns;
+        now_ns = stage_end_ns;
+
+        if (smoothed_ready_) {
+            ++report_.smoothed;
+            state_machine_.updateSpeed(smoothed_speed_, sample_ns);
+            stage_end_ns = timer_.nsecsElapsed();
+            stage_ns[static_cast<int>(Stage::StateMachine)] += stage_end_ns - now_ns;
+            now_ns = stage_end_ns;
+
+            const ExpressionState new_state = state_machine_.getCurrentState();
+            if (new_state != old_state) {
+                ++report_.transitions;
+                ++report_.transition_counts[static_cast<int>(old_state) % STATE_COUNT]
+                                           [static_cast<int>(new_state) % STATE_COUNT];
+                alert_manager_.onStateChanged(old_state, new_state);
+                stage_end_ns = timer_.nsecsElapsed();
+                stage_ns[static_cast<int>(Stage::Alerts)] += stage_end_ns - now_ns;
+                now_ns = stage_end_ns;
+            }
+        }
+
+        if (data_logger_) {
+            data_logger_->logSpeedDataAt(sample.speed, speed_monitor_.smoothedSpeed(),
+                                         state_machine_.getCurrentState(), sample.time_ms);
+            stage_end_ns = timer_.nsecsElapsed();
+            stage_ns[static_cast<int>(Stage::Logging)] += stage_end_ns - now_ns;
+            now_ns = stage_end_ns;
+        }
+    }
+    report_.stalls = speed_monitor_.gapStatistics().stalls;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "business_logic/alert_manager.h"
+#include "business_logic/expression_state_machine.h"
+#include "business_logic/speed_monitor.h"
+#include "replay_reader.h"
+#include <QElapsedTimer>
+#include <array>
+
+class ConfigurationManager;
+class DataLogger;
+
+/**
+ * @brief The speed -> expression -> alert pipeline without UI or transport
+ *
+ * Mirrors what ApplicationController does per speed sample, driven by a
+ * virtual clock: every component sees the recorded sample time instead of
+ * the wall clock, so smoothing, hysteresis and minimum dwell behave as they
+ * did in the car while samples are pushed as fast as the CPU allows.
+ * Every stage is timed separately.
+ */
+class ReplayPipeline {
+public:
+    enum class Stage {
+        Read,           ///< Reading and parsing the recording
+        Smoothing,      ///< SpeedMonitor
+        StateMachine,   ///< ExpressionStateMachine
+        Alerts,         ///< AlertManager
+        Logging         ///< DataLogger (optional)
+    };
+
+    static constexpr int STAGE_COUNT = 5;
+    static constexpr int STATE_COUNT = 5;
+    static constexpr int ALERT_LEVEL_COUNT = 4;
+    static constexpr qint64 MAX_DWELL_GAP_MS = 2000;   ///< Longer gaps do not count as time in state
+    static constexpr int SPEED_BIN_KMH = 10;
+    static constexpr int SPEED_BINS = 26;                ///< Last bin holds 250 km/h and above
+
+    struct Report {
+        quint64 samples = 0;
+        quint64 smoothed = 0;                ///< Samples that reached the state machine
+        quint64 transitions = 0;
+        std::array<std::array<quint64, STATE_COUNT>, STATE_COUNT> transition_counts{};   ///< [from][to]
+        std::array<qint64, STATE_COUNT> state_ms{};              ///< Recorded time per state
+        std::array<quint64, SPEED_BINS> speed_histogram{};       ///< Raw samples per speed bin
+        std::array<quint64, ALERT_LEVEL_COUNT> alerts{};         ///< Per AlertManager::AlertLevel
+        std::array<qint64, STAGE_COUNT> stage_ns{};
+        quint64 stalls = 0;                  ///< Transport stalls SpeedMonitor detected
+        qint64 recorded_ms = 0;              ///< Time covered by samples (gaps excluded)
+        qint64 first_ms = 0;                 ///< Earliest and latest sample
+        qint64 last_ms = 0;
+
+        /**
+         * @brief Add another replay's results (another file or worker)
+         */
+        void merge(const Report& other);
+    };
+
+    static const char* stageName(Stage stage);
+
+    /**
+     * @brief Configure the components like ApplicationController::initialize()
+     */
+    explicit ReplayPipeline(const ConfigurationManager& config);
+
+    /**
+     * @brief Also log every sample (with its recorded time)
+     * @param logger Not owned; nullptr disables logging
+     */
+    void setDataLogger(DataLogger* logger) { data_logger_ = logger; }
+
+    /**
+     * @brief Push samples through the pipeline in order
+     */
+    void process(const ReplaySample* samples, int count);
+
+    /**
+     * @brief Account time spent reading the recording
+     */
+    void addStageTime(Stage stage, qint64 ns) { report_.stage_ns[static_cast<int>(stage)] += ns; }
+
+    const Report& report() const { return report_; }
+
+private:
+    SpeedMonitor speed_monitor_;
+    ExpressionStateMachine state_machine_;
+    AlertManager alert_manager_;
+    DataLogger* data_logger_ = nullptr;
+    QElapsedTimer timer_;
+    Report report_;
+    bool smoothed_ready_ = false;            ///< SpeedMonitor produced a value for this sample
+    double smoothed_speed_ = 0.0;
+    qint64 last_ms_ = 0;                     ///< Previous sample time
+};
@@ -0,0 +1,197 @@
+#include "replay_reader.h"
+#include "business_logic/speed_log_query.h"
+#include "data_acquisition/afb_event_parser.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+
+ReplayReader::Format ReplayReader::formatForPath(const QString& path) {
+    if (path.endsWith(".csv")) {
+        return Format::Csv;
+    }
+    if (path.endsWith(QString(".") + ColumnarLog::FILE_SUFFIX)) {
+        return Format::Columnar;
+    }
+    return Format::AfbCapture;
+}
+
+QStringList ReplayReader::expandPath(const QString& path) {
+    const QFileInfo info(path);
+    if (!info.isDir()) {
+        return {path};
+    }
+    QStringList paths = SpeedLogQuery(path).logFiles();
+    const QFileInfoList captures = QDir(path).entryInfoList({"*.afb", "*.jsonl"}, QDir::Files,
+                                                            QDir::Name);
+    for (const QFileInfo& capture : captures) {
+        paths.append(capture.absoluteFilePath());
+    }
+    return paths;
+}
+
+ReplayReader::ReplayReader(const QString& event)
+    : event_(event.toLatin1())
+{
+}
+
+bool ReplayReader::open(const QString& path) {
+    file_.close();
+    columnar_.close();
+    buffer_.clear();
+    ready_.clear();
+    ready_pos_ = 0;
+    group_.clear();
+    last_ms_ = 0;
+    format_ = formatForPath(path);
+
+    if (format_ == Format::Columnar) {
+        QString error;
+        if (!columnar_.open(path, &error)) {
+            qWarning() << "Cannot read" << path << ":" << error;
+            return false;
+        }
+        next_block_ = 0;
+        at_end_ = false;
+        return true;
+    }
+
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        qWarning() << "Cannot open" << path << ":" << file_.errorString();
+        return false;
+    }
+    at_end_ = false;
+    return true;
+}
+
+int ReplayReader::read(ReplaySample* out, int max) {
+    while (ready_pos_ >= ready_.size()) {
+        ready_.clear();
+        ready_pos_ = 0;
+        if (!fill()) {
+            return 0;
+        }
+    }
+    const int count = qMin(max, ready_.size() - ready_pos_);
+    std::copy(ready_.constBegin() + ready_pos_, ready_.constBegin() + ready_pos_ + count, out);
+    ready_pos_ += count;
+    return count;
+}
+
+bool ReplayReader::fill() {
+    if (at_end_) {
+        return false;
+    }
+    if (format_ == Format::Columnar) {
+        fillColumnar();
+        return true;
+    }
+
+    const QByteArray chunk = file_.read(CHUNK_BYTES);
+    bytes_read_ += chunk.size();
+    if (chunk.isEmpty()) {
+        // A last line without newline still counts
+        if (!buffer_.isEmpty()) {
+            buffer_.append('\n');
+        } else {
+            at_end_ = true;
+        }
+    } else {
+        buffer_.append(chunk);
+    }
+
+    int pos = 0;
+    if (format_ == Format::Csv) {
+        const quint64 malformed = csv_scanner_.stats().malformed;
+        pos = static_cast<int>(csv_scanner_.scan(buffer_.constData(), buffer_.size(),
+                                                 [this](const SpeedLogRecord& record, qint64, qint64) {
+            addCsvRecord(record);
+        }));
+        // The header and commit markers are expected; count the rest
+        rows_skipped_ += csv_scanner_.stats().malformed - malformed;
+    } else {
+        const char* bytes = buffer_.constData();
+        while (pos < buffer_.size()) {
+            const int end = buffer_.indexOf('\n', pos);
+            if (end < 0) {
+                break;
+            }
+            parseAfbLine(bytes + pos, end - pos);
+            pos = end + 1;
+        }
+    }
+    buffer_.remove(0, pos);
+
+    if (chunk.isEmpty() && buffer_.isEmpty()) {
+        at_end_ = true;
+        flushGroup(0);
+    }
+    return true;
+}
+
+void ReplayReader::fillColumnar() {
+    const QVector<ColumnarLogReader::BlockInfo>& blocks = columnar_.blocks();
+    if (next_block_ >= blocks.size()) {
+        at_end_ = true;
+        return;
+    }
+    const QVector<SpeedLogRecord> records = columnar_.readBlock(next_block_);
+    bytes_read_ += (next_block_ + 1 < blocks.size() ? blocks[next_block_ + 1].offset
+                                                    : columnar_.validBytes())
+        - blocks[next_block_].offset;
+    ++next_block_;
+    ready_.reserve(records.size());
+    for (const SpeedLogRecord& record : records) {
+        ready_.append({record.wall_ms, record.raw_speed});
+    }
+}
+
+void ReplayReader::addCsvRecord(const SpeedLogRecord& record) {
+    // The CSV parser accepts "nan" and "inf"; no component expects them
+    if (!std::isfinite(record.raw_speed)) {
+        ++rows_skipped_;
+        return;
+    }
+    if (!group_.isEmpty() && record.wall_ms != group_ms_) {
+        flushGroup(record.wall_ms);
+    }
+    group_ms_ = record.wall_ms;
+    group_.append(record.raw_speed);
+}
+
+void ReplayReader::flushGroup(qint64 next_ms) {
+    const int count = group_.size();
+    if (count == 0) {
+        return;
+    }
+    // Rows share a second only when the log has one-second timestamps
+    const qint64 gap = next_ms - group_ms_;
+    const qint64 span = (gap > 0 && gap <= 1000) ? gap : DEFAULT_PERIOD_MS * count;
+    for (int i = 0; i < count; ++i) {
+        ready_.append({group_ms_ + span * i / count, group_[i]});
+    }
+    group_.clear();
+}
+
+void ReplayReader::parseAfbLine(const char* line, int length) {
+    if (length == 0) {
+        return;
+    }
+    AfbEvent event;
+    if (AfbEventParser::parse(line, static_cast<std::size_t>(length), event)
+            != AfbEventParser::Result::Event
+        || !event.nameEquals(event_.constData())) {
+        ++rows_skipped_;
+        return;
+    }
+    if (!event.has_value || !std::isfinite(event.value)
+        || (event.has_unit && !event.unitEquals("km/h"))) {
+        ++rows_skipped_;
+        return;
+    }
+    const qint64 time_ms = event.has_timestamp ? event.timestamp_ms : last_ms_ + DEFAULT_PERIOD_MS;
+    last_ms_ = time_ms;
+    ready_.append({time_ms, event.value});
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "business_logic/columnar_log.h"
+#include "business_logic/speed_log_csv_scanner.h"
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief One recorded speed sample
+ */
+struct ReplaySample {
+    qint64 time_ms = 0;    ///< Recorded time, ms since epoch
+    double speed = 0.0;    ///< Raw speed in km/h
+};
+
+/**
+ * @brief Streams the samples of one recording in bounded memory
+ *
+ * Reads DataLogger CSV logs, columnar logs (.cslog) and captured AFB
+ * frames (one JSON frame per line, as written by a WebSocket capture).
+ * The raw speed column is replayed. CSV timestamps with one-second
+ * resolution are spread evenly up to the next distinct timestamp, like
+ * the AFB stand-in does.
+ */
+class ReplayReader {
+public:
+    enum class Format {
+        Csv,
+        Columnar,
+        AfbCapture
+    };
+
+    static constexpr const char* DEFAULT_EVENT = "vss/Vehicle.Speed";
+    static constexpr qint64 DEFAULT_PERIOD_MS = 100;   ///< Assumed spacing without timestamps
+    static constexpr int CHUNK_BYTES = 1 << 20;
+
+    /**
+     * @brief Format by file name (.csv, .cslog, anything else is an AFB capture)
+     */
+    static Format formatForPath(const QString& path);
+
+    /**
+     * @brief Recordings under a path: the file itself, or a directory's
+     *        speed logs and captures (*.afb, *.jsonl), oldest first
+     */
+    static QStringList expandPath(const QString& path);
+
+    /**
+     * @param event AFB event carrying the speed (captures only)
+     */
+    explicit ReplayReader(const QString& event = DEFAULT_EVENT);
+
+    /**
+     * @brief Start reading a recording
+     * @return false if it cannot be opened
+     */
+    bool open(const QString& path);
+
+    /**
+     * @brief Next samples in recorded order
+     * @param out Room for max samples
+     * @return Number of samples, 0 at the end of the recording
+     */
+    int read(ReplaySample* out, int max);
+
+    quint64 rowsSkipped() const { return rows_skipped_; }   ///< Malformed rows, other events
+    qint64 bytesRead() const { return bytes_read_; }
+
+private:
+    /**
+     * @brief Parse the next chunk into ready_; false at the end of the file
+     */
+    bool fill();
+    void fillColumnar();
+    void addCsvRecord(const SpeedLogRecord& record);
+    void parseAfbLine(const char* line, int length);
+
+    /**
+     * @brief Emit the rows sharing group_ms_, spread up to next_ms (0 = unknown)
+     */
+    void flushGroup(qint64 next_ms);
+
+    QByteArray event_;
+    Format format_ = Format::Csv;
+    QFile file_;
+    ColumnarLogReader columnar_;
+    int next_block_ = 0;
+    QByteArray buffer_;                  ///< Unparsed bytes (partial last line)
+    SpeedLogCsvScanner csv_scanner_;
+    bool at_end_ = true;
+    QVector<ReplaySample> ready_;
+    int ready_pos_ = 0;
+    QVector<double> group_;              ///< CSV speeds sharing group_ms_
+    qint64 group_ms_ = 0;
+    qint64 last_ms_ = 0;                 ///< Previous capture sample
+    quint64 rows_skipped_ = 0;
+    qint64 bytes_read_ = 0;
+};
@@ -0,0 +1,98 @@
+#include "work_stealing_pool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(int workers, int max_pending)
+    : max_pending_(std::max(1, max_pending))
+{
+    const int count = std::max(1, workers);
+    for (int i = 0; i < count; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (int i = 0; i < count; ++i) {
+        threads_.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_available_.wait(lock, [this]() { return pending_ < max_pending_; });
+    Queue& queue = *queues_[next_queue_++ % queues_.size()];
+    {
+        std::lock_guard<std::mutex> queue_lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    ++pending_;
+    lock.unlock();
+    work_available_.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    all_done_.wait(lock, [this]() { return pending_ == 0 && running_ == 0; });
+}
+
+bool WorkStealingPool::take(int worker, Task* task) {
+    // Own deque first, newest task
+    {
+        Queue& own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            *task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    // Then the oldest task of the next worker that has one
+    const int count = static_cast<int>(queues_.size());
+    for (int i = 1; i < count; ++i) {
+        Queue& victim = *queues_[(worker + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            *task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int worker) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_available_.wait(lock, [this]() { return pending_ > 0 || stopping_; });
+            if (pending_ == 0) {
+                return;   // Stopping and drained
+            }
+            // Claim one task; every claim is backed by a task in some deque
+            --pending_;
+            ++running_;
+        }
+        space_available_.notify_one();
+
+        Task task;
+        while (!take(worker, &task)) {
+            std::this_thread::yield();   // A concurrent scan took the one we saw first
+        }
+        task(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --running_;
+        }
+        all_done_.notify_all();
+    }
+}
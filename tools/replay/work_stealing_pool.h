@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads with one task deque each
+ *
+ * submit() deals tasks round-robin to the deques. A worker takes the
+ * newest task from its own deque and, once that is empty, steals the
+ * oldest task of another worker, so a few long tasks do not leave the
+ * other threads idle. submit() blocks while max_pending tasks are
+ * waiting, which bounds memory however many tasks a producer has.
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @brief Task body; gets the index of the worker running it
+     */
+    using Task = std::function<void(int worker)>;
+
+    /**
+     * @param workers Number of threads (at least 1)
+     * @param max_pending Tasks waiting before submit() blocks (at least 1)
+     */
+    WorkStealingPool(int workers, int max_pending);
+
+    /**
+     * @brief Finishes the submitted tasks and joins the threads
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int workerCount() const { return static_cast<int>(threads_.size()); }
+
+    void submit(Task task);
+
+    /**
+     * @brief Block until every submitted task has finished
+     */
+    void wait();
+
+    /**
+     * @brief Tasks run by a worker other than the one they were dealt to
+     */
+    unsigned long long stolenCount() const { return stolen_.load(std::memory_order_relaxed); }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(int worker);
+    bool take(int worker, Task* task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    int max_pending_;
+
+    std::mutex mutex_;                         ///< Guards the counters below
+    std::condition_variable work_available_;
+    std::condition_variable space_available_;
+    std::condition_variable all_done_;
+    int pending_ = 0;                          ///< Submitted, not yet taken
+    int running_ = 0;                          ///< Taken, not yet finished
+    bool stopping_ = false;
+    unsigned next_queue_ = 0;
+    std::atomic<unsigned long long> stolen_{0};
+};